@@ -80,6 +80,7 @@ enum class AlgoDataType : uint32_t {
     INT16X16X32 = 1 << 5,
     INT4X4X16 = 1 << 6,
     QINT4x4x32 = 1 << 7,
+    BFLOAT16 = 1 << 8,
 };
 
 /*!
@@ -206,6 +206,52 @@ protected:
 
 using SVD = SVDForward;
 
+/*!
+ * \brief matrix multiplication of float activations and weights quantized to
+ *      int8 or int4, which are dequantized inside the kernel
+ *
+ * C[m, n] = sum_k A[m, k] * W[n, k] * scale[n, k / group_size]
+ *
+ * Only the weights and their scales are read from memory in the quantized
+ * form, which reduces the memory traffic of a matrix mul with a small m.
+ */
+class WeightQuantMatrixMulForward : public OperatorBase {
+    DEF_OPR_PARAM(WeightQuantMatrixMul);
+    DEF_OPR_IMPL(WeightQuantMatrixMulForward, OperatorBase, 3, 1);
+
+public:
+    /**
+     * \param[in] A (m, k) or (batch, m, k), float32
+     * \param[in] W (n, k) if bits is 8, (n, k / 2) if bits is 4, with the
+     *      leading batch dim if A has it, int8
+     * \param[in] scale (n, k / group_size), or (n, 1) if group_size is 0,
+     *      with the leading batch dim if A has it, float32
+     * \param[out] C (m, n) or (batch, m, n), float32
+     *
+     * All the tensors must be contiguous.
+     */
+    virtual void exec(
+            _megdnn_tensor_in A, _megdnn_tensor_in W, _megdnn_tensor_in scale,
+            _megdnn_tensor_out C, _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& A, const TensorLayout& W, const TensorLayout& scale,
+            TensorLayout& C);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& A, const TensorLayout& W, const TensorLayout& scale,
+            const TensorLayout& C) = 0;
+
+    //! number of weights sharing a scale in a row of \p k weights
+    size_t group_size(size_t k) const {
+        return param().group_size ? param().group_size : k;
+    }
+
+protected:
+    void check_exec(
+            const TensorLayout& A, const TensorLayout& W, const TensorLayout& scale,
+            const TensorLayout& C, size_t workspace_in_bytes);
+};
+using WeightQuantMatrixMul = WeightQuantMatrixMulForward;
+
 }  // namespace megdnn
 
 #include "megdnn/internal/opr_header_epilogue.h"
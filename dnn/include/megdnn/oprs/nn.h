@@ -549,11 +549,13 @@ protected:
 };
 
 class ConvPoolingForward : public ConvPoolingBase {
-    DEF_OPR_IMPL(ConvPoolingForward, ConvPoolingBase, 2, 1);
+    DEF_OPR_IMPL(ConvPoolingForward, ConvPoolingBase, 3, 1);
 
 public:
     /**
      * \param[in] src input tensor
+     * \param[in] filter filter of the conv
+     * \param[in] bias bias of the conv, broadcast along the channels
      * \param[out] dst output tensor
      */
     virtual void exec(
@@ -575,6 +577,70 @@ protected:
 };
 using ConvPooling = ConvPoolingForward;
 
+/*!
+ * \brief a channel-wise ConvBias followed by a 1x1 ConvBias, in NCHW
+ *
+ * dst = pw_nonline(conv1x1(dw_nonline(chanwise_conv(src, dw_filter) + dw_bias),
+ *       pw_filter) + pw_bias)
+ *
+ * The output of the channel-wise conv does not have to be written to memory as
+ * a whole feature map, an implementation may compute it for a few rows at a
+ * time and consume it by the 1x1 conv while it is in cache.
+ */
+class DepthwisePointwiseConvBiasForward : public OperatorBase {
+    DEF_OPR_PARAM(DepthwisePointwiseConvBias);
+    DEF_OPR_IMPL(DepthwisePointwiseConvBiasForward, OperatorBase, 5, 1);
+
+public:
+    /**
+     * \param[in] src (n, c, ih, iw)
+     * \param[in] dw_filter (c, 1, 1, fh, fw), the filter of a channel-wise
+     *      ConvBias in group mode
+     * \param[in] dw_bias (1, c, 1, 1)
+     * \param[in] pw_filter (oc, c, 1, 1)
+     * \param[in] pw_bias (1, oc, 1, 1)
+     * \param[out] dst (n, oc, oh, ow)
+     *
+     * src, the filters and dst are all Float32 or all QuantizedS8, with
+     * Float32 or QuantizedS32 biases respectively. The output of the
+     * channel-wise conv is rounded to QuantizedS8 in the quantized case, with
+     * the scale given by mid_dtype().
+     */
+    virtual void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in dw_filter,
+            _megdnn_tensor_in dw_bias, _megdnn_tensor_in pw_filter,
+            _megdnn_tensor_in pw_bias, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) = 0;
+    void deduce_dtype(
+            DType src, DType dw_filter, DType dw_bias, DType pw_filter,
+            DType pw_bias, DType& dst);
+    void deduce_layout(
+            const TensorLayout& src, const TensorLayout& dw_filter,
+            const TensorLayout& dw_bias, const TensorLayout& pw_filter,
+            const TensorLayout& pw_bias, TensorLayout& dst);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& dw_filter,
+            const TensorLayout& dw_bias, const TensorLayout& pw_filter,
+            const TensorLayout& pw_bias, const TensorLayout& dst) = 0;
+
+    /*!
+     * \brief dtype of the output of the channel-wise conv
+     *
+     * It is the scale of pw_bias divided by the scale of pw_filter in the
+     * quantized case, as the bias of a ConvBias has the scale of its src times
+     * the scale of its filter.
+     */
+    static DType mid_dtype(DType src, DType pw_filter, DType pw_bias);
+
+protected:
+    void check_exec(
+            const TensorLayout& src, const TensorLayout& dw_filter,
+            const TensorLayout& dw_bias, const TensorLayout& pw_filter,
+            const TensorLayout& pw_bias, const TensorLayout& dst,
+            size_t workspace_in_bytes);
+};
+using DepthwisePointwiseConvBias = DepthwisePointwiseConvBiasForward;
+
 class GroupLocalBase : public OperatorBase {
     DEF_OPR_IMPL_CTOR(GroupLocalBase, OperatorBase);
     DEF_OPR_PARAM(Convolution);
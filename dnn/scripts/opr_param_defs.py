@@ -1275,3 +1275,29 @@ PADDING_MODES = [Doc('REPLICATE = 0', 'aaaaaa|abcdefgh|hhhhhhh'),
  add_fields('bool', Doc('bias_correction', 'whether correct bias'), 'true').
  add_fields('bool', Doc('always_adapt', 'apply adaptive lr to 0.0'), 'false')
 )
+
+(pdef('WeightQuantMatrixMul').
+ add_fields('uint32',
+            Doc('bits', 'Bits of a quantized weight, which is 8 or 4. Two 4-bit '
+                'weights are packed into a byte along k, the first one in the low '
+                'bits.'),
+            '8',
+            Doc('group_size', 'Number of consecutive weights along k sharing a '
+                'scale, 0 (the default) means a single scale for each output '
+                'channel.'),
+            '0'))
+
+(pdef('DepthwisePointwiseConvBias',
+      'pw_nonline(conv1x1(dw_nonline(channel_wise_conv(x, dw_filter) + dw_bias), '
+      'pw_filter) + pw_bias), i.e. a channel-wise ConvBias followed by a 1x1 '
+      'ConvBias in NCHW').
+ add_enum_alias('DwNonlineMode', 'ConvBiasV0', 'NonlineMode',
+                name_field='dw_nonline_mode').
+ add_enum_alias('PwNonlineMode', 'ConvBiasV0', 'NonlineMode',
+                name_field='pw_nonline_mode').
+ add_fields(
+     'uint32',
+     Doc('pad_h', 'padding of the channel-wise conv on the first dimension'), 0,
+     Doc('pad_w', 'padding of the channel-wise conv on the second dimension'), 0,
+     Doc('stride_h', 'stride of the channel-wise conv on the first dimension'), 1,
+     Doc('stride_w', 'stride of the channel-wise conv on the second dimension'), 1))
@@ -0,0 +1,116 @@
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+DType DepthwisePointwiseConvBiasForward::mid_dtype(
+        DType src, DType pw_filter, DType pw_bias) {
+    if (src.enumv() == DTypeEnum::QuantizedS8) {
+        float scale = pw_bias.param<dtype::QuantizedS32>().scale /
+                      pw_filter.param<dtype::QuantizedS8>().scale;
+        return dtype::QuantizedS8(scale);
+    }
+    return src;
+}
+
+void DepthwisePointwiseConvBiasForward::deduce_dtype(
+        DType src, DType dw_filter, DType dw_bias, DType pw_filter, DType pw_bias,
+        DType& dst) {
+    if (src.enumv() == DTypeEnum::Float32) {
+        megdnn_assert(
+                dw_filter == src && dw_bias == src && pw_filter == src &&
+                        pw_bias == src,
+                "all the inputs of a float DepthwisePointwiseConvBias must be "
+                "Float32");
+        megdnn_assert(
+                !dst.valid() || dst == src, "invalid dst dtype %s", dst.name());
+        dst = src;
+        return;
+    }
+    megdnn_assert(
+            src.enumv() == DTypeEnum::QuantizedS8 &&
+                    dw_filter.enumv() == DTypeEnum::QuantizedS8 &&
+                    pw_filter.enumv() == DTypeEnum::QuantizedS8 &&
+                    dw_bias.enumv() == DTypeEnum::QuantizedS32 &&
+                    pw_bias.enumv() == DTypeEnum::QuantizedS32,
+            "unsupported dtypes of DepthwisePointwiseConvBias: %s %s %s %s %s",
+            src.name(), dw_filter.name(), dw_bias.name(), pw_filter.name(),
+            pw_bias.name());
+    float src_scale = src.param<dtype::QuantizedS8>().scale,
+          dw_scale = dw_filter.param<dtype::QuantizedS8>().scale,
+          dw_bias_scale = dw_bias.param<dtype::QuantizedS32>().scale;
+    megdnn_assert(
+            std::abs(src_scale * dw_scale - dw_bias_scale) < 1e-6 * dw_bias_scale,
+            "scale of dw_bias must be the product of the scales of src and "
+            "dw_filter, got %g * %g vs %g",
+            src_scale, dw_scale, dw_bias_scale);
+    megdnn_assert(
+            dst.valid() && dst.enumv() == DTypeEnum::QuantizedS8,
+            "dst of a quantized DepthwisePointwiseConvBias must be QuantizedS8");
+}
+
+void DepthwisePointwiseConvBiasForward::deduce_layout(
+        const TensorLayout& src, const TensorLayout& dw_filter,
+        const TensorLayout& dw_bias, const TensorLayout& pw_filter,
+        const TensorLayout& pw_bias, TensorLayout& dst) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(src) + ", " + megdnn_layout_msg(dw_filter) + ", " +
+               megdnn_layout_msg(pw_filter);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    megdnn_assert(
+            src.ndim == 4 && dw_filter.ndim == 5 && pw_filter.ndim == 4, "%s",
+            errmsg().c_str());
+    auto&& p = param();
+    size_t FH = dw_filter[3], FW = dw_filter[4];
+    megdnn_assert(
+            src[2] + 2 * p.pad_h >= FH && src[3] + 2 * p.pad_w >= FW, "%s",
+            errmsg().c_str());
+    size_t OH = infer_conv_shape(src[2], FH, p.stride_h, p.pad_h),
+           OW = infer_conv_shape(src[3], FW, p.stride_w, p.pad_w);
+    DType dst_dtype = dst.dtype;
+    deduce_dtype(
+            src.dtype, dw_filter.dtype, dw_bias.dtype, pw_filter.dtype, pw_bias.dtype,
+            dst_dtype);
+    dst = TensorLayout{{src[0], pw_filter[0], OH, OW}, dst_dtype};
+}
+
+void DepthwisePointwiseConvBiasForward::check_exec(
+        const TensorLayout& src, const TensorLayout& dw_filter,
+        const TensorLayout& dw_bias, const TensorLayout& pw_filter,
+        const TensorLayout& pw_bias, const TensorLayout& dst,
+        size_t workspace_in_bytes) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(src) + ", " + megdnn_layout_msg(dw_filter) + ", " +
+               megdnn_layout_msg(dw_bias) + ", " + megdnn_layout_msg(pw_filter) +
+               ", " + megdnn_layout_msg(pw_bias) + ", " + megdnn_layout_msg(dst);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    megdnn_assert(
+            src.is_contiguous() && dw_filter.is_contiguous() &&
+                    dw_bias.is_contiguous() && pw_filter.is_contiguous() &&
+                    pw_bias.is_contiguous() && dst.is_contiguous(),
+            "%s", errmsg().c_str());
+    size_t C = src[1], OC = pw_filter[0];
+    megdnn_assert(
+            dw_filter[0] == C && dw_filter[1] == 1 && dw_filter[2] == 1 &&
+                    pw_filter[1] == C && pw_filter[2] == 1 && pw_filter[3] == 1,
+            "%s", errmsg().c_str());
+    megdnn_assert(
+            dw_bias.eq_shape({1, C, 1, 1}) && pw_bias.eq_shape({1, OC, 1, 1}), "%s",
+            errmsg().c_str());
+    megdnn_assert(
+            param().stride_h > 0 && param().stride_w > 0, "%s", errmsg().c_str());
+    TensorLayout dst_expected = dst;
+    deduce_layout(src, dw_filter, dw_bias, pw_filter, pw_bias, dst_expected);
+    megdnn_assert_eq_layout(dst_expected, dst);
+
+    auto required_workspace_in_bytes =
+            get_workspace_in_bytes(src, dw_filter, dw_bias, pw_filter, pw_bias, dst);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
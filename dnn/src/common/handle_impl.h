@@ -212,7 +212,9 @@ private:
     cb(LAMBUpdate) \
     cb(LSTMBackward) \
     cb(SoftmaxForward) \
-    cb(SoftmaxBackward)
+    cb(SoftmaxBackward) \
+    cb(WeightQuantMatrixMulForward) \
+    cb(DepthwisePointwiseConvBiasForward)
 // clang-format on
 
 /*!
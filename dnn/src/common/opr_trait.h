@@ -26,6 +26,7 @@ DEF(Convolution3DBackwardData, 3, true, false);
 DEF(Convolution3DBackwardFilter, 3, true, false);
 DEF(ConvPoolingForward, 4, true, true);
 DEF(ConvBiasForward, 5, true, true);
+DEF(DepthwisePointwiseConvBiasForward, 6, true, true);
 DEF(SeparableConvForward, 4, true, true);
 DEF(SeparableFilterForward, 4, true, true);
 DEF(Images2NeibsForward, 2, true, true);
@@ -60,6 +61,7 @@ DEF(MatrixMulForward, 3, true, true);
 DEF(BatchedMatrixMulForward, 3, true, true);
 DEF(MatrixInverse, 2, true, true);
 DEF(SVDForward, 4, true, true);
+DEF(WeightQuantMatrixMulForward, 4, true, true);
 DEF(ReduceForward, 2, true, true);
 DEF(CumsumForward, 2, true, true);
 DEF(ArgmaxForward, 2, true, true);
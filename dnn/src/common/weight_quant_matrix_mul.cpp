@@ -0,0 +1,72 @@
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+void WeightQuantMatrixMulForward::deduce_layout(
+        const TensorLayout& A, const TensorLayout& W, const TensorLayout&,
+        TensorLayout& C) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(A) + ", " + megdnn_layout_msg(W);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    megdnn_assert(
+            (A.ndim == 2 || A.ndim == 3) && A.ndim == W.ndim, "%s", errmsg().c_str());
+    if (A.ndim == 2) {
+        C = TensorLayout(TensorShape{A[0], W[0]}, A.dtype);
+    } else {
+        C = TensorLayout(TensorShape{A[0], A[1], W[1]}, A.dtype);
+    }
+}
+
+void WeightQuantMatrixMulForward::check_exec(
+        const TensorLayout& A, const TensorLayout& W, const TensorLayout& scale,
+        const TensorLayout& C, size_t workspace_in_bytes) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(A) + ", " + megdnn_layout_msg(W) + ", " +
+               megdnn_layout_msg(scale) + ", " + megdnn_layout_msg(C) +
+               ", bits=" + std::to_string(param().bits) +
+               ", group_size=" + std::to_string(param().group_size);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    megdnn_assert(
+            A.dtype == dtype::Float32() && W.dtype == dtype::Int8() &&
+                    scale.dtype == dtype::Float32() && C.dtype == dtype::Float32(),
+            "%s", errmsg().c_str());
+    megdnn_assert(
+            A.is_contiguous() && W.is_contiguous() && scale.is_contiguous() &&
+                    C.is_contiguous(),
+            "%s", errmsg().c_str());
+    megdnn_assert(
+            (A.ndim == 2 || A.ndim == 3) && W.ndim == A.ndim &&
+                    scale.ndim == A.ndim && C.ndim == A.ndim,
+            "%s", errmsg().c_str());
+    size_t batch_dim = A.ndim - 2;
+    if (batch_dim) {
+        megdnn_assert(
+                W[0] == A[0] && scale[0] == A[0] && C[0] == A[0], "%s",
+                errmsg().c_str());
+    }
+    size_t M = A[batch_dim], K = A[batch_dim + 1], N = W[batch_dim];
+    auto bits = param().bits;
+    megdnn_assert(bits == 8 || bits == 4, "%s", errmsg().c_str());
+    megdnn_assert(
+            W[batch_dim + 1] * (8 / bits) == K && K % (8 / bits) == 0, "%s",
+            errmsg().c_str());
+    size_t group = group_size(K);
+    megdnn_assert(
+            group && K % group == 0 && group % (8 / bits) == 0, "%s",
+            errmsg().c_str());
+    megdnn_assert(
+            scale[batch_dim] == N && scale[batch_dim + 1] == K / group, "%s",
+            errmsg().c_str());
+    megdnn_assert(C[batch_dim] == M && C[batch_dim + 1] == N, "%s", errmsg().c_str());
+
+    auto required_workspace_in_bytes = get_workspace_in_bytes(A, W, scale, C);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
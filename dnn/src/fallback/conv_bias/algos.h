@@ -22,6 +22,7 @@ public:
     ConvAlgoTypePack get_algo_type() const override {
         auto support_data_type = static_cast<AlgoDataType>(
                 static_cast<uint32_t>(AlgoDataType::FLOAT16) |
+                static_cast<uint32_t>(AlgoDataType::BFLOAT16) |
                 static_cast<uint32_t>(AlgoDataType::FLOAT32) |
                 static_cast<uint32_t>(AlgoDataType::INT8X8X16) |
                 static_cast<uint32_t>(AlgoDataType::QINT8X8X32) |
@@ -10,6 +10,9 @@ namespace winograd {
 MEGDNN_REG_WINOGRAD_STRATEGY(
         float, float, float, float, 2, 3, 4, 4, winograd_gi_2x3_4x4_f)
 
+MEGDNN_REG_WINOGRAD_STRATEGY(
+        float, float, float, float, 4, 3, 4, 4, winograd_4x3_4x4_f)
+
 MEGDNN_REG_WINOGRAD_STRATEGY(float, float, float, float, 6, 3, 1, 1, winograd_6x3_1x1_f)
 
 MEGDNN_REG_WINOGRAD_STRATEGY(float, float, float, float, 6, 3, 4, 4, winograd_6x3_4x4_f)
@@ -21,6 +24,9 @@ MEGDNN_REG_WINOGRAD_STRATEGY(float, float, float, float, 4, 5, 1, 1, winograd_4x
 MEGDNN_REG_WINOGRAD_STRATEGY(
         float, float, float, float, 2, 3, 4, 4, winograd_F23_mk4_f_nchw44)
 
+MEGDNN_REG_WINOGRAD_STRATEGY(
+        float, float, float, float, 4, 3, 4, 4, winograd_F43_mk4_f_nchw44)
+
 MEGDNN_REG_WINOGRAD_STRATEGY(
         float, float, float, float, 6, 3, 4, 4, winograd_F63_mk4_f_nchw44)
 
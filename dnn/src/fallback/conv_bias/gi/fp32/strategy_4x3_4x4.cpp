@@ -0,0 +1,314 @@
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+#include "src/common/winograd/winograd_helper.h"
+#include "src/fallback/conv_bias/gi/fp32/helper.h"
+#include "src/fallback/conv_bias/gi/fp32/strategy.h"
+#include "src/fallback/conv_bias/gi/utils.h"
+#include "src/fallback/conv_bias/winograd/winograd.h"
+#include "src/fallback/elemwise_helper/op_unary.h"
+
+#include "midout.h"
+MIDOUT_DECL(megdnn_fallback_winograd_fp32_F43_4x4)
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+constexpr size_t alpha = 4 + 3 - 1;
+
+struct InputTransform4X3 {
+    //! gather the patch of 4 input channels into patchT, as (alpha, alpha, 4)
+    template <bool inner>
+    static void prepare(
+            const float* input, float* patchT, int ih_start, int iw_start, size_t IH,
+            size_t IW, size_t ic) {
+        if (inner) {
+            const float* input_ptr = input + ic * IH * IW + ih_start * IW + iw_start;
+            for (size_t ih = 0; ih < alpha; ++ih) {
+                //! the columns 2 and 3 are transposed twice to stay in the row
+                float* dst = patchT + ih * alpha * 4;
+                transpose_4x4(input_ptr, dst, IH * IW, 4);
+                transpose_4x4(input_ptr + 2, dst + 2 * 4, IH * IW, 4);
+                input_ptr += IW;
+            }
+        } else {
+            memset(patchT, 0, sizeof(float) * 4 * alpha * alpha);
+            int ih0_act = std::max<int>(ih_start, 0),
+                ih1_act = std::min<int>(ih_start + alpha, IH),
+                iw0_act = std::max<int>(iw_start, 0),
+                iw1_act = std::min<int>(iw_start + alpha, IW);
+            // partial copy
+            for (size_t ico = 0; ico < 4; ++ico) {
+                for (int ih = ih0_act; ih < ih1_act; ++ih) {
+                    for (int iw = iw0_act; iw < iw1_act; ++iw) {
+                        size_t iho = ih - ih_start, iwo = iw - iw_start;
+                        patchT[(iho * alpha + iwo) * 4 + ico] =
+                                input[(ic + ico) * IH * IW + ih * IW + iw];
+                    }
+                }
+            }
+        }
+    }
+
+    static void transform(
+            const float* patchT, float* input_transform_buf, size_t unit_idx,
+            size_t nr_units_in_tile, size_t ic, size_t IC) {
+        // BT * d * B
+        size_t ICB = IC / 4;
+        size_t icb = ic / 4;
+
+#define cb(m, n)                                       \
+    Vector<float, 4> d##m##n = Vector<float, 4>::load( \
+            patchT + m * alpha * 4 + n * 4);
+        UNROLL_CALL_NOWRAPPER_D2(6, 6, cb);
+#undef cb
+
+        //! BT
+        //!  4  0 -5  0  1  0
+        //!  0 -4 -4  1  1  0
+        //!  0  4 -4 -1  1  0
+        //!  0 -2 -1  2  1  0
+        //!  0  2 -1 -2  1  0
+        //!  0  4  0 -5  0  1
+        Vector<float, 4> a, b, c, e;
+#define cb(m)                                       \
+    a = d4##m - d2##m * 4.f;                        \
+    b = d3##m - d1##m * 4.f;                        \
+    c = d4##m - d2##m;                              \
+    e = (d3##m - d1##m) * 2.f;                      \
+    auto t0##m = d0##m * 4.f - d2##m * 5.f + d4##m; \
+    auto t1##m = a + b;                             \
+    auto t2##m = a - b;                             \
+    auto t3##m = c + e;                             \
+    auto t4##m = c - e;                             \
+    auto t5##m = d1##m * 4.f - d3##m * 5.f + d5##m;
+        UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+
+#define cb(m)                                          \
+    a = t##m##4 - t##m##2 * 4.f;                       \
+    b = t##m##3 - t##m##1 * 4.f;                       \
+    c = t##m##4 - t##m##2;                             \
+    e = (t##m##3 - t##m##1) * 2.f;                     \
+    d##m##0 = t##m##0 * 4.f - t##m##2 * 5.f + t##m##4; \
+    d##m##1 = a + b;                                   \
+    d##m##2 = a - b;                                   \
+    d##m##3 = c + e;                                   \
+    d##m##4 = c - e;                                   \
+    d##m##5 = t##m##1 * 4.f - t##m##3 * 5.f + t##m##5;
+        UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+
+#define cb(m, n)                                                                 \
+    d##m##n.save(                                                                \
+            input_transform_buf + (m * alpha + n) * ICB * nr_units_in_tile * 4 + \
+            icb * nr_units_in_tile * 4 + unit_idx * 4);
+        UNROLL_CALL_NOWRAPPER_D2(6, 6, cb);
+#undef cb
+    }
+};
+
+template <BiasMode bmode, typename Op>
+struct OutputTransform4X3 {
+    static void transform(
+            const float* output_transform_buf, const float* bias, float* output,
+            float* transform_mid_buf, size_t oh_start, size_t ow_start, size_t OH,
+            size_t OW, size_t oc_start, size_t oc_end, size_t oc_index, size_t unit_idx,
+            size_t nr_units_in_tile, const DType& src_dtype, const DType& dst_dtype) {
+        Op op(src_dtype, dst_dtype);
+        //! AT * m * A
+
+        size_t oc = oc_start + oc_index;
+        size_t OCB = (oc_end - oc_start) / 4;
+        size_t ocb = oc_index / 4;
+
+#define cb(m, n)                                                                  \
+    auto v##m##n = Vector<float, 4>::load(                                        \
+            output_transform_buf + (m * alpha + n) * OCB * nr_units_in_tile * 4 + \
+            ocb * nr_units_in_tile * 4 + unit_idx * 4);
+        UNROLL_CALL_NOWRAPPER_D2(6, 6, cb);
+#undef cb
+
+        //! AT
+        //!  1  1  1  1  1  0
+        //!  0  1 -1  2 -2  0
+        //!  0  1  1  4  4  0
+        //!  0  1 -1  8 -8  1
+        Vector<float, 4> v1addv2, v1subv2, v3addv4, v3subv4;
+#define cb(m)                               \
+    v1addv2 = v1##m + v2##m;                \
+    v1subv2 = v1##m - v2##m;                \
+    v3addv4 = v3##m + v4##m;                \
+    v3subv4 = v3##m - v4##m;                \
+    auto t0##m = v0##m + v1addv2 + v3addv4; \
+    auto t1##m = v1subv2 + v3subv4 * 2.f;   \
+    auto t2##m = v1addv2 + v3addv4 * 4.f;   \
+    auto t3##m = v1subv2 + v3subv4 * 8.f + v5##m;
+        UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+
+#define cb(m)                              \
+    v1addv2 = t##m##1 + t##m##2;           \
+    v1subv2 = t##m##1 - t##m##2;           \
+    v3addv4 = t##m##3 + t##m##4;           \
+    v3subv4 = t##m##3 - t##m##4;           \
+    v##m##0 = t##m##0 + v1addv2 + v3addv4; \
+    v##m##1 = v1subv2 + v3subv4 * 2.f;     \
+    v##m##2 = v1addv2 + v3addv4 * 4.f;     \
+    v##m##3 = v1subv2 + v3subv4 * 8.f + t##m##5;
+        UNROLL_CALL_NOWRAPPER(4, cb);
+#undef cb
+
+        if (bmode == BiasMode::BROADCAST_CHANNEL_BIAS) {
+            Vector<float, 4> vbias = Vector<float, 4>::load(bias + oc);
+#define cb(m, n) v##m##n += vbias;
+            UNROLL_CALL_RAW_D2(4, 4, cb);
+#undef cb
+        }
+        if (bmode != BiasMode::BIAS) {
+#define cb(m, n) v##m##n = op(CONCAT(v##m, n).value);
+            UNROLL_CALL_RAW_D2(4, 4, cb);
+#undef cb
+        }
+
+#define cb(m, n) CONCAT(v##m, n).save(transform_mid_buf + (m * 4 + n) * 4);
+        UNROLL_CALL_RAW_D2(4, 4, cb);
+#undef cb
+
+        for (size_t oco = 0; oco < 4 && oc + oco < oc_end; ++oco) {
+            for (size_t oho = 0; oho < 4 && oh_start + oho < OH; ++oho) {
+                for (size_t owo = 0; owo < 4 && ow_start + owo < OW; ++owo) {
+                    size_t oh = oh_start + oho;
+                    size_t ow = ow_start + owo;
+                    float res = transform_mid_buf[oho * 4 * 4 + owo * 4 + oco];
+                    if (bmode == BiasMode::BIAS) {
+                        res += bias[(oc + oco) * OH * OW + oh * OW + ow];
+                        res = op(res);
+                    }
+                    output[(oc + oco) * OH * OW + oh * OW + ow] = res;
+                }
+            }
+        }
+    }
+};
+}  // namespace
+
+namespace megdnn {
+namespace fallback {
+namespace winograd {
+
+MEGDNN_REG_WINOGRAD_STRATEGY_IMPL(winograd_4x3_4x4_f)
+
+void winograd_4x3_4x4_f::filter(
+        const float* filter, float* filter_transform_buf, float* transform_mid_buf,
+        size_t OC, size_t IC, size_t oc_start, size_t oc_end) {
+    // Gg * GT
+    // G
+    //  1/4      0     0
+    // -1/6   -1/6  -1/6
+    // -1/6    1/6  -1/6
+    //  1/24  1/12   1/6
+    //  1/24 -1/12   1/6
+    //  0        0     1
+    //! it runs once for the weights with weight preprocess, so it stays scalar
+    //! for the single output channel of each filter process kern
+    auto transform_row = [](const float* g, float* wd) {
+        float tmp0 = (g[0] + g[2]) * -0.16666667f, tmp1 = g[1] * -0.16666667f;
+        wd[0] = g[0] * 0.25f;
+        wd[1] = tmp0 + tmp1;
+        wd[2] = tmp0 - tmp1;
+        tmp0 = g[0] * 0.041666668f + g[2] * 0.16666667f;
+        tmp1 = g[1] * 0.083333336f;
+        wd[3] = tmp0 + tmp1;
+        wd[4] = tmp0 - tmp1;
+        wd[5] = g[2];
+    };
+    megdnn_assert(OC % 4 == 0 && IC % 4 == 0);
+    size_t OCB = OC / 4;
+    size_t ICB = IC / 4;
+    //! wd(3, alpha) = g * GT
+    float* wd = transform_mid_buf;
+    for (size_t oc = oc_start; oc < oc_end; oc++) {
+        rep(ic, IC) {
+            const float* fptr = filter + (oc * IC + ic) * 3 * 3;
+            rep(i, 3) { transform_row(fptr + i * 3, wd + i * alpha); }
+            size_t ocb = oc / 4, oc4 = oc % 4, icb = ic / 4, ic4 = ic % 4;
+            rep(j, alpha) {
+                float col[3] = {wd[j], wd[alpha + j], wd[2 * alpha + j]}, ret[alpha];
+                transform_row(col, ret);
+                rep(i, alpha) {
+                    filter_transform_buf
+                            [(i * alpha + j) * OCB * ICB * 4 * 4 + ocb * ICB * 4 * 4 +
+                             icb * 4 * 4 + ic4 * 4 + oc4] = ret[i];
+                }
+            }
+        }
+    }
+}
+
+void winograd_4x3_4x4_f::input(
+        const float* input, float* input_transform_buf, float* transform_mid_buf,
+        size_t IH, size_t IW, size_t IC, size_t PH, size_t PW, size_t unit_start_idx,
+        size_t nr_units_in_tile) {
+    megdnn_assert(IC % 4 == 0);
+    constexpr int alpha = 3 + 4 - 1;
+
+    // OW = IW + 2 * PW - KERNEL_SIZE + 1
+    auto units_w = div_ceil<size_t>(IW + 2 * PW - KERNEL_SIZE + 1, OUTPUT_BLOCK_SIZE);
+    float* patchT = transform_mid_buf;
+
+    for (size_t ic = 0; ic < IC; ic += 4) {
+        rep(unit_idx, nr_units_in_tile) {
+            size_t index = unit_start_idx + unit_idx;
+            size_t nh = index / units_w;
+            size_t nw = index % units_w;
+            int ih_start = nh * OUTPUT_BLOCK_SIZE - PH;
+            int iw_start = nw * OUTPUT_BLOCK_SIZE - PW;
+            if (ih_start >= 0 && ih_start + alpha <= static_cast<int>(IH) &&
+                iw_start >= 0 && iw_start + alpha <= static_cast<int>(IW)) {
+                InputTransform4X3::prepare<true>(
+                        input, patchT, ih_start, iw_start, IH, IW, ic);
+            } else {
+                InputTransform4X3::prepare<false>(
+                        input, patchT, ih_start, iw_start, IH, IW, ic);
+            }
+            InputTransform4X3::transform(
+                    patchT, input_transform_buf, unit_idx, nr_units_in_tile, ic, IC);
+        }
+    }
+}
+
+void winograd_4x3_4x4_f::output(
+        const float* output_transform_buf, const float* bias, float* output,
+        float* transform_mid_buf, BiasMode bmode, NonlineMode nonline_mode, size_t OH,
+        size_t OW, size_t oc_start, size_t oc_end, size_t unit_start_idx,
+        size_t nr_units_in_tile) {
+#define cb(_bmode, _nonline_op, ...) \
+    OutputTransform4X3<_bmode MEGDNN_COMMA _nonline_op>::transform(__VA_ARGS__);
+
+    auto units_w = div_ceil<size_t>(OW, OUTPUT_BLOCK_SIZE);
+
+    for (size_t oc = oc_start; oc < oc_end; oc += 4) {
+        size_t oc_index = oc - oc_start;
+        rep(unit_idx, nr_units_in_tile) {
+            size_t index = unit_start_idx + unit_idx;
+            auto nh = index / units_w;
+            auto nw = index % units_w;
+            size_t oh_start = nh * OUTPUT_BLOCK_SIZE;
+            size_t ow_start = nw * OUTPUT_BLOCK_SIZE;
+            GI_DISPATCH_CONV_WINOGRAD_BIAS(
+                    megdnn_fallback_winograd_fp32_F43_4x4, cb, float, float, bmode,
+                    nonline_mode, output_transform_buf, bias, output, transform_mid_buf,
+                    oh_start, ow_start, OH, OW, oc_start, oc_end, oc_index, unit_idx,
+                    nr_units_in_tile, src_dtype, dst_dtype);
+        }
+    }
+#undef cb
+}
+
+}  // namespace winograd
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
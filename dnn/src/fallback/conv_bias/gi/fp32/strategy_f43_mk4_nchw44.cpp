@@ -0,0 +1,342 @@
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+#include "src/common/winograd/winograd_helper.h"
+#include "src/fallback/conv_bias/gi/fp32/helper.h"
+#include "src/fallback/conv_bias/gi/fp32/strategy.h"
+#include "src/fallback/conv_bias/gi/utils.h"
+#include "src/fallback/conv_bias/winograd/winograd.h"
+#include "src/fallback/elemwise_helper/op_unary.h"
+
+#include "midout.h"
+MIDOUT_DECL(megdnn_fallback_winograd_fp32_F43_mk4)
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+constexpr size_t alpha = 4 + 3 - 1;
+constexpr size_t pack_size = 4;
+
+struct InputTransformF43_NCHW44 {
+    template <bool inner>
+    static void prepare(
+            const float* input, float* patchT, int ih_start, int iw_start, size_t IH,
+            size_t IW, size_t ic) {
+        size_t IW4 = IW * pack_size;
+        size_t icb = ic / pack_size;
+        const float* input_ptr = input + icb * IH * IW4;
+        if (inner) {
+            input_ptr += ih_start * IW4 + iw_start * pack_size;
+            for (size_t ih = 0; ih < alpha; ih++) {
+#define cb(i) auto v##i = GiLoadFloat32(input_ptr + pack_size * i);
+                UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+
+#define cb(i) GiStoreFloat32(patchT + ih * pack_size * alpha + i * pack_size, v##i);
+                UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+                input_ptr += IW4;
+            }
+        } else {
+            memset(patchT, 0, sizeof(float) * pack_size * alpha * alpha);
+            int ih0_act = std::max<int>(ih_start, 0),
+                ih1_act = std::min<int>(ih_start + alpha, IH),
+                iw0_act = std::max<int>(iw_start, 0),
+                iw1_act = std::min<int>(iw_start + alpha, IW);
+            // partial copy
+            for (int ih = ih0_act; ih < ih1_act; ++ih) {
+                for (int iw = iw0_act; iw < iw1_act; ++iw) {
+                    size_t iho = ih - ih_start, iwo = iw - iw_start;
+                    auto src = GiLoadFloat32(input_ptr + ih * IW4 + iw * pack_size);
+                    GiStoreFloat32(
+                            patchT + iho * pack_size * alpha + iwo * pack_size, src);
+                }
+            }
+        }
+    }
+
+    static void transform(
+            const float* patchT, float* input_transform_buf, size_t unit_idx,
+            size_t nr_units_in_tile, size_t ic, size_t IC) {
+        // BT * d * B
+        size_t ICB = IC / pack_size;
+        size_t icb = ic / pack_size;
+
+#define cb(m, n)                                       \
+    Vector<float, 4> d##m##n = Vector<float, 4>::load( \
+            patchT + m * alpha * pack_size + n * pack_size);
+        UNROLL_CALL_NOWRAPPER_D2(6, 6, cb);
+#undef cb
+
+        //! BT
+        //!  4  0 -5  0  1  0
+        //!  0 -4 -4  1  1  0
+        //!  0  4 -4 -1  1  0
+        //!  0 -2 -1  2  1  0
+        //!  0  2 -1 -2  1  0
+        //!  0  4  0 -5  0  1
+        Vector<float, 4> a, b, c, e;
+#define cb(m)                                       \
+    a = d4##m - d2##m * 4.f;                        \
+    b = d3##m - d1##m * 4.f;                        \
+    c = d4##m - d2##m;                              \
+    e = (d3##m - d1##m) * 2.f;                      \
+    auto t0##m = d0##m * 4.f - d2##m * 5.f + d4##m; \
+    auto t1##m = a + b;                             \
+    auto t2##m = a - b;                             \
+    auto t3##m = c + e;                             \
+    auto t4##m = c - e;                             \
+    auto t5##m = d1##m * 4.f - d3##m * 5.f + d5##m;
+        UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+
+#define cb(m)                                          \
+    a = t##m##4 - t##m##2 * 4.f;                       \
+    b = t##m##3 - t##m##1 * 4.f;                       \
+    c = t##m##4 - t##m##2;                             \
+    e = (t##m##3 - t##m##1) * 2.f;                     \
+    d##m##0 = t##m##0 * 4.f - t##m##2 * 5.f + t##m##4; \
+    d##m##1 = a + b;                                   \
+    d##m##2 = a - b;                                   \
+    d##m##3 = c + e;                                   \
+    d##m##4 = c - e;                                   \
+    d##m##5 = t##m##1 * 4.f - t##m##3 * 5.f + t##m##5;
+        UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+
+#define cb(m, n)                                                   \
+    d##m##n.save(                                                  \
+            input_transform_buf +                                  \
+            (m * alpha + n) * ICB * nr_units_in_tile * pack_size + \
+            icb * nr_units_in_tile * pack_size + unit_idx * pack_size);
+        UNROLL_CALL_NOWRAPPER_D2(6, 6, cb);
+#undef cb
+    }
+};
+
+template <BiasMode bmode, typename Op>
+struct OutputTransformF43_NCHW44 {
+    static void transform(
+            const float* output_transform_buf, const float* bias, float* output,
+            size_t oh_start, size_t ow_start, size_t OH, size_t OW, size_t oc_start,
+            size_t oc_end, size_t oc_index, size_t unit_idx, size_t nr_units_in_tile,
+            const DType& src_dtype, const DType& dst_dtype) {
+        Op op(src_dtype, dst_dtype);
+        //! AT * m * A
+
+        size_t oc = oc_start + oc_index;
+        size_t OCB = (oc_end - oc_start) / pack_size;
+        size_t ocb = oc_index / pack_size;
+
+#define cb(m, n)                                                   \
+    auto v##m##n = Vector<float, 4>::load(                         \
+            output_transform_buf +                                 \
+            (m * alpha + n) * OCB * nr_units_in_tile * pack_size + \
+            ocb * nr_units_in_tile * pack_size + unit_idx * pack_size);
+        UNROLL_CALL_NOWRAPPER_D2(6, 6, cb);
+#undef cb
+
+        //! AT
+        //!  1  1  1  1  1  0
+        //!  0  1 -1  2 -2  0
+        //!  0  1  1  4  4  0
+        //!  0  1 -1  8 -8  1
+        Vector<float, 4> v1addv2, v1subv2, v3addv4, v3subv4;
+#define cb(m)                               \
+    v1addv2 = v1##m + v2##m;                \
+    v1subv2 = v1##m - v2##m;                \
+    v3addv4 = v3##m + v4##m;                \
+    v3subv4 = v3##m - v4##m;                \
+    auto t0##m = v0##m + v1addv2 + v3addv4; \
+    auto t1##m = v1subv2 + v3subv4 * 2.f;   \
+    auto t2##m = v1addv2 + v3addv4 * 4.f;   \
+    auto t3##m = v1subv2 + v3subv4 * 8.f + v5##m;
+        UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+
+#define cb(m)                              \
+    v1addv2 = t##m##1 + t##m##2;           \
+    v1subv2 = t##m##1 - t##m##2;           \
+    v3addv4 = t##m##3 + t##m##4;           \
+    v3subv4 = t##m##3 - t##m##4;           \
+    v##m##0 = t##m##0 + v1addv2 + v3addv4; \
+    v##m##1 = v1subv2 + v3subv4 * 2.f;     \
+    v##m##2 = v1addv2 + v3addv4 * 4.f;     \
+    v##m##3 = v1subv2 + v3subv4 * 8.f + t##m##5;
+        UNROLL_CALL_NOWRAPPER(4, cb);
+#undef cb
+
+        if (bmode == BiasMode::BROADCAST_CHANNEL_BIAS) {
+            Vector<float, 4> vbias = Vector<float, 4>::load(bias + oc);
+#define cb(m, n) v##m##n += vbias;
+            UNROLL_CALL_RAW_D2(4, 4, cb);
+#undef cb
+        }
+        if (bmode != BiasMode::BIAS) {
+#define cb(m, n) v##m##n = op(CONCAT(v##m, n).value);
+            UNROLL_CALL_RAW_D2(4, 4, cb);
+#undef cb
+        }
+#define out_save(oho, owo)                                                           \
+    do {                                                                             \
+        size_t oh = oh_start + oho;                                                  \
+        size_t ow = ow_start + owo;                                                  \
+        if (oh < OH && ow < OW) {                                                    \
+            if (bmode == BiasMode::BIAS) {                                           \
+                v##oho##owo += Vector<float, 4>::load(                               \
+                        bias + oc * OH * OW + oh * OW * pack_size + ow * pack_size); \
+                v##oho##owo = op(v##oho##owo.value);                                 \
+            }                                                                        \
+            v##oho##owo.save(                                                        \
+                    output + oc * OH * OW + oh * OW * pack_size + ow * pack_size);   \
+        }                                                                            \
+    } while (0);
+        UNROLL_CALL_RAW_D2(4, 4, out_save);
+#undef out_save
+    }
+};
+}  // namespace
+
+namespace megdnn {
+namespace fallback {
+namespace winograd {
+
+MEGDNN_REG_WINOGRAD_STRATEGY_IMPL(winograd_F43_mk4_f_nchw44)
+
+void winograd_F43_mk4_f_nchw44::filter(
+        const float* filter, float* filter_transform_buf, float* transform_mid_buf,
+        size_t OC, size_t IC, size_t oc_start, size_t oc_end) {
+    constexpr size_t pack_size = 4;
+    // Gg * GT
+    // G
+    //  1/4      0     0
+    // -1/6   -1/6  -1/6
+    // -1/6    1/6  -1/6
+    //  1/24  1/12   1/6
+    //  1/24 -1/12   1/6
+    //  0        0     1
+    MEGDNN_MARK_USED_VAR(transform_mid_buf);
+    megdnn_assert(
+            (oc_end - oc_start) % pack_size == 0 && oc_start % pack_size == 0 &&
+                    oc_end % pack_size == 0 && IC % pack_size == 0 &&
+                    OC % pack_size == 0,
+            "NCHW44 Winograd filter transform requires both OC and IC "
+            "are times of 4");
+
+    size_t ICB = IC / pack_size;
+
+    for (size_t ocb = oc_start / pack_size; ocb < oc_end / pack_size; ocb++) {
+        for (size_t icb = 0; icb < ICB; icb++) {
+            for (size_t ic_inner = 0; ic_inner < pack_size; ic_inner++) {
+                const float* fptr = filter +
+                                    (ocb * ICB + icb) * KERNEL_SIZE * KERNEL_SIZE *
+                                            pack_size * pack_size +
+                                    ic_inner * pack_size;
+
+#define cb(m, n)                                       \
+    Vector<float, 4> g##m##n = Vector<float, 4>::load( \
+            fptr + (m * KERNEL_SIZE + n) * pack_size * pack_size);
+                UNROLL_CALL_NOWRAPPER_D2(3, 3, cb)
+#undef cb
+
+#define FILTER_TRANSFORM(n, wd, g)                         \
+    auto wd##n##0 = g##0##n * 0.25f;                       \
+    tmp0 = (g##0##n + g##2##n) * -0.16666667f;             \
+    tmp1 = g##1##n * -0.16666667f;                         \
+    auto wd##n##1 = tmp0 + tmp1;                           \
+    auto wd##n##2 = tmp0 - tmp1;                           \
+    tmp0 = g##0##n * 0.041666668f + g##2##n * 0.16666667f; \
+    tmp1 = g##1##n * 0.083333336f;                         \
+    auto wd##n##3 = tmp0 + tmp1;                           \
+    auto wd##n##4 = tmp0 - tmp1;                           \
+    auto wd##n##5 = g##2##n;
+                Vector<float, 4> tmp0, tmp1;
+                UNROLL_CALL_RAW(3, FILTER_TRANSFORM, wd, g);
+                UNROLL_CALL_RAW(6, FILTER_TRANSFORM, ret, wd);
+#undef FILTER_TRANSFORM
+#define cb_save(m, n)                                                                 \
+    ret##m##n.save(                                                                   \
+            filter_transform_buf + (m * alpha + n) * OC * IC + ocb * IC * pack_size + \
+            icb * pack_size * pack_size + ic_inner * pack_size);
+                UNROLL_CALL_NOWRAPPER_D2(6, 6, cb_save)
+#undef cb_save
+            }
+        }
+    }
+}
+
+void winograd_F43_mk4_f_nchw44::input(
+        const float* input, float* input_transform_buf, float* transform_mid_buf,
+        size_t IH, size_t IW, size_t IC, size_t PH, size_t PW, size_t unit_start_idx,
+        size_t nr_units_in_tile) {
+    constexpr size_t pack_size = 4;
+    megdnn_assert(IC % pack_size == 0);
+    constexpr int alpha = 4 + 3 - 1;
+
+    // OW = IW + 2 * PW - KERNEL_SIZE + 1
+    auto units_w = div_ceil<size_t>(IW + 2 * PW - KERNEL_SIZE + 1, OUTPUT_BLOCK_SIZE);
+    float* patchT = transform_mid_buf;
+
+    for (size_t ic = 0; ic < IC; ic += pack_size) {
+        rep(unit_idx, nr_units_in_tile) {
+            size_t index = unit_start_idx + unit_idx;
+            size_t nh = index / units_w;
+            size_t nw = index % units_w;
+            int ih_start = nh * OUTPUT_BLOCK_SIZE - PH;
+            int iw_start = nw * OUTPUT_BLOCK_SIZE - PW;
+            if (ih_start >= 0 && ih_start + alpha <= static_cast<int>(IH) &&
+                iw_start >= 0 && iw_start + alpha <= static_cast<int>(IW)) {
+                InputTransformF43_NCHW44::prepare<true>(
+                        input, patchT, ih_start, iw_start, IH, IW, ic);
+            } else {
+                InputTransformF43_NCHW44::prepare<false>(
+                        input, patchT, ih_start, iw_start, IH, IW, ic);
+            }
+            InputTransformF43_NCHW44::transform(
+                    patchT, input_transform_buf, unit_idx, nr_units_in_tile, ic, IC);
+        }
+    }
+}
+
+void winograd_F43_mk4_f_nchw44::output(
+        const float* output_transform_buf, const float* bias, float* output,
+        float* transform_mid_buf, BiasMode bmode, NonlineMode nonline_mode, size_t OH,
+        size_t OW, size_t oc_start, size_t oc_end, size_t unit_start_idx,
+        size_t nr_units_in_tile) {
+    MEGDNN_MARK_USED_VAR(transform_mid_buf);
+#define cb(_bmode, _nonline_op, ...)                                                \
+    for (size_t oc = oc_start; oc < oc_end; oc += pack_size) {                      \
+        size_t oc_index = oc - oc_start;                                            \
+        rep(unit_idx, nr_units_in_tile) {                                           \
+            size_t index = unit_start_idx + unit_idx;                               \
+            auto nh = index / units_w;                                              \
+            auto nw = index % units_w;                                              \
+            size_t oh_start = nh * OUTPUT_BLOCK_SIZE;                               \
+            size_t ow_start = nw * OUTPUT_BLOCK_SIZE;                               \
+            OutputTransformF43_NCHW44<_bmode MEGDNN_COMMA _nonline_op>::transform(  \
+                    output_transform_buf, bias, output, oh_start, ow_start, OH, OW, \
+                    oc_start, oc_end, oc_index, unit_idx, nr_units_in_tile,         \
+                    src_dtype, dst_dtype);                                          \
+        }                                                                           \
+    }
+
+    auto units_w = div_ceil<size_t>(OW, OUTPUT_BLOCK_SIZE);
+    constexpr size_t pack_size = 4;
+
+    size_t OC = oc_end - oc_start;
+    megdnn_assert(
+            OC % pack_size == 0 && oc_start % pack_size == 0 && oc_end % pack_size == 0,
+            "NCHW44 Winograd filter transform requires OC is times of 4");
+
+    GI_DISPATCH_CONV_WINOGRAD_BIAS(
+            megdnn_fallback_winograd_fp32_F43_mk4, cb, float, float, bmode,
+            nonline_mode);
+#undef cb
+}
+
+}  // namespace winograd
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
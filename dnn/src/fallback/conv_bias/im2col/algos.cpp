@@ -355,6 +355,7 @@ bool ConvBiasImpl::AlgoIm2col::usable(
              param.src_type.enumv() != DTypeEnum::Quantized8Asymm &&
 #if !MEGDNN_DISABLE_FLOAT16
              param.src_type.enumv() != DTypeEnum::Float16 &&
+             param.src_type.enumv() != DTypeEnum::BFloat16 &&
 #endif
              param.src_type.enumv() != DTypeEnum::Float32)) {
             return false;
@@ -386,6 +387,8 @@ bool ConvBiasImpl::AlgoIm2col::usable(
                 return false;
             }
         }
+        //! bfloat16 is always computed in float32
+        bool is_bf16 = param.src_type.enumv() == DTypeEnum::BFloat16;
         size_t oc_tile_size = 0, ohw_tile_size = 0;
         choice_ohw_oc_block(
                 param, oc_tile_size, ohw_tile_size, matmul_desc.innerblocksize.m,
@@ -400,7 +403,9 @@ bool ConvBiasImpl::AlgoIm2col::usable(
                   param.filter_meta.stride[0] == 1)) &&
                (param.filter_meta.dilation[0] == param.filter_meta.dilation[1] &&
                 param.filter_meta.dilation[0] == 1) &&
-               param.compute_mode == param::ConvBias::ComputeMode::DEFAULT;
+               (param.compute_mode == param::ConvBias::ComputeMode::DEFAULT ||
+                (is_bf16 &&
+                 param.compute_mode == param::ConvBias::ComputeMode::FLOAT32));
     }
     MIDOUT_END();
     return false;
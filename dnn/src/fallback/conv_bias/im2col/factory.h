@@ -26,7 +26,10 @@ enum class StrategyType : uint32_t {
     QUINT8x8x32x8 = 6,
 #endif
     QINT8x8x32 = 7,
-    QINT8x8x32x8 = 8
+    QINT8x8x32x8 = 8,
+#if !MEGDNN_DISABLE_FLOAT16
+    BFLOAT16_BFLOAT16 = 9,
+#endif
 };
 
 struct StrategyHashParam {
@@ -136,6 +139,7 @@ public:
 #endif
 #if !MEGDNN_DISABLE_FLOAT16
         cb1(dt_float16, dt_float16, StrategyType::FLOAT16_FLOAT16);
+        cb1(dt_bfloat16, dt_bfloat16, StrategyType::BFLOAT16_BFLOAT16);
 #endif
         cb2(dt_int8, dt_int32, dt_int32, dt_int8, dt_int32, dt_int32,
             StrategyType::INT8x8x32);
@@ -259,6 +263,10 @@ public:
                 cb1(NCHW, DEFAULT, dt_float16, dt_float16, PostprocessMode::NO_PROCESS,
                     "DefaultStrategyType::FLOAT16_FLOAT16"_hash);
                 break;
+            case StrategyType::BFLOAT16_BFLOAT16:
+                cb1(NCHW, DEFAULT, dt_bfloat16, dt_bfloat16, PostprocessMode::FLOAT,
+                    "DefaultStrategyType::BFLOAT16_BFLOAT16"_hash);
+                break;
 #endif
             case StrategyType::INT8x8x32:
                 if (format == param::ConvBias::Format::NCHW) {
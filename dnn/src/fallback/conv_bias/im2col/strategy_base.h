@@ -8,6 +8,8 @@
 #else
 #include "src/common/postprocess_helper.h"
 #endif
+#include "src/common/conv_bias.h"
+#include "src/common/opr_delegate.h"
 using namespace megdnn;
 #if MEGDNN_X86
 using namespace x86;
@@ -225,6 +227,39 @@ void copy_bias(
     }
 }
 
+//! the arch PostProcess works on the lanes of the op dtype, so bfloat16 goes
+//! through the elemwise of the inplace cpu handle, which computes in float32
+template <
+        typename op_ctype, typename op_dtype, megdnn::PostprocessMode postprocess_mode>
+struct StrategyPostProcess : PostProcess<op_ctype, op_dtype, postprocess_mode> {};
+
+template <>
+struct StrategyPostProcess<dt_bfloat16, dt_bfloat16, megdnn::PostprocessMode::FLOAT> {
+    static void run(
+            void* conv_dst_ptr, const void* bias_ptr, void* dst_ptr,
+            megdnn::ConvBiasForward::BiasMode bias_mode,
+            megdnn::param::ConvBias::NonlineMode nonlineMode, DType bias_type,
+            DType dst_type, size_t N, size_t OC, size_t OH, size_t OW,
+            size_t pack_oc_size = 1) {
+        megdnn_assert(pack_oc_size == 1);
+        TensorLayout dst_layout({N, OC, OH, OW}, dst_type);
+        TensorLayout bias_layout;
+        if (bias_mode == megdnn::BiasMode::BROADCAST_CHANNEL_BIAS) {
+            bias_layout = TensorLayout({1, OC, 1, 1}, bias_type);
+        } else if (bias_mode == megdnn::BiasMode::BIAS) {
+            bias_layout = TensorLayout({N, OC, OH, OW}, bias_type);
+        } else {
+            bias_layout.dtype = bias_type;
+        }
+        TensorND conv_dst{conv_dst_ptr, dst_layout}, dst{dst_ptr, dst_layout},
+                bias{const_cast<void*>(bias_ptr), bias_layout};
+        param::ConvBias param;
+        param.nonlineMode = nonlineMode;
+        handle_bias_and_nonlinear(
+                inplace_cpu_handle().get(), param, &conv_dst, &dst, &bias);
+    }
+};
+
 template <
         typename bias_ctype, typename dst_ctype, typename op_ctype, typename op_dtype,
         megdnn::PostprocessMode postprocess_mode>
@@ -246,7 +281,7 @@ void do_postprocess(
                     : static_cast<void*>(
                               const_cast<bias_ctype*>(bias_ptr + sparam.oc_cur_index)));
     size_t pack_oc_size = sparam.pack_oc_size;
-    PostProcess<op_ctype, op_dtype, postprocess_mode>::run(
+    StrategyPostProcess<op_ctype, op_dtype, postprocess_mode>::run(
             matmul_dst, bias_preprocess_ptr, matmul_dst, param.bias_mode,
             param.nonlineMode, param.bias_type, param.dst_type, 1_z,
             sparam.output_block_oc_size / pack_oc_size, 1_z, sparam.output_block_size,
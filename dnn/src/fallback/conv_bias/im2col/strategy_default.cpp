@@ -188,6 +188,9 @@ INSTANTIAL_CLASS(
 INSTANTIAL_CLASS(
         dt_float16, dt_float16, dt_float16, dt_float16, dt_float16,
         megdnn::PostprocessMode::NO_PROCESS)
+INSTANTIAL_CLASS(
+        dt_bfloat16, dt_bfloat16, dt_bfloat16, dt_bfloat16, dt_bfloat16,
+        megdnn::PostprocessMode::FLOAT)
 #endif
 
 #if MEGDNN_AARCH64 || MEGDNN_ARMV7
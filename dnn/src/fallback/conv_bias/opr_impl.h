@@ -229,6 +229,8 @@ public:
             GI_COMMON_DIRECT_NCHW44_FP32,
             GI_COMMON_DIRECT_NCHW_NCHW44_FP32,
             GI_COMMON_CHWNWISE_NCHW44_F32,
+            GI_COMMON_WINOGRAD_F43_4X4_FP32,
+            GI_COMMON_WINOGRAD_F43_4X4_NCHW44_F32,
 
 #if MEGDNN_X86
             X86_DIRECT = 1 << 8,
@@ -379,10 +381,12 @@ private:
     class AlgoFP32WinogradF23_4x4;
     class AlgoFP32WinogradF63;
     class AlgoFP32WinogradF63_4x4;
+    class AlgoFP32WinogradF43_4x4;
     class AlgoFP32WinogradF54;
     class AlgoFP32WinogradF45;
     class AlgoFP32WinogradF23_4x4_NCHW44;
     class AlgoFP32WinogradF63_4x4_NCHW44;
+    class AlgoFP32WinogradF43_4x4_NCHW44;
     class AlgoFP32WinogradF73_4x4_NCHW44;
 
     class AlgoF32Direct;
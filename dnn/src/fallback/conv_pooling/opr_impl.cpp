@@ -0,0 +1,311 @@
+#include "src/fallback/conv_pooling/opr_impl.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "src/common/utils.h"
+#include "src/fallback/general_intrinsic/gi_float.h"
+#include "src/naive/handle.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+using Param = param::ConvPooling;
+
+constexpr size_t LANES = GI_SIMD_LEN_BYTE / sizeof(float);
+//! output channels of the conv sharing each load of the input
+constexpr size_t OC_BLOCK = 4;
+//! bytes of the tile of the conv output which should stay in L2 cache
+constexpr size_t CONV_TILE_BYTES = 64 * 1024;
+//! alignment of the buffers of the threads in the workspace
+constexpr size_t ALIGN = 64;
+
+struct Shape {
+    size_t N, IC, IH, IW, OC, FH, FW, OH, OW, PH, PW;
+};
+
+Shape make_shape(
+        const TensorLayout& src, const TensorLayout& filter, const TensorLayout& dst,
+        const Param& p) {
+    return {src[0],
+            src[1],
+            src[2],
+            src[3],
+            filter[0],
+            filter[2],
+            filter[3],
+            infer_conv_shape(src[2], filter[2], p.conv_stride_h, p.conv_pad_h),
+            infer_conv_shape(src[3], filter[3], p.conv_stride_w, p.conv_pad_w),
+            dst[2],
+            dst[3]};
+}
+
+/*!
+ * \brief pooled rows in a tile
+ *
+ * The conv rows of a tile of OC_BLOCK channels are small enough to stay in
+ * cache, and each thread gets a tile even if there are few samples and output
+ * channels.
+ */
+size_t tile_rows(const Shape& s, const Param& p, size_t nr_threads) {
+    size_t conv_rows =
+            std::max<size_t>(1, CONV_TILE_BYTES / (OC_BLOCK * s.OW * sizeof(float)));
+    size_t rows = conv_rows >= p.pool_shape_h
+                        ? (conv_rows - p.pool_shape_h) / p.pool_stride_h + 1
+                        : 1;
+    size_t nr_tasks = s.N * div_ceil(s.OC, OC_BLOCK);
+    return std::min(rows, div_ceil(s.PH, div_ceil(nr_threads, nr_tasks)));
+}
+
+//! the conv rows of OC_BLOCK channels needed by \p rows pooled rows
+size_t thread_buf_size(const Shape& s, const Param& p, size_t rows) {
+    size_t conv_rows = (rows - 1) * p.pool_stride_h + p.pool_shape_h;
+    return round_up<size_t>(OC_BLOCK * conv_rows * s.OW * sizeof(float), ALIGN);
+}
+
+//! [begin, end) of the outputs whose input of the kernel tap \p f is in
+//! [0, isize)
+void valid_range(
+        size_t f, size_t pad, size_t stride, size_t isize, size_t osize,
+        size_t& begin, size_t& end) {
+    begin = pad > f ? div_ceil(pad - f, stride) : 0;
+    end = isize + pad > f ? std::min(osize, div_ceil(isize + pad - f, stride)) : 0;
+    begin = std::min(begin, end);
+}
+
+//! [begin, end) of the inputs in [0, isize) of the pooling window of output
+//! \p o
+void window_range(
+        size_t o, size_t stride, size_t pad, size_t window, size_t isize,
+        size_t& begin, size_t& end) {
+    size_t lo = o * stride, hi = lo + window;
+    end = hi > pad ? std::min(isize, hi - pad) : 0;
+    begin = std::min(lo > pad ? lo - pad : 0, end);
+}
+
+/*!
+ * \brief out[r * out_stride + i] += in[i * stride] * k[r] for r in
+ *      [0, OC_BLOCK) and i in [0, size)
+ *
+ * Each load of the input is shared by the OC_BLOCK output channels.
+ */
+void axpy_block(
+        float* out, size_t out_stride, const float* in, const float* k, size_t size,
+        size_t stride) {
+    size_t i = 0;
+    if (stride == 1) {
+        GI_FLOAT32_t vk[OC_BLOCK];
+        for (size_t r = 0; r < OC_BLOCK; ++r) {
+            vk[r] = GiBroadcastFloat32(k[r]);
+        }
+        for (; i + LANES <= size; i += LANES) {
+            GI_FLOAT32_t x = GiLoadFloat32(in + i);
+            for (size_t r = 0; r < OC_BLOCK; ++r) {
+                float* o = out + r * out_stride + i;
+                GiStoreFloat32(o, GiMlaqFloat32(GiLoadFloat32(o), x, vk[r]));
+            }
+        }
+    }
+    for (; i < size; ++i) {
+        float x = in[i * stride];
+        for (size_t r = 0; r < OC_BLOCK; ++r) {
+            out[r * out_stride + i] += x * k[r];
+        }
+    }
+}
+
+/*!
+ * \brief the conv rows [oh0, oh1) of \p ocs <= OC_BLOCK output channels of a
+ *      sample, laid out as [OC_BLOCK][oh1 - oh0][OW] in \p buf
+ *
+ * Each tap of the kernel is added to whole output rows at once, over the
+ * outputs whose input is not padding, so there is no bound check in the inner
+ * loop. The channels past \p ocs get zero weights.
+ */
+void conv_tile(
+        const float* src, const float* filter, const float* bias, float* buf,
+        size_t ocs, const Shape& s, const Param& p, size_t oh0, size_t oh1) {
+    size_t plane = (oh1 - oh0) * s.OW, fsize = s.FH * s.FW;
+    bool flip = p.convMode == Param::ConvMode::CONVOLUTION;
+    for (size_t r = 0; r < OC_BLOCK; ++r) {
+        std::fill(buf + r * plane, buf + (r + 1) * plane, r < ocs ? bias[r] : 0.f);
+    }
+    for (size_t ic = 0; ic < s.IC; ++ic) {
+        const float* sptr = src + ic * s.IH * s.IW;
+        for (size_t fh = 0; fh < s.FH; ++fh) {
+            for (size_t fw = 0; fw < s.FW; ++fw) {
+                size_t begin, end;
+                valid_range(fw, p.conv_pad_w, p.conv_stride_w, s.IW, s.OW, begin, end);
+                if (begin == end) {
+                    continue;
+                }
+                size_t tap = flip ? fsize - 1 - (fh * s.FW + fw) : fh * s.FW + fw;
+                float k[OC_BLOCK];
+                for (size_t r = 0; r < OC_BLOCK; ++r) {
+                    k[r] = r < ocs ? filter[(r * s.IC + ic) * fsize + tap] : 0.f;
+                }
+                for (size_t oh = oh0; oh < oh1; ++oh) {
+                    size_t ih = oh * p.conv_stride_h + fh;
+                    if (ih < p.conv_pad_h || ih - p.conv_pad_h >= s.IH) {
+                        continue;
+                    }
+                    const float* in = sptr + (ih - p.conv_pad_h) * s.IW +
+                                      begin * p.conv_stride_w + fw - p.conv_pad_w;
+                    axpy_block(
+                            buf + (oh - oh0) * s.OW + begin, plane, in, k,
+                            end - begin, p.conv_stride_w);
+                }
+            }
+        }
+    }
+}
+
+void apply_nonline(float* ptr, size_t size, Param::NonlineMode mode) {
+    size_t i = 0;
+    switch (mode) {
+        case Param::NonlineMode::IDENTITY:
+            return;
+        case Param::NonlineMode::RELU: {
+            GI_FLOAT32_t zero = GiZeroFloat32();
+            for (; i + LANES <= size; i += LANES) {
+                GiStoreFloat32(ptr + i, GiMaximumFloat32(GiLoadFloat32(ptr + i), zero));
+            }
+            for (; i < size; ++i) {
+                ptr[i] = std::max(ptr[i], 0.f);
+            }
+            break;
+        }
+        case Param::NonlineMode::SIGMOID:
+            for (; i < size; ++i) {
+                ptr[i] = 1.f / (1.f + std::exp(-ptr[i]));
+            }
+            break;
+        default:
+            megdnn_throw("unsupported nonline mode of ConvPooling");
+    }
+}
+
+/*!
+ * \brief pool the rows [ph0, ph1) of a channel from its conv rows [oh0, ...)
+ *      in \p conv
+ *
+ * MAX ignores the padding while AVERAGE counts it, as Pooling does.
+ */
+void pool_tile(
+        const float* conv, float* dst, const Shape& s, const Param& p, size_t oh0,
+        size_t ph0, size_t ph1) {
+    bool is_max = p.poolMode == Param::PoolMode::MAX;
+    float scale = 1.f / (p.pool_shape_h * p.pool_shape_w);
+    for (size_t ph = ph0; ph < ph1; ++ph) {
+        size_t h0, h1;
+        window_range(ph, p.pool_stride_h, p.pool_pad_h, p.pool_shape_h, s.OH, h0, h1);
+        float* out = dst + ph * s.PW;
+        for (size_t pw = 0; pw < s.PW; ++pw) {
+            size_t w0, w1;
+            window_range(
+                    pw, p.pool_stride_w, p.pool_pad_w, p.pool_shape_w, s.OW, w0, w1);
+            float acc = is_max ? -std::numeric_limits<float>::infinity() : 0.f;
+            for (size_t h = h0; h < h1; ++h) {
+                const float* row = conv + (h - oh0) * s.OW;
+                for (size_t w = w0; w < w1; ++w) {
+                    acc = is_max ? std::max(acc, row[w]) : acc + row[w];
+                }
+            }
+            out[pw] = is_max ? acc : acc * scale;
+        }
+    }
+}
+
+/*!
+ * \brief the pooled rows [ph0, ph1) of \p ocs output channels of a sample
+ *
+ * Only the conv rows under the pooling windows of the tile are computed, so
+ * the rows shared with the neighbouring tiles are computed twice when the
+ * windows overlap.
+ */
+void tile_float(
+        const float* src, const float* filter, const float* bias, float* dst,
+        float* buf, size_t ocs, const Shape& s, const Param& p, size_t ph0,
+        size_t ph1) {
+    size_t oh0, oh1, unused;
+    window_range(
+            ph0, p.pool_stride_h, p.pool_pad_h, p.pool_shape_h, s.OH, oh0, unused);
+    window_range(
+            ph1 - 1, p.pool_stride_h, p.pool_pad_h, p.pool_shape_h, s.OH, unused, oh1);
+    oh1 = std::max(oh0, oh1);
+    conv_tile(src, filter, bias, buf, ocs, s, p, oh0, oh1);
+    size_t plane = (oh1 - oh0) * s.OW;
+    for (size_t r = 0; r < ocs; ++r) {
+        apply_nonline(buf + r * plane, plane, p.nonlineMode);
+        pool_tile(buf + r * plane, dst + r * s.PH * s.PW, s, p, oh0, ph0, ph1);
+    }
+}
+
+}  // anonymous namespace
+
+size_t ConvPoolingForwardImpl::nr_threads() {
+    return static_cast<naive::HandleImpl*>(handle())
+            ->megcore_dispatcher()
+            ->nr_threads();
+}
+
+size_t ConvPoolingForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout& filter, const TensorLayout& bias,
+        const TensorLayout& dst) {
+    if (src.dtype.enumv() != DTypeEnum::Float32) {
+        return naive::ConvPoolingForwardImpl::get_workspace_in_bytes(
+                src, filter, bias, dst);
+    }
+    Shape s = make_shape(src, filter, dst, param());
+    size_t nr_threads = this->nr_threads();
+    size_t rows = tile_rows(s, param(), nr_threads);
+    return nr_threads * thread_buf_size(s, param(), rows) + ALIGN;
+}
+
+void ConvPoolingForwardImpl::exec(
+        const _megdnn_in TensorND src, const _megdnn_in TensorND filter,
+        const _megdnn_in TensorND bias, _megdnn_out TensorND dst,
+        _megdnn_out Workspace workspace) {
+    if (src.layout.dtype.enumv() != DTypeEnum::Float32) {
+        naive::ConvPoolingForwardImpl::exec(src, filter, bias, dst, workspace);
+        return;
+    }
+    check_layout(src.layout, filter.layout, bias.layout, dst.layout, workspace.size);
+    megdnn_assert(
+            src.layout.is_contiguous() && filter.layout.is_contiguous() &&
+            bias.layout.is_contiguous() && dst.layout.is_contiguous() &&
+            filter.layout.dtype == src.layout.dtype &&
+            bias.layout.dtype == src.layout.dtype);
+    megdnn_assert(
+            workspace.size >= get_workspace_in_bytes(
+                                      src.layout, filter.layout, bias.layout,
+                                      dst.layout));
+    auto p = param();
+    Shape s = make_shape(src.layout, filter.layout, dst.layout, p);
+    size_t rows = tile_rows(s, p, nr_threads()), nr_tiles = div_ceil(s.PH, rows),
+           nr_oc_blocks = div_ceil(s.OC, OC_BLOCK),
+           buf_size = thread_buf_size(s, p, rows);
+    size_t src_stride = s.IC * s.IH * s.IW, dst_stride = s.OC * s.PH * s.PW;
+    auto bufs = reinterpret_cast<dt_byte*>(
+            round_up<uintptr_t>(reinterpret_cast<uintptr_t>(workspace.raw_ptr), ALIGN));
+    auto naive_handle = static_cast<naive::HandleImpl*>(handle());
+    auto run = [=](size_t index, size_t thread_id) {
+        size_t tile = index % nr_tiles, ocb = index / nr_tiles % nr_oc_blocks,
+               n = index / nr_tiles / nr_oc_blocks;
+        size_t oc = ocb * OC_BLOCK, ph0 = tile * rows,
+               ph1 = std::min(s.PH, ph0 + rows);
+        tile_float(
+                src.ptr<float>() + n * src_stride,
+                filter.ptr<float>() + oc * s.IC * s.FH * s.FW, bias.ptr<float>() + oc,
+                dst.ptr<float>() + n * dst_stride + oc * s.PH * s.PW,
+                reinterpret_cast<float*>(bufs + thread_id * buf_size),
+                std::min(OC_BLOCK, s.OC - oc), s, p, ph0, ph1);
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+            naive_handle, s.N * nr_oc_blocks * nr_tiles, run);
+}
+
+// vim: syntax=cpp.doxygen
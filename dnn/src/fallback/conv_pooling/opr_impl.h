@@ -0,0 +1,36 @@
+#pragma once
+
+#include "src/naive/convpooling/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief a float32 dense conv followed by a pooling, fused with general
+ *      intrinsics
+ *
+ * The pooled rows of each block of output channels are split into tiles, and
+ * the conv rows needed by a tile are computed into a buffer which stays in the
+ * L2 cache and pooled immediately, so the conv output is never written to
+ * memory. Other dtypes are forwarded to the naive implementation.
+ */
+class ConvPoolingForwardImpl final : public naive::ConvPoolingForwardImpl {
+public:
+    using naive::ConvPoolingForwardImpl::ConvPoolingForwardImpl;
+    void exec(
+            const _megdnn_in TensorND src, const _megdnn_in TensorND filter,
+            const _megdnn_in TensorND bias, _megdnn_out TensorND dst,
+            _megdnn_out Workspace workspace) override;
+    //! a tile of the conv output for each thread
+    size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& filter,
+            const TensorLayout& bias, const TensorLayout& dst) override;
+
+private:
+    size_t nr_threads();
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -408,6 +408,8 @@ ConvolutionImpl::AlgoDataType ConvolutionImpl::NCBKernSizeParam::deduce_algo_dat
 #if !MEGDNN_DISABLE_FLOAT16
     } else if (src_type.enumv() == DTypeEnum::Float16) {
         return ConvolutionImpl::AlgoDataType::FLOAT16;
+    } else if (src_type.enumv() == DTypeEnum::BFloat16) {
+        return ConvolutionImpl::AlgoDataType::BFLOAT16;
 #endif
     } else if (
             src_type.enumv() == DTypeEnum::Int8 ||
@@ -0,0 +1,369 @@
+#include "src/fallback/depthwise_pointwise_conv_bias/opr_impl.h"
+
+#include <algorithm>
+
+#include "src/common/utils.h"
+#include "src/fallback/general_intrinsic/gi_float.h"
+#include "src/naive/handle.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+using Param = param::DepthwisePointwiseConvBias;
+using NonlineMode = param::ConvBias::NonlineMode;
+
+constexpr size_t LANES = GI_SIMD_LEN_BYTE / sizeof(float);
+//! output channels of the 1x1 conv sharing each load of the tile
+constexpr size_t OC_BLOCK = 4;
+//! bytes of the tile of the channel-wise output which should stay in L2 cache
+constexpr size_t MID_TILE_BYTES = 64 * 1024;
+//! alignment of the buffers of the threads in the workspace
+constexpr size_t ALIGN = 64;
+
+struct Shape {
+    size_t N, C, IH, IW, OC, OH, OW, FH, FW;
+};
+
+Shape make_shape(
+        const TensorLayout& src, const TensorLayout& dw_filter,
+        const TensorLayout& pw_filter, const TensorLayout& dst) {
+    return {src[0], src[1], src[2],       src[3],      pw_filter[0],
+            dst[2], dst[3], dw_filter[3], dw_filter[4]};
+}
+
+/*!
+ * \brief rows of the output in a tile
+ *
+ * A tile is small enough to keep the channel-wise output in cache, and to
+ * give each thread a tile even if there are fewer samples than threads.
+ */
+size_t tile_rows(const Shape& s, size_t dtype_size, size_t nr_threads) {
+    size_t rows = std::max<size_t>(1, MID_TILE_BYTES / (s.C * s.OW * dtype_size));
+    return std::min(rows, div_ceil(s.OH, div_ceil(nr_threads, s.N)));
+}
+
+//! the channel-wise output of a tile, followed by int32 accumulators of the
+//! pixels of the tile for int8
+size_t thread_buf_size(const Shape& s, size_t rows, DType dtype) {
+    size_t pixels = rows * s.OW;
+    size_t size = round_up<size_t>(s.C * pixels * dtype.size(), ALIGN);
+    if (dtype.enumv() == DTypeEnum::QuantizedS8) {
+        size += round_up<size_t>(pixels * sizeof(int32_t), ALIGN);
+    }
+    return size;
+}
+
+//! [begin, end) of the outputs whose input of the kernel tap \p f is in
+//! [0, isize)
+void valid_range(
+        size_t f, size_t pad, size_t stride, size_t isize, size_t osize,
+        size_t& begin, size_t& end) {
+    begin = pad > f ? div_ceil(pad - f, stride) : 0;
+    end = isize + pad > f ? std::min(osize, div_ceil(isize + pad - f, stride)) : 0;
+    begin = std::min(begin, end);
+}
+
+void apply_nonline(float* ptr, size_t size, NonlineMode mode) {
+    size_t i = 0;
+    switch (mode) {
+        case NonlineMode::IDENTITY:
+            return;
+        case NonlineMode::RELU: {
+            GI_FLOAT32_t zero = GiZeroFloat32();
+            for (; i + LANES <= size; i += LANES) {
+                GiStoreFloat32(ptr + i, GiMaximumFloat32(GiLoadFloat32(ptr + i), zero));
+            }
+            break;
+        }
+        case NonlineMode::H_SWISH: {
+            GI_FLOAT32_t zero = GiZeroFloat32(), three = GiBroadcastFloat32(3.f),
+                         six = GiBroadcastFloat32(6.f),
+                         inv_six = GiBroadcastFloat32(1.f / 6.f);
+            for (; i + LANES <= size; i += LANES) {
+                GI_FLOAT32_t x = GiLoadFloat32(ptr + i);
+                GI_FLOAT32_t t = GiMinimumFloat32(
+                        GiMaximumFloat32(GiAddFloat32(x, three), zero), six);
+                GiStoreFloat32(
+                        ptr + i, GiMultiplyFloat32(GiMultiplyFloat32(x, t), inv_six));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    for (; i < size; ++i) {
+        ptr[i] = naive::apply_dw_pw_nonline(mode, ptr[i]);
+    }
+}
+
+//! out[i] += in[i * stride] * k for i in [0, size)
+void axpy(float* out, const float* in, float k, size_t size, size_t stride) {
+    size_t i = 0;
+    if (stride == 1) {
+        GI_FLOAT32_t vk = GiBroadcastFloat32(k);
+        for (; i + LANES <= size; i += LANES) {
+            GiStoreFloat32(
+                    out + i,
+                    GiMlaqFloat32(GiLoadFloat32(out + i), GiLoadFloat32(in + i), vk));
+        }
+    }
+    for (; i < size; ++i) {
+        out[i] += in[i * stride] * k;
+    }
+}
+
+/*!
+ * \brief the channel-wise conv of the output rows [oh0, oh1) of a sample
+ *
+ * Each tap of the kernel is added to a whole output row at once, over the
+ * outputs whose input is not padding, so there is no bound check in the inner
+ * loop.
+ */
+void dw_float(
+        const float* src, const float* filter, const float* bias, float* mid,
+        const Shape& s, const Param& p, size_t oh0, size_t oh1) {
+    size_t rows = oh1 - oh0;
+    for (size_t c = 0; c < s.C; ++c) {
+        const float* sptr = src + c * s.IH * s.IW;
+        const float* fptr = filter + c * s.FH * s.FW;
+        for (size_t oh = oh0; oh < oh1; ++oh) {
+            float* out = mid + (c * rows + oh - oh0) * s.OW;
+            std::fill(out, out + s.OW, bias[c]);
+            for (size_t fh = 0; fh < s.FH; ++fh) {
+                size_t ih = oh * p.stride_h + fh;
+                if (ih < p.pad_h || ih - p.pad_h >= s.IH) {
+                    continue;
+                }
+                const float* in = sptr + (ih - p.pad_h) * s.IW;
+                for (size_t fw = 0; fw < s.FW; ++fw) {
+                    size_t begin, end;
+                    valid_range(fw, p.pad_w, p.stride_w, s.IW, s.OW, begin, end);
+                    axpy(out + begin, in + begin * p.stride_w + fw - p.pad_w,
+                         fptr[fh * s.FW + fw], end - begin, p.stride_w);
+                }
+            }
+            apply_nonline(out, s.OW, p.dw_nonline_mode);
+        }
+    }
+}
+
+/*!
+ * \brief dst[r * dst_stride + i] = bias[r] + dot(filter[r * C : (r + 1) * C],
+ *      mid[i : : P]) for r in [0, ROWS) and i in [0, P)
+ *
+ * Each load of 2 vectors of the tile is shared by ROWS output channels.
+ */
+template <size_t ROWS>
+void pw_float(
+        const float* mid, size_t P, const float* filter, size_t C,
+        const float* bias, float* dst, size_t dst_stride) {
+    size_t i = 0;
+    for (; i + 2 * LANES <= P; i += 2 * LANES) {
+        GI_FLOAT32_t acc[ROWS][2];
+        for (size_t r = 0; r < ROWS; ++r) {
+            acc[r][0] = acc[r][1] = GiBroadcastFloat32(bias[r]);
+        }
+        const float* m = mid + i;
+        for (size_t c = 0; c < C; ++c, m += P) {
+            GI_FLOAT32_t m0 = GiLoadFloat32(m), m1 = GiLoadFloat32(m + LANES);
+            for (size_t r = 0; r < ROWS; ++r) {
+                GI_FLOAT32_t w = GiBroadcastFloat32(filter[r * C + c]);
+                acc[r][0] = GiMlaqFloat32(acc[r][0], m0, w);
+                acc[r][1] = GiMlaqFloat32(acc[r][1], m1, w);
+            }
+        }
+        for (size_t r = 0; r < ROWS; ++r) {
+            GiStoreFloat32(dst + r * dst_stride + i, acc[r][0]);
+            GiStoreFloat32(dst + r * dst_stride + i + LANES, acc[r][1]);
+        }
+    }
+    for (; i < P; ++i) {
+        for (size_t r = 0; r < ROWS; ++r) {
+            float acc = bias[r];
+            for (size_t c = 0; c < C; ++c) {
+                acc += filter[r * C + c] * mid[c * P + i];
+            }
+            dst[r * dst_stride + i] = acc;
+        }
+    }
+}
+
+void pw_float(
+        size_t rows, const float* mid, size_t P, const float* filter, size_t C,
+        const float* bias, float* dst, size_t dst_stride) {
+    switch (rows) {
+#define cb(_rows) \
+    case _rows:   \
+        return pw_float<_rows>(mid, P, filter, C, bias, dst, dst_stride);
+        cb(1);
+        cb(2);
+        cb(3);
+        cb(4);
+#undef cb
+        default:
+            megdnn_assert_internal(0);
+    }
+}
+
+void tile_float(
+        const float* src, const float* dw_filter, const float* dw_bias,
+        const float* pw_filter, const float* pw_bias, float* dst, float* mid,
+        const Shape& s, const Param& p, size_t oh0, size_t oh1) {
+    dw_float(src, dw_filter, dw_bias, mid, s, p, oh0, oh1);
+    size_t P = (oh1 - oh0) * s.OW, dst_stride = s.OH * s.OW;
+    dst += oh0 * s.OW;
+    for (size_t oc = 0; oc < s.OC; oc += OC_BLOCK) {
+        size_t rows = std::min(OC_BLOCK, s.OC - oc);
+        pw_float(
+                rows, mid, P, pw_filter + oc * s.C, s.C, pw_bias + oc,
+                dst + oc * dst_stride, dst_stride);
+        for (size_t r = 0; r < rows; ++r) {
+            apply_nonline(dst + (oc + r) * dst_stride, P, p.pw_nonline_mode);
+        }
+    }
+}
+
+//! scales of the accumulators and of the int8 outputs of the two convs
+struct QuantParam {
+    float dw_scale, pw_scale;
+    DTypeParam<dtype::QuantizedS8> mid, dst;
+};
+
+inline int8_t requantize(
+        int32_t acc, float scale, const DTypeParam<dtype::QuantizedS8>& out,
+        NonlineMode mode) {
+    return out.quantize(naive::apply_dw_pw_nonline(mode, acc * scale)).as_int8();
+}
+
+/*!
+ * \brief the int8 version of tile_float, with int32 accumulators in \p acc
+ *
+ * The 1x1 conv adds a channel of the tile to the accumulators of all the
+ * pixels at once, which the compiler is free to vectorize.
+ */
+void tile_int8(
+        const int8_t* src, const int8_t* dw_filter, const int32_t* dw_bias,
+        const int8_t* pw_filter, const int32_t* pw_bias, int8_t* dst, int8_t* mid,
+        int32_t* acc, const Shape& s, const Param& p, const QuantParam& q,
+        size_t oh0, size_t oh1) {
+    size_t rows = oh1 - oh0;
+    for (size_t c = 0; c < s.C; ++c) {
+        const int8_t* sptr = src + c * s.IH * s.IW;
+        const int8_t* fptr = dw_filter + c * s.FH * s.FW;
+        for (size_t oh = oh0; oh < oh1; ++oh) {
+            std::fill(acc, acc + s.OW, dw_bias[c]);
+            for (size_t fh = 0; fh < s.FH; ++fh) {
+                size_t ih = oh * p.stride_h + fh;
+                if (ih < p.pad_h || ih - p.pad_h >= s.IH) {
+                    continue;
+                }
+                const int8_t* in = sptr + (ih - p.pad_h) * s.IW;
+                for (size_t fw = 0; fw < s.FW; ++fw) {
+                    size_t begin, end;
+                    valid_range(fw, p.pad_w, p.stride_w, s.IW, s.OW, begin, end);
+                    int32_t k = fptr[fh * s.FW + fw];
+                    const int8_t* iptr = in + fw - p.pad_w;
+                    for (size_t ow = begin; ow < end; ++ow) {
+                        acc[ow] += iptr[ow * p.stride_w] * k;
+                    }
+                }
+            }
+            int8_t* out = mid + (c * rows + oh - oh0) * s.OW;
+            for (size_t ow = 0; ow < s.OW; ++ow) {
+                out[ow] = requantize(acc[ow], q.dw_scale, q.mid, p.dw_nonline_mode);
+            }
+        }
+    }
+    size_t P = rows * s.OW;
+    dst += oh0 * s.OW;
+    for (size_t oc = 0; oc < s.OC; ++oc) {
+        std::fill(acc, acc + P, pw_bias[oc]);
+        for (size_t c = 0; c < s.C; ++c) {
+            int32_t k = pw_filter[oc * s.C + c];
+            const int8_t* m = mid + c * P;
+            for (size_t i = 0; i < P; ++i) {
+                acc[i] += m[i] * k;
+            }
+        }
+        int8_t* out = dst + oc * s.OH * s.OW;
+        for (size_t i = 0; i < P; ++i) {
+            out[i] = requantize(acc[i], q.pw_scale, q.dst, p.pw_nonline_mode);
+        }
+    }
+}
+
+}  // anonymous namespace
+
+size_t DepthwisePointwiseConvBiasForwardImpl::nr_threads() {
+    return static_cast<naive::HandleImpl*>(handle())
+            ->megcore_dispatcher()
+            ->nr_threads();
+}
+
+size_t DepthwisePointwiseConvBiasForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout& dw_filter, const TensorLayout&,
+        const TensorLayout& pw_filter, const TensorLayout&, const TensorLayout& dst) {
+    Shape s = make_shape(src, dw_filter, pw_filter, dst);
+    size_t nr_threads = this->nr_threads();
+    size_t rows = tile_rows(s, src.dtype.size(), nr_threads);
+    return nr_threads * thread_buf_size(s, rows, src.dtype) + ALIGN;
+}
+
+void DepthwisePointwiseConvBiasForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in dw_filter, _megdnn_tensor_in dw_bias,
+        _megdnn_tensor_in pw_filter, _megdnn_tensor_in pw_bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(
+            src.layout, dw_filter.layout, dw_bias.layout, pw_filter.layout,
+            pw_bias.layout, dst.layout, workspace.size);
+    Shape s = make_shape(src.layout, dw_filter.layout, pw_filter.layout, dst.layout);
+    DType dtype = src.layout.dtype;
+    size_t rows = tile_rows(s, dtype.size(), nr_threads()),
+           nr_tiles = div_ceil(s.OH, rows),
+           buf_size = thread_buf_size(s, rows, dtype);
+    size_t src_stride = s.C * s.IH * s.IW, dst_stride = s.OC * s.OH * s.OW;
+    auto bufs = reinterpret_cast<dt_byte*>(
+            round_up<uintptr_t>(reinterpret_cast<uintptr_t>(workspace.raw_ptr), ALIGN));
+    auto p = param();
+    auto naive_handle = static_cast<naive::HandleImpl*>(handle());
+    if (dtype.enumv() == DTypeEnum::Float32) {
+        auto run = [=](size_t index, size_t thread_id) {
+            size_t n = index / nr_tiles, oh0 = index % nr_tiles * rows,
+                   oh1 = std::min(s.OH, oh0 + rows);
+            tile_float(
+                    src.ptr<float>() + n * src_stride, dw_filter.ptr<float>(),
+                    dw_bias.ptr<float>(), pw_filter.ptr<float>(),
+                    pw_bias.ptr<float>(), dst.ptr<float>() + n * dst_stride,
+                    reinterpret_cast<float*>(bufs + thread_id * buf_size), s, p, oh0,
+                    oh1);
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(naive_handle, s.N * nr_tiles, run);
+        return;
+    }
+    QuantParam q{
+            dw_bias.layout.dtype.param<dtype::QuantizedS32>().scale,
+            pw_bias.layout.dtype.param<dtype::QuantizedS32>().scale,
+            mid_dtype(dtype, pw_filter.layout.dtype, pw_bias.layout.dtype)
+                    .param<dtype::QuantizedS8>(),
+            dst.layout.dtype.param<dtype::QuantizedS8>()};
+    size_t mid_size = round_up<size_t>(s.C * rows * s.OW, ALIGN);
+    auto run = [=](size_t index, size_t thread_id) {
+        size_t n = index / nr_tiles, oh0 = index % nr_tiles * rows,
+               oh1 = std::min(s.OH, oh0 + rows);
+        dt_byte* buf = bufs + thread_id * buf_size;
+        tile_int8(
+                static_cast<const int8_t*>(src.raw_ptr()) + n * src_stride,
+                static_cast<const int8_t*>(dw_filter.raw_ptr()),
+                static_cast<const int32_t*>(dw_bias.raw_ptr()),
+                static_cast<const int8_t*>(pw_filter.raw_ptr()),
+                static_cast<const int32_t*>(pw_bias.raw_ptr()),
+                static_cast<int8_t*>(dst.raw_ptr()) + n * dst_stride,
+                reinterpret_cast<int8_t*>(buf),
+                reinterpret_cast<int32_t*>(buf + mid_size), s, p, q, oh0, oh1);
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(naive_handle, s.N * nr_tiles, run);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "src/naive/depthwise_pointwise_conv_bias/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief a channel-wise conv followed by a 1x1 conv, fused with general
+ *      intrinsics
+ *
+ * The output rows of each sample are split into tiles whose channel-wise
+ * output fits in the L2 cache, so the 1x1 conv reads it back from the cache
+ * instead of from memory. The tiles of all the samples are shared among the
+ * threads.
+ */
+class DepthwisePointwiseConvBiasForwardImpl final
+        : public naive::DepthwisePointwiseConvBiasForwardImpl {
+public:
+    using naive::DepthwisePointwiseConvBiasForwardImpl::
+            DepthwisePointwiseConvBiasForwardImpl;
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in dw_filter,
+            _megdnn_tensor_in dw_bias, _megdnn_tensor_in pw_filter,
+            _megdnn_tensor_in pw_bias, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) override;
+    //! a tile of the output of the channel-wise conv for each thread
+    size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& dw_filter,
+            const TensorLayout& dw_bias, const TensorLayout& pw_filter,
+            const TensorLayout& pw_bias, const TensorLayout& dst) override;
+
+private:
+    size_t nr_threads();
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -5,7 +5,9 @@
 #include "src/fallback/batched_matrix_mul/opr_impl.h"
 #include "src/fallback/concat/opr_impl.h"
 #include "src/fallback/conv_bias/opr_impl.h"
+#include "src/fallback/conv_pooling/opr_impl.h"
 #include "src/fallback/convolution/opr_impl.h"
+#include "src/fallback/depthwise_pointwise_conv_bias/opr_impl.h"
 #include "src/fallback/elemwise/opr_impl.h"
 #include "src/fallback/elemwise_multi_type/opr_impl.h"
 #include "src/fallback/flip/opr_impl.h"
@@ -25,6 +27,7 @@
 #include "src/fallback/tile/opr_impl.h"
 #include "src/fallback/type_cvt/opr_impl.h"
 #include "src/fallback/warp_perspective/opr_impl.h"
+#include "src/fallback/weight_quant_matrix_mul/opr_impl.h"
 
 namespace megdnn {
 namespace fallback {
@@ -59,6 +62,9 @@ MEGDNN_SPECIALIZE_CREATE_OPERATOR(Resize)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(BatchedMatrixMulForward)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvBias)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(PowC)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(WeightQuantMatrixMulForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(DepthwisePointwiseConvBiasForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvPoolingForward)
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
@@ -118,6 +118,8 @@ public:
             X86_F32_6x16,
             X86_INT8X8X32_VNNI,
             X86_INT8X8X32_MKLDNN,
+            X86_BF16_6x16,
+            X86_BF16_AVX512_8X32,
 #elif MEGDNN_AARCH64 || MEGDNN_ARMV7
             ARM_COMMON_INT8X8X16 = 1 << 8,
             ARM_COMMON_INT8X8X32_GEMV,
@@ -0,0 +1,188 @@
+#include "src/fallback/weight_quant_matrix_mul/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/fallback/general_intrinsic/gi_float.h"
+#include "src/fallback/general_intrinsic/gi_int.h"
+#include "src/naive/handle.h"
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! int8 weights dequantized by a vector load
+constexpr size_t CHUNK = GI_SIMD_LEN_BYTE;
+constexpr size_t LANES = GI_SIMD_LEN_BYTE / sizeof(float);
+//! max rows of activations sharing the dequantized weights in registers
+constexpr size_t MAX_ROWS = 4;
+//! bytes of the tile of activations which should stay in the L2 cache
+constexpr size_t A_TILE_BYTES = 256 * 1024;
+//! alignment of the buffers of unpacked int4 weights in the workspace
+constexpr size_t ALIGN = 64;
+
+//! the two signed 4-bit values of each byte, the low bits first
+struct Int4Table {
+    int8_t val[256][2];
+    Int4Table() {
+        for (int i = 0; i < 256; ++i) {
+            val[i][0] = static_cast<int8_t>(i << 4) >> 4;
+            val[i][1] = static_cast<int8_t>(i) >> 4;
+        }
+    }
+};
+
+void unpack_int4(const int8_t* src, int8_t* dst, size_t K) {
+    static const Int4Table table;
+    for (size_t i = 0; i < K / 2; ++i) {
+        auto&& val = table.val[static_cast<uint8_t>(src[i])];
+        dst[2 * i] = val[0];
+        dst[2 * i + 1] = val[1];
+    }
+}
+
+//! dequantize CHUNK int8 weights into 4 float vectors, without the scale
+GI_FORCEINLINE void load_weights(const int8_t* w, GI_FLOAT32_t* wf) {
+    GI_INT8_t q = GiLoadInt8(w);
+    GI_INT16_t lo = GiMoveLowLongInt8(q), hi = GiMoveHighLongInt8(q);
+    wf[0] = GiCastToFloat32(GiMoveLowLongInt16(lo));
+    wf[1] = GiCastToFloat32(GiMoveHighLongInt16(lo));
+    wf[2] = GiCastToFloat32(GiMoveLowLongInt16(hi));
+    wf[3] = GiCastToFloat32(GiMoveHighLongInt16(hi));
+}
+
+/*!
+ * \brief C[m * N] = dot(A[m * K : (m + 1) * K], w * scale) for m in [0, ROWS)
+ *
+ * The products of a group are accumulated in vectors before they are scaled,
+ * so a group costs a single multiplication by its scale for each row, and the
+ * vectors are only reduced at the end of the row.
+ */
+template <size_t ROWS>
+void dot_rows(
+        const float* A, const int8_t* w, const float* scale, float* C, size_t N,
+        size_t K, size_t group) {
+    GI_FLOAT32_t total[ROWS];
+    float total_tail[ROWS];
+    for (size_t m = 0; m < ROWS; ++m) {
+        total[m] = GiZeroFloat32();
+        total_tail[m] = 0.f;
+    }
+    for (size_t g0 = 0; g0 < K; g0 += group, ++scale) {
+        GI_FLOAT32_t acc[ROWS];
+        float tail[ROWS];
+        for (size_t m = 0; m < ROWS; ++m) {
+            acc[m] = GiZeroFloat32();
+            tail[m] = 0.f;
+        }
+        size_t k = g0, end = g0 + group;
+        for (; k + CHUNK <= end; k += CHUNK) {
+            GI_FLOAT32_t wf[4];
+            load_weights(w + k, wf);
+            for (size_t m = 0; m < ROWS; ++m) {
+                const float* a = A + m * K + k;
+                for (size_t j = 0; j < 4; ++j) {
+                    acc[m] = GiMlaqFloat32(acc[m], GiLoadFloat32(a + j * LANES), wf[j]);
+                }
+            }
+        }
+        for (; k < end; ++k) {
+            for (size_t m = 0; m < ROWS; ++m) {
+                tail[m] += A[m * K + k] * w[k];
+            }
+        }
+        GI_FLOAT32_t vscale = GiBroadcastFloat32(*scale);
+        for (size_t m = 0; m < ROWS; ++m) {
+            total[m] = GiMlaqFloat32(total[m], acc[m], vscale);
+            total_tail[m] += tail[m] * *scale;
+        }
+    }
+    for (size_t m = 0; m < ROWS; ++m) {
+        C[m * N] = GiReduceAddFloat32(total[m]) + total_tail[m];
+    }
+}
+
+void dot_rows(
+        size_t rows, const float* A, const int8_t* w, const float* scale, float* C,
+        size_t N, size_t K, size_t group) {
+    switch (rows) {
+#define cb(_rows) \
+    case _rows:   \
+        return dot_rows<_rows>(A, w, scale, C, N, K, group);
+        cb(1);
+        cb(2);
+        cb(3);
+        cb(4);
+#undef cb
+        default:
+            megdnn_assert_internal(0);
+    }
+}
+
+//! size of a buffer of a row of unpacked int4 weights
+size_t unpack_buf_size(size_t K) {
+    return round_up<size_t>(K, ALIGN);
+}
+
+}  // anonymous namespace
+
+size_t WeightQuantMatrixMulForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& A, const TensorLayout&, const TensorLayout&,
+        const TensorLayout&) {
+    if (param().bits == 8) {
+        return 0;
+    }
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    return nr_threads * unpack_buf_size(A[A.ndim - 1]) + ALIGN;
+}
+
+void WeightQuantMatrixMulForwardImpl::exec(
+        _megdnn_tensor_in A, _megdnn_tensor_in W, _megdnn_tensor_in scale,
+        _megdnn_tensor_out C, _megdnn_workspace workspace) {
+    check_exec(A.layout, W.layout, scale.layout, C.layout, workspace.size);
+    size_t batch_dim = A.layout.ndim - 2;
+    size_t batch = batch_dim ? A.layout[0] : 1, M = A.layout[batch_dim],
+           K = A.layout[batch_dim + 1], N = W.layout[batch_dim];
+    size_t bits = param().bits, group = group_size(K), nr_groups = K / group,
+           row_bytes = K * bits / 8;
+    size_t nr_threads = static_cast<naive::HandleImpl*>(handle())
+                                ->megcore_dispatcher()
+                                ->nr_threads();
+    // several blocks of output channels for each thread to balance the load,
+    // each large enough to amortize the loads of the activations
+    size_t n_block = std::max<size_t>(8, div_ceil(N, nr_threads * 4));
+    size_t nr_n_blocks = div_ceil(N, n_block);
+    size_t m_tile = std::max(
+            MAX_ROWS, A_TILE_BYTES / (K * sizeof(float)) / MAX_ROWS * MAX_ROWS);
+    auto unpack_buf = reinterpret_cast<int8_t*>(
+            round_up<uintptr_t>(reinterpret_cast<uintptr_t>(workspace.raw_ptr), ALIGN));
+    auto run = [=](size_t index, size_t thread_id) {
+        size_t b = index / nr_n_blocks, n_begin = index % nr_n_blocks * n_block,
+               n_end = std::min(N, n_begin + n_block);
+        const float* a_ptr = A.ptr<float>() + b * M * K;
+        const int8_t* w_ptr = W.ptr<int8_t>() + b * N * row_bytes;
+        const float* s_ptr = scale.ptr<float>() + b * N * nr_groups;
+        float* c_ptr = C.ptr<float>() + b * M * N;
+        int8_t* buf = unpack_buf + thread_id * unpack_buf_size(K);
+        for (size_t m0 = 0; m0 < M; m0 += m_tile) {
+            size_t m_end = std::min(M, m0 + m_tile);
+            for (size_t n = n_begin; n < n_end; ++n) {
+                const int8_t* w = w_ptr + n * row_bytes;
+                if (bits == 4) {
+                    unpack_int4(w, buf, K);
+                    w = buf;
+                }
+                for (size_t m = m0; m < m_end; m += MAX_ROWS) {
+                    dot_rows(
+                            std::min(MAX_ROWS, m_end - m), a_ptr + m * K, w,
+                            s_ptr + n * nr_groups, c_ptr + m * N + n, N, K, group);
+                }
+            }
+        }
+    };
+    MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN(
+            static_cast<naive::HandleImpl*>(handle()), batch * nr_n_blocks, run);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "src/naive/weight_quant_matrix_mul/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief weight only quantized matrix mul with general intrinsics
+ *
+ * Rows of weights are dequantized in registers right before they are
+ * multiplied with up to 4 rows of activations, so the float weights are never
+ * written to memory. The rows of activations are tiled to stay in cache while
+ * the weights stream through, and the output channels are split among the
+ * threads.
+ */
+class WeightQuantMatrixMulForwardImpl final
+        : public naive::WeightQuantMatrixMulForwardImpl {
+public:
+    using naive::WeightQuantMatrixMulForwardImpl::WeightQuantMatrixMulForwardImpl;
+    void exec(
+            _megdnn_tensor_in A, _megdnn_tensor_in W, _megdnn_tensor_in scale,
+            _megdnn_tensor_out C, _megdnn_workspace workspace) override;
+    //! a buffer of a row of unpacked int4 weights for each thread
+    size_t get_workspace_in_bytes(
+            const TensorLayout& A, const TensorLayout& W, const TensorLayout& scale,
+            const TensorLayout& C) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -10,9 +10,9 @@ namespace naive {
 
 ConvPoolingForwardImpl::ConvPoolingForwardImpl(Handle* handle)
         : ConvPoolingForward(handle) {
-    convFwd = new ConvolutionForwardImpl(this->handle());
-    poolFwd = new PoolingForwardImpl(this->handle());
-    return;
+    convFwd = make_unique<ConvolutionForwardImpl>(this->handle());
+    poolFwd = make_unique<PoolingForwardImpl>(this->handle());
+    nonlineFwd = make_unique<ElemwiseForwardImpl>(this->handle());
 }
 
 void ConvPoolingForwardImpl::setParamOfSublayers() {
@@ -75,10 +75,10 @@ void ConvPoolingForwardImpl::exec(
         const _megdnn_in TensorND bias, _megdnn_out TensorND dst,
         _megdnn_out Workspace workspace) {
     Workspace empty_wsp;
-    TensorND conv_dst{workspace.raw_ptr, conv_dst_layout};
     // convFwd->check_layout(src.layout, filter.layout, workspace.layout,
     // empty_wsp.layout);
     check_layout(src.layout, filter.layout, bias.layout, dst.layout, workspace.size);
+    TensorND conv_dst{workspace.raw_ptr, conv_dst_layout};
     convFwd->exec(src, filter, conv_dst, nullptr, empty_wsp);
 
     // calculate bias
@@ -98,7 +98,6 @@ void ConvPoolingForwardImpl::exec(
     }
 
     // calculate nonline
-    nonlineFwd = new ElemwiseForwardImpl(this->handle());
     switch (this->param().nonlineMode) {
         case Param::NonlineMode::RELU:
             nonlineFwd->param().mode = Elemwise::Param::Mode::RELU;
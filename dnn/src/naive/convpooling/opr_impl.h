@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include "megdnn/oprs.h"
 #include "src/naive/convolution/opr_impl.h"
 #include "src/naive/elemwise/opr_impl.h"
@@ -7,7 +8,7 @@
 namespace megdnn {
 namespace naive {
 
-class ConvPoolingForwardImpl final : public ConvPoolingForward {
+class ConvPoolingForwardImpl : public ConvPoolingForward {
 public:
     ConvPoolingForwardImpl(Handle* handle);
     void exec(
@@ -28,9 +29,9 @@ public:
 private:
     void setParamOfSublayers();
     TensorLayout conv_dst_layout;
-    PoolingForwardImpl* poolFwd;
-    ElemwiseForwardImpl* nonlineFwd;
-    ConvolutionForwardImpl* convFwd;
+    std::unique_ptr<PoolingForwardImpl> poolFwd;
+    std::unique_ptr<ElemwiseForwardImpl> nonlineFwd;
+    std::unique_ptr<ConvolutionForwardImpl> convFwd;
 };
 
 }  // namespace naive
@@ -0,0 +1,127 @@
+#include "src/naive/depthwise_pointwise_conv_bias/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+using namespace megdnn;
+using namespace naive;
+
+namespace {
+
+using Param = param::DepthwisePointwiseConvBias;
+
+struct Shape {
+    size_t N, C, IH, IW, OC, OH, OW, FH, FW;
+};
+
+inline float to_acc(float x) {
+    return x;
+}
+inline int32_t to_acc(dt_qint8 x) {
+    return x.as_int8();
+}
+inline int32_t to_acc(dt_qint32 x) {
+    return x.as_int32();
+}
+
+//! apply the nonlinearity to the accumulator times \p scale and round it to
+//! \p out_scale
+inline float from_acc(float acc, float, float, Param::DwNonlineMode mode) {
+    return apply_dw_pw_nonline(mode, acc);
+}
+inline dt_qint8 from_acc(
+        int32_t acc, float scale, float out_scale, Param::DwNonlineMode mode) {
+    return dtype::QuantizedS8(out_scale).param().quantize(
+            apply_dw_pw_nonline(mode, acc * scale));
+}
+
+template <typename ctype>
+using bias_type = typename std::conditional<
+        std::is_same<ctype, dt_qint8>::value, dt_qint32, float>::type;
+
+/*!
+ * \brief the two convs of the samples, with int32 accumulators and
+ *      requantized outputs if \p ctype is dt_qint8
+ *
+ * \p dw_scale and \p pw_scale are the scales of the accumulators, \p mid_scale
+ * and \p dst_scale the scales of the int8 outputs, all unused for float.
+ */
+template <typename ctype>
+void exec_internal(
+        const ctype* src, const ctype* dw_filter, const bias_type<ctype>* dw_bias,
+        const ctype* pw_filter, const bias_type<ctype>* pw_bias, ctype* dst,
+        ctype* mid, const Shape& s, const Param& p, float dw_scale, float mid_scale,
+        float pw_scale, float dst_scale) {
+    using acc_type = decltype(to_acc(*dw_bias));
+    rep(n, s.N) {
+        rep(c, s.C) rep(oh, s.OH) rep(ow, s.OW) {
+            acc_type acc = to_acc(dw_bias[c]);
+            rep(fh, s.FH) rep(fw, s.FW) {
+                int ih = static_cast<int>(oh * p.stride_h + fh - p.pad_h),
+                    iw = static_cast<int>(ow * p.stride_w + fw - p.pad_w);
+                if (ih >= 0 && ih < static_cast<int>(s.IH) && iw >= 0 &&
+                    iw < static_cast<int>(s.IW)) {
+                    acc += to_acc(src[(c * s.IH + ih) * s.IW + iw]) *
+                           to_acc(dw_filter[(c * s.FH + fh) * s.FW + fw]);
+                }
+            }
+            mid[(c * s.OH + oh) * s.OW + ow] =
+                    from_acc(acc, dw_scale, mid_scale, p.dw_nonline_mode);
+        }
+        size_t P = s.OH * s.OW;
+        rep(oc, s.OC) rep(i, P) {
+            acc_type acc = to_acc(pw_bias[oc]);
+            rep(c, s.C) {
+                acc += to_acc(pw_filter[oc * s.C + c]) * to_acc(mid[c * P + i]);
+            }
+            dst[oc * P + i] = from_acc(acc, pw_scale, dst_scale, p.pw_nonline_mode);
+        }
+        src += s.C * s.IH * s.IW;
+        dst += s.OC * P;
+    }
+}
+
+}  // anonymous namespace
+
+size_t DepthwisePointwiseConvBiasForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout&, const TensorLayout&,
+        const TensorLayout&, const TensorLayout&, const TensorLayout& dst) {
+    return src[1] * dst[2] * dst[3] * src.dtype.size();
+}
+
+void DepthwisePointwiseConvBiasForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in dw_filter, _megdnn_tensor_in dw_bias,
+        _megdnn_tensor_in pw_filter, _megdnn_tensor_in pw_bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(
+            src.layout, dw_filter.layout, dw_bias.layout, pw_filter.layout,
+            pw_bias.layout, dst.layout, workspace.size);
+    auto&& sl = src.layout;
+    auto&& dl = dst.layout;
+    Shape s{sl[0], sl[1], sl[2], sl[3], pw_filter.layout[0],
+            dl[2], dl[3], dw_filter.layout[3], dw_filter.layout[4]};
+    auto p = param();
+    if (src.layout.dtype.enumv() == DTypeEnum::Float32) {
+        MEGDNN_DISPATCH_CPU_KERN_OPR(exec_internal<float>(
+                src.ptr<float>(), dw_filter.ptr<float>(), dw_bias.ptr<float>(),
+                pw_filter.ptr<float>(), pw_bias.ptr<float>(), dst.ptr<float>(),
+                workspace.ptr<float>(), s, p, 1.f, 1.f, 1.f, 1.f));
+        return;
+    }
+    float dw_scale = dw_bias.layout.dtype.param<dtype::QuantizedS32>().scale,
+          pw_scale = pw_bias.layout.dtype.param<dtype::QuantizedS32>().scale,
+          mid_scale = mid_dtype(
+                              src.layout.dtype, pw_filter.layout.dtype,
+                              pw_bias.layout.dtype)
+                              .param<dtype::QuantizedS8>()
+                              .scale,
+          dst_scale = dst.layout.dtype.param<dtype::QuantizedS8>().scale;
+    MEGDNN_DISPATCH_CPU_KERN_OPR(exec_internal<dt_qint8>(
+            src.compatible_ptr<dt_qint8>(), dw_filter.compatible_ptr<dt_qint8>(),
+            dw_bias.compatible_ptr<dt_qint32>(), pw_filter.compatible_ptr<dt_qint8>(),
+            pw_bias.compatible_ptr<dt_qint32>(), dst.compatible_ptr<dt_qint8>(),
+            reinterpret_cast<dt_qint8*>(workspace.raw_ptr), s, p, dw_scale,
+            mid_scale, pw_scale, dst_scale));
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,42 @@
+#pragma once
+#include <cmath>
+#include "megdnn/oprs.h"
+
+namespace megdnn {
+namespace naive {
+
+//! the nonlinearity of a ConvBias on a float value
+inline float apply_dw_pw_nonline(param::ConvBias::NonlineMode mode, float x) {
+    using NonlineMode = param::ConvBias::NonlineMode;
+    switch (mode) {
+        case NonlineMode::RELU:
+            return x > 0.f ? x : 0.f;
+        case NonlineMode::SIGMOID:
+            return 1.f / (1.f + std::exp(-x));
+        case NonlineMode::H_SWISH:
+            return x * std::min(std::max(x + 3.f, 0.f), 6.f) / 6.f;
+        default:
+            return x;
+    }
+}
+
+class DepthwisePointwiseConvBiasForwardImpl
+        : public DepthwisePointwiseConvBiasForward {
+public:
+    using DepthwisePointwiseConvBiasForward::DepthwisePointwiseConvBiasForward;
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in dw_filter,
+            _megdnn_tensor_in dw_bias, _megdnn_tensor_in pw_filter,
+            _megdnn_tensor_in pw_bias, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) override;
+    //! the whole output of the channel-wise conv
+    size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& dw_filter,
+            const TensorLayout& dw_bias, const TensorLayout& pw_filter,
+            const TensorLayout& pw_bias, const TensorLayout& dst) override;
+};
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -23,6 +23,7 @@
 #include "src/naive/dct/opr_impl.h"
 #include "src/naive/deformable_conv/opr_impl.h"
 #include "src/naive/deformable_ps_roi_pooling/opr_impl.h"
+#include "src/naive/depthwise_pointwise_conv_bias/opr_impl.h"
 #include "src/naive/diag/opr_impl.h"
 #include "src/naive/dot/opr_impl.h"
 #include "src/naive/dropout/opr_impl.h"
@@ -83,6 +84,7 @@
 #include "src/naive/type_cvt/opr_impl.h"
 #include "src/naive/warp_affine/opr_impl.h"
 #include "src/naive/warp_perspective/opr_impl.h"
+#include "src/naive/weight_quant_matrix_mul/opr_impl.h"
 
 namespace megdnn {
 namespace naive {
@@ -0,0 +1,58 @@
+#include "src/naive/weight_quant_matrix_mul/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+namespace {
+
+//! the k-th weight of a row of packed 4-bit weights, the first in the low bits
+int8_t int4_weight(const int8_t* row, size_t k) {
+    auto byte = static_cast<uint8_t>(row[k / 2]);
+    return static_cast<int8_t>(k % 2 ? byte : byte << 4) >> 4;
+}
+
+void exec_internal(
+        const float* __restrict A, const int8_t* __restrict W,
+        const float* __restrict scale, float* __restrict C, size_t batch, size_t M,
+        size_t N, size_t K, size_t bits, size_t group) MEGDNN_NOEXCEPT {
+    size_t nr_groups = K / group, row_bytes = K * bits / 8;
+    rep(b, batch) {
+        rep(m, M) rep(n, N) {
+            const float* a = A + m * K;
+            const int8_t* w = W + n * row_bytes;
+            float res = 0.f;
+            rep(k, K) {
+                float wk = bits == 8 ? w[k] : int4_weight(w, k);
+                res += a[k] * wk * scale[n * nr_groups + k / group];
+            }
+            C[m * N + n] = res;
+        }
+        A += M * K;
+        W += N * row_bytes;
+        scale += N * nr_groups;
+        C += M * N;
+    }
+}
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace naive {
+
+void WeightQuantMatrixMulForwardImpl::exec(
+        _megdnn_tensor_in A, _megdnn_tensor_in W, _megdnn_tensor_in scale,
+        _megdnn_tensor_out C, _megdnn_workspace workspace) {
+    check_exec(A.layout, W.layout, scale.layout, C.layout, workspace.size);
+    size_t batch_dim = A.layout.ndim - 2;
+    size_t batch = batch_dim ? A.layout[0] : 1, M = A.layout[batch_dim],
+           K = A.layout[batch_dim + 1], N = W.layout[batch_dim];
+    size_t bits = param().bits, group = group_size(K);
+    MEGDNN_DISPATCH_CPU_KERN_OPR(exec_internal(
+            A.ptr<float>(), W.ptr<int8_t>(), scale.ptr<float>(), C.ptr<float>(),
+            batch, M, N, K, bits, group));
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
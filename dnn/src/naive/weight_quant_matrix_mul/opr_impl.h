@@ -0,0 +1,23 @@
+#pragma once
+#include "megdnn/oprs.h"
+
+namespace megdnn {
+namespace naive {
+
+class WeightQuantMatrixMulForwardImpl : public WeightQuantMatrixMulForward {
+public:
+    using WeightQuantMatrixMulForward::WeightQuantMatrixMulForward;
+    void exec(
+            _megdnn_tensor_in A, _megdnn_tensor_in W, _megdnn_tensor_in scale,
+            _megdnn_tensor_out C, _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout&, const TensorLayout&, const TensorLayout&,
+            const TensorLayout&) override {
+        return 0;
+    }
+};
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
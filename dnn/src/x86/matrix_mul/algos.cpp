@@ -1,6 +1,7 @@
 #include "src/x86/matrix_mul/algos.h"
 #include "src/common/utils.h"
 #include "src/fallback/matrix_mul/gemm_impl.h"
+#include "src/x86/matrix_mul/bf16/strategy.h"
 #include "src/x86/matrix_mul/f32/strategy.h"
 #include "src/x86/matrix_mul/int8/strategy.h"
 
@@ -679,4 +680,109 @@ MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL_DETAIL(
         x86::matmul::sgemm_pack_6x16_avx2, float, float, float, AlgoDataType::FLOAT32,
         DEFAULT);
 
+/*************************BFloat16 algos********************/
+#if !MEGDNN_DISABLE_FLOAT16
+namespace {
+template <typename Strategy>
+void bf16_gemm_kern(const MatrixMulImpl::KernParam& kern_param) {
+    constexpr int cacheline = 64;
+    auto M = kern_param.M, N = kern_param.N, K = kern_param.K;
+    auto trA = kern_param.trA, trB = kern_param.trB;
+    auto LDA = kern_param.LDA, LDB = kern_param.LDB, LDC = kern_param.LDC;
+    auto A_type = kern_param.A_type, B_type = kern_param.B_type,
+         C_type = kern_param.C_type;
+    const auto Aptr = kern_param.A<dt_bfloat16>(), Bptr = kern_param.B<dt_bfloat16>();
+    auto Cptr = kern_param.C<dt_bfloat16>();
+    Strategy strategy(M, N, K, A_type, B_type, C_type);
+    megdnn::matmul::GemmInterleaved<Strategy>(M, N, K, trA, trB, strategy, cacheline)
+            .execute(Aptr, LDA, Bptr, LDB, Cptr, LDC, kern_param.workspace_ptr);
+}
+
+template <typename Strategy>
+size_t bf16_gemm_workspace(const MatrixMulImpl::KernSizeParam& kern_size_param) {
+    constexpr int cacheline = 64;
+    auto M = kern_size_param.M, N = kern_size_param.N, K = kern_size_param.K;
+    auto trA = kern_size_param.trA, trB = kern_size_param.trB;
+    auto A_type = kern_size_param.A_type, B_type = kern_size_param.B_type,
+         C_type = kern_size_param.C_type;
+    Strategy strategy(M, N, K, A_type, B_type, C_type);
+    return megdnn::matmul::GemmInterleaved<Strategy>(
+                   M, N, K, trA, trB, strategy, cacheline)
+            .get_workspace_size();
+}
+
+//! the products are always accumulated in float32, so both compute modes are
+//! accepted
+bool can_be_treated_as_bf16(const MatrixMulImpl::KernSizeParam& kern_size_param) {
+    using Param = MatrixMulImpl::Param;
+    return kern_size_param.A_type.enumv() == DTypeEnum::BFloat16 &&
+           kern_size_param.B_type.enumv() == DTypeEnum::BFloat16 &&
+           kern_size_param.C_type.enumv() == DTypeEnum::BFloat16 &&
+           (kern_size_param.compute_mode == Param::ComputeMode::DEFAULT ||
+            kern_size_param.compute_mode == Param::ComputeMode::FLOAT32) &&
+           kern_size_param.format == Param::Format::DEFAULT;
+}
+
+void bf16_avx2_6x16_kern(const MatrixMulImpl::KernParam& kern_param) {
+    MIDOUT_BEGIN(megdnn_x86_matmul_kern, midout_iv("bf16_avx2_6x16_kern"_hash)) {
+        bf16_gemm_kern<x86::matmul::bf16gemm_pack_6x16_avx2>(kern_param);
+    }
+    MIDOUT_END();
+}
+
+#if MEGDNN_X86_WITH_AVX512_BF16
+void bf16_avx512_8x32_kern(const MatrixMulImpl::KernParam& kern_param) {
+    MIDOUT_BEGIN(megdnn_x86_matmul_kern, midout_iv("bf16_avx512_8x32_kern"_hash)) {
+        bf16_gemm_kern<x86::matmul::bf16gemm_avx512_8x32x2>(kern_param);
+    }
+    MIDOUT_END();
+}
+#endif
+}  // namespace
+
+bool MatrixMulImpl::AlgoBFloat16AVX2M6N16::usable(
+        const KernSizeParam& kern_size_param) const {
+    return can_be_treated_as_bf16(kern_size_param) && is_supported(SIMDType::AVX2) &&
+           is_supported(SIMDType::FMA);
+}
+
+size_t MatrixMulImpl::AlgoBFloat16AVX2M6N16::get_workspace(
+        const KernSizeParam& kern_size_param) const {
+    return bf16_gemm_workspace<x86::matmul::bf16gemm_pack_6x16_avx2>(kern_size_param);
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoBFloat16AVX2M6N16::get_kern(
+        const KernSizeParam&) const {
+    return bf16_avx2_6x16_kern;
+}
+
+MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL_DETAIL(
+        AlgoBFloat16AVX2M6N16, megdnn_x86_matmul_kern, "AlgoBFloat16AVX2M6N16"_hash,
+        x86::matmul::bf16gemm_pack_6x16_avx2, dt_bfloat16, dt_bfloat16, float,
+        AlgoDataType::BFLOAT16, DEFAULT);
+
+#if MEGDNN_X86_WITH_AVX512_BF16
+bool MatrixMulImpl::AlgoBFloat16Avx512M8N32::usable(
+        const KernSizeParam& kern_size_param) const {
+    return can_be_treated_as_bf16(kern_size_param) &&
+           is_supported(SIMDType::AVX512_BF16);
+}
+
+size_t MatrixMulImpl::AlgoBFloat16Avx512M8N32::get_workspace(
+        const KernSizeParam& kern_size_param) const {
+    return bf16_gemm_workspace<x86::matmul::bf16gemm_avx512_8x32x2>(kern_size_param);
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoBFloat16Avx512M8N32::get_kern(
+        const KernSizeParam&) const {
+    return bf16_avx512_8x32_kern;
+}
+
+MEGDNN_REG_GEMM_FUNC_FOR_IM2COL_IMPL(
+        AlgoBFloat16Avx512M8N32, megdnn_x86_matmul_kern,
+        "AlgoBFloat16Avx512M8N32"_hash, x86::matmul::bf16gemm_avx512_8x32x2,
+        dt_bfloat16, dt_bfloat16, AlgoDataType::BFLOAT16, DEFAULT);
+#endif
+#endif
+
 // vim: syntax=cpp.doxygen
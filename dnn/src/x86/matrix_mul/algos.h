@@ -133,6 +133,32 @@ public:
     MEGDNN_DECL_ALGO_TYPE(X86_F32_6x16)
 };
 
+#if !MEGDNN_DISABLE_FLOAT16
+class MatrixMulImpl::AlgoBFloat16AVX2M6N16 : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_BF16_6x16"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    MEGDNN_REG_GEMM_FUNC_FOR_IM2COL();
+    MEGDNN_DECL_ALGO_TYPE(X86_BF16_6x16)
+};
+
+#if MEGDNN_X86_WITH_AVX512_BF16
+class MatrixMulImpl::AlgoBFloat16Avx512M8N32 : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_BF16_AVX512_8X32"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override;
+    kern_t get_kern(const KernSizeParam&) const override;
+    MEGDNN_REG_GEMM_FUNC_FOR_IM2COL();
+    MEGDNN_DECL_ALGO_TYPE(X86_BF16_AVX512_8X32)
+};
+#endif
+#endif
+
 #if MEGDNN_X86_WITH_VNNI
 class MatrixMulImpl::AlgoInt8x8x32Vnni : public AlgoBase {
 public:
@@ -0,0 +1,33 @@
+#pragma once
+#include "src/fallback/matrix_mul/gemm_common.h"
+
+#if !MEGDNN_DISABLE_FLOAT16
+namespace megdnn {
+namespace x86 {
+namespace matmul {
+
+/*!
+ * A is converted to float32 when it is packed, B stays in bfloat16 and is
+ * converted in the kernel before the fma, the products are accumulated in
+ * float32 and rounded to bfloat16 once when C is stored
+ */
+MEGDNN_REG_GEMM_STRATEGY_WITH_PACK_A_TYPE(
+        dt_bfloat16, float, dt_bfloat16, float, 6, 16, 1, false, false,
+        bf16gemm_pack_6x16_avx2);
+
+#if MEGDNN_X86_WITH_AVX512_BF16
+/*!
+ * A and B are packed as pairs of bfloat16 along k, which are multiplied and
+ * accumulated into float32 by vdpbf16ps
+ */
+MEGDNN_REG_GEMM_STRATEGY(
+        dt_bfloat16, dt_bfloat16, float, 8, 32, 2, false, false,
+        bf16gemm_avx512_8x32x2);
+#endif
+
+}  // namespace matmul
+}  // namespace x86
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,211 @@
+#include <immintrin.h>
+#include <cstring>
+
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+#include "src/x86/matrix_mul/bf16/strategy.h"
+
+#if !MEGDNN_DISABLE_FLOAT16
+
+using namespace megdnn;
+using namespace x86;
+
+namespace {
+
+constexpr int KERNEL_H = 6;
+constexpr int KERNEL_W = 16;
+
+inline float bf16_to_float(const dt_bfloat16& val) {
+    return static_cast<float>(val);
+}
+
+//! widen 8 bfloat16 to float32 by shifting them to the high half of the words
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline __m256 widen_bf16(const dt_bfloat16* ptr) {
+    __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(raw), 16));
+}
+
+/*!
+ * \brief round 8 float32 to nearest even bfloat16, in the low half of the
+ *      words, as float2bfloat16 does
+ */
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline __m256i round_to_bf16(__m256 val) {
+    __m256i bits = _mm256_castps_si256(val);
+    __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+    __m256i rounded =
+            _mm256_add_epi32(bits, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7fff)));
+    //! keep nan a nan instead of rounding its mantissa into the exponent
+    __m256i nan = _mm256_or_si256(bits, _mm256_set1_epi32(0x10000));
+    __m256 is_nan = _mm256_cmp_ps(val, val, _CMP_UNORD_Q);
+    rounded = _mm256_castps_si256(_mm256_blendv_ps(
+            _mm256_castsi256_ps(rounded), _mm256_castsi256_ps(nan), is_nan));
+    return _mm256_srli_epi32(rounded, 16);
+}
+
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline void store_bf16x16(dt_bfloat16* dst, __m256 lo, __m256 hi, int n) {
+    __m256i packed = _mm256_permute4x64_epi64(
+            _mm256_packus_epi32(round_to_bf16(lo), round_to_bf16(hi)), 0xd8);
+    if (n == KERNEL_W) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), packed);
+    } else {
+        alignas(32) dt_bfloat16 tmp[KERNEL_W];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(tmp), packed);
+        memcpy(dst, tmp, n * sizeof(dt_bfloat16));
+    }
+}
+
+/*!
+ * \brief C[0:m, 0:n] = packA[6 x K] * packB[K x 16], with m <= 6, n <= 16
+ *
+ * Each row of B is widened to float32 right before it is multiplied, so B is
+ * read from memory in bfloat16. 12 accumulators, 2 rows of B and the
+ * broadcast of A fit into the 16 ymm registers.
+ */
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void kern_6x16(
+        const float* packA, const dt_bfloat16* packB, int K, dt_bfloat16* C,
+        size_t LDC, int m, int n) {
+#define cb(i)                             \
+    __m256 c##i##0 = _mm256_setzero_ps(); \
+    __m256 c##i##1 = _mm256_setzero_ps();
+    UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+    for (int k = 0; k < K; ++k) {
+        __m256 b0 = widen_bf16(packB);
+        __m256 b1 = widen_bf16(packB + 8);
+#define cb(i)                                      \
+    {                                              \
+        __m256 a = _mm256_broadcast_ss(packA + i); \
+        c##i##0 = _mm256_fmadd_ps(a, b0, c##i##0); \
+        c##i##1 = _mm256_fmadd_ps(a, b1, c##i##1); \
+    }
+        UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+        packA += KERNEL_H;
+        packB += KERNEL_W;
+    }
+#define cb(i)                                            \
+    if (i < m) {                                         \
+        store_bf16x16(C + i * LDC, c##i##0, c##i##1, n); \
+    }
+    UNROLL_CALL_NOWRAPPER(6, cb);
+#undef cb
+}
+
+void pack_A_n(
+        float* out, const dt_bfloat16* in, int ldin, int y0, int ymax, int k0,
+        int kmax) {
+    int ksize = kmax - k0;
+    for (int y = y0; y < ymax; y += KERNEL_H) {
+        int rows = std::min(KERNEL_H, ymax - y);
+        for (int r = 0; r < KERNEL_H; ++r) {
+            const dt_bfloat16* inptr = in + (y + r) * ldin + k0;
+            for (int k = 0; k < ksize; ++k) {
+                out[k * KERNEL_H + r] = r < rows ? bf16_to_float(inptr[k]) : 0.f;
+            }
+        }
+        out += KERNEL_H * ksize;
+    }
+}
+
+void pack_A_t(
+        float* out, const dt_bfloat16* in, int ldin, int y0, int ymax, int k0,
+        int kmax) {
+    int ksize = kmax - k0;
+    for (int y = y0; y < ymax; y += KERNEL_H) {
+        int rows = std::min(KERNEL_H, ymax - y);
+        for (int k = 0; k < ksize; ++k) {
+            const dt_bfloat16* inptr = in + (k0 + k) * ldin + y;
+            for (int r = 0; r < KERNEL_H; ++r) {
+                *out++ = r < rows ? bf16_to_float(inptr[r]) : 0.f;
+            }
+        }
+    }
+}
+
+void pack_B_n(
+        dt_bfloat16* out, const dt_bfloat16* in, int ldin, int x0, int xmax, int k0,
+        int kmax) {
+    int ksize = kmax - k0;
+    for (int x = x0; x < xmax; x += KERNEL_W) {
+        int cols = std::min(KERNEL_W, xmax - x);
+        for (int k = 0; k < ksize; ++k) {
+            memcpy(out, in + (k0 + k) * ldin + x, cols * sizeof(dt_bfloat16));
+            memset(out + cols, 0, (KERNEL_W - cols) * sizeof(dt_bfloat16));
+            out += KERNEL_W;
+        }
+    }
+}
+
+void pack_B_t(
+        dt_bfloat16* out, const dt_bfloat16* in, int ldin, int x0, int xmax, int k0,
+        int kmax) {
+    int ksize = kmax - k0;
+    for (int x = x0; x < xmax; x += KERNEL_W) {
+        int cols = std::min(KERNEL_W, xmax - x);
+        memset(out, 0, KERNEL_W * ksize * sizeof(dt_bfloat16));
+        for (int c = 0; c < cols; ++c) {
+            const dt_bfloat16* inptr = in + (x + c) * ldin + k0;
+            for (int k = 0; k < ksize; ++k) {
+                out[k * KERNEL_W + c] = inptr[k];
+            }
+        }
+        out += KERNEL_W * ksize;
+    }
+}
+
+}  // namespace
+
+namespace megdnn {
+namespace x86 {
+namespace matmul {
+
+MEGDNN_REG_GEMM_STRATEGY_IMPL(bf16gemm_pack_6x16_avx2);
+
+void bf16gemm_pack_6x16_avx2::pack_A(
+        float* out, const dt_bfloat16* in, int ldin, int y0, int ymax, int k0,
+        int kmax, bool transpose_A) const {
+    if (!transpose_A)
+        pack_A_n(out, in, ldin, y0, ymax, k0, kmax);
+    else
+        pack_A_t(out, in, ldin, y0, ymax, k0, kmax);
+}
+
+void bf16gemm_pack_6x16_avx2::pack_B(
+        dt_bfloat16* out, const dt_bfloat16* in, int ldin, int x0, int xmax, int k0,
+        int kmax, bool transpose_B) const {
+    if (!transpose_B)
+        pack_B_n(out, in, ldin, x0, xmax, k0, kmax);
+    else
+        pack_B_t(out, in, ldin, x0, xmax, k0, kmax);
+}
+
+void bf16gemm_pack_6x16_avx2::kern(
+        const float* packA, const dt_bfloat16* packB, size_t M, size_t N, size_t K,
+        dt_bfloat16* C, size_t LDC, bool is_first_k, const float*, float*) const {
+    //! C is only written once as the whole k is in a single block
+    megdnn_assert(
+            is_first_k && A_dtype.enumv() == DTypeEnum::BFloat16 &&
+            C_dtype.enumv() == DTypeEnum::BFloat16);
+    for (size_t m = 0; m < M; m += KERNEL_H) {
+        int rows = std::min<size_t>(KERNEL_H, M - m);
+        const dt_bfloat16* cur_packB = packB;
+        for (size_t n = 0; n < N; n += KERNEL_W) {
+            kern_6x16(
+                    packA, cur_packB, K, C + m * LDC + n, LDC, rows,
+                    std::min<size_t>(KERNEL_W, N - n));
+            cur_packB += KERNEL_W * K;
+        }
+        packA += KERNEL_H * K;
+    }
+}
+
+}  // namespace matmul
+}  // namespace x86
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,164 @@
+#include <immintrin.h>
+#include <cstring>
+
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+#include "src/x86/matrix_mul/bf16/strategy.h"
+
+#if !MEGDNN_DISABLE_FLOAT16 && MEGDNN_X86_WITH_AVX512_BF16
+
+using namespace megdnn;
+using namespace x86;
+
+namespace {
+
+constexpr int KERNEL_H = 8;
+constexpr int KERNEL_W = 32;
+
+/*!
+ * \brief C[0:m, 0:n] = packA[8 x K] * packB[K x 32], with m <= 8, n <= 32
+ *
+ * A pair of bfloat16 along k of a row of A is broadcast as a dword, and each
+ * dword lane of B holds the pair of the same column, so a vdpbf16ps adds the
+ * products of two steps of k to 16 float32 accumulators. \p K2 is the number
+ * of pairs.
+ */
+MEGDNN_ATTRIBUTE_TARGET("avx512f,avx512bw,avx512vl,avx512bf16")
+void kern_8x32(
+        const dt_bfloat16* packA, const dt_bfloat16* packB, int K2, dt_bfloat16* C,
+        size_t LDC, int m, int n) {
+    const int32_t* a_pairs = reinterpret_cast<const int32_t*>(packA);
+#define cb(i)                             \
+    __m512 c##i##0 = _mm512_setzero_ps(); \
+    __m512 c##i##1 = _mm512_setzero_ps();
+    UNROLL_CALL_NOWRAPPER(8, cb);
+#undef cb
+    for (int k = 0; k < K2; ++k) {
+        __m512bh b0 = (__m512bh)_mm512_loadu_si512(packB);
+        __m512bh b1 = (__m512bh)_mm512_loadu_si512(packB + KERNEL_W);
+#define cb(i)                                                 \
+    {                                                         \
+        __m512bh a = (__m512bh)_mm512_set1_epi32(a_pairs[i]); \
+        c##i##0 = _mm512_dpbf16_ps(c##i##0, a, b0);           \
+        c##i##1 = _mm512_dpbf16_ps(c##i##1, a, b1);           \
+    }
+        UNROLL_CALL_NOWRAPPER(8, cb);
+#undef cb
+        a_pairs += KERNEL_H;
+        packB += 2 * KERNEL_W;
+    }
+    //! vcvtneps2bf16 rounds to nearest even as float2bfloat16 does
+    __mmask16 mask0 = n >= 16 ? 0xffff : (1u << n) - 1;
+    __mmask16 mask1 = n >= 32 ? 0xffff : n > 16 ? (1u << (n - 16)) - 1 : 0;
+#define cb(i)                                                           \
+    if (i < m) {                                                        \
+        auto dst = C + i * LDC;                                         \
+        _mm256_mask_storeu_epi16(                                       \
+                dst, mask0, (__m256i)_mm512_cvtneps_pbh(c##i##0));      \
+        _mm256_mask_storeu_epi16(                                       \
+                dst + 16, mask1, (__m256i)_mm512_cvtneps_pbh(c##i##1)); \
+    }
+    UNROLL_CALL_NOWRAPPER(8, cb);
+#undef cb
+}
+
+//! write the pairs along k of \p rows rows of A, padded with zero
+template <typename GetA>
+void pack_A_pairs(
+        dt_bfloat16* out, int y0, int ymax, int k0, int kmax, GetA&& get) {
+    int ksize = kmax - k0;
+    for (int y = y0; y < ymax; y += KERNEL_H) {
+        int rows = std::min(KERNEL_H, ymax - y);
+        for (int k = 0; k < ksize; k += 2) {
+            for (int r = 0; r < KERNEL_H; ++r) {
+                bool valid = r < rows;
+                *out++ = valid ? get(y + r, k0 + k) : dt_bfloat16(0.f);
+                *out++ = valid && k + 1 < ksize ? get(y + r, k0 + k + 1)
+                                                : dt_bfloat16(0.f);
+            }
+        }
+    }
+}
+
+//! write the pairs along k of \p cols columns of B, padded with zero
+template <typename GetB>
+void pack_B_pairs(
+        dt_bfloat16* out, int x0, int xmax, int k0, int kmax, GetB&& get) {
+    int ksize = kmax - k0;
+    for (int x = x0; x < xmax; x += KERNEL_W) {
+        int cols = std::min(KERNEL_W, xmax - x);
+        for (int k = 0; k < ksize; k += 2) {
+            for (int c = 0; c < KERNEL_W; ++c) {
+                bool valid = c < cols;
+                *out++ = valid ? get(k0 + k, x + c) : dt_bfloat16(0.f);
+                *out++ = valid && k + 1 < ksize ? get(k0 + k + 1, x + c)
+                                                : dt_bfloat16(0.f);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+namespace megdnn {
+namespace x86 {
+namespace matmul {
+
+MEGDNN_REG_GEMM_STRATEGY_IMPL(bf16gemm_avx512_8x32x2);
+
+void bf16gemm_avx512_8x32x2::pack_A(
+        dt_bfloat16* out, const dt_bfloat16* in, int ldin, int y0, int ymax, int k0,
+        int kmax, bool transpose_A) const {
+    if (!transpose_A) {
+        pack_A_pairs(out, y0, ymax, k0, kmax, [=](int y, int k) {
+            return in[y * ldin + k];
+        });
+    } else {
+        pack_A_pairs(out, y0, ymax, k0, kmax, [=](int y, int k) {
+            return in[k * ldin + y];
+        });
+    }
+}
+
+void bf16gemm_avx512_8x32x2::pack_B(
+        dt_bfloat16* out, const dt_bfloat16* in, int ldin, int x0, int xmax, int k0,
+        int kmax, bool transpose_B) const {
+    if (!transpose_B) {
+        pack_B_pairs(out, x0, xmax, k0, kmax, [=](int k, int x) {
+            return in[k * ldin + x];
+        });
+    } else {
+        pack_B_pairs(out, x0, xmax, k0, kmax, [=](int k, int x) {
+            return in[x * ldin + k];
+        });
+    }
+}
+
+void bf16gemm_avx512_8x32x2::kern(
+        const dt_bfloat16* packA, const dt_bfloat16* packB, size_t M, size_t N,
+        size_t K, dt_bfloat16* C, size_t LDC, bool is_first_k, const float*,
+        float*) const {
+    //! C is only written once as the whole k is in a single block
+    megdnn_assert(
+            is_first_k && A_dtype.enumv() == DTypeEnum::BFloat16 &&
+            C_dtype.enumv() == DTypeEnum::BFloat16);
+    size_t K2 = div_ceil<size_t>(K, 2);
+    for (size_t m = 0; m < M; m += KERNEL_H) {
+        int rows = std::min<size_t>(KERNEL_H, M - m);
+        const dt_bfloat16* cur_packB = packB;
+        for (size_t n = 0; n < N; n += KERNEL_W) {
+            kern_8x32(
+                    packA, cur_packB, K2, C + m * LDC + n, LDC, rows,
+                    std::min<size_t>(KERNEL_W, N - n));
+            cur_packB += KERNEL_W * 2 * K2;
+        }
+        packA += KERNEL_H * 2 * K2;
+    }
+}
+
+}  // namespace matmul
+}  // namespace x86
+}  // namespace megdnn
+#endif
+
+// vim: syntax=cpp.doxygen
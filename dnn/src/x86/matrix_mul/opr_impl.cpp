@@ -23,6 +23,12 @@ class MatrixMulImpl::AlgoPack : NonCopyableObj {
     AlgoInt8x8x16SSE algoint8x8x16sse_m4n8k2;
     AlgoF32MK8_8x8 algof32mk8_8x8;
     AlgoFloatAVX2M6N16 algof32_6x16;
+#if !MEGDNN_DISABLE_FLOAT16
+    AlgoBFloat16AVX2M6N16 algobf16_6x16;
+#if MEGDNN_X86_WITH_AVX512_BF16
+    AlgoBFloat16Avx512M8N32 algobf16_avx512_8x32;
+#endif
+#endif
 
     SmallVector<fallback::MatrixMulImpl::AlgoBase*> m_all_algos;
     fallback::MatrixMulImpl::AlgoBase::Mapper m_all_algos_map;
@@ -48,6 +54,12 @@ public:
         m_all_algos.emplace_back(&f32mkl_packa);
 #endif
         m_all_algos.emplace_back(&algof32_6x16);
+#if !MEGDNN_DISABLE_FLOAT16
+#if MEGDNN_X86_WITH_AVX512_BF16
+        m_all_algos.emplace_back(&algobf16_avx512_8x32);
+#endif
+        m_all_algos.emplace_back(&algobf16_6x16);
+#endif
 
         for (auto&& algo : m_all_algos) {
             m_all_algos_map.emplace(algo->info().desc, algo);
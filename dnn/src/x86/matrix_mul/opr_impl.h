@@ -57,6 +57,12 @@ private:
     class AlgoPack;
     class AlgoF32MK8_8x8;
     class AlgoFloatAVX2M6N16;
+#if !MEGDNN_DISABLE_FLOAT16
+    class AlgoBFloat16AVX2M6N16;
+#if MEGDNN_X86_WITH_AVX512_BF16
+    class AlgoBFloat16Avx512M8N32;
+#endif
+#endif
 
 public:
     static const AlgoPack& algo_pack();
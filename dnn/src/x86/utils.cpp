@@ -117,6 +117,41 @@ bool feature_detect_vnni() {
     return (eax & 6) == 6;
 }
 
+bool feature_detect_avx512_bf16() {
+    uint32_t eax, ebx, ecx, edx;
+
+    // check cpu support
+#if defined(_WIN32)
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 7);
+    ebx = cpuInfo[1];
+    __cpuidex(cpuInfo, 7, 1);
+    eax = cpuInfo[0];
+#else
+    asm volatile("cpuid\n"
+                 : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                 : "a"(7), "c"(0)
+                 : "cc");
+    uint32_t leaf7_ebx = ebx;
+    asm volatile("cpuid\n"
+                 : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                 : "a"(7), "c"(1)
+                 : "cc");
+    ebx = leaf7_ebx;
+#endif
+    // avx512f    ---> 16 ebx of subleaf 0
+    // avx512bw   ---> 30 ebx of subleaf 0
+    // avx512vl   ---> 31 ebx of subleaf 0
+    // avx512bf16 ---> 5 eax of subleaf 1
+    if (!(bit(ebx, 16) && bit(ebx, 30) && bit(ebx, 31) && bit(eax, 5)))
+        return false;
+
+    // check os support of the ymm, zmm and opmask states
+    asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+    return (eax & 0xe6) == 0xe6;
+}
+
 bool feature_detect_avx_fma(int ftr) {
     // see Detecting Availability and Support in
     // https://software.intel.com/en-us/articles/introduction-to-intel-advanced-vector-extensions
@@ -136,6 +171,7 @@ bool is_avx_supported = feature_detect_avx_fma(28);
 bool is_fma_supported = feature_detect_avx_fma(12);
 bool is_avx2_supported = feature_detect_avx2();
 bool is_vnni_supported = feature_detect_vnni();
+bool is_avx512_bf16_supported = feature_detect_avx512_bf16();
 
 SIMDType disabled_simd_type_thresh = SIMDType::__NR_SIMD_TYPE;
 
@@ -169,6 +205,8 @@ bool x86::is_supported(SIMDType type) {
             return is_avx2_supported;
         case SIMDType::VNNI:
             return is_vnni_supported;
+        case SIMDType::AVX512_BF16:
+            return is_avx512_bf16_supported;
         default:
             break;
     }
@@ -28,6 +28,7 @@ enum class SIMDType {
     AVX2,
     FMA,
     VNNI,
+    AVX512_BF16,
     NONE,
     __NR_SIMD_TYPE  //! total number of SIMD types; used for testing
 };
@@ -453,6 +453,20 @@ TEST_F(FALLBACK_MULTI_THREADS, CONVBIAS_GI_WINOGRAD_PREPROCESS_NCHW44) {
     run(nchw44_args, dtype::Float32(), dtype::Float32(), dtype::Float32(),
         dtype::Float32(), 1e-3f);
 }
+
+TEST_F(FALLBACK_MULTI_THREADS, CONVBIAS_GI_WINOGRAD_F43_4x4) {
+    check_conv_bias(
+            conv_bias::get_winograd_mk_packed_args(), handle(),
+            "WINOGRAD:FB_GI_F32_MK4_4x8:4:4:16");
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, CONVBIAS_GI_WINOGRAD_F43_4x4_NCHW44) {
+    check_conv_bias(
+            conv_bias::get_nchw44_conv_bias_args(
+                    {3}, QUAN_NLMODE, BR_AND_NO_BIASMODE, 1),
+            handle(), "WINOGRAD_NCHW44:FB_GI_F32_MK4_4x8:4:4:16");
+}
+
 TEST_F(FALLBACK_MULTI_THREADS, CONV_BIAS_FORWARD_QUANTIZED) {
     using namespace conv_bias;
     param::ConvBias cur_param;
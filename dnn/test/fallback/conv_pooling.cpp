@@ -0,0 +1,127 @@
+#include "test/common/conv_pooling.h"
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/fallback/fixture.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+using Param = ConvPooling::Param;
+
+template <typename Run>
+void for_each_param(Run&& run) {
+    Param param;
+    for (auto conv_mode :
+         {Param::ConvMode::CROSS_CORRELATION, Param::ConvMode::CONVOLUTION}) {
+        for (auto pool_mode : {Param::PoolMode::MAX, Param::PoolMode::AVERAGE}) {
+            for (uint32_t window : {2, 3}) {
+                for (uint32_t conv_stride : {1, 2}) {
+                    param.convMode = conv_mode;
+                    param.poolMode = pool_mode;
+                    param.pool_shape_h = param.pool_shape_w = window;
+                    param.pool_stride_h = param.pool_stride_w = 2;
+                    param.pool_pad_h = param.pool_pad_w = window / 3;
+                    param.conv_stride_h = param.conv_stride_w = conv_stride;
+                    param.conv_pad_h = param.conv_pad_w = 1;
+                    run(param);
+                }
+            }
+        }
+    }
+    //! overlapping windows, asymmetric strides and no padding
+    param.pool_shape_h = param.pool_shape_w = 3;
+    param.pool_stride_h = 1;
+    param.pool_stride_w = 2;
+    param.pool_pad_h = param.pool_pad_w = 0;
+    param.conv_stride_h = 2;
+    param.conv_stride_w = 1;
+    param.conv_pad_h = 0;
+    param.conv_pad_w = 2;
+    run(param);
+}
+}  // namespace
+
+TEST_F(FALLBACK, CONV_POOLING) {
+    Checker<ConvPooling> checker(handle());
+    checker.set_epsilon(1e-3);
+    for (auto mode :
+         {Param::NonlineMode::IDENTITY, Param::NonlineMode::RELU,
+          Param::NonlineMode::SIGMOID}) {
+        for_each_param([&](Param param) {
+            param.nonlineMode = mode;
+            checker.set_param(param);
+            checker.execs({{1, 3, 7, 9}, {5, 3, 3, 3}, {1, 5, 1, 1}, {}});
+            checker.execs({{2, 8, 16, 16}, {16, 8, 3, 3}, {1, 16, 1, 1}, {}});
+            checker.execs({{3, 5, 23, 19}, {7, 5, 5, 5}, {1, 7, 1, 1}, {}});
+            checker.execs({{1, 4, 128, 130}, {6, 4, 1, 1}, {1, 6, 1, 1}, {}});
+        });
+    }
+}
+
+TEST_F(FALLBACK, CONV_POOLING_ARGS) {
+    Checker<ConvPooling> checker(handle());
+    checker.set_epsilon(1e-3);
+    for (auto&& arg : conv_pooling::get_args()) {
+        checker.set_param(arg.param).execs({arg.src, arg.filter, arg.bias, {}});
+    }
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(FALLBACK, BENCHMARK_CONV_POOLING) {
+    constexpr size_t RUN = 20;
+    Benchmarker<ConvBias> benchmarker_conv(handle());
+    benchmarker_conv.set_times(RUN).set_display(false);
+    Benchmarker<Pooling> benchmarker_pooling(handle());
+    benchmarker_pooling.set_times(RUN).set_display(false);
+    Benchmarker<ConvPooling> benchmarker_fused(handle());
+    benchmarker_fused.set_times(RUN).set_display(false);
+    auto run = [&](size_t N, size_t IC, size_t H, size_t W, size_t OC, size_t F,
+                   uint32_t window, Param::PoolMode pool_mode) {
+        ConvBias::Param conv_param;
+        conv_param.pad_h = conv_param.pad_w = F / 2;
+        conv_param.nonlineMode = ConvBias::Param::NonlineMode::RELU;
+        auto conv_used = benchmarker_conv.set_param(conv_param)
+                                 .execs({{N, IC, H, W},
+                                         {OC, IC, F, F},
+                                         {1, OC, 1, 1},
+                                         {},
+                                         {}}) /
+                         RUN;
+        Pooling::Param pooling_param;
+        pooling_param.mode = pool_mode == Param::PoolMode::MAX
+                                   ? Pooling::Param::Mode::MAX
+                                   : Pooling::Param::Mode::AVERAGE;
+        pooling_param.window_h = pooling_param.window_w = window;
+        pooling_param.stride_h = pooling_param.stride_w = 2;
+        benchmarker_pooling.set_param(pooling_param);
+        auto pooling_used = benchmarker_pooling.execs({{N, OC, H, W}, {}}) / RUN;
+        Param param;
+        param.convMode = Param::ConvMode::CROSS_CORRELATION;
+        param.poolMode = pool_mode;
+        param.nonlineMode = Param::NonlineMode::RELU;
+        param.pool_shape_h = param.pool_shape_w = window;
+        param.pool_stride_h = param.pool_stride_w = 2;
+        param.conv_pad_h = param.conv_pad_w = F / 2;
+        auto used = benchmarker_fused.set_param(param).execs(
+                            {{N, IC, H, W}, {OC, IC, F, F}, {1, OC, 1, 1}, {}}) /
+                    RUN;
+        printf("N=%zu IC=%zu H=%zu W=%zu OC=%zu F=%zu window=%u: conv + pooling "
+               "%.3f ms, fused %.3f ms (%.2fx)\n",
+               N, IC, H, W, OC, F, window, conv_used + pooling_used, used,
+               (conv_used + pooling_used) / used);
+    };
+    for (auto pool_mode : {Param::PoolMode::MAX, Param::PoolMode::AVERAGE}) {
+        run(1, 3, 224, 224, 32, 3, 2, pool_mode);
+        run(1, 16, 112, 112, 32, 3, 2, pool_mode);
+        run(1, 32, 56, 56, 64, 3, 3, pool_mode);
+        run(1, 64, 28, 28, 128, 3, 2, pool_mode);
+        run(4, 32, 56, 56, 32, 5, 3, pool_mode);
+    }
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,141 @@
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+#include "test/fallback/fixture.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+using Param = DepthwisePointwiseConvBias::Param;
+using NonlineMode = Param::DwNonlineMode;
+
+//! layouts of the inputs of a channel-wise conv with \p F x \p F filters of
+//! \p C channels followed by a 1x1 conv to \p OC channels
+TensorShapeArray make_shapes(
+        size_t N, size_t C, size_t H, size_t W, size_t OC, size_t F) {
+    return {{N, C, H, W}, {C, 1, 1, F, F}, {1, C, 1, 1}, {OC, C, 1, 1},
+            {1, OC, 1, 1}, {}};
+}
+
+template <typename Run>
+void for_each_param(Run&& run) {
+    Param param;
+    for (size_t F : {1, 3, 5}) {
+        for (uint32_t stride : {1, 2}) {
+            for (uint32_t pad : {0u, static_cast<uint32_t>(F / 2)}) {
+                param.stride_h = param.stride_w = stride;
+                param.pad_h = param.pad_w = pad;
+                run(param, F);
+            }
+        }
+    }
+    param.stride_h = 1;
+    param.stride_w = 2;
+    param.pad_h = 2;
+    param.pad_w = 0;
+    run(param, 3);
+}
+}  // namespace
+
+TEST_F(FALLBACK, DEPTHWISE_POINTWISE_CONV_BIAS_FLOAT) {
+    Checker<DepthwisePointwiseConvBias> checker(handle());
+    checker.set_epsilon(1e-3);
+    for (auto mode :
+         {NonlineMode::IDENTITY, NonlineMode::RELU, NonlineMode::SIGMOID,
+          NonlineMode::H_SWISH}) {
+        for_each_param([&](Param param, size_t F) {
+            param.dw_nonline_mode = mode;
+            param.pw_nonline_mode = NonlineMode::RELU;
+            checker.set_param(param);
+            checker.execs(make_shapes(1, 3, 7, 9, 5, F));
+            checker.execs(make_shapes(2, 8, 16, 16, 16, F));
+            checker.execs(make_shapes(3, 13, 11, 23, 7, F));
+            param.pw_nonline_mode = mode;
+            checker.set_param(param).execs(make_shapes(1, 32, 56, 56, 24, F));
+        });
+    }
+}
+
+TEST_F(FALLBACK, DEPTHWISE_POINTWISE_CONV_BIAS_INT8) {
+    Checker<DepthwisePointwiseConvBias> checker(handle());
+    UniformIntRNG int8_rng{-50, 50}, bias_rng{-1000, 1000};
+    // the scale of the channel-wise output is 2.4 / 0.2
+    checker.set_dtype(0, dtype::QuantizedS8(2.5f))
+            .set_dtype(1, dtype::QuantizedS8(0.1f))
+            .set_dtype(2, dtype::QuantizedS32(0.25f))
+            .set_dtype(3, dtype::QuantizedS8(0.2f))
+            .set_dtype(4, dtype::QuantizedS32(2.4f))
+            .set_dtype(5, dtype::QuantizedS8(100.f))
+            .set_rng(0, &int8_rng)
+            .set_rng(1, &int8_rng)
+            .set_rng(2, &bias_rng)
+            .set_rng(3, &int8_rng)
+            .set_rng(4, &bias_rng)
+            .set_epsilon(1);
+    for (auto mode : {NonlineMode::IDENTITY, NonlineMode::RELU, NonlineMode::H_SWISH}) {
+        for_each_param([&](Param param, size_t F) {
+            param.dw_nonline_mode = param.pw_nonline_mode = mode;
+            checker.set_param(param);
+            checker.execs(make_shapes(1, 3, 7, 9, 5, F));
+            checker.execs(make_shapes(2, 8, 16, 16, 16, F));
+            checker.execs(make_shapes(3, 13, 11, 23, 7, F));
+        });
+    }
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(FALLBACK, BENCHMARK_DEPTHWISE_POINTWISE_CONV_BIAS) {
+    constexpr size_t RUN = 20;
+    Benchmarker<ConvBias> benchmarker_conv(handle());
+    benchmarker_conv.set_times(RUN).set_display(false);
+    Benchmarker<DepthwisePointwiseConvBias> benchmarker_fused(handle());
+    benchmarker_fused.set_times(RUN).set_display(false);
+    auto run = [&](size_t N, size_t C, size_t H, size_t W, size_t OC, size_t F,
+                   uint32_t stride) {
+        ConvBias::Param dw_param;
+        dw_param.sparse = ConvBias::Param::Sparse::GROUP;
+        dw_param.stride_h = dw_param.stride_w = stride;
+        dw_param.pad_h = dw_param.pad_w = F / 2;
+        dw_param.nonlineMode = ConvBias::Param::NonlineMode::RELU;
+        size_t OH = (H + F / 2 * 2 - F) / stride + 1,
+               OW = (W + F / 2 * 2 - F) / stride + 1;
+        auto dw_used = benchmarker_conv.set_param(dw_param).execs(
+                               {{N, C, H, W},
+                                {C, 1, 1, F, F},
+                                {1, C, 1, 1},
+                                {},
+                                {}}) /
+                       RUN;
+        ConvBias::Param pw_param;
+        pw_param.nonlineMode = ConvBias::Param::NonlineMode::RELU;
+        auto pw_used = benchmarker_conv.set_param(pw_param).execs(
+                               {{N, C, OH, OW}, {OC, C, 1, 1}, {1, OC, 1, 1}, {}, {}}) /
+                       RUN;
+        Param param;
+        param.stride_h = param.stride_w = stride;
+        param.pad_h = param.pad_w = F / 2;
+        param.dw_nonline_mode = param.pw_nonline_mode = NonlineMode::RELU;
+        auto used = benchmarker_fused.set_param(param).execs(
+                            make_shapes(N, C, H, W, OC, F)) /
+                    RUN;
+        printf("N=%zu C=%zu H=%zu W=%zu OC=%zu F=%zu stride=%u: two convs %.3f ms, "
+               "fused %.3f ms (%.2fx)\n",
+               N, C, H, W, OC, F, stride, dw_used + pw_used, used,
+               (dw_used + pw_used) / used);
+    };
+    run(1, 32, 112, 112, 16, 3, 1);
+    run(1, 96, 112, 112, 24, 3, 2);
+    run(1, 144, 56, 56, 24, 3, 1);
+    run(1, 192, 28, 28, 64, 3, 1);
+    run(1, 384, 14, 14, 96, 3, 1);
+    run(1, 576, 14, 14, 160, 3, 2);
+    run(1, 960, 7, 7, 320, 3, 1);
+    run(8, 144, 56, 56, 24, 5, 1);
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
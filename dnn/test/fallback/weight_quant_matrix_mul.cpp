@@ -0,0 +1,88 @@
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+#include "test/fallback/fixture.h"
+
+namespace megdnn {
+namespace test {
+
+TEST_F(FALLBACK, WEIGHT_QUANT_MATRIX_MUL) {
+    Checker<WeightQuantMatrixMul> checker(handle());
+    UniformIntRNG weight_rng{-128, 127};
+    UniformFloatRNG scale_rng{0.001f, 0.02f};
+    checker.set_dtype(0, dtype::Float32())
+            .set_dtype(1, dtype::Int8())
+            .set_dtype(2, dtype::Float32())
+            .set_dtype(3, dtype::Float32())
+            .set_rng(1, &weight_rng)
+            .set_rng(2, &scale_rng)
+            .set_epsilon(1e-3);
+    WeightQuantMatrixMul::Param param;
+    for (uint32_t bits : {8, 4}) {
+        for (uint32_t group_size : {0, 16, 32, 128}) {
+            param.bits = bits;
+            param.group_size = group_size;
+            checker.set_param(param);
+            for (size_t m : {1, 3, 4, 7, 17}) {
+                for (size_t n : {1, 9, 33}) {
+                    for (size_t k : {128, 256, 384}) {
+                        size_t group = group_size ? group_size : k;
+                        checker.execs(
+                                {{m, k}, {n, k * bits / 8}, {n, k / group}, {}});
+                        checker.execs(
+                                {{2, m, k},
+                                 {2, n, k * bits / 8},
+                                 {2, n, k / group},
+                                 {}});
+                    }
+                }
+            }
+        }
+    }
+    // groups which are not a multiple of the vector length
+    param.bits = 8;
+    param.group_size = 6;
+    checker.set_param(param).execs({{5, 30}, {7, 30}, {7, 5}, {}});
+    param.bits = 4;
+    checker.set_param(param).execs({{5, 42}, {7, 21}, {7, 7}, {}});
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(FALLBACK, BENCHMARK_WEIGHT_QUANT_MATRIX_MUL) {
+    constexpr size_t RUN = 20;
+    Benchmarker<MatrixMul> benchmarker_float(handle());
+    benchmarker_float.set_times(RUN).set_display(false);
+    MatrixMul::Param float_param;
+    float_param.transposeB = true;
+    benchmarker_float.set_param(float_param);
+
+    Benchmarker<WeightQuantMatrixMul> benchmarker_quant(handle());
+    benchmarker_quant.set_times(RUN)
+            .set_display(false)
+            .set_dtype(1, dtype::Int8());
+    WeightQuantMatrixMul::Param param;
+    param.group_size = 128;
+    auto run = [&](size_t M, size_t N, size_t K) {
+        auto float_used = benchmarker_float.execs({{M, K}, {N, K}, {}}) / RUN;
+        printf("M=%zu N=%zu K=%zu float32: %.3f ms", M, N, K, float_used);
+        for (uint32_t bits : {8, 4}) {
+            param.bits = bits;
+            auto used = benchmarker_quant.set_param(param).execs(
+                                {{M, K}, {N, K * bits / 8}, {N, K / 128}, {}}) /
+                        RUN;
+            printf(", int%u: %.3f ms (%.2fx)", bits, used, float_used / used);
+        }
+        printf("\n");
+    };
+    for (size_t M : {1, 4, 16}) {
+        run(M, 4096, 4096);
+        run(M, 11008, 4096);
+        run(M, 4096, 11008);
+    }
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,61 @@
+#include "megdnn/dtype.h"
+#include "megdnn/oprs.h"
+#include "test/common/checker.h"
+#include "test/naive/fixture.h"
+
+namespace megdnn {
+namespace test {
+
+TEST_F(NAIVE, DEPTHWISE_POINTWISE_CONV_BIAS_FLOAT) {
+    Checker<DepthwisePointwiseConvBias> checker(handle(), false);
+    DepthwisePointwiseConvBias::Param param;
+    param.pad_h = param.pad_w = 1;
+    param.stride_h = param.stride_w = 2;
+    param.pw_nonline_mode = DepthwisePointwiseConvBias::Param::PwNonlineMode::RELU;
+    // the channel-wise sums of the windows are {12, 16, 24, 28}
+    checker.set_param(param).exect(
+            Testcase{
+                    TensorValue(
+                            {1, 1, 3, 3}, dtype::Float32(),
+                            {1, 2, 3, 4, 5, 6, 7, 8, 9}),
+                    TensorValue(
+                            {1, 1, 1, 3, 3}, dtype::Float32(),
+                            {1, 1, 1, 1, 1, 1, 1, 1, 1}),
+                    TensorValue({1, 1, 1, 1}, dtype::Float32(), {0}),
+                    TensorValue({1, 1, 1, 1}, dtype::Float32(), {0.5f}),
+                    TensorValue({1, 1, 1, 1}, dtype::Float32(), {-10}),
+                    {}},
+            Testcase{
+                    {},
+                    {},
+                    {},
+                    {},
+                    {},
+                    TensorValue({1, 1, 2, 2}, dtype::Float32(), {0, 0, 2, 4})});
+}
+
+TEST_F(NAIVE, DEPTHWISE_POINTWISE_CONV_BIAS_INT8) {
+    Checker<DepthwisePointwiseConvBias> checker(handle(), false);
+    // the channel-wise output is {11, -19} in a scale of 0.5 / 0.5, which the
+    // 1x1 conv maps to {23, -37}
+    checker.exect(
+            Testcase{
+                    TensorValue({1, 1, 1, 2}, dtype::QuantizedS8(0.5f), {10, -20}),
+                    TensorValue({1, 1, 1, 1, 1}, dtype::QuantizedS8(0.25f), {8}),
+                    TensorValue({1, 1, 1, 1}, dtype::QuantizedS32(0.125f), {8}),
+                    TensorValue({1, 1, 1, 1}, dtype::QuantizedS8(0.5f), {4}),
+                    TensorValue({1, 1, 1, 1}, dtype::QuantizedS32(0.5f), {2}),
+                    {}},
+            Testcase{
+                    {},
+                    {},
+                    {},
+                    {},
+                    {},
+                    TensorValue({1, 1, 1, 2}, dtype::QuantizedS8(4.f), {6, -9})});
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,46 @@
+#include "megdnn/dtype.h"
+#include "megdnn/oprs.h"
+#include "test/common/checker.h"
+#include "test/naive/fixture.h"
+
+namespace megdnn {
+namespace test {
+
+TEST_F(NAIVE, WEIGHT_QUANT_MATRIX_MUL_INT4_GROUP) {
+    Checker<WeightQuantMatrixMul> checker(handle(), false);
+    WeightQuantMatrixMul::Param param;
+    param.bits = 4;
+    param.group_size = 2;
+    // the weights are {{1, -2, 3, -8}, {7, 0, -1, 2}}, the first in the low bits
+    checker.set_param(param).exect(
+            Testcase{
+                    TensorValue({1, 4}, dtype::Float32(), {1, 2, 3, 4}),
+                    TensorValue({2, 2}, dtype::Int8(), {-31, -125, 7, 47}),
+                    TensorValue({2, 2}, dtype::Float32(), {0.5f, 2.f, 1.f, 0.25f}),
+                    {}},
+            Testcase{
+                    {},
+                    {},
+                    {},
+                    TensorValue({1, 2}, dtype::Float32(), {-47.5f, 8.25f})});
+}
+
+TEST_F(NAIVE, WEIGHT_QUANT_MATRIX_MUL_INT8_BATCHED) {
+    Checker<WeightQuantMatrixMul> checker(handle(), false);
+    checker.exect(
+            Testcase{
+                    TensorValue({2, 1, 2}, dtype::Float32(), {1, 2, 3, 4}),
+                    TensorValue({2, 1, 2}, dtype::Int8(), {-1, 2, 127, -128}),
+                    TensorValue({2, 1, 1}, dtype::Float32(), {0.5f, 0.25f}),
+                    {}},
+            Testcase{
+                    {},
+                    {},
+                    {},
+                    TensorValue({2, 1, 1}, dtype::Float32(), {1.5f, -32.75f})});
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
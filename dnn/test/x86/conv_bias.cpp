@@ -1294,6 +1294,44 @@ TEST_F(X86_MULTI_THREADS, CONV_BIAS_IM2COLMATMUL_FP32_6x16) {
     cb("IM2COLMATMUL:X86_F32_6x16:192");
 }
 
+#if !MEGDNN_DISABLE_FLOAT16
+//! bfloat16 is accumulated in float32 by the matmul, and the bias and the
+//! nonlinearity are applied to the rounded bfloat16 result
+TEST_F(X86_MULTI_THREADS, CONV_BIAS_IM2COLMATMUL_BF16_6x16) {
+    using namespace conv_bias;
+    Checker<ConvBias> checker(handle());
+    checker.set_before_exec_callback(
+            conv_bias::ConvBiasAlgoChecker<ConvBias>("IM2COLMATMUL:X86_BF16_6x16:192"));
+    NormalRNG default_rng;
+    checker.set_dtype(0, dtype::BFloat16())
+            .set_dtype(1, dtype::BFloat16())
+            .set_dtype(2, dtype::BFloat16())
+            .set_dtype(3, dtype::BFloat16())
+            .set_dtype(4, dtype::BFloat16())
+            .set_rng(0, &default_rng)
+            .set_rng(1, &default_rng)
+            .set_rng(2, &default_rng)
+            .set_epsilon(2e-2);
+    for (size_t kernel : {2, 3, 5})
+        for (size_t p : {0, 1})
+            for (NonlineMode nonline_mode :
+                 {NonlineMode::IDENTITY, NonlineMode::RELU, NonlineMode::SIGMOID}) {
+                param::ConvBias param;
+                param.pad_h = param.pad_w = p;
+                param.nonlineMode = nonline_mode;
+                param.compute_mode = param::ConvBias::ComputeMode::FLOAT32;
+                checker.set_param(param);
+                size_t oh = 12 + 2 * p - kernel + 1, ow = 14 + 2 * p - kernel + 1;
+                for (size_t oc : {1, 8, 20}) {
+                    TensorShape src{2, 8, 12, 14}, filter{oc, 8, kernel, kernel};
+                    checker.execs({src, filter, {}, {}, {}});
+                    checker.execs({src, filter, {1, oc, 1, 1}, {}, {}});
+                    checker.execs({src, filter, {2, oc, oh, ow}, {}, {}});
+                }
+            }
+}
+#endif
+
 #if MEGDNN_X86_WITH_MKL && SUPPORT_MKL_PACKED_GEMM
 TEST_F(X86_MULTI_THREADS, CONV_BIAS_IM2COLMATMUL_FP32_PACKA) {
     using namespace conv_bias;
@@ -107,6 +107,29 @@ TEST_F(X86, MATRIX_MUL_AVX2_6x16) {
             "X86_F32_6x16", param::MatrixMul::Format::DEFAULT, 1, 1e-3, false);
 }
 
+#if !MEGDNN_DISABLE_FLOAT16
+//! the naive matmul accumulates bfloat16 in float32 only with FLOAT32 compute
+//! mode, which is what the x86 kernels always do
+TEST_F(X86, MATRIX_MUL_AVX2_BF16_6x16) {
+    matrix_mul::check_matrix_mul(
+            dtype::BFloat16{}, dtype::BFloat16{}, dtype::BFloat16{}, handle(),
+            "X86_BF16_6x16", param::MatrixMul::Format::DEFAULT, 1, 1e-2, {}, true,
+            param::MatrixMul::ComputeMode::FLOAT32);
+}
+
+#if MEGDNN_X86_WITH_AVX512_BF16
+TEST_F(X86, MATRIX_MUL_AVX512_BF16_8X32) {
+    if (!is_supported(SIMDType::AVX512_BF16)) {
+        return;
+    }
+    matrix_mul::check_matrix_mul(
+            dtype::BFloat16{}, dtype::BFloat16{}, dtype::BFloat16{}, handle(),
+            "X86_BF16_AVX512_8X32", param::MatrixMul::Format::DEFAULT, 1, 1e-2, {},
+            true, param::MatrixMul::ComputeMode::FLOAT32);
+}
+#endif
+#endif
+
 #if MEGDNN_WITH_BENCHMARK
 
 TEST_F(X86, BENCHMARK_MATRIX_MUL_AVX2_MK8_8X8) {
@@ -7,6 +7,7 @@ from .core._imperative_rt.common import CompNode, DeviceType
 from .core._imperative_rt.common import get_device_prop as _get_device_prop
 from .core._imperative_rt.common import set_prealloc_config as _set_prealloc_config
 from .core._imperative_rt.common import what_is_xpu as _what_is_xpu
+from .core._imperative_rt.utils import _empty_blob_cache, _get_blob_cache_stats
 from .core._imperative_rt.utils import _try_coalesce_all_free_memory
 
 __all__ = [
@@ -22,6 +23,8 @@ __all__ = [
     "get_max_reserved_memory",
     "get_max_allocated_memory",
     "reset_max_memory_stats",
+    "get_blob_cache_stats",
+    "empty_blob_cache",
     "set_prealloc_config",
     "coalesce_free_memory",
     "DeviceType",
@@ -216,6 +219,33 @@ def reset_max_memory_stats(device: Optional[str] = None):
     CompNode.reset_max_memory_stats(device)
 
 
+def get_blob_cache_stats(device: Optional[str] = None) -> dict:
+    r"""Returns the statistics of the caching allocator for tensors on CPU devices.
+
+    The returned dict contains ``allocated`` and ``cached`` bytes, the size of the
+    ``largest_free`` cached block, ``fragmentation`` of the free cached memory, and
+    the counters ``nr_alloc``, ``nr_segment_alloc`` and ``nr_defrag``. The caching
+    allocator is enabled by setting environment variable
+    ``MEGENGINE_CPU_BLOB_CACHE=1`` before megengine is imported; otherwise, and for
+    devices other than CPU, all the values except ``nr_defrag`` are zero.
+
+    Due to the asynchronous execution of MegEngine, please call megengine._full_sync
+    before calling this function in order to get accurate value.
+    """
+    if device is None:
+        device = get_default_device()
+    return _get_blob_cache_stats(CompNode(device))
+
+
+def empty_blob_cache(device: Optional[str] = None):
+    r"""Releases the memory cached by the caching allocator for tensors on the
+    device, except those still in use.
+    """
+    if device is None:
+        device = get_default_device()
+    _empty_blob_cache(CompNode(device))
+
+
 set_default_device(os.getenv("MGE_DEFAULT_DEVICE", "xpux"))
 
 
@@ -2,6 +2,8 @@
 import collections
 import contextlib
 import functools
+import hashlib
+import inspect
 import itertools
 import json
 import os
@@ -34,6 +36,7 @@ from ..logger import get_logger
 from ..utils import comp_graph_tools as cgtools
 from ..utils.naming import AutoNaming
 from ..utils.profiler import is_profiling
+from ..version import __version__, git_version
 from .dtr_config import DTRConfig
 from .graph_opt_config import GraphOptimizationConfig
 from .sublinear_memory_config import SublinearMemoryConfig
@@ -94,6 +97,12 @@ class trace:
         opt_level: optimization level for compiling trace. Default: 2
         graph_opt_config: configuration for graph optimization. Default: None
         symbolic_shape: whether to use symbolic shape for tracing. Default: True
+        cache_dir: directory to keep trace results across processes, so the first
+            call of a new process runs the compiled trace directly. Entries are keyed
+            by the source of the function, MegEngine version, trace options and
+            input shapes, and a stale entry is retraced on mismatch. Not used with
+            ``capture_as_const`` or ``profiling``. Default: None, which uses the
+            ``MEGENGINE_TRACE_CACHE_DIR`` environment variable if it is set
     """
 
     def __new__(cls, *args, **kwargs):
@@ -113,6 +122,7 @@ class trace:
         opt_level: int = 2,
         graph_opt_config: GraphOptimizationConfig = None,
         symbolic_shape: bool = True,
+        cache_dir: str = None,
     ):
         self.__wrapped__ = function
         self._capture_as_const = capture_as_const or record_only
@@ -178,16 +188,109 @@ class trace:
                     suboptions = getattr(suboptions, word)
                 setattr(suboptions, words[-1], v)
 
-        self._trace = Trace()
-        self._trace.symbolic = symbolic or record_only
-        self._trace.capture_as_const = capture_as_const or record_only
-        self._trace.no_exec = record_only
-        self._trace.options_visitor = apply_options
-        self._trace.profile = profiling
-        self._trace.array_comparator = array_comparator
-        self._trace.record_input_shapes = _input_node_use_static_shape()
+        def make_trace():
+            trace = Trace()
+            trace.symbolic = symbolic or record_only
+            trace.capture_as_const = capture_as_const or record_only
+            trace.no_exec = record_only
+            trace.options_visitor = apply_options
+            trace.graph_options_key = repr(sorted(graph_options.items()))
+            trace.profile = profiling
+            trace.array_comparator = array_comparator
+            trace.record_input_shapes = _input_node_use_static_shape()
+            return trace
+
+        self._make_trace = make_trace
+        self._trace = make_trace()
+
+        # captured constants may change across processes, so they are not cached
+        self._trace_cache_dir = None
+        if not (self._capture_as_const or profiling):
+            self._trace_cache_dir = cache_dir or os.getenv("MEGENGINE_TRACE_CACHE_DIR")
+        self._trace_cache_file = None
 
     def __call__(self, *args, **kwargs):
+        if self._trace_cache_dir is None or self._trace_cache_file is not None:
+            return self._call(*args, **kwargs)
+        self._trace_cache_file = self._get_trace_cache_file(args, kwargs)
+        if self._load_trace_cache():
+            try:
+                return self._call(*args, **kwargs)
+            except TraceError as exc:
+                logger.warning(
+                    "cached trace {} is outdated, retracing: {}".format(
+                        self._trace_cache_file, exc
+                    )
+                )
+                self._trace = self._make_trace()
+        outputs = self._call(*args, **kwargs)
+        self._save_trace_cache()
+        return outputs
+
+    def _get_trace_cache_file(self, args, kwargs):
+        func = self.__wrapped__
+        try:
+            source = inspect.getsource(func)
+        except (OSError, TypeError):
+            source = None
+
+        def spec(value):
+            if isinstance(value, RawTensor):
+                shape, dtype, device = value._tuple_shape, value.dtype, value.device
+                return "Tensor", shape, str(dtype), str(device)
+            if isinstance(value, (list, tuple)):
+                return type(value).__name__, [spec(i) for i in value]
+            if isinstance(value, collections.abc.Mapping):
+                return sorted((k, spec(v)) for k, v in value.items())
+            return repr(value)
+
+        key = (
+            __version__,
+            git_version,
+            getattr(func, "__module__", None),
+            getattr(func, "__qualname__", None),
+            source,
+            self._trace.symbolic,
+            self._trace.record_input_shapes,
+            self._symbolic_shape,
+            sorted(self._graph_options.items()),
+            spec(args),
+            spec(kwargs),
+        )
+        digest = hashlib.sha256(repr(key).encode()).hexdigest()
+        return os.path.join(self._trace_cache_dir, digest + ".trace")
+
+    def _load_trace_cache(self):
+        try:
+            with open(self._trace_cache_file, "rb") as f:
+                state = pickle.load(f)
+        except FileNotFoundError:
+            return False
+        except Exception as exc:
+            logger.warning(
+                "failed to load trace cache {}: {}".format(self._trace_cache_file, exc)
+            )
+            return False
+        self._trace.set_state(state)
+        return True
+
+    def _save_trace_cache(self):
+        state = self._trace.get_state()
+        if state is None:
+            return
+        try:
+            data = pickle.dumps(state)
+        except Exception as exc:
+            logger.debug("trace result can not be cached: {}".format(exc))
+            return
+        os.makedirs(self._trace_cache_dir, exist_ok=True)
+        # other processes may read the cache at the same time
+        tmp_file = "{}.{}.tmp".format(self._trace_cache_file, os.getpid())
+        with open(tmp_file, "wb") as f:
+            f.write(data)
+        os.replace(tmp_file, self._trace_cache_file)
+
+    def _call(self, *args, **kwargs):
         global active_trace
         symbolic_shape = None
         outputs = None
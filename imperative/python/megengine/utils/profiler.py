@@ -11,12 +11,16 @@ from .. import _atexit
 from ..core._imperative_rt.core2 import (
     cupti_available,
     disable_cupti,
+    dump_sampling_profile,
     enable_cupti,
     full_sync,
+    get_sampling_profile,
     pop_scope,
     push_scope,
     start_profile,
+    start_sampling_profile,
     stop_profile,
+    stop_sampling_profile,
     sync,
 )
 from ..logger import get_logger
@@ -240,6 +244,71 @@ def merge_trace_events(directory: str):
     get_logger().info("profiling results written to {}".format(path))
 
 
+class SamplingProfiler:
+    r"""Low overhead profiler of op latencies, which can be kept on in production.
+
+    Only a part of the ops is sampled: one in every ``interval`` ops, or all the
+    ops in bursts of ``burst_ms`` milliseconds every ``burst_period_ms``
+    milliseconds. Latencies are aggregated into per-op histograms, which can be
+    read at any time without stopping the profiler.
+
+    Args:
+        interval: sample one op in every ``interval`` ops. Default: 100
+        burst_period_ms: period of sampling bursts, 0 to disable bursts. Default: 0
+        burst_ms: length of sampling bursts. Default: 0
+        profile_device: also measure device time with timer events. Default: False
+        ring_size: number of latest samples kept. Default: 4096
+
+    Examples:
+
+        .. code-block::
+
+           from megengine.utils.profiler import SamplingProfiler
+
+           profiler = SamplingProfiler(interval=1000)
+           profiler.start()
+           # run the model
+           profiler.dump("/var/lib/node_exporter/megengine.prom", "prometheus")
+    """
+
+    def __init__(
+        self,
+        interval: int = 100,
+        burst_period_ms: int = 0,
+        burst_ms: int = 0,
+        profile_device: bool = False,
+        ring_size: int = 4096,
+    ):
+        assert interval > 0, "interval should be positive"
+        assert burst_ms <= burst_period_ms, "burst_ms exceeds burst_period_ms"
+        self._config = (interval, burst_period_ms, burst_ms, profile_device, ring_size)
+
+    def start(self):
+        r"""Start sampling with empty histograms."""
+        start_sampling_profile(*self._config)
+
+    def stop(self):
+        r"""Stop sampling; the collected histograms remain readable."""
+        stop_sampling_profile()
+
+    def get(self, format: str = "json"):
+        r"""Return the histograms as a dict for ``"json"``, or as a string of
+        prometheus text exposition format for ``"prometheus"``."""
+        content = get_sampling_profile(format)
+        return json.loads(content) if format == "json" else content
+
+    def dump(self, path: str, format: str = "json"):
+        r"""Write the histograms to ``path``; the file is replaced atomically."""
+        dump_sampling_profile(path, format)
+
+    def __enter__(self):
+        self.start()
+        return self
+
+    def __exit__(self, val, tp, trace):
+        self.stop()
+
+
 def is_profiling():
     return _running_profiler is not None
 
@@ -495,7 +495,8 @@ void init_graph_rt(py::module m) {
 
     py::class_<cg::ComputingGraph::Options::SeqOpt>(PyComputingGraphOptions, "SeqOpt")
             DEF_READWRITE(enable_mem_plan_opt) DEF_READWRITE(enable_mem_reuse_alloc)
-                    DEF_READWRITE(enable_seq_comp_node_opt);
+                    DEF_READWRITE(enable_seq_comp_node_opt)
+                            DEF_READWRITE(enable_incremental_mem_plan);
 
 #undef CURRENT_CLASS
 #define CURRENT_CLASS cg::ComputingGraph::Options::GraphOpt
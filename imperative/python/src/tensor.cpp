@@ -5,6 +5,7 @@
 #include "megbrain/imperative/ops/backward_graph.h"
 #include "megbrain/imperative/ops/utility.h"
 #include "megbrain/imperative/profiler.h"
+#include "megbrain/imperative/sampling_profiler.h"
 #include "megbrain/imperative/transformations/dim_expansion.h"
 #include "megbrain/imperative/transformations/dtype_promote.h"
 #include "megbrain/imperative/transformations/eval.h"
@@ -891,6 +892,7 @@ void init_tensor(py::module m) {
     });
     m.def("get_option",
           [channel](std::string name) { return channel->get_option(name); });
+    m.def("get_stat", [channel](std::string name) { return channel->get_stat(name); });
     m.def("push_scope", [channel](std::string name) {
         Transformation::push_scope(name);
         channel->push_scope(name);
@@ -917,6 +919,23 @@ void init_tensor(py::module m) {
             results = nullptr;
         };
     });
+    m.def("start_sampling_profile",
+          [](size_t interval, size_t burst_period_ms, size_t burst_ms,
+             bool profile_device, size_t ring_size) {
+              imperative::SamplingProfiler::enable(
+                      {interval, burst_period_ms, burst_ms, profile_device,
+                       ring_size});
+          });
+    m.def("stop_sampling_profile", &imperative::SamplingProfiler::disable);
+    m.def("get_sampling_profile", [](std::string format) {
+        if (format == "prometheus") {
+            return imperative::SamplingProfiler::to_prometheus();
+        }
+        mgb_assert(format == "json", "unknown sampling profile format: %s",
+                   format.c_str());
+        return imperative::SamplingProfiler::to_json()->to_string();
+    });
+    m.def("dump_sampling_profile", &imperative::SamplingProfiler::dump);
     m.def("enable_cupti", &cupti::enable);
     m.def("disable_cupti", &cupti::disable);
     m.def("cupti_available", &cupti::available);
@@ -982,6 +1001,8 @@ void init_tensor(py::module m) {
         bool profile = false;
         bool record_input_shapes = false;
         py::function options_visitor;
+        //! identifies the options set by options_visitor for graph cache
+        std::string graph_options_key;
         std::shared_ptr<TracingTransformation> tracing;
         std::shared_ptr<CompiledTransformation> compiled;
         std::shared_ptr<LazyEvalTransformation> lazy_eval;
@@ -1019,6 +1040,9 @@ void init_tensor(py::module m) {
                     self.lazy_eval =
                             std::make_shared<LazyEvalTransformation>(self.no_exec);
                     self.options_visitor(py::cast(&self.lazy_eval->options()));
+                    if (!self.graph_options_key.empty()) {
+                        self.lazy_eval->enable_graph_cache(self.graph_options_key);
+                    }
                 }
             } else if (!self.compiled) {  // traced but not compiled
                 using namespace std::placeholders;
@@ -1139,9 +1163,91 @@ void init_tensor(py::module m) {
             .def_readwrite("capture_as_const", &Trace::capture_as_const)
             .def_readwrite("no_exec", &Trace::no_exec)
             .def_readwrite("options_visitor", &Trace::options_visitor)
+            .def_readwrite("graph_options_key", &Trace::graph_options_key)
             .def("enter", &Trace::enter)
             .def("exit", &Trace::exit)
             .def("dump", &Trace::dump)
+            .def("get_state",
+                 [](Trace& self) -> py::object {
+                     if (!self.trace_result) {
+                         return py::none();
+                     }
+                     py::list seq, vars;
+                     for (auto&& [op, inputs, outputs] : self.trace_result->seq) {
+                         seq.append(py::make_tuple(
+                                 op ? py::cast(op) : py::object(py::none()),
+                                 py::cast(inputs),
+                                 py::cast(outputs)));
+                     }
+                     for (auto&& var : self.trace_result->vars) {
+                         py::object data = py::none();
+                         if (var.bound_data) {
+                             auto&& host = var.bound_data.as_ref<HostValue>();
+                             auto value = host ? host->as_nd()
+                                               : var.bound_data.numpy()->as_nd();
+                             data = py::reinterpret_steal<py::object>(
+                                     npy::ndarray_from_tensor(
+                                             value, npy::ShareType::MUST_UNSHARE));
+                         }
+                         py::object shape = py::none();
+                         if (var.shape.ndim) {
+                             shape = py::cast(var.shape);
+                         }
+                         vars.append(py::make_tuple(
+                                 var.id, py::cast(static_cast<DType>(*var.dtype)),
+                                 var.device->to_string_logical(), data, var.mark,
+                                 var.name, static_cast<int>(var.kind),
+                                 var.value_required, var.data_required,
+                                 var.shape_required, shape));
+                     }
+                     return py::make_tuple(seq, vars);
+                 })
+            .def("set_state",
+                 [](Trace& self, py::tuple state) {
+                     mgb_assert(
+                             !self.trace_result && !self.tracing && !self.compiled,
+                             "trace state can only be set before tracing");
+                     TraceResult result;
+                     for (auto&& item : state[0].cast<py::list>()) {
+                         auto item_tuple = item.cast<py::tuple>();
+                         std::shared_ptr<OpDef> op;
+                         if (!item_tuple[0].is_none()) {
+                             op = item_tuple[0].cast<std::shared_ptr<OpDef>>();
+                         }
+                         result.seq.push_back(
+                                 {op, item_tuple[1].cast<SmallVector<size_t>>(),
+                                  item_tuple[2].cast<SmallVector<size_t>>()});
+                     }
+                     for (auto&& item : state[1].cast<py::list>()) {
+                         auto var_tuple = item.cast<py::tuple>();
+                         TraceResult::VarInfo var;
+                         var.id = var_tuple[0].cast<size_t>();
+                         auto dtype = var_tuple[1].cast<DType>();
+                         auto device = CompNode::load(var_tuple[2].cast<std::string>());
+                         var.dtype = DTypeValue::make(dtype);
+                         var.device = CompNodeValue::make(device);
+                         if (!var_tuple[3].is_none()) {
+                             // kept on host, see CompiledTransformation::compile
+                             HostTensorND value(device);
+                             value = npy::np2tensor(
+                                     var_tuple[3].ptr(), npy::Meth::copy_into(&value),
+                                     dtype);
+                             var.bound_data = HostValue::make(value);
+                         }
+                         var.mark = var_tuple[4].cast<std::string>();
+                         var.name = var_tuple[5].cast<std::string>();
+                         var.kind = static_cast<TraceResult::VarKind>(
+                                 var_tuple[6].cast<int>());
+                         var.value_required = var_tuple[7].cast<bool>();
+                         var.data_required = var_tuple[8].cast<bool>();
+                         var.shape_required = var_tuple[9].cast<bool>();
+                         if (!var_tuple[10].is_none()) {
+                             var.shape = var_tuple[10].cast<TensorShape>();
+                         }
+                         result.vars.push_back(std::move(var));
+                     }
+                     self.trace_result = std::move(result);
+                 })
             .def("begin_excluded_region",
                  [](Trace& self) {
                      mgb_assert(bool(self.tracing) ^ bool(self.compiled));
@@ -1287,6 +1393,11 @@ void init_tensor(py::module m) {
 
     m.def("reset_stats", [] { Stats::reset(); });
 
+    m.def("_get_lazy_eval_graph_cache_stats", [] {
+        auto stats = LazyEvalTransformation::graph_cache_stats();
+        return py::make_tuple(stats.nr_hit, stats.nr_miss);
+    });
+
     m.def("_get_convert_inputs",
           []() -> bool { return DTypePromoteCfg::convert_input_enabled; });
     m.def("_set_convert_inputs", [](bool flag) -> bool {
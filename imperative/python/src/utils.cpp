@@ -205,6 +205,22 @@ void init_utils(py::module m) {
     m.def("create_mm_server", []() {});
 #endif
 
+    m.def("_get_blob_cache_stats", [](const mgb::CompNode& cn) {
+        auto stats = mgb::imperative::BlobManager::inst()->get_cache_stats(cn);
+        py::dict ret;
+        ret["allocated"] = stats.allocated;
+        ret["cached"] = stats.cached;
+        ret["largest_free"] = stats.largest_free;
+        ret["fragmentation"] = stats.fragmentation();
+        ret["nr_alloc"] = stats.nr_alloc;
+        ret["nr_segment_alloc"] = stats.nr_segment_alloc;
+        ret["nr_defrag"] = stats.nr_defrag;
+        return ret;
+    });
+    m.def("_empty_blob_cache", [](const mgb::CompNode& cn) {
+        mgb::imperative::BlobManager::inst()->empty_cache(cn);
+    });
+
     // Debug code, internal only
     m.def("_defrag", [](const mgb::CompNode& cn) {
         mgb::imperative::BlobManager::inst()->defrag(cn);
@@ -135,3 +135,80 @@ def test_dtr_resnet1202():
     p.start()
     p.join()
     assert p.exitcode == 0
+
+
+def run_dtr_dropout():
+    mge.dtr.eviction_threshold = "1KB"
+    mge.dtr.enable()
+    x = mge.tensor(np.ones((1024, 1024), dtype=np.float32))
+    y = F.dropout(x, 0.5)
+    mask = y.numpy() == 0
+    # the other tensors go over the threshold and evict the evictable ones
+    for i in range(8):
+        F.exp(y * i).numpy()
+    # dropout draws from an rng, so its output must be kept rather than
+    # recomputed with another mask
+    np.testing.assert_array_equal(y.numpy() == 0, mask)
+    mge.dtr.disable()
+    mge._exit(0)
+
+
+@pytest.mark.require_ngpu(1)
+@pytest.mark.isolated_distributed
+def test_dtr_dropout():
+    p = mp.Process(target=run_dtr_dropout)
+    p.start()
+    p.join()
+    assert p.exitcode == 0
+
+
+def run_dtr_eviction_index():
+    from megengine.core import set_option
+    from megengine.core._imperative_rt.core2 import get_stat
+
+    rng = np.random.RandomState(0)
+    data = rng.randn(1024, 1024).astype("float32")
+    weights = [rng.randn(1024, 1024).astype("float32") * 0.03 for _ in range(16)]
+
+    def train_step():
+        x = mge.tensor(data)
+        ws = [mge.Parameter(w) for w in weights]
+        gm = GradManager().attach(ws)
+        with gm:
+            h = x
+            for w in ws:
+                h = F.relu(F.matmul(h, w))
+            loss = (h ** 2).mean()
+            gm.backward(loss)
+        return loss.numpy(), [w.grad.numpy() for w in ws]
+
+    # each activation takes 4MB, so the 16 layers go far over the threshold
+    mge.dtr.eviction_threshold = "32MB"
+    mge.dtr.enable()
+    results, evicts = [], []
+    for index in [0, 1]:
+        set_option("enable_dtr_eviction_index", index)
+        nr_evict = get_stat("nr_dtr_evict")
+        results.append(train_step())
+        evicts.append(get_stat("nr_dtr_evict") - nr_evict)
+    mge.dtr.disable()
+    set_option("enable_dtr_eviction_index", 0)
+
+    (loss_scan, grads_scan), (loss_index, grads_index) = results
+    np.testing.assert_allclose(loss_index, loss_scan, rtol=1e-5)
+    for g_index, g_scan in zip(grads_index, grads_scan):
+        np.testing.assert_allclose(g_index, g_scan, rtol=1e-5, atol=1e-6)
+    # both ways evict, and the index does not pick much worse tensors than
+    # the full scan, which would make it evict and recompute far more often
+    assert evicts[0] > 0 and evicts[1] > 0
+    assert evicts[1] <= 2 * evicts[0] + 16
+    mge._exit(0)
+
+
+@pytest.mark.require_ngpu(1)
+@pytest.mark.isolated_distributed
+def test_dtr_eviction_index():
+    p = mp.Process(target=run_dtr_eviction_index)
+    p.start()
+    p.join()
+    assert p.exitcode == 0
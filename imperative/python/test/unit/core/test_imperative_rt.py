@@ -1,4 +1,8 @@
 # -*- coding: utf-8 -*-
+import os
+import subprocess
+import sys
+
 import numpy as np
 import pytest
 
@@ -71,3 +75,42 @@ def test_opdef_path():
     assert Mode.__module__ == "megengine.core._imperative_rt.ops"
     assert Mode.__name__ == "Mode"
     assert Mode.__qualname__ == "Elemwise.Mode"
+
+
+def test_blob_cache_stats():
+    # the caching allocator is opt-in, and the env is read when the blob manager
+    # is created, so run in a fresh process
+    prog = """
+import numpy as np
+import megengine
+from megengine.device import empty_blob_cache, get_blob_cache_stats
+from megengine.tensor import Tensor
+
+nbytes = 256 * 256 * 4
+x = Tensor(np.ones((256, 256), dtype="float32"), device="cpu0")
+np.testing.assert_equal((x + 1).numpy(), 2)
+megengine._full_sync()
+stats = get_blob_cache_stats("cpu0")
+assert stats["cached"] >= stats["allocated"] >= nbytes
+assert 0 <= stats["fragmentation"] <= 1
+nr_segment_alloc = stats["nr_segment_alloc"]
+
+# freed storage is reused without asking the system allocator
+for _ in range(10):
+    np.testing.assert_equal((x * 2).numpy(), 2)
+megengine._full_sync()
+assert get_blob_cache_stats("cpu0")["nr_segment_alloc"] == nr_segment_alloc
+
+# the storage is returned to the cache by the comp node after a sync
+allocated = get_blob_cache_stats("cpu0")["allocated"]
+del x
+megengine._full_sync()
+stats = get_blob_cache_stats("cpu0")
+assert stats["allocated"] <= allocated - nbytes
+cached = stats["cached"]
+empty_blob_cache("cpu0")
+stats = get_blob_cache_stats("cpu0")
+assert stats["allocated"] <= stats["cached"] <= cached
+"""
+    env = dict(os.environ, MEGENGINE_CPU_BLOB_CACHE="1")
+    subprocess.check_call([sys.executable, "-c", prog], env=env)
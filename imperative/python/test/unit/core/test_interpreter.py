@@ -6,8 +6,8 @@ import pytest
 
 import megengine as mge
 import megengine.functional as F
-from megengine.core import set_option
-from megengine.core._imperative_rt.core2 import AsyncError
+from megengine.core import get_option, set_option
+from megengine.core._imperative_rt.core2 import AsyncError, get_stat
 
 
 def test_basic():
@@ -73,6 +73,85 @@ def test_drop_basic():
     set_option("enable_drop", False)
 
 
+def test_eager_fusion():
+    set_option("enable_eager_fusion", 1)
+    try:
+        a = np.random.rand(4, 5).astype("float32")
+        b = np.random.rand(4, 5).astype("float32")
+        x, y = mge.tensor(a), mge.tensor(b)
+        for _ in range(3):
+            nr_fused = get_stat("nr_fused_ops")
+            # intermediates are released by rebinding, so the chain can be fused
+            z = x * y
+            z = z + x
+            z = F.exp(-z)
+            z = F.sum(z, axis=1)
+            np.testing.assert_allclose(
+                z.numpy(), np.exp(-(a * b + a)).sum(axis=1), rtol=1e-5
+            )
+            assert get_stat("nr_fused_ops") - nr_fused == 5
+        # buffered ops are flushed by a sync without reading any value
+        nr_fused = get_stat("nr_fused_ops")
+        z = x * y
+        z = z + x
+        mge._full_sync()
+        assert get_stat("nr_fused_ops") - nr_fused == 2
+        np.testing.assert_allclose(z.numpy(), a * b + a, rtol=1e-5)
+    finally:
+        set_option("enable_eager_fusion", 0)
+
+
+def test_parallel_apply():
+    set_option("enable_parallel_apply", 1)
+    a = np.random.rand(16, 16).astype("float32")
+    x = mge.tensor(a, device="cpu0")
+    nr_run = get_stat("nr_parallel_apply")
+    # independent branches run in the pool, joined by a dependent op
+    branches = [F.exp(x * i) for i in range(8)]
+    y = F.sum(F.stack(branches), axis=0)
+    expect = sum(np.exp(a * i) for i in range(8))
+    np.testing.assert_allclose(y.numpy(), expect, rtol=1e-5)
+    assert get_stat("nr_parallel_apply") - nr_run >= 8
+    # ops drawing from an rng keep their order and run on the worker
+    nr_run = get_stat("nr_parallel_apply")
+    F.dropout(x, 0.5).numpy()
+    assert get_stat("nr_parallel_apply") == nr_run
+    # tensors in use by ops in flight can be deleted
+    z = F.matmul(branches[0], branches[1])
+    del branches
+    np.testing.assert_allclose(
+        z.numpy(), np.exp(a * 0) @ np.exp(a * 1), rtol=1e-5
+    )
+    set_option("enable_parallel_apply", 0)
+
+
+def test_parallel_apply_large_outputs():
+    from megengine.core._imperative_rt.utils import Logger
+
+    old_workers = get_option("parallel_apply_workers")
+    set_option("enable_parallel_apply", 1)
+    set_option("parallel_apply_workers", 4)
+    old_level = Logger.set_log_level(Logger.LogLevel.Warn)
+    try:
+        a = np.random.rand(1024, 1024).astype("float32")
+        x = mge.tensor(a, device="cpu0")
+        nr_run = get_stat("nr_parallel_apply")
+        # many large outputs are allocated by the workers at the same time
+        for _ in range(4):
+            branches = [x * i + i for i in range(16)]
+            values = [b.numpy() for b in branches]
+            del branches
+            for i, v in enumerate(values):
+                np.testing.assert_allclose(v, a * i + i, rtol=1e-6)
+        assert get_stat("nr_parallel_apply") - nr_run >= 64
+        # the workers must not leave the log level changed
+        assert Logger.set_log_level(old_level) == Logger.LogLevel.Warn
+    finally:
+        Logger.set_log_level(old_level)
+        set_option("parallel_apply_workers", old_workers)
+        set_option("enable_parallel_apply", 0)
+
+
 def test_finalize():
     prog = """
 import megengine
@@ -8,12 +8,14 @@ from tempfile import mkstemp
 import numpy as np
 import pytest
 
+import megengine as mge
 import megengine.core.tensor.megbrain_graph as G
 import megengine.functional as F
 import megengine.optimizer as optim
 import megengine.utils.comp_graph_tools as cgtools
 from megengine import Parameter, tensor
 from megengine.autodiff import GradManager
+from megengine.core._imperative_rt.core2 import _get_lazy_eval_graph_cache_stats
 from megengine.core.ops import builtin as ops
 from megengine.core.ops.builtin import Elemwise
 from megengine.core.tensor.utils import isscalar
@@ -101,6 +103,44 @@ def test_tensor_detach(trace_mode):
         f(x).numpy()
 
 
+def test_lazy_eval_graph_cache():
+    def make_trace(c):
+        # a new trace records the graph again, which may be compiled already
+        @trace(symbolic=True)
+        def f(x, y):
+            return (x * c + y).sum()
+
+        return f
+
+    nr_hit, nr_miss = _get_lazy_eval_graph_cache_stats()
+    for c in [2, 2, 3, 2]:
+        for shape in [(4,), (4,), (2, 3)]:
+            x = np.random.randn(*shape).astype("float32")
+            y = np.random.randn(*shape).astype("float32")
+            z = make_trace(c)(tensor(x), tensor(y))
+            np.testing.assert_allclose(z.numpy(), (x * c + y).sum(), rtol=1e-5)
+    # only the first run of each (c, shape) pair compiles a graph
+    new_hit, new_miss = _get_lazy_eval_graph_cache_stats()
+    assert new_miss - nr_miss == 4
+    assert new_hit - nr_hit == 8
+
+
+@pytest.mark.require_ngpu(1)
+def test_lazy_eval_graph_cache_memory():
+    @trace(symbolic=True)
+    def f(x):
+        return (F.exp(x) * 2 + 1).sum()
+
+    x = tensor(np.random.randn(1024, 1024).astype("float32"), device="gpu0")
+    mge._full_sync()
+    baseline = mge.device.get_allocated_memory("gpu0")
+    f(x).numpy()
+    del f
+    mge._full_sync()
+    # the graph stays in the cache, but its activations are freed
+    assert mge.device.get_allocated_memory("gpu0") <= baseline
+
+
 @pytest.mark.parametrize("trace_mode", [False, True])
 def test_exclude_from_trace(trace_mode):
     @trace(symbolic=trace_mode)
@@ -312,6 +352,38 @@ def test_trace_profiler(trace_mode):
     assert out.get("profiler")
 
 
+@pytest.mark.parametrize("trace_mode", [False, True])
+def test_trace_cache(trace_mode, tmp_path):
+    flag = [False]
+
+    def f(x):
+        return F.exp(x * 2) + 1 if flag[0] else -x
+
+    def run(x, expect):
+        traced = trace(f, symbolic=trace_mode, cache_dir=str(tmp_path))
+        for _ in range(3):
+            np.testing.assert_allclose(traced(x).numpy(), expect, rtol=1e-6)
+        return traced
+
+    a = np.random.rand(3, 4).astype("float32")
+    run(tensor(a), -a)
+    assert len(list(tmp_path.glob("*.trace"))) == 1
+
+    # a new trace, as in a restarted process, compiles the cached result at once
+    traced = trace(f, symbolic=trace_mode, cache_dir=str(tmp_path))
+    np.testing.assert_allclose(traced(tensor(a)).numpy(), -a)
+    assert traced._trace.options is not None
+
+    # other input shapes use other entries
+    b = np.random.rand(5).astype("float32")
+    run(tensor(b), -b)
+    assert len(list(tmp_path.glob("*.trace"))) == 2
+
+    # an outdated entry is retraced
+    flag[0] = True
+    run(tensor(a), np.exp(a * 2) + 1)
+
+
 def test_goptions():
     @trace(symbolic=True, opt_level=0, capture_as_const=True)
     def f(x):
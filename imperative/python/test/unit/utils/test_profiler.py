@@ -10,7 +10,7 @@ from megengine import distributed as dist
 from megengine import tensor
 from megengine.jit import trace
 from megengine.module import Module
-from megengine.utils.profiler import Profiler, scope
+from megengine.utils.profiler import Profiler, SamplingProfiler, scope
 
 
 class Simple(Module):
@@ -97,3 +97,25 @@ def test_profiler_dist(format, trace_mode):
 
     assert os.path.exists(profile_path), "profiling results not found"
     assert len(os.listdir(tempdir.name)) == n_gpus + 1
+
+
+def test_sampling_profiler(tmp_path):
+    x = tensor([1.23], dtype="float32")
+    with SamplingProfiler(interval=1) as profiler:
+        for _ in range(10):
+            x = x * 2
+        x.numpy()
+    result = profiler.get()
+    assert not result["enabled"]
+    host = result["ops"]["Elemwise"]["host"]
+    assert host["count"] >= 10
+    assert sum(host["buckets"]) == host["count"]
+    assert host["p50_us"] <= host["p99_us"]
+    assert len(result["recent"]) >= 10
+
+    path = str(tmp_path / "megengine.prom")
+    profiler.dump(path, "prometheus")
+    with open(path, "r") as f:
+        text = f.read()
+    assert text == profiler.get("prometheus")
+    assert 'megengine_op_host_latency_seconds_count{op="Elemwise"}' in text
@@ -17,6 +17,23 @@ BlobManagerImpl::BlobData::BlobData(OwnedBlob* in_blob) {
     h_storage.copy_from(const_cast<DeviceTensorStorage&>(d_storage), blob->m_size);
 }
 
+BlobManagerImpl::BlobManagerImpl() {
+    auto env = MGB_GETENV("MEGENGINE_CPU_BLOB_CACHE");
+    if (env && std::string(env) == "1") {
+        m_caching_allocator = std::make_unique<CachingBlobAllocator>();
+    }
+}
+
+DeviceTensorStorage::RawStorage BlobManagerImpl::alloc_storage(
+        CompNode cn, size_t size) {
+    if (m_caching_allocator && CachingBlobAllocator::is_supported(cn)) {
+        return m_caching_allocator->alloc(cn, size);
+    }
+    DeviceTensorStorage storage(cn);
+    storage.ensure_size(size);
+    return storage.raw_storage();
+}
+
 void BlobManagerImpl::register_blob(OwnedBlob* blob) {
     // add blob into the comp2blobs map
     MGB_LOCK_GUARD(m_mtx);
@@ -45,10 +62,8 @@ void BlobManagerImpl::alloc_with_defrag(OwnedBlob* blob, size_t size) {
 }
 
 void BlobManagerImpl::alloc_direct(OwnedBlob* blob, size_t size) {
-    DeviceTensorStorage storage(blob->m_comp_node);
     mgb_assert(blob->m_comp_node.valid());
-    storage.ensure_size(size);
-    blob->m_storage = storage.raw_storage();
+    blob->m_storage = alloc_storage(blob->m_comp_node, size);
 }
 
 DeviceTensorND BlobManagerImpl::alloc_workspace_with_defrag(
@@ -72,7 +87,12 @@ DeviceTensorND BlobManagerImpl::alloc_workspace_with_defrag(
 
 DeviceTensorND BlobManagerImpl::alloc_workspace(CompNode cn, TensorLayout layout) {
     DeviceTensorStorage storage(cn);
-    storage.ensure_size(layout.dtype.size(layout.total_nr_elems()));
+    size_t size = layout.dtype.size(layout.total_nr_elems());
+    if (m_caching_allocator && CachingBlobAllocator::is_supported(cn)) {
+        storage.reset(cn, size, m_caching_allocator->alloc(cn, size));
+    } else {
+        storage.ensure_size(size);
+    }
     DeviceTensorND dev_tensor;
     dev_tensor.reset(storage, layout);
     return dev_tensor;
@@ -82,11 +102,28 @@ void BlobManagerImpl::set_allocator(allocator_t allocator) {
     custom_allocator = allocator;
 }
 
+BlobManager::CacheStats BlobManagerImpl::get_cache_stats(CompNode cn) {
+    CacheStats stats;
+    if (m_caching_allocator && CachingBlobAllocator::is_supported(cn)) {
+        stats = m_caching_allocator->stats(cn);
+    }
+    MGB_LOCK_GUARD(m_mtx);
+    stats.nr_defrag = m_nr_defrag[cn];
+    return stats;
+}
+
+void BlobManagerImpl::empty_cache(CompNode cn) {
+    if (m_caching_allocator && CachingBlobAllocator::is_supported(cn)) {
+        m_caching_allocator->empty_cache(cn);
+    }
+}
+
 void BlobManagerImpl::defrag(const CompNode& cn) {
     BlobSetWithMux* blobs_set_ptr;
     {
         MGB_LOCK_GUARD(m_mtx);
         blobs_set_ptr = &m_comp2blobs_map[cn];
+        ++m_nr_defrag[cn];
     }
     MGB_LOCK_GUARD(blobs_set_ptr->mtx);
     std::vector<BlobData> blob_data_arrary;
@@ -123,6 +160,7 @@ void BlobManagerImpl::defrag(const CompNode& cn) {
     // wait all other comp nodes to avoid moved var being read; note that
     // ExecEnv has been paused, so no new task would not be dispatched
     CompNode::sync_all();
+    empty_cache(cn);
     CompNode::try_coalesce_all_free_memory();
 
     // try free all
@@ -137,7 +175,7 @@ void BlobManagerImpl::defrag(const CompNode& cn) {
     // allocate for each storage
     for (auto i : blob_data_arrary) {
         DeviceTensorStorage d_storage = DeviceTensorStorage(cn);
-        d_storage.ensure_size(i.blob->m_size);
+        d_storage.reset(cn, i.blob->m_size, alloc_storage(cn, i.blob->m_size));
         d_storage.copy_from(i.h_storage, i.blob->m_size);
         i.blob->m_storage = d_storage.raw_storage();
     }
@@ -166,6 +204,8 @@ struct BlobManagerStub : BlobManager {
     virtual void set_allocator(allocator_t allocator) {
         mgb_assert(0, "prohibited after global variable destruction");
     };
+    CacheStats get_cache_stats(CompNode cn) override { return {}; }
+    void empty_cache(CompNode cn) override {}
 };
 
 BlobManager* BlobManager::inst() {
@@ -2,6 +2,8 @@
 
 #include "megbrain/imperative/blob_manager.h"
 
+#include "./caching_blob_allocator.h"
+
 namespace mgb {
 namespace imperative {
 
@@ -36,7 +38,18 @@ class BlobManagerImpl final : public BlobManager {
 
     BlobManager::allocator_t custom_allocator;
 
+    //! allocator of blob storage on CPU, only enabled by
+    //! MEGENGINE_CPU_BLOB_CACHE=1
+    std::unique_ptr<CachingBlobAllocator> m_caching_allocator;
+
+    CompNode::UnorderedMap<size_t> m_nr_defrag;
+
+    //! allocate storage by the caching allocator if it supports \p cn
+    DeviceTensorStorage::RawStorage alloc_storage(CompNode cn, size_t size);
+
 public:
+    BlobManagerImpl();
+
     static BlobManager* inst();
 
     void alloc_with_defrag(OwnedBlob* blob, size_t size) override;
@@ -49,6 +62,10 @@ public:
     void unregister_blob(OwnedBlob* blob) override;
 
     void set_allocator(allocator_t allocator) override;
+
+    CacheStats get_cache_stats(CompNode cn) override;
+
+    void empty_cache(CompNode cn) override;
 };
 
 }  // namespace imperative
@@ -0,0 +1,195 @@
+#include "./caching_blob_allocator.h"
+
+#include "megbrain/comp_node_env.h"
+#include "megbrain/utils/arith_helper.h"
+
+using namespace mgb;
+using namespace imperative;
+
+namespace {
+//! all block sizes are rounded up to multiples of this
+constexpr size_t MIN_BLOCK_SIZE = 512;
+//! requests up to this size are served from small segments
+constexpr size_t MAX_SMALL_SIZE = 1 << 20;
+//! size of segments for small requests
+constexpr size_t SMALL_SEGMENT_SIZE = 2 << 20;
+//! large requests below this size share segments of LARGE_SEGMENT_SIZE
+constexpr size_t MIN_LARGE_ALLOC = 10 << 20;
+constexpr size_t LARGE_SEGMENT_SIZE = 20 << 20;
+//! granularity of segments for larger requests
+constexpr size_t ROUND_LARGE = 2 << 20;
+}  // anonymous namespace
+
+bool CachingBlobAllocator::is_supported(CompNode cn) {
+    return cn.device_type() == CompNode::DeviceType::CPU;
+}
+
+CachingBlobAllocator::RawStorage CachingBlobAllocator::alloc(
+        CompNode cn, size_t size) {
+    if (!size) {
+        return {};
+    }
+    auto pool = get_pool(cn);
+    auto block = pool->alloc(size);
+    return {block->ptr, [pool, block](dt_byte*) { Pool::free_async(pool, block); }};
+}
+
+void CachingBlobAllocator::empty_cache(CompNode cn) {
+    get_pool(cn)->empty_cache();
+}
+
+CachingBlobAllocator::Stats CachingBlobAllocator::stats(CompNode cn) {
+    return get_pool(cn)->stats();
+}
+
+std::shared_ptr<CachingBlobAllocator::Pool> CachingBlobAllocator::get_pool(
+        CompNode cn) {
+    MGB_LOCK_GUARD(m_mtx);
+    auto&& pool = m_pools[cn];
+    if (!pool) {
+        pool = std::make_shared<Pool>(cn);
+    }
+    return pool;
+}
+
+std::shared_ptr<void> CachingBlobAllocator::on_comp_node_finalize() {
+    MGB_LOCK_GUARD(m_mtx);
+    for (auto&& i : m_pools) {
+        i.second->set_finalized();
+    }
+    return {};
+}
+
+/* ======================= Pool ======================= */
+
+CachingBlobAllocator::Pool::~Pool() {
+    // blocks in use keep the pool alive, so all segments are free here
+    release_free_segments();
+}
+
+CachingBlobAllocator::Block* CachingBlobAllocator::Pool::alloc_segment(
+        size_t size, bool is_small) {
+    size_t seg_size;
+    if (is_small) {
+        seg_size = SMALL_SEGMENT_SIZE;
+    } else if (size < MIN_LARGE_ALLOC) {
+        seg_size = LARGE_SEGMENT_SIZE;
+    } else {
+        seg_size = get_aligned_power2(size, ROUND_LARGE);
+    }
+    void* ptr;
+    MGB_TRY { ptr = m_cn.alloc_device(seg_size); }
+    MGB_CATCH(MemAllocError&, {
+        // the cached segments may be enough for the comp node allocator
+        release_free_segments();
+        ptr = m_cn.alloc_device(seg_size);
+    });
+    m_stats.cached += seg_size;
+    ++m_stats.nr_segment_alloc;
+    auto block = new Block{static_cast<dt_byte*>(ptr), seg_size};
+    block->is_small = is_small;
+    return block;
+}
+
+void CachingBlobAllocator::Pool::release_free_segments() {
+    for (auto list : {&m_free_small, &m_free_large}) {
+        for (auto iter = list->begin(); iter != list->end();) {
+            auto block = *iter;
+            if (!block->prev && !block->next) {
+                m_cn.free_device(block->ptr);
+                m_stats.cached -= block->size;
+                delete block;
+                iter = list->erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+}
+
+CachingBlobAllocator::Block* CachingBlobAllocator::Pool::alloc(size_t size) {
+    size = get_aligned_power2(
+            size, std::max(MIN_BLOCK_SIZE, m_cn.get_mem_addr_alignment()));
+    bool is_small = size <= MAX_SMALL_SIZE;
+    MGB_LOCK_GUARD(m_mtx);
+    auto&& list = free_list(is_small);
+    Block key{nullptr, size};
+    Block* block;
+    auto iter = list.lower_bound(&key);
+    if (iter != list.end()) {
+        block = *iter;
+        list.erase(iter);
+    } else {
+        block = alloc_segment(size, is_small);
+    }
+
+    // split the block if the remainder is worth keeping
+    size_t remain = block->size - size;
+    if (is_small ? remain >= MIN_BLOCK_SIZE : remain > MAX_SMALL_SIZE) {
+        auto rest = new Block{block->ptr + size, remain};
+        rest->is_small = is_small;
+        rest->prev = block;
+        rest->next = block->next;
+        if (rest->next) {
+            rest->next->prev = rest;
+        }
+        block->next = rest;
+        block->size = size;
+        list.insert(rest);
+    }
+    block->allocated = true;
+    m_stats.allocated += block->size;
+    ++m_stats.nr_alloc;
+    return block;
+}
+
+void CachingBlobAllocator::Pool::free(Block* block) {
+    MGB_LOCK_GUARD(m_mtx);
+    auto&& list = free_list(block->is_small);
+    block->allocated = false;
+    m_stats.allocated -= block->size;
+    auto merge = [&](Block* dst, Block* src) {
+        // merge src into dst, where src follows dst in the segment
+        dst->size += src->size;
+        dst->next = src->next;
+        if (dst->next) {
+            dst->next->prev = dst;
+        }
+        delete src;
+    };
+    if (auto next = block->next; next && !next->allocated) {
+        list.erase(next);
+        merge(block, next);
+    }
+    if (auto prev = block->prev; prev && !prev->allocated) {
+        list.erase(prev);
+        merge(prev, block);
+        block = prev;
+    }
+    list.insert(block);
+}
+
+void CachingBlobAllocator::Pool::free_async(std::shared_ptr<Pool> pool, Block* block) {
+    if (pool->m_finalized) {
+        pool->free(block);
+        return;
+    }
+    auto do_free = [pool, block]() { pool->free(block); };
+    CompNodeEnv::from_comp_node(pool->m_cn).cpu_env().dispatch(do_free);
+}
+
+void CachingBlobAllocator::Pool::empty_cache() {
+    MGB_LOCK_GUARD(m_mtx);
+    release_free_segments();
+}
+
+CachingBlobAllocator::Stats CachingBlobAllocator::Pool::stats() {
+    MGB_LOCK_GUARD(m_mtx);
+    auto ret = m_stats;
+    for (auto list : {&m_free_small, &m_free_large}) {
+        if (!list->empty()) {
+            ret.largest_free = std::max(ret.largest_free, (*list->rbegin())->size);
+        }
+    }
+    return ret;
+}
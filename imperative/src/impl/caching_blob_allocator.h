@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <set>
+
+#include "megbrain/imperative/blob_manager.h"
+
+namespace mgb {
+namespace imperative {
+
+/*!
+ * \brief caching allocator for blob storage on CPU comp nodes
+ *
+ * Memory is requested from the comp node in segments, which are split into
+ * blocks on allocation. Freed blocks are coalesced with their free neighbors
+ * and kept in free lists ordered by size, with small and large requests served
+ * from separate segments to limit fragmentation.
+ *
+ * Like CompNode::free_device on cpu, a freed block is returned to its pool by
+ * a task dispatched to the comp node, so it is not handed out again before the
+ * tasks issued until the release have finished. Storage borrowed by other comp
+ * nodes is released only after those users finish (see BorrowedBlob).
+ */
+class CachingBlobAllocator final : CompNodeDepedentObject {
+public:
+    using RawStorage = DeviceTensorStorage::RawStorage;
+    using Stats = BlobManager::CacheStats;
+
+    //! whether blobs on \p cn should be allocated by this allocator
+    static bool is_supported(CompNode cn);
+
+    RawStorage alloc(CompNode cn, size_t size);
+
+    //! return all the segments without allocated blocks to the comp node
+    void empty_cache(CompNode cn);
+
+    Stats stats(CompNode cn);
+
+private:
+    struct Block {
+        dt_byte* ptr;
+        size_t size;
+        bool allocated = false;
+        bool is_small;
+        //! neighbor blocks in the same segment
+        Block *prev = nullptr, *next = nullptr;
+    };
+
+    struct BlockCmp {
+        bool operator()(const Block* a, const Block* b) const {
+            return a->size != b->size ? a->size < b->size : a->ptr < b->ptr;
+        }
+    };
+    using FreeList = std::set<Block*, BlockCmp>;
+
+    //! blocks on a comp node; shared with the deleters of storage
+    class Pool {
+        CompNode m_cn;
+        //! set when the comp node is finalized and tasks can not be dispatched
+        std::atomic_bool m_finalized{false};
+        std::mutex m_mtx;
+        FreeList m_free_small, m_free_large;
+        Stats m_stats;
+
+        FreeList& free_list(bool is_small) {
+            return is_small ? m_free_small : m_free_large;
+        }
+
+        //! allocate a new segment and return a block covering it
+        Block* alloc_segment(size_t size, bool is_small);
+
+        void release_free_segments();
+
+    public:
+        explicit Pool(CompNode cn) : m_cn{cn} {}
+        ~Pool();
+
+        Block* alloc(size_t size);
+        void free(Block* block);
+        //! free \p block after the tasks dispatched to the comp node so far
+        static void free_async(std::shared_ptr<Pool> pool, Block* block);
+        void set_finalized() { m_finalized = true; }
+        void empty_cache();
+        Stats stats();
+    };
+
+    std::mutex m_mtx;
+    CompNode::UnorderedMap<std::shared_ptr<Pool>> m_pools;
+
+    std::shared_ptr<Pool> get_pool(CompNode cn);
+
+    std::shared_ptr<void> on_comp_node_finalize() override;
+};
+
+}  // namespace imperative
+}  // namespace mgb
@@ -39,6 +39,9 @@ struct ApplyOp {
     SmallVector<TensorInfo*> inputs;
     SmallVector<TensorInfo*> outputs;
     bool validated = false;
+    //! ids of the other ops fused into this one by eager fusion, whose
+    //! execution is recorded by profiler together with this one
+    SmallVector<uint64_t> fused_ids;
 
     template <typename TFunctor>
     void get_props(TFunctor&& functor) const {
@@ -136,9 +139,17 @@ struct PopScope {
     const char* get_name() const { return "PopScope"; }
 };
 
+//! wait for the ApplyOps running in the worker pool
+struct Flush {
+    template <typename TFunctor>
+    void get_props(TFunctor&& functor) const {}
+
+    const char* get_name() const { return "Flush"; }
+};
+
 using CommandData = std::variant<
         Put, ApplyOp, Del, GetValue, Drop, SetOption, StartProfile, StopProfile,
-        PushScope, PopScope>;
+        PushScope, PopScope, Flush>;
 
 struct Command {
     uint64_t id;
@@ -0,0 +1,149 @@
+#include "./eviction_index.h"
+
+using namespace mgb;
+using namespace imperative;
+using namespace interpreter::intl;
+
+namespace {
+//! rebuild the event queue when stale events outnumber live nodes by this
+constexpr size_t MAX_STALE_EVENT_RATIO = 4;
+}  // anonymous namespace
+
+void EvictionIndex::set(TensorInfo* ptr, double k, double d, double now) {
+    advance(now);
+    if (!contains(ptr)) {
+        ptr->index_pos = m_heap.size();
+        m_heap.push_back({ptr, k, d});
+        if (m_cert_version.size() < m_heap.size()) {
+            m_cert_version.push_back(0);
+        }
+    } else {
+        auto&& node = m_heap[ptr->index_pos];
+        node.k = k;
+        node.d = d;
+    }
+    sift_up(ptr->index_pos);
+    sift_down(ptr->index_pos);
+    update_certs_around(ptr->index_pos);
+}
+
+void EvictionIndex::erase(TensorInfo* ptr, double now) {
+    if (!contains(ptr)) {
+        return;
+    }
+    advance(now);
+    size_t pos = ptr->index_pos, last = m_heap.size() - 1;
+    if (pos != last) {
+        swap_nodes(pos, last);
+    }
+    m_heap.pop_back();
+    ptr->index_pos = UINT_MAX;
+    if (pos < m_heap.size()) {
+        auto moved = m_heap[pos].ptr;
+        sift_up(pos);
+        sift_down(moved->index_pos);
+        update_certs_around(moved->index_pos);
+    }
+}
+
+TensorInfo* EvictionIndex::top(double now) {
+    advance(now);
+    return m_heap.empty() ? nullptr : m_heap[0].ptr;
+}
+
+void EvictionIndex::clear() {
+    for (auto&& i : m_heap) {
+        i.ptr->index_pos = UINT_MAX;
+    }
+    m_heap.clear();
+    m_cert_version.clear();
+    m_events = {};
+}
+
+void EvictionIndex::advance(double now) {
+    while (!m_events.empty()) {
+        auto [time, pos, version] = m_events.top();
+        if (time > now) {
+            break;
+        }
+        m_events.pop();
+        if (pos >= m_heap.size() || version != m_cert_version[pos]) {
+            continue;
+        }
+        // the node becomes smaller than its parent at this time
+        m_now = std::max(m_now, time);
+        size_t parent = (pos - 1) / 2;
+        swap_nodes(pos, parent);
+        update_certs_around(parent);
+        update_cert(pos * 2 + 1);
+        update_cert(pos * 2 + 2);
+    }
+    m_now = std::max(m_now, now);
+    if (m_events.size() > (m_heap.size() + 1) * MAX_STALE_EVENT_RATIO) {
+        m_events = {};
+        for (size_t i = 1; i < m_heap.size(); ++i) {
+            update_cert(i);
+        }
+    }
+}
+
+void EvictionIndex::swap_nodes(size_t a, size_t b) {
+    std::swap(m_heap[a], m_heap[b]);
+    m_heap[a].ptr->index_pos = a;
+    m_heap[b].ptr->index_pos = b;
+}
+
+void EvictionIndex::update_cert(size_t pos) {
+    if (!pos || pos >= m_heap.size()) {
+        return;
+    }
+    auto version = ++m_cert_version[pos];
+    auto&& c = m_heap[pos];
+    auto&& p = m_heap[(pos - 1) / 2];
+    // c < p iff k_c * (t - d_p) < k_p * (t - d_c), which is linear in t; it
+    // can only start to hold in future if k_c < k_p
+    if (c.k < p.k) {
+        double time = (c.k * p.d - p.k * c.d) / (c.k - p.k);
+        m_events.emplace(std::max(time, m_now), pos, version);
+    }
+}
+
+void EvictionIndex::update_certs_around(size_t pos) {
+    update_cert(pos);
+    update_cert(pos * 2 + 1);
+    update_cert(pos * 2 + 2);
+}
+
+void EvictionIndex::sift_up(size_t pos) {
+    while (pos) {
+        size_t parent = (pos - 1) / 2;
+        if (!(value(pos) < value(parent))) {
+            break;
+        }
+        swap_nodes(pos, parent);
+        update_certs_around(parent);
+        update_cert(pos * 2 + 1);
+        update_cert(pos * 2 + 2);
+        pos = parent;
+    }
+}
+
+void EvictionIndex::sift_down(size_t pos) {
+    for (;;) {
+        size_t child = pos * 2 + 1;
+        if (child >= m_heap.size()) {
+            break;
+        }
+        if (child + 1 < m_heap.size() && value(child + 1) < value(child)) {
+            ++child;
+        }
+        if (!(value(child) < value(pos))) {
+            break;
+        }
+        swap_nodes(pos, child);
+        update_certs_around(pos);
+        update_cert(child * 2 + 1);
+        update_cert(child * 2 + 2);
+        pos = child;
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <queue>
+#include <tuple>
+#include <vector>
+
+#include "./tensor_info.h"
+
+namespace mgb::imperative::interpreter::intl {
+
+/*!
+ * \brief kinetic min-heap of DTR eviction candidates
+ *
+ * The evaluation function of a candidate (see TensorInfo::eval_func) has the
+ * form k / (t - d), where t is the current timestamp, d is derived from the
+ * last used time and k collects the other terms. The order of two candidates
+ * changes at most once as t grows, so a binary heap ordered by the value at
+ * current time stays valid until one of the parent-child pairs crosses. The
+ * crossing times of all pairs are kept in an event queue, and the heap is
+ * repaired by processing the due events whenever time advances.
+ *
+ * All methods take the current timestamp, which must not decrease.
+ */
+class EvictionIndex {
+public:
+    //! insert the tensor or update its key
+    void set(TensorInfo* ptr, double k, double d, double now);
+
+    //! remove the tensor; do nothing if it is not in the index
+    void erase(TensorInfo* ptr, double now);
+
+    //! the tensor with minimal evaluation function, or nullptr if empty
+    TensorInfo* top(double now);
+
+    /*!
+     * \brief the tensor with minimal evaluation function, whose key is
+     *      checked to be up to date
+     *
+     * \param get_k returns the current k of a tensor, or a negative value if
+     *      the tensor should be removed from the index
+     *
+     * Keys of the top tensors are refreshed until the top one does not
+     * change. If the key of another tensor is stale and its current value
+     * is v, the value of the returned tensor is at most v * k / k_stale.
+     */
+    template <typename GetK>
+    TensorInfo* top_checked(double now, GetK&& get_k) {
+        while (auto ptr = top(now)) {
+            double k = get_k(ptr);
+            if (!contains(ptr)) {
+                continue;
+            }
+            if (k < 0) {
+                erase(ptr, now);
+                continue;
+            }
+            auto&& node = m_heap[ptr->index_pos];
+            if (k == node.k) {
+                return ptr;
+            }
+            set(ptr, k, node.d, now);
+        }
+        return nullptr;
+    }
+
+    bool contains(TensorInfo* ptr) const { return ptr->index_pos != UINT_MAX; }
+
+    size_t size() const { return m_heap.size(); }
+
+    void clear();
+
+private:
+    struct Node {
+        TensorInfo* ptr;
+        double k, d;
+    };
+
+    //! (time, heap position, version of the certificate)
+    using Event = std::tuple<double, size_t, size_t>;
+
+    std::vector<Node> m_heap;
+    //! version of the certificate between each node and its parent
+    std::vector<size_t> m_cert_version;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> m_events;
+    double m_now = 0;
+
+    double value(size_t pos) const { return m_heap[pos].k / (m_now - m_heap[pos].d); }
+
+    //! process all crossing events up to \p now
+    void advance(double now);
+
+    void swap_nodes(size_t a, size_t b);
+
+    //! recompute the crossing time of node \p pos and its parent
+    void update_cert(size_t pos);
+
+    //! recompute certificates around \p pos after it is changed
+    void update_certs_around(size_t pos);
+
+    void sift_up(size_t pos);
+    void sift_down(size_t pos);
+};
+
+}  // namespace mgb::imperative::interpreter::intl
@@ -8,6 +8,8 @@
 #include "megbrain/imperative/ops/backward_graph.h"
 #include "megbrain/imperative/ops/opr_attr.h"
 #include "megbrain/imperative/ops/utility.h"
+#include "megbrain/imperative/resource_manager.h"
+#include "megbrain/imperative/sampling_profiler.h"
 #include "megbrain/imperative/utils/to_string.h"
 
 #include "../blob_manager_impl.h"
@@ -19,6 +21,27 @@ using namespace imperative;
 using namespace interpreter;
 using namespace interpreter::intl;
 
+namespace {
+//! whether the op is pure and cheap to be fused with its neighbours
+bool is_eager_fusible(const ApplyOp& cmd) {
+    auto&& op = *cmd.op;
+    if (op.same_type<Elemwise>() || op.same_type<TypeCvt>()) {
+        return true;
+    }
+    // the reduce target shape must be decided by the param
+    return op.same_type<Reduce>() && cmd.inputs.size() == 1;
+}
+
+//! whether the tensor can be evicted by DTR
+bool is_evictable(TensorInfo* ptr) {
+    return ptr->producer && ptr->ptr && ptr->evict_type == EvictType::NONE;
+}
+
+size_t blob_addr(TensorInfo* ptr) {
+    return reinterpret_cast<size_t>(ptr->ptr->blob()->storage().get());
+}
+}  // anonymous namespace
+
 namespace {
 auto tinfo_to_tid(SmallVector<TensorInfo*> tinfo) {
     SmallVector<uint64_t> tid;
@@ -149,11 +172,11 @@ TensorInfo* ChannelImpl::put_impl(const HostTensorND& value, bool no_cache) {
         info->desc.value = value.proxy_to_default_cpu();
     }
     if (Profiler::is_profiling()) {
-        m_worker.add_task(
+        add_task(
                 {Profiler::next_id(), Put{info, value, no_cache},
                  get_channel_state().stack_manager.dump()});
     } else {
-        m_worker.add_task({
+        add_task({
                 Profiler::next_id(),
                 Put{info, value, no_cache},
         });
@@ -208,11 +231,11 @@ void ChannelImpl::del_impl(Handle handle) {
     auto* info = reinterpret_cast<TensorInfo*>(handle);
     m_valid_handle.erase(handle);
     if (Profiler::is_profiling()) {
-        m_worker.add_task(
+        add_task(
                 {Profiler::next_id(), Del{info},
                  get_channel_state().stack_manager.dump()});
     } else {
-        m_worker.add_task({
+        add_task({
                 Profiler::next_id(),
                 Del{info},
         });
@@ -229,11 +252,11 @@ void ChannelImpl::drop(Handle handle) {
                 "invalid handle: %p", handle);
         auto* info = reinterpret_cast<TensorInfo*>(handle);
         if (Profiler::is_profiling()) {
-            m_worker.add_task(
+            add_task(
                     {Profiler::next_id(), Drop{info},
                      get_channel_state().stack_manager.dump()});
         } else {
-            m_worker.add_task({
+            add_task({
                     Profiler::next_id(),
                     Drop{info},
             });
@@ -378,11 +401,11 @@ void ChannelImpl::dispatch_kernel(
                 OpDispatchEvent, cmd.id, guard.value().name(), op_info_getter,
                 tinfo_to_tid(cmd.inputs), tinfo_to_tid(cmd.outputs),
                 state.stack_manager.dump());
-        m_worker.add_task(
+        add_task(
                 {Profiler::next_id(), std::move(cmd),
                  get_channel_state().stack_manager.dump()});
     } else {
-        m_worker.add_task({
+        add_task({
                 Profiler::next_id(),
                 std::move(cmd),
         });
@@ -528,6 +551,10 @@ void ChannelImpl::sync() {
 }
 
 void ChannelImpl::sync_impl() {
+    flush_fusion_window();
+    if (get_channel_state().options.enable_parallel_apply) {
+        m_worker.add_task({Profiler::next_id(), Flush{}});
+    }
     m_worker.wait_all_task_finish();
     MGB_LOCK_GUARD(m_mutex);
     check_worker_exc_unsafe();
@@ -545,6 +572,14 @@ void ChannelImpl::close() {
     mgb_assert(m_valid_handle.empty());
     mgb_log_debug("%ld tensor exists before channel close", (long)valid_handles.size());
     sync_impl();
+    {
+        MGB_LOCK_GUARD(m_fusion_window.mutex);
+        m_fusion_window.stop = true;
+    }
+    m_fusion_window.cv.notify_all();
+    if (m_fusion_window.flusher.joinable()) {
+        m_fusion_window.flusher.join();
+    }
     m_closed = true;
 }
 
@@ -555,6 +590,19 @@ size_t ChannelImpl::get_option(std::string name) {
     return state.options.get_option(name);
 }
 
+size_t ChannelImpl::get_stat(std::string name) {
+    if (name == "nr_parallel_apply") {
+        return m_parallel_apply.nr_run;
+    }
+    if (name == "nr_fused_ops") {
+        return m_fusion_window.nr_fused;
+    }
+    if (name == "nr_dtr_evict") {
+        return m_dtr.nr_evict;
+    }
+    mgb_throw(MegBrainError, "unknown channel stat: %s", name.c_str());
+}
+
 void ChannelImpl::set_option(std::string name, size_t value) {
     MGB_LOCK_GUARD(m_spin);
     mgb_assert(check_available(), "Channel already closed");
@@ -570,11 +618,11 @@ void ChannelImpl::set_option(std::string name, size_t value) {
         BlobManager::inst()->set_allocator(custom_allocator);
     }
     if (Profiler::is_profiling()) {
-        m_worker.add_task(
+        add_task(
                 {Profiler::next_id(), SetOption{name, value},
                  get_channel_state().stack_manager.dump()});
     } else {
-        m_worker.add_task({
+        add_task({
                 Profiler::next_id(),
                 SetOption{name, value},
         });
@@ -585,6 +633,7 @@ void ChannelImpl::clear_candidates() {
     MGB_LOCK_GUARD(m_spin);
     mgb_assert(check_available(), "Channel already closed");
     m_dtr.candidates.clear();
+    m_dtr.sync_index(false);
 }
 
 TensorInfo* ChannelImpl::alloc() {
@@ -676,6 +725,12 @@ void ChannelImpl::real_free(TensorInfo* ptr) {
     }
     MGB_RECORD_EVENT(TensorEraseEvent, ptr->id, ptr->ptr_use_count);
     ptr->status = TensorInfo::Deleted;
+    if (has_value) {
+        // the free memory around the candidates next to it may grow
+        size_t addr = blob_addr(ptr);
+        ptr->ptr.reset();
+        m_dtr.refresh_addr_neighbor(addr);
+    }
     MGB_LOCK_GUARD(m_pool_spin);
     m_pool.free(ptr);
 }
@@ -720,11 +775,17 @@ void ChannelImpl::produce_tensor(TensorInfo* dest, TensorPtr ptr) {
 void ChannelImpl::release_tensor(TensorInfo* dest) {
     MGB_RECORD_EVENT(TensorReleaseEvent, dest->id);
     MGB_LOCK_GUARD(m_mutex);
+    size_t addr = dest->ptr ? blob_addr(dest) : 0;
     dest->ptr.reset();
     auto& state = get_worker_state();
     if (dest->size_exceeds_thd(state.options.dtr_evictee_minimum_size)) {
         m_dtr.erase_candidate(dest);
     }
+    if (addr) {
+        // the free memory around the candidates next to it may grow, even if
+        // the tensor itself is not a candidate
+        m_dtr.refresh_addr_neighbor(addr);
+    }
 }
 
 void ChannelImpl::regenerate(TensorInfo* dest) {
@@ -802,6 +863,9 @@ void ChannelImpl::do_apply_op(const ApplyOp& cmd, std::string reason) {
         return outputs;
     };
     MGB_RECORD_EVENT(OpExecuteEvent, apply_id, {}, reason);
+    for (auto id : cmd.fused_ids) {
+        MGB_RECORD_EVENT(OpExecuteEvent, id, {}, reason);
+    }
     SmallVector<std::pair<CompNode, uint64_t>> kernels;
     if (profiling_device) {
         // Collecting devices
@@ -838,10 +902,14 @@ void ChannelImpl::do_apply_op(const ApplyOp& cmd, std::string reason) {
     } else {
         validated = false;
     }
+    auto sampling = SamplingProfiler::begin(
+            cmd.outputs.empty() || !cmd.outputs[0] ? CompNode{}
+                                                   : cmd.outputs[0]->desc.comp_node);
     // Here std::move is REQUIRED for removing duplicated references.
     auto outputs = apply_on_physical_tensor(
             apply_on_physical_tensor, *cmd.op, std::move(inputs), output_descs,
             validated);
+    SamplingProfiler::end(sampling, *cmd.op);
     // After execute
     for (auto&& [device, kernel_id] : kernels) {
         MGB_RECORD_EVENT_IF(
@@ -883,6 +951,9 @@ void ChannelImpl::do_apply_op(const ApplyOp& cmd, std::string reason) {
         }
         m_dtr.unpin(cmd.inputs, state);
     }
+    for (auto id : cmd.fused_ids) {
+        MGB_RECORD_EVENT(OpExecuteFinishEvent, id, {}, reason);
+    }
     MGB_RECORD_EVENT(OpExecuteFinishEvent, apply_id, {}, reason);
     // End profiling operator
 }
@@ -948,6 +1019,7 @@ bool ChannelImpl::auto_evict(size_t force_num) {
            force_num > 0) {
         MGB_RECORD_EVENT(AutoEvictEvent);
         sample_on_device(m_dtr.comp_node, false);
+        m_dtr.sync_index(state.options.enable_dtr_eviction_index);
         auto best = m_dtr.find_best_tensor(state.options.enable_dtr_sqrt_sampling);
         if (!best) {
             MGB_RECORD_EVENT(AutoEvictFinishEvent);
@@ -961,6 +1033,7 @@ bool ChannelImpl::auto_evict(size_t force_num) {
             flag = true;
         }
         do_drop(best);
+        ++m_dtr.nr_evict;
         if (best->evict_type == EvictType::DROP) {
             m_dtr.update_dsu_after_evict(best);
         }
@@ -999,6 +1072,7 @@ bool ChannelImpl::check_available() {
 }
 
 TensorPtr ChannelImpl::wait_tensor(TensorInfo* info, TensorProp prop) {
+    flush_fusion_window();
     std::unique_lock<decltype(m_mutex)> lock(m_mutex);
     mgb_assert(!m_waitee, "duplicate waitee");
     m_waitee = info;
@@ -1011,17 +1085,24 @@ TensorPtr ChannelImpl::wait_tensor(TensorInfo* info, TensorProp prop) {
         // avoid dead lock
         lock.unlock();
         if (Profiler::is_profiling()) {
-            m_worker.add_task(
+            add_task(
                     {Profiler::next_id(), GetValue{info},
                      get_channel_state().stack_manager.dump()});
         } else {
-            m_worker.add_task({
+            add_task({
                     Profiler::next_id(),
                     GetValue{info},
             });
         }
         lock.lock();
         wait_host = true;
+    } else if (
+            !require_host && !info->ptr &&
+            get_channel_state().options.enable_parallel_apply) {
+        // outputs of the ops in the worker pool are produced when waited for
+        lock.unlock();
+        m_worker.add_task({Profiler::next_id(), Flush{}});
+        lock.lock();
     }
     m_cv.wait(lock, [&]() {
         check_worker_exc_unsafe();
@@ -1091,17 +1172,399 @@ void ChannelImpl::alloc_tensor_with_evict(OwnedBlob* x) {
             imperative_log_profile_begin("defrag");
             BlobManager::inst()->defrag(x->comp_node());
             imperative_log_profile_end("defrag");
+            if (in_worker) {
+                // all the candidates are moved
+                m_dtr.rebuild_index();
+            }
             BlobManager::inst()->alloc_direct(x, x->size());
         }
     });
     set_log_level(pre_level);
 }
 
+void ChannelImpl::add_task(Command&& cmd) {
+    MGB_LOCK_GUARD(m_fusion_window.mutex);
+    if (!buffer_for_fusion(cmd)) {
+        flush_fusion_window_unsafe();
+        m_worker.add_task(std::move(cmd));
+    }
+}
+
+bool ChannelImpl::buffer_for_fusion(Command& cmd) {
+    auto& options = get_channel_state().options;
+    auto& window = m_fusion_window;
+    if (!options.enable_eager_fusion || options.enable_drop ||
+        options.enable_dtr_auto_drop) {
+        return false;
+    }
+    if (auto* apply = std::get_if<ApplyOp>(&cmd.data)) {
+        if (!apply->validated || !is_eager_fusible(*apply)) {
+            return false;
+        }
+        auto cn = apply->outputs[0]->desc.comp_node;
+        for (auto i : apply->inputs) {
+            if (i->desc.comp_node != cn) {
+                return false;
+            }
+        }
+        if (!window.cmds.empty() && window.comp_node != cn) {
+            flush_fusion_window_unsafe();
+        }
+        if (window.cmds.empty()) {
+            window.begin = std::chrono::steady_clock::now();
+            window.timeout = std::chrono::microseconds(options.eager_fusion_timeout);
+            if (!window.flusher.joinable()) {
+                window.flusher = std::thread([this] { run_fusion_flusher(); });
+            }
+            window.cv.notify_all();
+        }
+        window.comp_node = cn;
+        for (auto i : apply->outputs) {
+            window.produced.insert(i);
+        }
+        window.cmds.push_back(std::move(cmd));
+        if (++window.nr_apply >= options.eager_fusion_window) {
+            flush_fusion_window_unsafe();
+        }
+        return true;
+    }
+    if (std::holds_alternative<Put>(cmd.data)) {
+        // the dest of Put is a new tensor, so it can be executed before the
+        // buffered ops
+        m_worker.add_task(std::move(cmd));
+        return true;
+    }
+    if (std::holds_alternative<Del>(cmd.data) && !window.cmds.empty()) {
+        // keep the order relative to buffered ops that may use the tensor
+        window.cmds.push_back(std::move(cmd));
+        return true;
+    }
+    return false;
+}
+
+void ChannelImpl::flush_fusion_window() {
+    MGB_LOCK_GUARD(m_fusion_window.mutex);
+    flush_fusion_window_unsafe();
+}
+
+void ChannelImpl::flush_fusion_window_unsafe() {
+    auto& window = m_fusion_window;
+    if (window.cmds.empty()) {
+        return;
+    }
+    auto cmds = std::move(window.cmds);
+    auto produced = std::move(window.produced);
+    window.cmds.clear();
+    window.produced.clear();
+    window.nr_apply = 0;
+
+    // outputs deleted by the user have no users outside of the window, since
+    // any other use would have flushed the window
+    std::unordered_set<TensorInfo*> deleted;
+    SmallVector<Command*> applies;
+    for (auto&& cmd : cmds) {
+        if (std::holds_alternative<ApplyOp>(cmd.data)) {
+            applies.push_back(&cmd);
+        } else if (auto* del = std::get_if<Del>(&cmd.data)) {
+            if (produced.count(del->dest)) {
+                deleted.insert(del->dest);
+            }
+        }
+    }
+    if (applies.size() < 2 || deleted.empty()) {
+        for (auto&& cmd : cmds) {
+            m_worker.add_task(std::move(cmd));
+        }
+        return;
+    }
+
+    Subgraph graph;
+    SmallVector<TensorInfo*> inputs, outputs;
+    SmallVector<LogicalTensorDesc> var_descs;
+    std::unordered_map<TensorInfo*, Subgraph::var_t> info2var;
+    auto add_var = [&](TensorInfo* info) {
+        auto ins = info2var.emplace(info, info2var.size());
+        if (ins.second) {
+            var_descs.push_back(info->desc);
+        }
+        return ins;
+    };
+    SmallVector<uint64_t> fused_ids;
+    for (auto cmd : applies) {
+        auto&& apply = std::get<ApplyOp>(cmd->data);
+        fused_ids.push_back(apply.id);
+        Subgraph::expr_t expr{apply.op, {}, {}};
+        for (auto i : apply.inputs) {
+            auto ins = add_var(i);
+            if (ins.second) {
+                inputs.push_back(i);
+                graph.inputs.push_back(ins.first->second);
+            }
+            expr.inputs.push_back(ins.first->second);
+        }
+        for (auto o : apply.outputs) {
+            auto ins = add_var(o);
+            mgb_assert(ins.second);
+            expr.outputs.push_back(ins.first->second);
+            if (!deleted.count(o)) {
+                outputs.push_back(o);
+                graph.outputs.push_back(ins.first->second);
+            }
+        }
+        graph.exprs.push_back(std::move(expr));
+    }
+    window.nr_fused += applies.size();
+    if (!outputs.empty()) {
+        auto op = get_fused_op(std::move(graph), var_descs);
+        // the fused op takes the id of the first op, and the others are kept
+        // for profiler
+        auto&& first = *applies[0];
+        ApplyOp fused{
+                fused_ids[0], std::move(op), std::move(inputs), std::move(outputs),
+                true};
+        fused.fused_ids.assign(fused_ids.begin() + 1, fused_ids.end());
+        m_worker.add_task({Profiler::next_id(), std::move(fused), first.trace});
+    }
+    for (auto&& cmd : cmds) {
+        if (auto* del = std::get_if<Del>(&cmd.data)) {
+            if (deleted.count(del->dest)) {
+                // the deleted intermediates are never produced, and unknown
+                // to the worker
+                auto info = del->dest;
+                MGB_RECORD_EVENT(TensorEraseEvent, info->id, info->ptr_use_count);
+                info->status = TensorInfo::Deleted;
+                MGB_LOCK_GUARD(m_pool_spin);
+                m_pool.free(info);
+            } else {
+                m_worker.add_task(std::move(cmd));
+            }
+        }
+    }
+}
+
+std::shared_ptr<OpDef> ChannelImpl::get_fused_op(
+        Subgraph graph, const SmallVector<LogicalTensorDesc>& var_descs) {
+    auto& window = m_fusion_window;
+    if (!window.prefix_cache) {
+        window.prefix_cache =
+                ResourceManager::create_local<FusionWindow::PrefixCache>();
+        window.op_cache = ResourceManager::create_local<FusionWindow::OpCache>();
+    }
+    auto get_descs = [&](const SmallVector<Subgraph::var_t>& vars) {
+        SmallVector<LogicalTensorDesc> descs;
+        for (auto i : vars) {
+            descs.push_back(var_descs[i]);
+        }
+        return descs;
+    };
+    // ids of prefixes start from 1, and 0 is the empty one
+    size_t prefix = 0;
+    for (auto&& expr : graph.exprs) {
+        auto& cache = *window.prefix_cache;
+        FusionWindow::PrefixCache::key_t key{
+                expr.op, get_descs(expr.inputs), {prefix, expr.inputs, expr.outputs}};
+        auto iter = cache.find(key);
+        if (iter == cache.end()) {
+            iter = cache.emplace(std::move(key), cache.size() + 1).first;
+        }
+        prefix = iter->second;
+    }
+    auto& cache = *window.op_cache;
+    FusionWindow::OpCache::key_t key{
+            graph.exprs.back().op, get_descs(graph.inputs), {prefix, graph.outputs}};
+    auto iter = cache.find(key);
+    if (iter == cache.end()) {
+        auto op = CompiledOp::make(SubgraphOp::make(
+                "EagerFusion", std::make_shared<Subgraph>(std::move(graph))));
+        iter = cache.emplace(std::move(key), std::move(op)).first;
+    }
+    return iter->second;
+}
+
+void ChannelImpl::run_fusion_flusher() {
+    sys::set_thread_name("eager_fusion");
+    auto& window = m_fusion_window;
+    std::unique_lock<std::mutex> lock(window.mutex);
+    while (!window.stop) {
+        if (window.cmds.empty()) {
+            window.cv.wait(lock);
+        } else if (std::chrono::steady_clock::now() >= window.begin + window.timeout) {
+            flush_fusion_window_unsafe();
+        } else {
+            window.cv.wait_until(lock, window.begin + window.timeout);
+        }
+    }
+}
+
+bool ChannelImpl::dispatch_parallel_apply(const ApplyOp& cmd) {
+    auto& state = get_worker_state();
+    auto& options = state.options;
+    auto& parallel = m_parallel_apply;
+    auto&& op = *cmd.op;
+    auto on_cpu = [](TensorInfo* info) {
+        return !info ||
+               info->desc.comp_node.device_type() == CompNode::DeviceType::CPU;
+    };
+    // DTR and the profiler expect ops to run one by one, and ops with side
+    // effects keep their order with all the others
+    bool supported =
+            !options.enable_drop && !options.enable_dtr_auto_drop &&
+            !Profiler::is_profiling() && !op.trait()->has_side_effect &&
+            !op.trait()->make_forward_graph &&
+            std::all_of(cmd.inputs.begin(), cmd.inputs.end(), on_cpu) &&
+            std::all_of(cmd.outputs.begin(), cmd.outputs.end(), on_cpu);
+    if (!supported) {
+        drain_parallel_apply();
+        return false;
+    }
+    for (auto i : cmd.inputs) {
+        wait_parallel_apply(i);
+    }
+    SmallVector<TensorPtr> inputs;
+    inputs.reserve(cmd.inputs.size());
+    for (auto i : cmd.inputs) {
+        if (mgb_unlikely(i->invalid)) {
+            // the outputs are invalidated in the serial path
+            return false;
+        }
+        mgb_assert(i->ptr, "Invalid input tensor ptr!");
+        inputs.push_back(i->ptr);
+    }
+    // inputs may be shared by the ops in flight, so they must not be made
+    // contiguous in place by the workers
+    auto&& constraints = OpDef::get_input_layout_constraint(op, inputs);
+    for (size_t idx = 0; idx < inputs.size(); ++idx) {
+        auto&& layout = inputs[idx]->layout();
+        auto&& layout_checker = constraints[idx];
+        if (!layout.is_contiguous() || (layout_checker && !layout_checker(layout))) {
+            drain_parallel_apply();
+            return false;
+        }
+    }
+
+    size_t nr_workers = std::max<size_t>(options.parallel_apply_workers, 1);
+    if (!parallel.pool || parallel.nr_workers != nr_workers) {
+        drain_parallel_apply();
+        parallel.pool = std::make_unique<ParallelApply::Pool>("apply");
+        parallel.pool->start(nr_workers);
+        parallel.nr_workers = nr_workers;
+    }
+    while (parallel.tasks.size() >= parallel.nr_workers) {
+        finish_parallel_apply(parallel.tasks.begin());
+    }
+    SmallVector<LogicalTensorDesc> output_descs;
+    for (auto i : cmd.outputs) {
+        output_descs.push_back(i->desc);
+    }
+    auto run = [this, op = cmd.op, inputs = std::move(inputs),
+                output_descs = std::move(output_descs),
+                validated = cmd.validated]() mutable {
+        // DTR is off in the pool, so blobs are allocated directly: eviction
+        // and defragmentation move the memory of the other ops in flight, and
+        // alloc_tensor_with_evict changes the global log level
+        thread_local bool allocator_set = false;
+        if (!allocator_set) {
+            OpDef::set_allocator([](CompNode device, size_t size) {
+                auto blob = Blob::make(device, size);
+                BlobManager::inst()->alloc_direct(blob.get(), size);
+                return blob->storage();
+            });
+            allocator_set = true;
+        }
+        auto sampling = SamplingProfiler::begin(
+                output_descs.empty() ? CompNode{} : output_descs[0].comp_node);
+        auto outputs = OpDef::apply_on_physical_tensor(
+                *op, std::move(inputs), output_descs, validated);
+        SamplingProfiler::end(sampling, *op);
+        for (auto& o : outputs) {
+            o->set_ready_event(record_event(o->comp_node()));
+        }
+        ++m_parallel_apply.nr_run;
+        return outputs;
+    };
+    parallel.tasks.push_back({cmd, parallel.pool->launch(std::move(run))});
+    auto task = std::prev(parallel.tasks.end());
+    for (auto o : cmd.outputs) {
+        if (o) {
+            parallel.producer[o] = task;
+        }
+    }
+    return true;
+}
+
+void ChannelImpl::finish_parallel_apply(ParallelApply::TaskIter task) {
+    auto& state = get_worker_state();
+    auto cmd = std::move(task->cmd);
+    auto future = std::move(task->outputs);
+    for (auto o : cmd.outputs) {
+        m_parallel_apply.producer.erase(o);
+    }
+    m_parallel_apply.tasks.erase(task);
+    SmallVector<TensorPtr> outputs;
+    if (!state.options.catch_worker_execption) {
+        outputs = future.get();
+    } else {
+        try {
+            outputs = future.get();
+        } catch (...) {
+            MGB_LOCK_GUARD(m_mutex);
+            for (auto o : cmd.outputs) {
+                if (o) {
+                    o->invalid = true;
+                }
+            }
+            m_worker_exc = std::current_exception();
+            MGB_RECORD_EVENT(WorkerExceptionEvent);
+            if (m_waitee) {
+                notify_tensor_unsafe(m_waitee);
+            }
+            return;
+        }
+    }
+    mgb_assert(outputs.size() == cmd.outputs.size());
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        auto output = cmd.outputs[i];
+        if (output && !output->ptr) {
+            produce_tensor(output, outputs[i]);
+            sample_on_device(output->desc.comp_node, false);
+        }
+    }
+}
+
+void ChannelImpl::wait_parallel_apply(TensorInfo* dest) {
+    auto iter = m_parallel_apply.producer.find(dest);
+    if (iter != m_parallel_apply.producer.end()) {
+        finish_parallel_apply(iter->second);
+    }
+}
+
+void ChannelImpl::drain_parallel_apply() {
+    while (!m_parallel_apply.tasks.empty()) {
+        finish_parallel_apply(m_parallel_apply.tasks.begin());
+    }
+}
+
 void ChannelImpl::process_one_task(Command& icmd) {
     using namespace ranges;
     using namespace ranges::views;
     auto& state = get_worker_state();
     auto& options = state.options;
+    if (!m_parallel_apply.tasks.empty()) {
+        // Del and GetValue only wait for the producer of their tensor, while
+        // the other commands keep their order with all the ops in flight
+        std::visit(
+                [&](const auto& cmd) {
+                    using T = std::decay_t<decltype(cmd)>;
+                    if constexpr (
+                            std::is_same_v<T, Del> || std::is_same_v<T, GetValue>) {
+                        wait_parallel_apply(cmd.dest);
+                    } else if constexpr (
+                            !std::is_same_v<T, Put> && !std::is_same_v<T, ApplyOp>) {
+                        drain_parallel_apply();
+                    }
+                },
+                icmd.data);
+    }
     // TODO: remove std::visit for support osx 10.12
     auto cmd_visitor = [&](const auto& cmd) {
         using T = std::decay_t<decltype(cmd)>;
@@ -1120,6 +1583,9 @@ void ChannelImpl::process_one_task(Command& icmd) {
                     TensorCommandFinishEvent, cmd.dest->id, TensorCommandKind::Put);
             sample_on_device(cmd.dest->desc.comp_node, false);
         } else if constexpr (std::is_same_v<T, ApplyOp>) {
+            if (options.enable_parallel_apply && dispatch_parallel_apply(cmd)) {
+                return;
+            }
             for (auto& i : cmd.inputs) {
                 if (mgb_unlikely(i->invalid)) {
                     MGB_LOCK_GUARD(m_mutex);
@@ -1168,7 +1634,8 @@ void ChannelImpl::process_one_task(Command& icmd) {
                 bool inplace =
                         any_of(cartesian_product(cmd.inputs, cmd.outputs), is_inplace);
 
-                if (!inplace && !cross_cn && !m_dtr.is_bad_op(get_name(*cmd.op))) {
+                if (!inplace && !cross_cn && !cmd.op->trait()->has_side_effect &&
+                    !m_dtr.is_bad_op(get_name(*cmd.op))) {
                     TensorInfo::ComputePath::make(
                             cmd.id, cmd.op, cmd.inputs, cmd.outputs);
                     size_t detach_cnt = 0;
@@ -1256,6 +1723,8 @@ void ChannelImpl::process_one_task(Command& icmd) {
             MGB_RECORD_EVENT(ScopeEvent, cmd.scope_name);
         } else if constexpr (std::is_same_v<T, PopScope>) {
             MGB_RECORD_EVENT(ScopeFinishEvent, cmd.scope_name);
+        } else if constexpr (std::is_same_v<T, Flush>) {
+            drain_parallel_apply();
         } else {
             static_assert(!std::is_same_v<T, T>);
         }
@@ -1308,11 +1777,11 @@ void ChannelImpl::start_profile() {
     auto capture_tensors = collect_valid_tensors();
     if (capture_tensors.size() > 0) {
         if (Profiler::is_profiling()) {
-            m_worker.add_task(
+            add_task(
                     {Profiler::next_id(), StartProfile{std::move(capture_tensors)},
                      get_channel_state().stack_manager.dump()});
         } else {
-            m_worker.add_task({
+            add_task({
                     Profiler::next_id(),
                     StartProfile{std::move(capture_tensors)},
             });
@@ -1326,11 +1795,11 @@ void ChannelImpl::stop_profile() {
     auto escape_tensors = collect_valid_tensors();
     if (escape_tensors.size() > 0) {
         if (Profiler::is_profiling()) {
-            m_worker.add_task(
+            add_task(
                     {Profiler::next_id(), StopProfile{std::move(escape_tensors)},
                      get_channel_state().stack_manager.dump()});
         } else {
-            m_worker.add_task({
+            add_task({
                     Profiler::next_id(),
                     StopProfile{std::move(escape_tensors)},
             });
@@ -1345,11 +1814,11 @@ void ChannelImpl::push_scope(std::string name) {
     state.stack_manager.enter(name);
     MGB_RECORD_EVENT(ScopeEvent, name);
     if (Profiler::is_profiling()) {
-        m_worker.add_task(
+        add_task(
                 {Profiler::next_id(), PushScope{name},
                  get_channel_state().stack_manager.dump()});
     } else {
-        m_worker.add_task({
+        add_task({
                 Profiler::next_id(),
                 PushScope{name},
         });
@@ -1363,11 +1832,11 @@ void ChannelImpl::pop_scope(std::string name) {
     state.stack_manager.exit(name);
     MGB_RECORD_EVENT(ScopeFinishEvent, name);
     if (Profiler::is_profiling()) {
-        m_worker.add_task(
+        add_task(
                 {Profiler::next_id(), PopScope{name},
                  get_channel_state().stack_manager.dump()});
     } else {
-        m_worker.add_task({
+        add_task({
                 Profiler::next_id(),
                 PopScope{name},
         });
@@ -1426,6 +1895,7 @@ void ChannelImpl::DynamicSublinear::update_dsu_after_recompute(TensorInfo* ptr)
     dsu_fa->t -= ptr->compute_time;
     ptr->dsu_ptr->parent.reset();
     ptr->dsu_ptr->t = ptr->compute_time;
+    refresh_component(ptr);
 }
 
 void ChannelImpl::DynamicSublinear::update_dsu_after_evict(TensorInfo* ptr) {
@@ -1439,6 +1909,7 @@ void ChannelImpl::DynamicSublinear::update_dsu_after_evict(TensorInfo* ptr) {
             merge(ptr->dsu_ptr, i->dsu_ptr);
         }
     }
+    refresh_component(ptr);
 }
 
 double ChannelImpl::DynamicSublinear::estimate_neighbor_cost(TensorInfo* ptr) {
@@ -1469,6 +1940,23 @@ TensorInfo* ChannelImpl::DynamicSublinear::find_best_tensor(
     if (candidates.empty())
         return nullptr;
 
+    if (index_enabled) {
+        // the adjacent free memory of a candidate may grow without any tensor
+        // next to it being released (e.g. by a workspace), so its key may be
+        // stale; the key of the best one is checked before it is returned.
+        // If the free memory around each candidate grows by at most D since
+        // its key is computed, the evaluation function of the returned one is
+        // at most (1 + D / m) times the minimum, where m is the memory of the
+        // optimal candidate; see TestDTREvictionIndex.StaleKeyBound
+        return index.top_checked(estimate_timestamp, [this](TensorInfo* ptr) {
+            if (!is_evictable(ptr)) {
+                return -1.0;
+            }
+            update_index_addr(ptr);
+            return index_key(ptr);
+        });
+    }
+
     double min_msps = -1;
     TensorInfo* best = nullptr;
     size_t sz = 1;
@@ -1540,6 +2028,12 @@ void ChannelImpl::DynamicSublinear::insert_candidate(TensorInfo* ptr) {
     if (!comp_node.valid()) {
         comp_node = ptr->ptr->comp_node();
     }
+    if (index_enabled) {
+        ptr->index_addr = blob_addr(ptr);
+        index_addr.emplace(ptr->index_addr, ptr);
+        refresh_key(ptr);
+        refresh_addr_neighbor(ptr->index_addr);
+    }
 }
 
 void ChannelImpl::DynamicSublinear::erase_candidate(TensorInfo* ptr) {
@@ -1550,6 +2044,11 @@ void ChannelImpl::DynamicSublinear::erase_candidate(TensorInfo* ptr) {
     }
     // some tensors may be erased already, just skip them
     if (ptr->cand_index != UINT_MAX) {
+        if (index_enabled) {
+            index.erase(ptr, estimate_timestamp);
+            index_addr.erase({ptr->index_addr, ptr});
+            refresh_addr_neighbor(ptr->index_addr);
+        }
         std::swap(candidates[ptr->cand_index], candidates.back());
         candidates[ptr->cand_index]->cand_index = ptr->cand_index;
         candidates.pop_back();
@@ -1559,4 +2058,123 @@ void ChannelImpl::DynamicSublinear::erase_candidate(TensorInfo* ptr) {
 
 void ChannelImpl::DynamicSublinear::update_used_time(TensorInfo* ptr) {
     ptr->last_used_time = estimate_timestamp;
+    refresh_key(ptr);
+}
+
+void ChannelImpl::DynamicSublinear::sync_index(bool enable) {
+    if (enable == index_enabled) {
+        return;
+    }
+    index.clear();
+    index_addr.clear();
+    index_enabled = enable;
+    if (enable) {
+        for (auto i : candidates) {
+            if (i->ptr) {
+                i->index_addr = blob_addr(i);
+                index_addr.emplace(i->index_addr, i);
+            }
+            refresh_key(i);
+        }
+    }
+}
+
+void ChannelImpl::DynamicSublinear::rebuild_index() {
+    if (index_enabled) {
+        sync_index(false);
+        sync_index(true);
+    }
+}
+
+void ChannelImpl::DynamicSublinear::refresh_key(TensorInfo* ptr) {
+    if (!index_enabled || ptr->cand_index == UINT_MAX) {
+        return;
+    }
+    if (!is_evictable(ptr)) {
+        index.erase(ptr, estimate_timestamp);
+        return;
+    }
+    update_index_addr(ptr);
+    index.set(ptr, index_key(ptr), ptr->last_used_time - 1e-3, estimate_timestamp);
+}
+
+double ChannelImpl::DynamicSublinear::index_key(TensorInfo* ptr) {
+    // the same evaluation function as the scan in find_best_tensor, with the
+    // staleness term left to the index
+    size_t begin_ptr = blob_addr(ptr);
+    auto side_info = ptr->ptr->comp_node().get_free_left_and_right(
+            begin_ptr, begin_ptr + ptr->ptr->blob()->size());
+    double free_mem = side_info.first + side_info.second;
+    return ptr->eval_func_time_invariant(
+            estimate_neighbor_cost(ptr), free_mem, 1.0, 1.0, 1.0001);
+}
+
+void ChannelImpl::DynamicSublinear::update_index_addr(TensorInfo* ptr) {
+    size_t addr = blob_addr(ptr), prev_addr = ptr->index_addr;
+    if (addr == prev_addr) {
+        return;
+    }
+    index_addr.erase({prev_addr, ptr});
+    ptr->index_addr = addr;
+    index_addr.emplace(addr, ptr);
+    refresh_addr_neighbor(prev_addr);
+    refresh_addr_neighbor(addr);
+}
+
+void ChannelImpl::DynamicSublinear::refresh_component(TensorInfo* ptr) {
+    if (!index_enabled) {
+        return;
+    }
+    // neighbor cost of a tensor depends on the inputs and outputs of its
+    // producer, so walk through the evicted tensors connected to ptr
+    std::unordered_set<TensorInfo*> visited{ptr};
+    SmallVector<TensorInfo*> stack{ptr};
+    auto visit = [&](TensorInfo* i) {
+        if (i && visited.insert(i).second) {
+            if (i->evict_type == EvictType::DROP) {
+                stack.push_back(i);
+            } else {
+                refresh_key(i);
+            }
+        }
+    };
+    while (!stack.empty()) {
+        auto i = stack.back();
+        stack.pop_back();
+        if (i->producer) {
+            for (auto j : i->producer->inputs) {
+                visit(j);
+            }
+            for (auto j : i->producer->outputs) {
+                visit(j);
+            }
+        }
+        for (auto user : i->users) {
+            for (auto j : user->outputs) {
+                visit(j);
+            }
+        }
+    }
+}
+
+void ChannelImpl::DynamicSublinear::refresh_addr_neighbor(size_t addr) {
+    auto iter = index_addr.lower_bound({addr, nullptr});
+    auto next = iter;
+    while (next != index_addr.end() && next->first == addr) {
+        ++next;
+    }
+    // refresh_key may move entries of index_addr, so take the neighbors first
+    TensorInfo *next_ptr = nullptr, *prev_ptr = nullptr;
+    if (next != index_addr.end()) {
+        next_ptr = next->second;
+    }
+    if (iter != index_addr.begin()) {
+        prev_ptr = std::prev(iter)->second;
+    }
+    if (next_ptr) {
+        refresh_key(next_ptr);
+    }
+    if (prev_ptr) {
+        refresh_key(prev_ptr);
+    }
 }
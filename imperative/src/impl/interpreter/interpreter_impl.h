@@ -1,18 +1,26 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <future>
 #include <list>
+#include <set>
 #include <stack>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <variant>
 #include "megbrain/comp_node.h"
+#include "megbrain/imperative/graph_cache.h"
 #include "megbrain/imperative/interpreter.h"
 #include "megbrain/imperative/profiler.h"
+#include "megbrain/utils/async_worker.h"
 #include "megbrain/utils/mempool.h"
 
 #include "./commands.h"
+#include "./eviction_index.h"
 #include "./option_manager.h"
 #include "./stack_manager.h"
 #include "./tensor_info.h"
@@ -54,6 +62,7 @@ struct ChannelImpl : Interpreter::Channel {
     size_t get_option(std::string name) override;
     void set_option(std::string name, size_t value) override;
     void clear_candidates() override;
+    size_t get_stat(std::string name) override;
 
     void start_profile() override;
     void stop_profile() override;
@@ -84,6 +93,38 @@ private:
 
     void process_one_task(Command&);
 
+    //! send a command to the worker, possibly through the fusion window
+    void add_task(Command&& cmd);
+
+    //! try to keep the command in the fusion window; return whether it is
+    //! taken
+    bool buffer_for_fusion(Command& cmd);
+
+    //! send all buffered commands to the worker, fusing the ops whose
+    //! intermediate results have been deleted
+    void flush_fusion_window();
+
+    //! flush_fusion_window with the window mutex held
+    void flush_fusion_window_unsafe();
+
+    //! the compiled op running \p graph, cached by the structure of the graph
+    //! so that its computing graphs are reused
+    std::shared_ptr<OpDef> get_fused_op(
+            Subgraph graph, const SmallVector<LogicalTensorDesc>& var_descs);
+
+    //! body of the thread flushing the fusion window on timeout
+    void run_fusion_flusher();
+
+    //! try to run the ApplyOp in the worker pool after the producers of its
+    //! inputs finish; return whether it is taken
+    bool dispatch_parallel_apply(const ApplyOp& cmd);
+
+    //! wait for the in-flight ApplyOp producing \p dest, if any
+    void wait_parallel_apply(TensorInfo* dest);
+
+    //! wait for all the in-flight ApplyOps
+    void drain_parallel_apply();
+
     void check_worker_exc_unsafe();
 
     void produce_tensor(TensorInfo* dest, TensorPtr ptr);
@@ -132,6 +173,72 @@ private:
     bool m_applying = false;
     bool m_closed = false;
 
+    //! commands buffered in channel for eager fusion, see the
+    //! enable_eager_fusion option
+    //!
+    //! the window is flushed by the channel when a command can not be
+    //! buffered or at sync points, and by the flusher thread when it is kept
+    //! longer than eager_fusion_timeout; all the members except nr_fused are
+    //! guarded by mutex
+    struct FusionWindow {
+        //! fused subgraphs are interned expr by expr: an expr is keyed by its
+        //! op, input descs, the id of the prefix before it and its vars, and
+        //! mapped to the id of the prefix ending at it
+        using PrefixCache = OpMethResultCache<
+                size_t, size_t, SmallVector<Subgraph::var_t>,
+                SmallVector<Subgraph::var_t>>;
+        //! keyed by the last op, input descs, the prefix id and the outputs
+        using OpCache = OpMethResultCache<
+                std::shared_ptr<OpDef>, size_t, SmallVector<Subgraph::var_t>>;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<Command> cmds;
+        size_t nr_apply = 0;
+        CompNode comp_node;
+        //! outputs of the buffered ApplyOps
+        std::unordered_set<TensorInfo*> produced;
+        //! when the first command of the window is buffered
+        std::chrono::steady_clock::time_point begin;
+        std::chrono::microseconds timeout{0};
+        std::thread flusher;
+        bool stop = false;
+        PrefixCache* prefix_cache = nullptr;
+        OpCache* op_cache = nullptr;
+        //! number of ops fused into subgraphs
+        std::atomic_size_t nr_fused{0};
+    } m_fusion_window;
+
+    //! ApplyOps running in the worker pool, see the enable_parallel_apply
+    //! option; only accessed by the worker thread
+    //!
+    //! apply_on_physical_tensor of an op without side effects (see
+    //! OpTrait::has_side_effect) may run on several workers at once. It must
+    //! not write its inputs, and may only use thread-local state, like the
+    //! proxy graphs and the caches of OpDef, or state under its own lock. Ops
+    //! with side effects or forward graphs and ops off cpu are run serially by
+    //! the worker thread after the pool is drained.
+    struct ParallelApply {
+        using Pool = FutureThreadPool<SmallVector<TensorPtr>>;
+        struct Task {
+            ApplyOp cmd;
+            Pool::Future outputs;
+        };
+        using TaskIter = std::list<Task>::iterator;
+
+        std::unique_ptr<Pool> pool;
+        size_t nr_workers = 0;
+        //! in-flight tasks in dispatch order
+        std::list<Task> tasks;
+        //! in-flight task of each output not produced yet
+        std::unordered_map<TensorInfo*, TaskIter> producer;
+        //! number of ops run by the workers of the pool
+        std::atomic_size_t nr_run{0};
+    } m_parallel_apply;
+
+    //! produce the outputs of an in-flight ApplyOp after it finishes
+    void finish_parallel_apply(ParallelApply::TaskIter task);
+
     struct WorkQueue : AsyncQueueSC<Command, WorkQueue> {
         // set max_spin=0 to prevent Queue fetch task in busy wait manner.
         // this won't affect throughput when python interpreter is sending enough task,
@@ -268,6 +375,52 @@ private:
          */
         void erase_candidate(TensorInfo* ptr);
 
+        /*!
+         * \brief enable or disable the eviction index
+         *
+         * The index is rebuilt from all the candidates when it is enabled.
+         */
+        void sync_index(bool enable);
+
+        /*!
+         * \brief rebuild the eviction index from all the candidates, e.g.
+         * after the blobs are moved by defragmentation
+         */
+        void rebuild_index();
+
+        /*!
+         * \brief recompute the key of tensor ptr in the eviction index
+         *
+         * Note: Candidates that are not available are removed from the index,
+         * and they are added back when their keys are refreshed after they
+         * become available again.
+         */
+        void refresh_key(TensorInfo* ptr);
+
+        /*!
+         * \brief the time invariant part of the evaluation function of an
+         * evictable tensor, i.e. the key in the eviction index
+         */
+        double index_key(TensorInfo* ptr);
+
+        /*!
+         * \brief update the position of ptr in index_addr if its blob has
+         * been moved, e.g. after it is recomputed
+         */
+        void update_index_addr(TensorInfo* ptr);
+
+        /*!
+         * \brief refresh the keys of tensors whose neighbor cost may change
+         * with the component of evicted tensors around ptr
+         */
+        void refresh_component(TensorInfo* ptr);
+
+        /*!
+         * \brief refresh the keys of the candidates next to addr in device
+         * memory, whose adjacent free memory may change
+         */
+        void refresh_addr_neighbor(size_t addr);
+
         //! estimate the current time, in order to reduce the overhead of timer
         double estimate_timestamp = 0;
 
@@ -277,6 +430,18 @@ private:
         //! store all tensors that may be evicted
         SmallVector<TensorInfo*> candidates;
 
+        //! whether available candidates are kept in index
+        bool index_enabled = false;
+
+        //! available candidates ordered by the evaluation function
+        EvictionIndex index;
+
+        //! indexed candidates ordered by device address
+        std::set<std::pair<size_t, TensorInfo*>> index_addr;
+
+        //! number of tensors evicted by auto_evict
+        std::atomic_size_t nr_evict{0};
+
         bool is_bad_op(std::string op_name) {
             return std::find(op_blacklist.begin(), op_blacklist.end(), op_name) !=
                    op_blacklist.end();
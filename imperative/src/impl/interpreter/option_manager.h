@@ -38,6 +38,10 @@ public:
             "disable memory forwarding, thus each tensor has its own storage.");
     DEF_OPTION(enable_dtr_auto_drop, "MEGENGINE_DTR_AUTO_DROP", 0, "");
     DEF_OPTION(enable_dtr_sqrt_sampling, "MEGENGINE_DTR_SQRT_SAMPLING", 0, "");
+    DEF_OPTION(
+            enable_dtr_eviction_index, "MEGENGINE_DTR_EVICTION_INDEX", 0,
+            "keep DTR eviction candidates in an index ordered by the evaluation "
+            "function, instead of scanning all of them on each eviction.");
     DEF_OPTION(
             dtr_eviction_threshold, "MEGENGINE_DTR_EVICTION_THRESHOLD", 0,
             "auto drop will start whenever gpu memory usage exceeds this value.");
@@ -45,6 +49,25 @@ public:
             dtr_evictee_minimum_size, "MEGENGINE_DTR_EVICTEE_MINIMUM_SIZE", 1048576,
             "the minimum memory value of a tensor added to the candidate set");
     DEF_OPTION(record_computing_path, "MEGENGINE_RECORD_COMPUTING_PATH", 0, "");
+    DEF_OPTION(
+            enable_eager_fusion, "MEGENGINE_EAGER_FUSION", 0,
+            "buffer elemwise/typecvt/reduce ops in the channel and execute them as "
+            "one compiled subgraph if their intermediates are deleted in time.");
+    DEF_OPTION(
+            eager_fusion_window, "MEGENGINE_EAGER_FUSION_WINDOW", 16,
+            "max number of ops buffered for eager fusion.");
+    DEF_OPTION(
+            eager_fusion_timeout, "MEGENGINE_EAGER_FUSION_TIMEOUT", 1000,
+            "max microseconds that ops are buffered for eager fusion before they "
+            "are sent to the worker.");
+    DEF_OPTION(
+            enable_parallel_apply, "MEGENGINE_PARALLEL_APPLY", 0,
+            "run independent ops on cpu in a pool of workers, while ops depending "
+            "on each other and ops with side effects still run in program order; "
+            "the ops run concurrently must only use thread-local state.");
+    DEF_OPTION(
+            parallel_apply_workers, "MEGENGINE_PARALLEL_APPLY_WORKERS", 4,
+            "number of workers (and max number of ops in flight) for parallel apply.");
 
 #undef DEF_OPTION
 
@@ -120,10 +120,19 @@ struct TensorInfo {
     double eval_func(
             double cost, double free_mem, double cur_time, double param_cost,
             double param_mem, double param_time, double param_recompute_times) {
+        return eval_func_time_invariant(
+                       cost, free_mem, param_cost, param_mem,
+                       param_recompute_times) /
+               pow((double)(cur_time - last_used_time + 1e-3), param_time);
+    }
+
+    //! the part of eval_func that does not change with current time
+    double eval_func_time_invariant(
+            double cost, double free_mem, double param_cost, double param_mem,
+            double param_recompute_times) {
         return pow(cost + 1e-3, param_cost) *
                pow(param_recompute_times, (double)recompute_times) /
-               (pow((memory + free_mem) / 1024.0 / 1024.0, param_mem) *
-                pow((double)(cur_time - last_used_time + 1e-3), param_time));
+               pow((memory + free_mem) / 1024.0 / 1024.0, param_mem);
     }
 
     void pin() { ++pinned; }
@@ -158,6 +167,11 @@ struct TensorInfo {
 
     // UINT_MAX as a magic default value
     size_t cand_index = UINT_MAX;
+
+    // position in EvictionIndex, UINT_MAX if not indexed
+    size_t index_pos = UINT_MAX;
+    // device address of the candidate when indexed
+    size_t index_addr = 0;
 };
 }  // namespace interpreter::intl
 
@@ -10,6 +10,103 @@
 namespace mgb {
 namespace imperative {
 
+namespace {
+//! inference on inputs with larger host values is not cached
+constexpr size_t MAX_INFER_CACHE_VALUE_SIZE = 256;
+//! the cache is cleared when it grows beyond this, e.g. for dynamic shapes
+constexpr size_t MAX_INFER_CACHE_SIZE = 4096;
+
+/*!
+ * \brief key of the output attrs inference cache
+ *
+ * Unlike OpMethArgs, shapes and small host values of the inputs are part of
+ * the key, since the inferred attrs depend on them.
+ */
+struct InferCacheKey {
+    struct Input {
+        DType dtype;
+        CompNode comp_node;
+        TensorShape shape;
+        bool has_value;
+    };
+
+    std::shared_ptr<OpDef> op;
+    SmallVector<Input> inputs;
+    //! contents of all input values
+    std::string values;
+    size_t hash_value = 0;
+
+    //! return false if the inputs have values too large to be cached
+    bool init(const OpDef& def, const SmallVector<LogicalTensorDesc>& descs) {
+        XXHash state;
+        size_t op_hash = def.hash();
+        state.update(&op_hash, sizeof(op_hash));
+        for (auto&& i : descs) {
+            bool has_value = !i.value.empty();
+            inputs.push_back({i.layout.dtype, i.comp_node, i.layout, has_value});
+            size_t data[] = {
+                    mgb::hash(i.layout.dtype.handle()), mgb::hash(i.comp_node),
+                    i.layout.ndim, has_value};
+            state.update(data, sizeof(data));
+            state.update(i.layout.shape, sizeof(size_t) * i.layout.ndim);
+            if (has_value) {
+                auto&& layout = i.value.layout();
+                size_t size = layout.span().dist_byte();
+                if (!layout.is_contiguous() ||
+                    values.size() + size > MAX_INFER_CACHE_VALUE_SIZE) {
+                    return false;
+                }
+                values.append(reinterpret_cast<const char*>(i.value.raw_ptr()), size);
+            }
+        }
+        state.update(values.data(), values.size());
+        hash_value = state.digest();
+        op = const_cast<OpDef&>(def).shared_from_this();
+        return true;
+    }
+
+    bool operator==(const InferCacheKey& rhs) const {
+        if (hash_value != rhs.hash_value || inputs.size() != rhs.inputs.size() ||
+            values != rhs.values || !op->is_same(*rhs.op)) {
+            return false;
+        }
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            auto &&lhs_i = inputs[i], &&rhs_i = rhs.inputs[i];
+            if (lhs_i.dtype != rhs_i.dtype || lhs_i.comp_node != rhs_i.comp_node ||
+                lhs_i.has_value != rhs_i.has_value ||
+                lhs_i.shape.ndim != rhs_i.shape.ndim ||
+                !lhs_i.shape.eq_shape(rhs_i.shape)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct Hash {
+        size_t operator()(const InferCacheKey& key) const { return key.hash_value; }
+    };
+};
+
+struct InferCache
+        : std::unordered_map<
+                  InferCacheKey, std::tuple<SmallVector<LogicalTensorDesc>, bool>,
+                  InferCacheKey::Hash>,
+          CompNodeDepedentObject {
+    //! not reset when the cache is cleared
+    size_t nr_hit = 0;
+
+    std::shared_ptr<void> on_comp_node_finalize() override {
+        clear();
+        return {};
+    }
+};
+
+InferCache& infer_cache() {
+    thread_local auto& cache = *ResourceManager::create_local<InferCache>();
+    return cache;
+}
+}  // anonymous namespace
+
 std::shared_ptr<OpDef> OpDef::make_from_op_node(cg::OperatorNodeBase* node) {
     OpTrait* trait;
     trait = OpTrait::find_by_typeinfo(node->dyn_typeinfo());
@@ -46,7 +143,28 @@ VarNodeArray OpDef::apply_on_var_node(const OpDef& def, const VarNodeArray& inpu
 
 std::tuple<SmallVector<LogicalTensorDesc>, bool> OpDef::infer_output_attrs_fallible(
         const OpDef& def, const SmallVector<LogicalTensorDesc>& inputs) {
-    return def.trait()->infer_output_attrs_fallible(def, inputs);
+    // ops are applied repeatedly on inputs of the same shapes in a training
+    // loop, and the inference may build a graph, so cache the results
+    auto& cache = infer_cache();
+    InferCacheKey key;
+    if (!key.init(def, inputs)) {
+        return def.trait()->infer_output_attrs_fallible(def, inputs);
+    }
+    auto iter = cache.find(key);
+    if (iter == cache.end()) {
+        auto result = def.trait()->infer_output_attrs_fallible(def, inputs);
+        if (cache.size() >= MAX_INFER_CACHE_SIZE) {
+            cache.clear();
+        }
+        iter = cache.emplace(std::move(key), std::move(result)).first;
+    } else {
+        ++cache.nr_hit;
+    }
+    return iter->second;
+}
+
+size_t OpDef::infer_output_attrs_cache_hits() {
+    return infer_cache().nr_hit;
 }
 
 SmallVector<VarNode::LayoutConstraintCallback> OpDef::get_input_layout_constraint(
@@ -230,7 +348,26 @@ std::shared_ptr<OpDef> Subgraph::as_single() const {
 }
 
 bool Subgraph::operator==(const Subgraph& rhs) const {
-    mgb_assert(false, "Not Implemented");
+    if (inputs != rhs.inputs || outputs != rhs.outputs ||
+        constants.size() != rhs.constants.size() ||
+        exprs.size() != rhs.exprs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < constants.size(); ++i) {
+        // constants are compared by identity
+        if (constants[i] != rhs.constants[i]) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < exprs.size(); ++i) {
+        auto &&lhs_expr = exprs[i], &&rhs_expr = rhs.exprs[i];
+        if (lhs_expr.inputs != rhs_expr.inputs ||
+            lhs_expr.outputs != rhs_expr.outputs ||
+            !lhs_expr.op->is_same(*rhs_expr.op)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 }  // namespace imperative
@@ -182,6 +182,9 @@ struct OpTrait {
     IsSame is_same_st;
     MakeNameFunc make_name;
     GraphMaker make_forward_graph;
+    //! the op draws from an RNG, writes its inputs or talks to other devices,
+    //! so it keeps its order with the other ops and can not be recomputed
+    bool has_side_effect = false;
     OpTrait(const char* name);
     static OpTrait* find_by_name(const char* name);
     static OpTrait* find_by_typeinfo(Typeinfo* type);
@@ -217,6 +220,11 @@ struct OpTraitRegistry {
     FOR_EACH_OP_METH(DECL)
 #undef DECL
 
+    OpTraitRegistry& side_effect() {
+        trait->has_side_effect = true;
+        return *this;
+    }
+
     OpTraitRegistry& fallback();
 
     template <typename T>
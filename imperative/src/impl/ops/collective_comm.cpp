@@ -57,6 +57,7 @@ std::shared_ptr<OpDef> make_from_op_node(cg::OperatorNodeBase* node) {
 OP_TRAIT_REG(CollectiveComm, CollectiveComm, opr::CollectiveComm)
         .apply_on_var_node(apply_on_var_node)
         .make_from_op_node(make_from_op_node)
+        .side_effect()
         .fallback();
 }  // anonymous namespace
 #endif  // MGB_ENABLE_OPR_MM
@@ -304,6 +304,7 @@ OP_TRAIT_REG(InplaceAdd, InplaceAdd, opr::AddUpdate)
         .apply_on_var_node(apply_inplace_add_on_var_node)
         .apply_on_physical_tensor(apply_inplace_add_on_physical_tensor)
         .infer_output_attrs_fallible(infer_inplace_add_output_attrs_fallible)
+        .side_effect()
         .fallback();
 }  // anonymous namespace
 
@@ -48,10 +48,12 @@ cg::OperatorNodeBase* apply_on_var_node_remote_recv(
 
 OP_TRAIT_REG(RemoteSend, RemoteSend, mgb::opr::RemoteSend)
         .apply_on_var_node(apply_on_var_node_remote_send)
+        .side_effect()
         .fallback();
 
 OP_TRAIT_REG(RemoteRecv, RemoteRecv, mgb::opr::RemoteRecv)
         .apply_on_var_node(apply_on_var_node_remote_recv)
+        .side_effect()
         .fallback();
 }  // anonymous namespace
 #endif  // MGB_ENABLE_OPR_MM
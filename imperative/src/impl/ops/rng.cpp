@@ -636,6 +636,7 @@ CompNode get_rng_handle_compnode(Handle handle) {
             .apply_on_physical_tensor(apply_on_physical_tensor<NAME>)       \
             .infer_output_attrs_fallible(infer_output_attrs_fallible<NAME>) \
             .get_input_layout_constraint(get_input_layout_constraint<NAME>) \
+            .side_effect()                                                  \
             .fallback();                                                    \
     }
 
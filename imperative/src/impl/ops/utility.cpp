@@ -119,6 +119,7 @@ OP_TRAIT_REG(Barrier, imperative::Barrier)
         .apply_on_physical_tensor(apply_on_physical_tensor)
         .infer_output_attrs_fallible(infer_output_attrs_fallible)
         .get_input_layout_constraint(get_input_layout_constraint)
+        .side_effect()
         .fallback();
 }  // namespace barrier
 }  // namespace
@@ -412,6 +412,9 @@ public:
     std::string get_mem_allocation_info() const override { mgb_assert(0); }
     VarNode* find_var_by_id(size_t id) const override { mgb_assert(0); }
     void share_device_memory_with(ComputingGraph& other) override { mgb_assert(0); }
+    void share_device_memory_with_arena(const std::string&) override {
+        mgb_assert(0);
+    }
     void set_device_memory_allocator(
             std::shared_ptr<cg::DeviceMemoryAllocator> allocator) override {
         mgb_assert(0);
@@ -90,6 +90,9 @@ protected:
     std::string get_mem_allocation_info() const override { mgb_assert(0); }
     VarNode* find_var_by_id(size_t) const override { mgb_assert(0); }
     void share_device_memory_with(ComputingGraph&) override { mgb_assert(0); }
+    void share_device_memory_with_arena(const std::string&) override {
+        mgb_assert(0);
+    }
     void set_device_memory_allocator(
             std::shared_ptr<cg::DeviceMemoryAllocator>) override {
         mgb_assert(0);
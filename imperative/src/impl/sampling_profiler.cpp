@@ -0,0 +1,382 @@
+#include "megbrain/imperative/sampling_profiler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+
+#include "./event_pool.h"
+#include "./op_trait.h"
+
+using namespace mgb;
+using namespace imperative;
+
+namespace {
+//! max number of op types with histograms; further types are only kept in
+//! the ring buffer
+constexpr size_t MAX_OP_TYPES = 256;
+//! max number of device timings waiting for their events on a thread
+constexpr size_t MAX_PENDING_DEVICE_SAMPLES = 256;
+
+uint64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+}
+
+size_t bucket_of(uint64_t ns) {
+    size_t idx = 0;
+    for (uint64_t us = ns / 1000; us; us >>= 1) {
+        ++idx;
+    }
+    return std::min(idx, SamplingProfiler::NR_BUCKETS - 1);
+}
+
+//! upper bound of bucket \p idx in seconds
+double bucket_bound(size_t idx) {
+    return static_cast<double>(uint64_t(1) << idx) * 1e-6;
+}
+}  // anonymous namespace
+
+struct SamplingProfiler::State {
+    struct Histogram {
+        std::atomic<uint64_t> count{0}, sum_ns{0}, max_ns{0};
+        std::atomic<uint64_t> buckets[NR_BUCKETS]{};
+
+        void add(uint64_t ns) {
+            count.fetch_add(1, std::memory_order_relaxed);
+            sum_ns.fetch_add(ns, std::memory_order_relaxed);
+            auto prev = max_ns.load(std::memory_order_relaxed);
+            while (prev < ns && !max_ns.compare_exchange_weak(
+                                        prev, ns, std::memory_order_relaxed)) {
+            }
+            buckets[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        //! upper bound of the latency at quantile \p q, in seconds
+        double quantile(double q) const {
+            auto total = count.load(std::memory_order_relaxed);
+            uint64_t acc = 0;
+            for (size_t i = 0; i + 1 < NR_BUCKETS; ++i) {
+                acc += buckets[i].load(std::memory_order_relaxed);
+                if (acc >= q * total) {
+                    return bucket_bound(i);
+                }
+            }
+            return max_ns.load(std::memory_order_relaxed) * 1e-9;
+        }
+
+        std::shared_ptr<json::Object> to_json() const {
+            auto ret = json::Object::make();
+            auto nr = count.load(std::memory_order_relaxed);
+            auto sum = sum_ns.load(std::memory_order_relaxed);
+            (*ret)["count"] = json::NumberInt::make(nr);
+            (*ret)["sum_us"] = json::Number::make(sum * 1e-3);
+            (*ret)["mean_us"] = json::Number::make(nr ? sum * 1e-3 / nr : 0.);
+            (*ret)["max_us"] =
+                    json::Number::make(max_ns.load(std::memory_order_relaxed) * 1e-3);
+            for (auto [key, q] : {std::make_pair("p50_us", .5),
+                                  std::make_pair("p90_us", .9),
+                                  std::make_pair("p99_us", .99)}) {
+                (*ret)[key] = json::Number::make(quantile(q) * 1e6);
+            }
+            auto arr = json::Array::make();
+            for (auto&& i : buckets) {
+                arr->add(json::NumberInt::make(i.load(std::memory_order_relaxed)));
+            }
+            (*ret)["buckets"] = arr;
+            return ret;
+        }
+    };
+
+    struct OpStats {
+        std::atomic<const OpTrait*> type{nullptr};
+        Histogram host, device;
+    };
+
+    //! a sample in the ring buffer; seq is odd while the sample is written
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        std::atomic<const char*> op{nullptr};
+        std::atomic<uint64_t> start_ns{0}, host_ns{0};
+    };
+
+    //! device timing of a sampled op waiting for its events
+    struct PendingDevice {
+        std::shared_ptr<State> state;
+        OpStats* stats;
+        std::shared_ptr<CompNode::Event> start, end;
+    };
+
+    Config config;
+    uint64_t epoch_ns = steady_ns();
+    OpStats ops[MAX_OP_TYPES];
+    std::unique_ptr<Slot[]> ring;
+    size_t ring_mask;
+    std::atomic<uint64_t> head{0};
+
+    explicit State(const Config& config_) : config{config_} {
+        size_t size = 1;
+        while (size < std::max<size_t>(config.ring_size, 1)) {
+            size <<= 1;
+        }
+        ring.reset(new Slot[size]);
+        ring_mask = size - 1;
+    }
+
+    uint64_t now_ns() const { return steady_ns() - epoch_ns; }
+
+    //! get the stats of \p type, inserting it without lock if not found
+    OpStats* get_stats(const OpTrait* type) {
+        size_t hash = std::hash<const void*>{}(type);
+        for (size_t i = 0; i < MAX_OP_TYPES; ++i) {
+            auto&& stats = ops[(hash + i) % MAX_OP_TYPES];
+            auto cur = stats.type.load(std::memory_order_acquire);
+            if (!cur &&
+                !stats.type.compare_exchange_strong(
+                        cur, type, std::memory_order_acq_rel)) {
+                // cur is updated to the type inserted by another thread
+            } else if (!cur) {
+                return &stats;
+            }
+            if (cur == type) {
+                return &stats;
+            }
+        }
+        return nullptr;
+    }
+
+    void push(const char* op, uint64_t start_ns, uint64_t host_ns) {
+        auto pos = head.fetch_add(1, std::memory_order_relaxed);
+        auto&& slot = ring[pos & ring_mask];
+        slot.seq.store(pos * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.op.store(op, std::memory_order_relaxed);
+        slot.start_ns.store(start_ns, std::memory_order_relaxed);
+        slot.host_ns.store(host_ns, std::memory_order_relaxed);
+        slot.seq.store(pos * 2 + 2, std::memory_order_release);
+    }
+};
+
+std::atomic_bool SamplingProfiler::sm_enabled{false};
+std::atomic_size_t SamplingProfiler::sm_interval{1};
+std::atomic_size_t SamplingProfiler::sm_burst_period_ms{0};
+std::atomic_size_t SamplingProfiler::sm_burst_ms{0};
+std::atomic<uint64_t> SamplingProfiler::sm_epoch_ms{0};
+std::shared_ptr<SamplingProfiler::State> SamplingProfiler::sm_state;
+
+void SamplingProfiler::enable(const Config& config) {
+    auto state = std::make_shared<State>(config);
+    sm_interval.store(config.interval, std::memory_order_relaxed);
+    sm_burst_period_ms.store(config.burst_period_ms, std::memory_order_relaxed);
+    sm_burst_ms.store(config.burst_ms, std::memory_order_relaxed);
+    sm_epoch_ms.store(state->epoch_ns / 1000000, std::memory_order_relaxed);
+    std::atomic_store(&sm_state, state);
+    sm_enabled.store(true, std::memory_order_relaxed);
+}
+
+void SamplingProfiler::disable() {
+    sm_enabled.store(false, std::memory_order_relaxed);
+}
+
+bool SamplingProfiler::should_sample() {
+    if (auto period = sm_burst_period_ms.load(std::memory_order_relaxed)) {
+        auto elapsed =
+                steady_ns() / 1000000 - sm_epoch_ms.load(std::memory_order_relaxed);
+        return elapsed % period < sm_burst_ms.load(std::memory_order_relaxed);
+    }
+    thread_local size_t tm_counter = 0;
+    if (++tm_counter < sm_interval.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    tm_counter = 0;
+    return true;
+}
+
+SamplingProfiler::Scope SamplingProfiler::begin_sample(CompNode comp_node) {
+    Scope scope;
+    scope.m_state = std::atomic_load(&sm_state);
+    if (!scope.m_state) {
+        return {};
+    }
+    if (scope.m_state->config.profile_device && comp_node.valid()) {
+        scope.m_comp_node = comp_node;
+        scope.m_start_event = EventPool::with_timer().alloc_shared(comp_node);
+        scope.m_start_event->record();
+    }
+    scope.m_start_ns = scope.m_state->now_ns();
+    return scope;
+}
+
+void SamplingProfiler::end_sample(Scope& scope, const OpDef& op) {
+    auto&& state = *scope.m_state;
+    auto host_ns = state.now_ns() - scope.m_start_ns;
+    auto type = op.trait();
+    auto stats = state.get_stats(type);
+    if (stats) {
+        stats->host.add(host_ns);
+    }
+    state.push(type->name, scope.m_start_ns, host_ns);
+
+    // device timings are resolved on later samples of the same thread, so the
+    // events are never waited for
+    thread_local std::deque<State::PendingDevice> tm_pending;
+    if (scope.m_start_event) {
+        auto end = EventPool::with_timer().alloc_shared(scope.m_comp_node);
+        end->record();
+        tm_pending.push_back(
+                {std::move(scope.m_state), stats, std::move(scope.m_start_event),
+                 std::move(end)});
+    }
+    while (!tm_pending.empty()) {
+        auto&& item = tm_pending.front();
+        if (item.end->finished()) {
+            if (item.stats) {
+                auto secs = item.start->elapsed_time_until(*item.end);
+                item.stats->device.add(static_cast<uint64_t>(secs * 1e9));
+            }
+        } else if (tm_pending.size() <= MAX_PENDING_DEVICE_SAMPLES) {
+            break;
+        }
+        tm_pending.pop_front();
+    }
+    scope = {};
+}
+
+std::vector<SamplingProfiler::Sample> SamplingProfiler::recent_samples() {
+    std::vector<Sample> ret;
+    auto state = std::atomic_load(&sm_state);
+    if (!state) {
+        return ret;
+    }
+    auto head = state->head.load(std::memory_order_acquire);
+    auto nr = std::min<uint64_t>(head, state->ring_mask + 1);
+    for (auto pos = head - nr; pos < head; ++pos) {
+        auto&& slot = state->ring[pos & state->ring_mask];
+        auto seq = slot.seq.load(std::memory_order_acquire);
+        if (seq != pos * 2 + 2) {
+            // being written, or overwritten by a newer sample
+            continue;
+        }
+        Sample sample{
+                slot.op.load(std::memory_order_relaxed),
+                slot.start_ns.load(std::memory_order_relaxed),
+                slot.host_ns.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == seq) {
+            ret.push_back(sample);
+        }
+    }
+    return ret;
+}
+
+std::shared_ptr<json::Object> SamplingProfiler::to_json() {
+    auto ret = json::Object::make();
+    auto state = std::atomic_load(&sm_state);
+    if (!state) {
+        return ret;
+    }
+    auto&& config = state->config;
+    auto config_json = json::Object::make();
+    (*config_json)["interval"] = json::NumberInt::make(config.interval);
+    (*config_json)["burst_period_ms"] = json::NumberInt::make(config.burst_period_ms);
+    (*config_json)["burst_ms"] = json::NumberInt::make(config.burst_ms);
+    (*config_json)["profile_device"] = json::Bool::make(config.profile_device);
+    (*ret)["config"] = config_json;
+    (*ret)["enabled"] = json::Bool::make(is_enabled());
+    (*ret)["nr_samples"] =
+            json::NumberInt::make(state->head.load(std::memory_order_relaxed));
+    auto ops = json::Object::make();
+    for (auto&& stats : state->ops) {
+        if (auto type = stats.type.load(std::memory_order_acquire)) {
+            auto op = json::Object::make();
+            (*op)["host"] = stats.host.to_json();
+            if (stats.device.count.load(std::memory_order_relaxed)) {
+                (*op)["device"] = stats.device.to_json();
+            }
+            (*ops)[type->name] = op;
+        }
+    }
+    (*ret)["ops"] = ops;
+    auto recent = json::Array::make();
+    for (auto&& sample : recent_samples()) {
+        auto item = json::Object::make();
+        (*item)["op"] = json::String::make(sample.op);
+        (*item)["start_us"] = json::Number::make(sample.start_ns * 1e-3);
+        (*item)["host_us"] = json::Number::make(sample.host_ns * 1e-3);
+        recent->add(item);
+    }
+    (*ret)["recent"] = recent;
+    return ret;
+}
+
+std::string SamplingProfiler::to_prometheus() {
+    std::string ret;
+    auto state = std::atomic_load(&sm_state);
+    if (!state) {
+        return ret;
+    }
+    auto dump_metric = [&](const char* metric, const char* help, auto get_hist) {
+        ret += ssprintf("# HELP %s %s\n# TYPE %s histogram\n", metric, help, metric);
+        for (auto&& stats : state->ops) {
+            auto type = stats.type.load(std::memory_order_acquire);
+            auto&& hist = get_hist(stats);
+            auto count = hist.count.load(std::memory_order_relaxed);
+            if (!type || !count) {
+                continue;
+            }
+            uint64_t acc = 0;
+            for (size_t i = 0; i + 1 < NR_BUCKETS; ++i) {
+                acc += hist.buckets[i].load(std::memory_order_relaxed);
+                ret += ssprintf(
+                        "%s_bucket{op=\"%s\",le=\"%g\"} %llu\n", metric, type->name,
+                        bucket_bound(i), static_cast<unsigned long long>(acc));
+            }
+            // counters are read without lock, so +Inf is computed from buckets
+            acc += hist.buckets[NR_BUCKETS - 1].load(std::memory_order_relaxed);
+            ret += ssprintf(
+                    "%s_bucket{op=\"%s\",le=\"+Inf\"} %llu\n", metric, type->name,
+                    static_cast<unsigned long long>(acc));
+            ret += ssprintf(
+                    "%s_sum{op=\"%s\"} %g\n", metric, type->name,
+                    hist.sum_ns.load(std::memory_order_relaxed) * 1e-9);
+            ret += ssprintf(
+                    "%s_count{op=\"%s\"} %llu\n", metric, type->name,
+                    static_cast<unsigned long long>(acc));
+        }
+    };
+    dump_metric(
+            "megengine_op_host_latency_seconds",
+            "Host latency of the sampled imperative ops.",
+            [](State::OpStats& stats) -> State::Histogram& { return stats.host; });
+    if (state->config.profile_device) {
+        dump_metric(
+                "megengine_op_device_latency_seconds",
+                "Device latency of the sampled imperative ops.",
+                [](State::OpStats& stats) -> State::Histogram& {
+                    return stats.device;
+                });
+    }
+    return ret;
+}
+
+void SamplingProfiler::dump(const std::string& path, const std::string& format) {
+    std::string content;
+    if (format == "json") {
+        content = to_json()->to_string();
+    } else if (format == "prometheus") {
+        content = to_prometheus();
+    } else {
+        mgb_throw(MegBrainError, "unknown sampling profile format: %s", format.c_str());
+    }
+    // metric collectors may read the file at any time, so it is replaced at once
+    auto tmp_path = path + ".tmp";
+    {
+        std::ofstream fout(tmp_path);
+        mgb_throw_if(!fout, MegBrainError, "failed to open %s", tmp_path.c_str());
+        fout << content;
+    }
+    mgb_throw_if(
+            std::rename(tmp_path.c_str(), path.c_str()), MegBrainError,
+            "failed to write %s", path.c_str());
+}
@@ -3,12 +3,160 @@
 #include "megbrain/imperative/ops/autogen.h"
 
 #include "megbrain/opr/utility.h"
+#include "megbrain/utils/hash.h"
 
 #include "../mgb_cg_impl.h"
 
+#include <cstring>
+#include <list>
+
 namespace mgb {
 namespace imperative {
 
+namespace {
+//! tags of the records in GraphKey::code
+enum RecordTag : size_t { INPUT, HOST_CONST, DEVICE_CONST, APPLY, OUTPUTS };
+
+size_t graph_cache_capacity() {
+    static size_t capacity = [] {
+        auto env = MGB_GETENV("MEGENGINE_LAZY_EVAL_CACHE_SIZE");
+        return env ? std::stoul(env) : 16;
+    }();
+    return capacity;
+}
+}  // anonymous namespace
+
+size_t LazyEvalTransformation::GraphKey::hash() const {
+    XXHash hasher;
+    hasher.update(code.data(), code.size() * sizeof(size_t));
+    size_t ret = hasher.digest();
+    for (auto&& op : ops) {
+        ret = hash_pair_combine(ret, op->hash());
+    }
+    for (auto&& desc : inputs) {
+        ret = hash_pair_combine(ret, mgb::hash(desc.layout.dtype.enumv()));
+        for (size_t i = 0; i < desc.layout.ndim; ++i) {
+            ret = hash_pair_combine(ret, desc.layout[i]);
+        }
+    }
+    for (auto&& value : host_consts) {
+        hasher.reset();
+        hasher.update(value.raw_ptr(), value.layout().span().dist_byte());
+        ret = hash_pair_combine(ret, hasher.digest());
+    }
+    for (auto&& value : device_consts) {
+        ret = hash_pair_combine(ret, mgb::hash(value.raw_ptr()));
+    }
+    return hash_pair_combine(ret, mgb::hash(options));
+}
+
+bool LazyEvalTransformation::GraphKey::operator==(const GraphKey& rhs) const {
+    auto eq_op = [](auto&& lhs, auto&& rhs) { return lhs->is_same(*rhs); };
+    auto eq_desc = [](const LogicalTensorDesc& lhs, const LogicalTensorDesc& rhs) {
+        return lhs.comp_node == rhs.comp_node && lhs.layout.dtype == rhs.layout.dtype &&
+               lhs.layout.eq_shape(rhs.layout);
+    };
+    // host consts are folded into the graph, so their values must match
+    auto eq_host = [](const HostTensorND& lhs, const HostTensorND& rhs) {
+        return lhs.comp_node() == rhs.comp_node() &&
+               lhs.layout().eq_layout(rhs.layout()) &&
+               !memcmp(lhs.raw_ptr(), rhs.raw_ptr(), lhs.layout().span().dist_byte());
+    };
+    // device consts are read on execution, so only the storage must match
+    auto eq_device = [](const DeviceTensorND& lhs, const DeviceTensorND& rhs) {
+        return lhs.comp_node() == rhs.comp_node() && lhs.raw_ptr() == rhs.raw_ptr() &&
+               lhs.layout().eq_layout(rhs.layout());
+    };
+    auto eq = [](auto&& lhs, auto&& rhs, auto&& pred) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), pred);
+    };
+    return code == rhs.code && options == rhs.options && eq(ops, rhs.ops, eq_op) &&
+           eq(inputs, rhs.inputs, eq_desc) &&
+           eq(host_consts, rhs.host_consts, eq_host) &&
+           eq(device_consts, rhs.device_consts, eq_device);
+}
+
+struct LazyEvalTransformation::CompiledGraph {
+    GraphKey key;
+    size_t hash;
+    std::shared_ptr<ComputingGraph> graph;
+    std::shared_ptr<GraphSlots> slots;
+    std::unique_ptr<cg::AsyncExecutable> executable;
+};
+
+/*!
+ * \brief least recently used compiled graphs
+ *
+ * A graph is taken out of the cache while executing, so that it is never
+ * executed by two threads at the same time.
+ */
+class LazyEvalTransformation::GraphCache final : public CompNodeDepedentObject {
+    std::mutex m_mutex;
+    std::list<std::unique_ptr<CompiledGraph>> m_graphs;
+    GraphCacheStats m_stats;
+
+    std::shared_ptr<void> on_comp_node_finalize() override {
+        MGB_LOCK_GUARD(m_mutex);
+        m_graphs.clear();
+        return {};
+    }
+
+public:
+    static GraphCache& inst() {
+        static GraphCache cache;
+        return cache;
+    }
+
+    std::unique_ptr<CompiledGraph> take(const GraphKey& key, size_t hash) {
+        MGB_LOCK_GUARD(m_mutex);
+        for (auto iter = m_graphs.begin(); iter != m_graphs.end(); ++iter) {
+            if ((*iter)->hash == hash && (*iter)->key == key) {
+                auto ret = std::move(*iter);
+                m_graphs.erase(iter);
+                ++m_stats.nr_hit;
+                return ret;
+            }
+        }
+        ++m_stats.nr_miss;
+        return {};
+    }
+
+    GraphCacheStats stats() {
+        MGB_LOCK_GUARD(m_mutex);
+        return m_stats;
+    }
+
+    void put(std::unique_ptr<CompiledGraph> graph) {
+        MGB_LOCK_GUARD(m_mutex);
+        if (is_finalized()) {
+            return;
+        }
+        m_graphs.push_front(std::move(graph));
+        while (m_graphs.size() > graph_cache_capacity()) {
+            m_graphs.pop_back();
+        }
+    }
+};
+
+LazyEvalTransformation::GraphCacheStats LazyEvalTransformation::graph_cache_stats() {
+    return GraphCache::inst().stats();
+}
+
+VarNode* LazyEvalTransformation::make_input(DeviceTensorND value) {
+    m_key.code.push_back(INPUT);
+    m_key.inputs.push_back({{value.shape(), value.dtype()}, value.comp_node()});
+    auto callback = [slots = m_slots, idx = m_slots->inputs.size()]() {
+        return std::move(slots->inputs[idx]);
+    };
+    auto* node = opr::InputCallback::make(
+                         *m_graph, callback, value.comp_node(), value.dtype(),
+                         value.shape(), {}, true)[0]
+                         .node();
+    m_slots->inputs.push_back(std::move(value));
+    var_id(node);
+    return node;
+}
+
 ValueRefList LazyEvalTransformation::apply_transformation(
         const Operator& op, Span<ValueRef> inputs) {
     if (auto* op_val = op.as<ApplyOp>()) {
@@ -24,18 +172,15 @@ ValueRefList LazyEvalTransformation::apply_transformation(
                 input_nodes.push_back(input_node->node());
             } else {
                 // ImmutableTensor has empty shape issues
-                auto dev_val = input.dev_tensor()->as_nd();
-                auto dev_val_provider = [dev_val]() mutable {
-                    return std::move(dev_val);
-                };
-                auto* node = opr::InputCallback::make(
-                                     *m_graph, dev_val_provider, *input.device(),
-                                     *input.dtype(), input.shape()->as_tensor_shape(),
-                                     {}, true)[0]
-                                     .node();
-                input_nodes.push_back(node);
+                input_nodes.push_back(make_input(input.dev_tensor()->as_nd()));
             }
         }
+        m_key.code.push_back(APPLY);
+        m_key.code.push_back(input_nodes.size());
+        for (auto* node : input_nodes) {
+            m_key.code.push_back(var_id(node));
+        }
+        m_key.ops.push_back(op_val->op().shared_from_this());
         if (require_link && m_io_link.node()) {
             mgb_assert(!input_nodes.empty());
             auto comp_node = m_io_link.node()->comp_node();
@@ -69,7 +214,12 @@ ValueRefList LazyEvalTransformation::apply_transformation(
             VarNode* node;
             if (args.host) {
                 node = opr::ImmutableTensor::make(*m_graph, *args.host).node();
+                m_key.code.push_back(HOST_CONST);
+                m_key.host_consts.push_back(*args.host);
+                m_key.cacheable &= args.host->layout().is_contiguous();
             } else {
+                m_key.code.push_back(DEVICE_CONST);
+                m_key.device_consts.push_back(*args.device);
                 node = opr::SharedDeviceTensor::make(
                                *m_graph, std::make_shared<DeviceTensorND>(*args.device),
                                true, {})
@@ -89,15 +239,7 @@ ValueRefList LazyEvalTransformation::apply_transformation(
             }
         } else {
             // FIXME: reason for sync
-            auto dev_val = get_dev_val();
-            auto callback = [dev_val]() mutable -> DeviceTensorND {
-                return std::move(dev_val);
-            };
-            auto* node = opr::InputCallback::make(
-                                 *m_graph, callback, dev_val.comp_node(),
-                                 dev_val.dtype(), dev_val.shape(), {}, true)[0]
-                                 .node();
-            return {record_var(node)};
+            return {record_var(make_input(get_dev_val()))};
         }
     } else if (auto* get_attr = op.as<GetAttr>()) {
         if (auto* lazy_val = inputs.item().as(m_value_type)) {
@@ -199,48 +341,88 @@ void LazyEvalTransformation::on_unregister() noexcept {
         }
         return;
     }
-    std::mutex mtx;
-    std::vector<std::pair<LazyEvalValue::ref_t, DeviceTensorND>> values;
-    ComputingGraph::OutputSpec output_specs;
-    for (auto&& lazy_val : lazy_vals) {
-        auto* output = opr::OutputCallback::make(
-                               {[lazy_val, &mtx, &values](DeviceTensorND data) {
-                                   MGB_LOCK_GUARD(mtx);
-                                   values.push_back({lazy_val, data});
-                               }},
-                               lazy_val->node())
-                               .node();
-        output_specs.push_back({output, {}});
-    }
-    if (m_io_link.node()) {
-        output_specs.push_back({m_io_link, {}});
-    }
-    if (output_specs.empty()) {
-        return;
+    bool use_cache = m_graph_cache_enabled && m_key.cacheable;
+    size_t hash = 0;
+    std::unique_ptr<CompiledGraph> compiled;
+    if (use_cache) {
+        m_key.code.push_back(OUTPUTS);
+        for (auto&& lazy_val : lazy_vals) {
+            m_key.code.push_back(var_id(lazy_val->node()));
+        }
+        hash = m_key.hash();
+        compiled = GraphCache::inst().take(m_key, hash);
     }
-    {
-        // set_priority_to_id
-        auto on_opr = [](mgb::cg::OperatorNodeBase* opr) {
-            if (opr->node_prop().attribute().priority == 0) {
-                opr->node_prop().attribute().priority = opr->id();
+    if (compiled) {
+        // the compiled graph has the same inputs in the same order
+        compiled->slots->inputs = std::move(m_slots->inputs);
+    } else {
+        ComputingGraph::OutputSpec output_specs;
+        for (size_t i = 0; i < lazy_vals.size(); ++i) {
+            auto* output = opr::OutputCallback::make(
+                                   {[slots = m_slots, i](DeviceTensorND data) {
+                                       slots->outputs[i] = data;
+                                   }},
+                                   lazy_vals[i]->node())
+                                   .node();
+            output_specs.push_back({output, {}});
+        }
+        if (m_io_link.node()) {
+            output_specs.push_back({m_io_link, {}});
+        }
+        if (output_specs.empty()) {
+            return;
+        }
+        {
+            // set_priority_to_id
+            auto on_opr = [](mgb::cg::OperatorNodeBase* opr) {
+                if (opr->node_prop().attribute().priority == 0) {
+                    opr->node_prop().attribute().priority = opr->id();
+                }
+            };
+            mgb::cg::DepOprIter dep_iter{on_opr};
+            for (auto&& output_spec : output_specs) {
+                dep_iter.add(output_spec.first);
             }
-        };
-        mgb::cg::DepOprIter dep_iter{on_opr};
-        for (auto&& output_spec : output_specs) {
-            dep_iter.add(output_spec.first);
+        }
+        compiled = std::make_unique<CompiledGraph>();
+        compiled->graph = m_graph;
+        compiled->slots = m_slots;
+        try {
+            compiled->executable = m_graph->compile(output_specs);
+        } catch (...) {
+            m_graph_exc = std::current_exception();
+        }
+    }
+    auto&& slots = *compiled->slots;
+    slots.outputs.resize(lazy_vals.size());
+    if (!m_graph_exc) {
+        try {
+            compiled->executable->execute();
+            compiled->executable->wait();
+        } catch (...) {
+            m_graph_exc = std::current_exception();
         }
     }
-    try {
-        auto exectuble = m_graph->compile(output_specs);
-        exectuble->execute();
-        exectuble->wait();
-    } catch (...) {
-        m_graph_exc = std::current_exception();
+    for (size_t i = 0; i < lazy_vals.size(); ++i) {
+        auto&& data = slots.outputs[i];
+        if (data.comp_node().valid()) {
+            lazy_vals[i].reset(imperative::apply(
+                    CreateTensor(CreateTensor::Common, data.comp_node(), data.layout()),
+                    DeviceStorage::make(data.storage()))[0]);
+        }
     }
-    for (auto&& [var, data] : values) {
-        var.reset(imperative::apply(
-                CreateTensor(CreateTensor::Common, data.comp_node(), data.layout()),
-                DeviceStorage::make(data.storage()))[0]);
+    // the values are owned by the tensors now
+    slots.inputs.clear();
+    slots.outputs.clear();
+    if (use_cache && !m_graph_exc) {
+        if (compiled->graph == m_graph) {
+            compiled->hash = hash;
+            compiled->key = std::move(m_key);
+        }
+        // the activations are allocated again on the next hit, so a cached
+        // graph only keeps its device consts after its trace is dropped
+        compiled->executable->clear_device_memory();
+        GraphCache::inst().put(std::move(compiled));
     }
     for (auto&& lazy_val : lazy_vals) {
         if (lazy_val.is(m_value_type)) {
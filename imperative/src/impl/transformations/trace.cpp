@@ -24,6 +24,17 @@
 namespace mgb {
 namespace imperative {
 
+namespace {
+//! value of bound data, which is kept as HostValue if the trace result is
+//! restored from a trace cache
+HostTensorND bound_host_value(const ValueRef& data) {
+    if (auto&& host = data.as_ref<HostValue>()) {
+        return host->as_nd();
+    }
+    return data.numpy()->as_nd();
+}
+}  // anonymous namespace
+
 VarNodeArray TraceResult::dump(
         ComputingGraph& graph,
         std::vector<std::tuple<size_t, std::string, TensorShape>> inputs,
@@ -60,11 +71,11 @@ VarNodeArray TraceResult::dump(
                 }
                 if (!var.name.empty()) {
                     node = opr::ImmutableTensor::make(
-                                   graph, var.bound_data.numpy()->as_nd(), {var.name})
+                                   graph, bound_host_value(var.bound_data), {var.name})
                                    .node();
                 } else {
                     node = opr::ImmutableTensor::make(
-                                   graph, var.bound_data.numpy()->as_nd())
+                                   graph, bound_host_value(var.bound_data))
                                    .node();
                 }
             }
@@ -302,6 +313,19 @@ void CompiledTransformation::compile() {
         VarAccessor accessor;
         accessor.node = node.node();
         if (auto bound_data = var_info->bound_data) {
+            if (auto host = bound_data.as_ref<HostValue>()) {
+                auto value = host->as_nd();
+                accessor.shape_getter = [value]() -> TensorShape {
+                    return value.shape();
+                };
+                accessor.data_getter = [value]() -> DeviceTensorND {
+                    DeviceTensorND data{value.comp_node()};
+                    data.copy_from(value).sync();
+                    return data;
+                };
+                accessor.value_getter = [value]() -> HostTensorND { return value; };
+                return accessor;
+            }
             accessor.shape_getter = [bound_data]() -> TensorShape {
                 return bound_data.shape()->as_tensor_shape();
             };
@@ -383,7 +407,7 @@ void CompiledTransformation::compile() {
         VarAccessor accessor;
         mgb_assert(
                 var_info->kind == VarKind::Constant, "const node should be constant");
-        HostTensorND host_val = var_info->bound_data.numpy()->as_nd();
+        HostTensorND host_val = bound_host_value(var_info->bound_data);
         accessor.node = opr::ImmutableTensor::make(*m_graph, host_val).node();
         return accessor;
     };
@@ -9,6 +9,22 @@ class BlobManager : public NonCopyableObj {
 public:
     using allocator_t =
             std::function<DeviceTensorStorage::RawStorage(CompNode, size_t)>;
+
+    //! statistics of cached blob storage on a comp node
+    struct CacheStats {
+        size_t allocated = 0;  //!< bytes of storage in use
+        size_t cached = 0;  //!< bytes held from the comp node allocator
+        size_t largest_free = 0;  //!< size of the largest free cached block
+        size_t nr_alloc = 0;  //!< number of storage allocations
+        size_t nr_segment_alloc = 0;  //!< allocations from comp node
+        size_t nr_defrag = 0;  //!< number of defragmentations
+
+        //! fraction of free cached memory outside of the largest free block
+        double fragmentation() const {
+            size_t free = cached - allocated;
+            return free ? 1 - double(largest_free) / free : 0;
+        }
+    };
     virtual ~BlobManager() = default;
 
     static BlobManager* inst();
@@ -27,6 +43,11 @@ public:
     virtual void unregister_blob(OwnedBlob* blob) = 0;
 
     virtual void defrag(const CompNode& cn) = 0;
+
+    virtual CacheStats get_cache_stats(CompNode cn) = 0;
+
+    //! release cached storage that is not in use to the comp node
+    virtual void empty_cache(CompNode cn) = 0;
 };
 
 }  // namespace imperative
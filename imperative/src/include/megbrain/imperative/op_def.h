@@ -57,6 +57,10 @@ public:
     static std::tuple<SmallVector<LogicalTensorDesc>, bool> infer_output_attrs_fallible(
             const OpDef& def, const SmallVector<LogicalTensorDesc>& inputs);
 
+    //! number of infer_output_attrs_fallible calls in this thread whose result
+    //! is taken from the cache
+    static size_t infer_output_attrs_cache_hits();
+
     static EncodedSubgraph make_backward_graph(
             const OpDef& def, const SmallVector<LogicalTensorDesc>& inputs,
             const SmallVector<bool>& input_requires_grad,
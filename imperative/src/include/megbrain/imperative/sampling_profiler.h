@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "megbrain/comp_node.h"
+#include "megbrain/imperative/op_def.h"
+#include "megbrain/utils/json.h"
+
+namespace mgb {
+namespace imperative {
+
+/*!
+ * \brief profiler cheap enough to be kept on in production
+ *
+ * Only a part of the ops is sampled: one in every \p interval ops, or all the
+ * ops in bursts of \p burst_ms milliseconds every \p burst_period_ms
+ * milliseconds. Latencies of the sampled ops are added to per-op-type
+ * histograms of atomic counters, and the latest samples are kept in a
+ * fixed-size ring buffer, so recording takes no lock. Ops not sampled only
+ * pay for a thread-local counter.
+ *
+ * Host latency covers the execution of the op by the interpreter, which is
+ * only the kernel dispatch on asynchronous comp nodes; device latency is
+ * measured with timer events if \p profile_device is set.
+ */
+class SamplingProfiler {
+    struct State;
+
+public:
+    struct Config {
+        //! sample one op in every \p interval ops if bursts are disabled
+        size_t interval = 100;
+        //! sample all ops for \p burst_ms in every \p burst_period_ms
+        size_t burst_period_ms = 0, burst_ms = 0;
+        //! measure device time with timer events on the comp node of op
+        bool profile_device = false;
+        //! number of latest samples kept, rounded up to a power of 2
+        size_t ring_size = 4096;
+    };
+
+    //! bucket i of the histograms counts latencies in [2^(i-1), 2^i)
+    //! microseconds, and the last bucket is unbounded
+    static constexpr size_t NR_BUCKETS = 32;
+
+    struct Sample {
+        const char* op;
+        //! host time since the profiler was enabled
+        uint64_t start_ns;
+        uint64_t host_ns;
+    };
+
+    //! a sampled op in execution, or empty if the op is not sampled
+    class Scope {
+        std::shared_ptr<State> m_state;
+        CompNode m_comp_node;
+        uint64_t m_start_ns = 0;
+        std::shared_ptr<CompNode::Event> m_start_event;
+        friend class SamplingProfiler;
+
+    public:
+        explicit operator bool() const { return m_state != nullptr; }
+    };
+
+    /*!
+     * \brief start sampling with a new set of histograms
+     *
+     * Ops in execution keep recording to the previous histograms.
+     */
+    static void enable(const Config& config);
+
+    static void disable();
+
+    static bool is_enabled() { return sm_enabled.load(std::memory_order_relaxed); }
+
+    //! decide whether the op to be executed on \p comp_node is sampled
+    static Scope begin(CompNode comp_node) {
+        if (!is_enabled() || !should_sample()) {
+            return {};
+        }
+        return begin_sample(comp_node);
+    }
+
+    //! record the latency of a sampled op
+    static void end(Scope& scope, const OpDef& op) {
+        if (scope) {
+            end_sample(scope, op);
+        }
+    }
+
+    //! latest samples in time order
+    static std::vector<Sample> recent_samples();
+
+    //! histograms and latest samples as a json object
+    static std::shared_ptr<json::Object> to_json();
+
+    //! histograms in prometheus text exposition format
+    static std::string to_prometheus();
+
+    //! write to_json() or to_prometheus() to \p path, by \p format of "json"
+    //! or "prometheus"
+    static void dump(const std::string& path, const std::string& format);
+
+private:
+    static std::atomic_bool sm_enabled;
+    static std::atomic_size_t sm_interval, sm_burst_period_ms, sm_burst_ms;
+    static std::atomic<uint64_t> sm_epoch_ms;
+    //! accessed with std::atomic_load and std::atomic_store
+    static std::shared_ptr<State> sm_state;
+
+    static bool should_sample();
+    static Scope begin_sample(CompNode comp_node);
+    static void end_sample(Scope& scope, const OpDef& op);
+};
+
+}  // namespace imperative
+}  // namespace mgb
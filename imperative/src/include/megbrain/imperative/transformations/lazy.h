@@ -1,6 +1,7 @@
 #pragma once
 
 #include <future>
+#include <unordered_map>
 #include <variant>
 
 #include "megbrain/imperative/dispatch.h"
@@ -43,15 +44,65 @@ public:
  * 3. Try infer value/shape when handling GetAttr;
  * 4. Compile and execute graph, get values and replace LazyEvalValues by concrete
  * values.
+ *
+ * If graph cache is enabled, the structure of the recorded graph is kept as a
+ * GraphKey, and compiled graphs are shared by all the transformations which
+ * record the same structure, with external values fed through InputCallback.
  */
 class LazyEvalTransformation final : public Transformation {
+public:
+    /*!
+     * \brief structure of the recorded graph
+     *
+     * Ops and external values are recorded in order; values produced by the
+     * graph are referred by the order they are recorded.
+     */
+    struct GraphKey {
+        //! tags of the records, followed by their var ids
+        std::vector<size_t> code;
+        std::vector<std::shared_ptr<OpDef>> ops;
+        SmallVector<LogicalTensorDesc> inputs;
+        std::vector<HostTensorND> host_consts;
+        std::vector<DeviceTensorND> device_consts;
+        //! identifies the graph options, which are not compared
+        std::string options;
+        bool cacheable = true;
+
+        size_t hash() const;
+        bool operator==(const GraphKey& rhs) const;
+    };
+
+    //! lookups of the graph cache shared by all the transformations
+    struct GraphCacheStats {
+        size_t nr_hit = 0, nr_miss = 0;
+    };
+    static GraphCacheStats graph_cache_stats();
+
 private:
+    //! values exchanged with a compiled graph through callbacks
+    struct GraphSlots {
+        std::vector<DeviceTensorND> inputs, outputs;
+    };
+    struct CompiledGraph;
+    class GraphCache;
+
     bool m_no_exec;
+    bool m_graph_cache_enabled = false;
     std::shared_ptr<ComputingGraph> m_graph;
     std::vector<LazyEvalValue::weak_ref_t> m_weak_vars;
     SymbolVar m_io_link = nullptr;
     std::exception_ptr m_graph_exc;
     ObjectType<LazyEvalValue> m_value_type{"LazyEvalValue"};
+    GraphKey m_key;
+    std::shared_ptr<GraphSlots> m_slots = std::make_shared<GraphSlots>();
+    std::unordered_map<VarNode*, size_t> m_var_ids;
+
+    //! make a var fed by \p value on each execution
+    VarNode* make_input(DeviceTensorND value);
+
+    size_t var_id(VarNode* node) {
+        return m_var_ids.emplace(node, m_var_ids.size()).first->second;
+    }
 
 public:
     LazyEvalTransformation(bool no_exec) : m_no_exec(no_exec) {
@@ -60,6 +111,7 @@ public:
 
     LazyEvalValue::ref_t record_var(
             VarNode* node, ValueRef bound_data = {}, std::string name = {}) {
+        var_id(node);
         auto lazy_eval_val = m_value_type.make(node, bound_data, name);
         m_weak_vars.push_back(lazy_eval_val);
         return lazy_eval_val;
@@ -67,6 +119,18 @@ public:
 
     ComputingGraph::Options& options() { return m_graph->options(); }
 
+    /*!
+     * \brief reuse the compiled graph of previous transformations which record
+     * the same graph
+     *
+     * \param options identifies the options set by options(), since graphs
+     *      compiled with different options are not interchangeable
+     */
+    void enable_graph_cache(std::string options) {
+        m_graph_cache_enabled = true;
+        m_key.options = std::move(options);
+    }
+
     ValueRefList apply_transformation(
             const Operator& op, Span<ValueRef> inputs) override;
 
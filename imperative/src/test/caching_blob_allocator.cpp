@@ -0,0 +1,115 @@
+#include "./helper.h"
+
+#include "../impl/caching_blob_allocator.h"
+#include "megbrain/comp_node_env.h"
+#include "megbrain/utils/timer.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace mgb;
+using namespace imperative;
+
+TEST(TestCachingBlobAllocator, ReuseAndCoalesce) {
+    auto cn = CompNode::load("cpu0");
+    CachingBlobAllocator allocator;
+    auto a = allocator.alloc(cn, 1000), b = allocator.alloc(cn, 3000),
+         c = allocator.alloc(cn, 500);
+    auto stats = allocator.stats(cn);
+    ASSERT_EQ(1u, stats.nr_segment_alloc);
+    ASSERT_EQ(3u, stats.nr_alloc);
+    ASSERT_GE(stats.allocated, 4500u);
+
+    // blocks are split from the same segment
+    ASSERT_LT(a.get(), b.get());
+    ASSERT_LT(b.get(), c.get());
+
+    // freed neighbors are coalesced, so a larger block fits at a
+    auto pa = a.get();
+    a.reset();
+    b.reset();
+    cn.sync();
+    auto d = allocator.alloc(cn, 3500);
+    ASSERT_EQ(pa, d.get());
+    ASSERT_EQ(1u, allocator.stats(cn).nr_segment_alloc);
+
+    // large requests use separate segments
+    auto e = allocator.alloc(cn, 16 << 20);
+    stats = allocator.stats(cn);
+    ASSERT_EQ(2u, stats.nr_segment_alloc);
+    auto pe = e.get();
+    e.reset();
+    cn.sync();
+    ASSERT_EQ(pe, allocator.alloc(cn, 12 << 20).get());
+
+    c.reset();
+    d.reset();
+    cn.sync();
+    stats = allocator.stats(cn);
+    ASSERT_EQ(0u, stats.allocated);
+    ASSERT_EQ(size_t(16 << 20), stats.largest_free);
+    allocator.empty_cache(cn);
+    stats = allocator.stats(cn);
+    ASSERT_EQ(0u, stats.cached);
+    ASSERT_EQ(0., stats.fragmentation());
+}
+
+TEST(TestCachingBlobAllocator, FreeAfterPendingTasks) {
+    auto cn = CompNode::load("cpu0");
+    CachingBlobAllocator allocator;
+    auto a = allocator.alloc(cn, 1000);
+    auto pa = a.get();
+    std::atomic_bool started{false}, done{false};
+    CompNodeEnv::from_comp_node(cn).cpu_env().dispatch([&]() {
+        started = true;
+        while (!done) {
+            std::this_thread::yield();
+        }
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+
+    // a task issued before the release may still use the block
+    a.reset();
+    auto b = allocator.alloc(cn, 1000);
+    ASSERT_NE(pa, b.get());
+    ASSERT_GE(allocator.stats(cn).allocated, 2000u);
+
+    done = true;
+    cn.sync();
+    ASSERT_EQ(pa, allocator.alloc(cn, 1000).get());
+}
+
+TEST(TestCachingBlobAllocator, StorageOutlivesAllocator) {
+    auto cn = CompNode::load("cpu0");
+    CachingBlobAllocator::RawStorage storage;
+    {
+        CachingBlobAllocator allocator;
+        storage = allocator.alloc(cn, 100);
+    }
+    memset(storage.get(), 0, 100);
+    storage.reset();
+}
+
+TEST(TestCachingBlobAllocator, BenchmarkAlloc) {
+    constexpr size_t NR_ITER = 10000;
+    auto cn = CompNode::load("cpu0");
+    CachingBlobAllocator allocator;
+    for (size_t size : {1 << 10, 1 << 16, 1 << 22}) {
+        RealTimer timer;
+        for (size_t i = 0; i < NR_ITER; ++i) {
+            DeviceTensorStorage storage{cn};
+            storage.ensure_size(size);
+        }
+        cn.sync();
+        auto time_direct = timer.get_secs_reset();
+        for (size_t i = 0; i < NR_ITER; ++i) {
+            allocator.alloc(cn, size);
+        }
+        cn.sync();
+        auto time_cached = timer.get_secs();
+        mgb_log("alloc %zu bytes: comp node %.3fus cached %.3fus", size,
+                time_direct * 1e6 / NR_ITER, time_cached * 1e6 / NR_ITER);
+    }
+}
@@ -0,0 +1,193 @@
+#include "./helper.h"
+
+#include "../impl/interpreter/eviction_index.h"
+#include "megbrain/utils/timer.h"
+
+#include <random>
+
+using namespace mgb;
+using namespace imperative;
+using namespace interpreter::intl;
+
+namespace {
+struct Key {
+    double k, d;
+};
+
+//! reference implementation: scan all the keys
+TensorInfo* scan_best(
+        std::vector<TensorInfo>& infos, const std::vector<Key>& keys,
+        const std::vector<bool>& alive, double now) {
+    TensorInfo* best = nullptr;
+    double best_val = 0;
+    for (size_t i = 0; i < infos.size(); ++i) {
+        if (alive[i]) {
+            double val = keys[i].k / (now - keys[i].d);
+            if (!best || val < best_val) {
+                best = &infos[i];
+                best_val = val;
+            }
+        }
+    }
+    return best;
+}
+}  // anonymous namespace
+
+TEST(TestDTREvictionIndex, MatchScan) {
+    constexpr size_t N = 200;
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<double> dist_k{0.1, 10}, dist_t{0, 1};
+    std::vector<TensorInfo> infos(N);
+    std::vector<Key> keys(N);
+    std::vector<bool> alive(N, false);
+    EvictionIndex index;
+    double now = 1;
+    auto set = [&](size_t i) {
+        keys[i] = {dist_k(rng), now - dist_t(rng) - 1e-3};
+        alive[i] = true;
+        index.set(&infos[i], keys[i].k, keys[i].d, now);
+    };
+    for (size_t i = 0; i < N; ++i) {
+        set(i);
+    }
+    for (int iter = 0; iter < 5000; ++iter) {
+        now += dist_t(rng) * (iter % 7 ? 0.01 : 1);
+        auto i = rng() % N;
+        switch (rng() % 3) {
+            case 0:
+                set(i);
+                break;
+            case 1:
+                alive[i] = false;
+                index.erase(&infos[i], now);
+                break;
+            default:
+                break;
+        }
+        auto expect = scan_best(infos, keys, alive, now);
+        auto get = index.top(now);
+        ASSERT_EQ(expect == nullptr, get == nullptr);
+        if (expect) {
+            auto val = [&](TensorInfo* ptr) {
+                auto&& key = keys[ptr - infos.data()];
+                return key.k / (now - key.d);
+            };
+            ASSERT_LE(val(get), val(expect) * (1 + 1e-9));
+        }
+    }
+    index.clear();
+    for (auto&& i : infos) {
+        ASSERT_EQ(UINT_MAX, i.index_pos);
+    }
+}
+
+TEST(TestDTREvictionIndex, StaleKeyBound) {
+    // k = a / (m + f) as in TensorInfo::eval_func_time_invariant, where f is
+    // the free memory around the tensor, which may change without the key
+    // being refreshed
+    constexpr size_t N = 200;
+    constexpr double MEM_MIN = 1, FREE_GROW = 0.5;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> dist_a{0.1, 10}, dist_m{MEM_MIN, 8},
+            dist_f{0, 4}, dist_t{0, 1};
+    std::vector<TensorInfo> infos(N);
+    //! f_key: the free memory when the key is computed
+    std::vector<double> a(N), m(N), f(N), f_key(N), d(N);
+    std::vector<bool> alive(N, true);
+    EvictionIndex index;
+    double now = 1;
+    auto get_k = [&](TensorInfo* ptr) {
+        auto i = ptr - infos.data();
+        f_key[i] = f[i];
+        return alive[i] ? a[i] / (m[i] + f[i]) : -1.0;
+    };
+    for (size_t i = 0; i < N; ++i) {
+        a[i] = dist_a(rng);
+        m[i] = dist_m(rng);
+        f[i] = dist_f(rng);
+        d[i] = now - dist_t(rng) - 1e-3;
+        index.set(&infos[i], get_k(&infos[i]), d[i], now);
+    }
+    for (int iter = 0; iter < 2000; ++iter) {
+        now += dist_t(rng) * 0.01;
+        // the free memory changes silently, and grows by at most FREE_GROW
+        // since the key is computed
+        for (int j = 0; j < 4; ++j) {
+            auto i = rng() % N;
+            f[i] = std::min(
+                    std::max(0.0, f[i] + (dist_t(rng) * 2 - 1) * FREE_GROW),
+                    f_key[i] + FREE_GROW);
+        }
+        if (iter % 5 == 0) {
+            alive[rng() % N] = false;
+        }
+        std::vector<Key> keys(N);
+        for (size_t i = 0; i < N; ++i) {
+            keys[i] = {alive[i] ? a[i] / (m[i] + f[i]) : 0, d[i]};
+        }
+        auto expect = scan_best(infos, keys, alive, now);
+        auto get = index.top_checked(now, get_k);
+        ASSERT_EQ(expect == nullptr, get == nullptr);
+        if (!expect) {
+            break;
+        }
+        auto val = [&](TensorInfo* ptr) {
+            auto&& key = keys[ptr - infos.data()];
+            return key.k / (now - key.d);
+        };
+        ASSERT_LE(
+                val(get), val(expect) * (1 + FREE_GROW / MEM_MIN) * (1 + 1e-9));
+    }
+}
+
+TEST(TestDTREvictionIndex, BenchmarkEvict) {
+    constexpr size_t NR_EVICT = 1000, NR_REFRESH = 4;
+    for (size_t nr_cand : {1000, 10000, 100000}) {
+        std::mt19937 rng(nr_cand);
+        std::uniform_real_distribution<double> dist_k{0.1, 10}, dist_t{0, 1};
+        std::vector<TensorInfo> infos(nr_cand);
+        std::vector<Key> keys(nr_cand);
+        std::vector<bool> alive(nr_cand, true);
+        double now = 1;
+        for (auto&& i : keys) {
+            i = {dist_k(rng), now - dist_t(rng) - 1e-3};
+        }
+
+        // each eviction selects the best candidate and refreshes the keys of
+        // a few neighbors, as auto_evict does
+        auto keys_scan = keys;
+        RealTimer timer;
+        for (size_t i = 0; i < NR_EVICT; ++i) {
+            auto best = scan_best(infos, keys_scan, alive, now);
+            alive[best - infos.data()] = false;
+            for (size_t j = 0; j < NR_REFRESH; ++j) {
+                keys_scan[rng() % nr_cand].k *= 1.5;
+            }
+            now += 1e-3;
+        }
+        auto time_scan = timer.get_secs_reset();
+
+        EvictionIndex index;
+        now = 1;
+        rng.seed(nr_cand);
+        for (size_t i = 0; i < nr_cand; ++i) {
+            index.set(&infos[i], keys[i].k, keys[i].d, now);
+        }
+        timer.reset();
+        for (size_t i = 0; i < NR_EVICT; ++i) {
+            index.erase(index.top(now), now);
+            for (size_t j = 0; j < NR_REFRESH; ++j) {
+                auto&& key = keys[rng() % nr_cand];
+                key.k *= 1.5;
+                auto ptr = &infos[&key - keys.data()];
+                if (index.contains(ptr)) {
+                    index.set(ptr, key.k, key.d, now);
+                }
+            }
+            now += 1e-3;
+        }
+        auto time_index = timer.get_secs();
+        mgb_log("dtr eviction with %zu candidates: scan %.3fus index %.3fus", nr_cand,
+                time_scan * 1e6 / NR_EVICT, time_index * 1e6 / NR_EVICT);
+    }
+}
@@ -82,6 +82,51 @@ TEST(TestImperative, Split) {
     OprChecker(op).run({TensorShape{100}, s1, s2});
 }
 
+TEST(TestImperative, InferOutputAttrsCache) {
+    auto cn = CompNode::load("xpu0");
+    auto desc = [&](const TensorShape& shape) {
+        return LogicalTensorDesc{{shape, dtype::Float32()}, cn};
+    };
+    auto infer = [](const std::shared_ptr<OpDef>& op,
+                    const SmallVector<LogicalTensorDesc>& inputs) {
+        auto [outputs, validated] = OpDef::infer_output_attrs_fallible(*op, inputs);
+        mgb_assert(validated && outputs.size() == 1);
+        return TensorShape(outputs[0].layout);
+    };
+
+    auto add = OprAttr::make("Elemwise");
+    add->cast_final_safe<OprAttr>().param.write_pod(
+            opr::Elemwise::Param{opr::Elemwise::Param::Mode::ADD});
+    auto hits = OpDef::infer_output_attrs_cache_hits();
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ(TensorShape({2, 3}), infer(add, {desc({2, 3}), desc({2, 3})}));
+        ASSERT_EQ(TensorShape({4, 5}), infer(add, {desc({4, 5}), desc({4, 5})}));
+        ASSERT_EQ(TensorShape({2, 3}), infer(add, {desc({1, 3}), desc({2, 1})}));
+        // all three are taken from the cache in the second pass
+        ASSERT_EQ(hits + i * 3u, OpDef::infer_output_attrs_cache_hits());
+    }
+
+    // the inferred shape of reshape depends on the value of the target shape
+    OprAttr::Param param;
+    param.write_pod(megdnn::param::OptionalAxisV1{});
+    auto reshape = OprAttr::make("Reshape", param, OperatorNodeConfig{});
+    auto tshp = [](std::initializer_list<int> shape) {
+        auto cpu = CompNode::load("cpu:default");
+        HostTensorND host{cpu, {{shape.size()}, dtype::Int32()}};
+        std::copy(shape.begin(), shape.end(), host.ptr<int>());
+        DeviceTensorND dev;
+        dev.copy_from(host);
+        return LogicalTensorDesc{host.layout(), cpu, dev};
+    };
+    hits = OpDef::infer_output_attrs_cache_hits();
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ(TensorShape({3, 2}), infer(reshape, {desc({2, 3}), tshp({3, 2})}));
+        ASSERT_EQ(TensorShape({6}), infer(reshape, {desc({2, 3}), tshp({6})}));
+        ASSERT_EQ(TensorShape({1, 6}), infer(reshape, {desc({2, 3}), tshp({1, 6})}));
+        ASSERT_EQ(hits + i * 3u, OpDef::infer_output_attrs_cache_hits());
+    }
+}
+
 #if MGB_CUDA && MGB_ENABLE_EXCEPTION
 void run_graph(size_t mem_reserved) {
     CompNode::try_coalesce_all_free_memory();
@@ -0,0 +1,100 @@
+#include "./helper.h"
+
+#include "megbrain/imperative/ops/autogen.h"
+#include "megbrain/imperative/sampling_profiler.h"
+
+#include <thread>
+
+using namespace mgb;
+using namespace imperative;
+
+TEST(TestSamplingProfiler, Interval) {
+    auto cn = CompNode::load("cpu0");
+    auto add = Elemwise::make(Elemwise::Mode::ADD);
+    auto mul = Elemwise::make(Elemwise::Mode::MUL);
+    auto cvt = TypeCvt::make(dtype::Float32());
+    SamplingProfiler::Config config;
+    config.interval = 4;
+    config.ring_size = 6;
+    SamplingProfiler::enable(config);
+    size_t nr_sampled = 0;
+    for (size_t i = 0; i < 100; ++i) {
+        auto scope = SamplingProfiler::begin(cn);
+        nr_sampled += static_cast<bool>(scope);
+        SamplingProfiler::end(scope, nr_sampled % 3 ? (i % 2 ? *add : *mul) : *cvt);
+    }
+    ASSERT_EQ(25u, nr_sampled);
+    SamplingProfiler::disable();
+    ASSERT_FALSE(SamplingProfiler::begin(cn));
+
+    auto json = SamplingProfiler::to_json()->to_string();
+    ASSERT_NE(std::string::npos, json.find("\"Elemwise\""));
+    ASSERT_NE(std::string::npos, json.find("\"TypeCvt\""));
+
+    // ring size is rounded up to 8
+    auto samples = SamplingProfiler::recent_samples();
+    ASSERT_EQ(8u, samples.size());
+    for (size_t i = 1; i < samples.size(); ++i) {
+        ASSERT_LE(samples[i - 1].start_ns, samples[i].start_ns);
+    }
+
+    // ops of the same type share a histogram
+    auto text = SamplingProfiler::to_prometheus();
+    ASSERT_NE(
+            std::string::npos,
+            text.find("megengine_op_host_latency_seconds_bucket{op=\"Elemwise\","
+                      "le=\"+Inf\"} 17"));
+}
+
+TEST(TestSamplingProfiler, Burst) {
+    auto cn = CompNode::load("cpu0");
+    auto add = Elemwise::make(Elemwise::Mode::ADD);
+    SamplingProfiler::Config config;
+    config.burst_period_ms = 20;
+    config.burst_ms = 10;
+    SamplingProfiler::enable(config);
+    size_t nr_ops = 0, nr_sampled = 0;
+    auto run = [&](size_t ms) {
+        auto stop = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+        while (std::chrono::steady_clock::now() < stop) {
+            auto scope = SamplingProfiler::begin(cn);
+            nr_sampled += static_cast<bool>(scope);
+            ++nr_ops;
+            SamplingProfiler::end(scope, *add);
+        }
+    };
+    run(100);
+    SamplingProfiler::disable();
+    ASSERT_GT(nr_sampled, 0u);
+    ASSERT_LT(nr_sampled, nr_ops);
+}
+
+TEST(TestSamplingProfiler, MultiThread) {
+    constexpr size_t NR_THREAD = 4, NR_OP = 10000;
+    auto cn = CompNode::load("cpu0");
+    auto add = Elemwise::make(Elemwise::Mode::ADD);
+    SamplingProfiler::Config config;
+    config.interval = 1;
+    config.profile_device = true;
+    SamplingProfiler::enable(config);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < NR_THREAD; ++i) {
+        threads.emplace_back([&]() {
+            for (size_t j = 0; j < NR_OP; ++j) {
+                auto scope = SamplingProfiler::begin(cn);
+                SamplingProfiler::end(scope, *add);
+            }
+        });
+    }
+    for (auto&& i : threads) {
+        i.join();
+    }
+    SamplingProfiler::disable();
+    auto text = SamplingProfiler::to_prometheus();
+    ASSERT_NE(
+            std::string::npos,
+            text.find(ssprintf(
+                    "megengine_op_host_latency_seconds_count{op=\"Elemwise\"} %zu",
+                    NR_THREAD * NR_OP)));
+    ASSERT_EQ(4096u, SamplingProfiler::recent_samples().size());
+}
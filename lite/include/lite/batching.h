@@ -0,0 +1,74 @@
+#pragma once
+
+#include "network.h"
+
+#include <future>
+
+namespace lite {
+
+/*!
+ * \brief config of the batching of requests to a network
+ *
+ * \param max_batch_size the max number of samples in a batch, where the
+ * samples of a request are counted on dim 0 of its inputs
+ *
+ * \param max_wait_us the max time to wait for more requests after the first
+ * request of a batch arrives
+ *
+ * \param pad_to_max_batch pad the batch with zeros to max_batch_size, so the
+ * network always runs with the same input shapes, which keeps the memory plan
+ * of the network, and works with Options::const_shape
+ */
+struct LITE_API BatchingConfig {
+    size_t max_batch_size = 8;
+    size_t max_wait_us = 1000;
+    bool pad_to_max_batch = false;
+};
+
+/*!
+ * \brief run the concurrent requests to a network in batches
+ *
+ * Requests are queued and run by a worker thread, which concatenates the
+ * inputs of the requests with the same non-batch shapes on dim 0, forwards the
+ * network once, and gives each request the slices of the outputs on dim 0. The
+ * slices share one copy of the outputs of the batch.
+ *
+ * The network must not be used by others after the BatchedNetwork is created.
+ */
+class LITE_API BatchedNetwork {
+public:
+    using Outputs = std::vector<std::shared_ptr<Tensor>>;
+
+    struct Stats {
+        size_t nr_requests = 0;
+        size_t nr_batches = 0;
+        //! samples in the requests, not counting padding
+        size_t nr_samples = 0;
+        size_t nr_padded_samples = 0;
+    };
+
+    BatchedNetwork(std::shared_ptr<Network> network, const BatchingConfig& config = {});
+
+    //! wait for all the queued requests to finish
+    ~BatchedNetwork();
+
+    //! queue a request, whose inputs are in the order of
+    //! Network::get_all_input_name(), and outputs are in the order of
+    //! Network::get_all_output_name()
+    std::future<Outputs> submit(std::vector<std::shared_ptr<Tensor>> inputs);
+
+    //! submit a request and wait for its outputs
+    Outputs forward(std::vector<std::shared_ptr<Tensor>> inputs) {
+        return submit(std::move(inputs)).get();
+    }
+
+    Stats get_stats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace lite
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
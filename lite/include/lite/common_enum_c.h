@@ -86,12 +86,17 @@ typedef enum {
  *
  * 5. LITE_ALGO_PROFILE | LITE_ALGO_OPTIMIZED | LITE_ALGO_REPRODUCIBLE means:
  * profile the best algorithm form the optimzed and reproducible algorithms
+ *
+ * 6. LITE_ALGO_COST_MODEL means: choose the algorithm with the least running
+ * time estimated by an analytic cost model, without profiling. Combined with
+ * LITE_ALGO_PROFILE, algorithms in profile cache are preferred
  */
 typedef enum {
     LITE_ALGO_HEURISTIC = 1 << 0,
     LITE_ALGO_PROFILE = 1 << 1,
     LITE_ALGO_REPRODUCIBLE = 1 << 2,
     LITE_ALGO_OPTIMIZED = 1 << 3,
+    LITE_ALGO_COST_MODEL = 1 << 4,
 } LiteAlgoSelectStrategy;
 
 /*!
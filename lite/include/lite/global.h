@@ -127,6 +127,13 @@ LITE_API void set_loader_lib_path(const std::string& loader_path);
 LITE_API void set_persistent_cache(
         const std::string& cache_path, bool always_sync = false);
 
+/*!
+ * \brief Set the algo policy cache file shared by all processes on the host,
+ * the file is memory mapped and updated in place, so it needs not be dumped
+ * \param cache_path is the file path which store the cache
+ */
+LITE_API void set_shared_persistent_cache(const std::string& cache_path);
+
 /*!
  * \brief dump the PersistentCache policy cache to file, if the network is set
  * to profile when forward, though this the algo policy will dump to file
@@ -341,6 +341,12 @@ public:
     static void share_runtime_memory_with(
             std::shared_ptr<Network> dst_network, std::shared_ptr<Network> src_network);
 
+    //! share the runtime memory with all the networks using the arena with the
+    //! same name in this process; the arena is sized to the max runtime memory
+    //! of these networks, so they must be forwarded in turn, not concurrently
+    static void share_runtime_memory_with_arena(
+            std::shared_ptr<Network> dst_network, std::string arena_name);
+
     //! Dump input/output values of all internal variables to output
     //! file, in txt format
     static void enable_io_txt_dump(
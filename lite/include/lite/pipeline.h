@@ -0,0 +1,53 @@
+#pragma once
+
+#include "network.h"
+
+#include <functional>
+
+namespace lite {
+
+/*!
+ * \brief keep several forwards of a network in flight
+ *
+ * The pipeline holds \p depth networks, the given one and the ones sharing
+ * weights with it, each with its own IO tensors and running on its own stream,
+ * so the inputs of a forward can be prepared while others are running.
+ *
+ * A network got by acquire() is owned by the caller until it is submitted,
+ * and is owned by the pipeline from submit() until its callback returns, so
+ * its IO tensors must not be touched in the meantime. Callbacks are called in
+ * the order of submission on a worker thread of the pipeline.
+ *
+ * The given network must be loaded, and must not use set_async_callback.
+ */
+class LITE_API NetworkPipeline {
+public:
+    using Callback = std::function<void(Network&)>;
+
+    NetworkPipeline(std::shared_ptr<Network> network, size_t depth = 2);
+
+    //! wait for all the submitted forwards
+    ~NetworkPipeline();
+
+    //! get an idle network to fill its inputs, waiting if all are in flight
+    std::shared_ptr<Network> acquire();
+
+    //! forward a network got by acquire(), and call \p callback with it, which
+    //! can read the outputs, after the forward finishes
+    void submit(std::shared_ptr<Network> network, Callback callback = {});
+
+    //! wait for all the submitted forwards and their callbacks, and throw the
+    //! first error of them if any
+    void wait();
+
+    //! number of the networks, which is the max number of forwards in flight
+    size_t depth() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+}  // namespace lite
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -132,6 +132,12 @@ LITE_API int LITE_set_loader_lib_path(const char* loader_path);
  */
 LITE_API int LITE_set_persistent_cache(const char* cache_path, int always_sync);
 
+/*!
+ * \brief Set the algo policy cache file shared by all processes on the host
+ * \param[in] cache_path is the file path which store the cache
+ */
+LITE_API int LITE_set_shared_persistent_cache(const char* cache_path);
+
 /*!
  * \brief Set the tensor policy cache file for CPU/CUDA ...
  * \param[in] cache_path is the file path which store the cache
@@ -528,6 +528,15 @@ LITE_API int LITE_set_memory_allocator(
 LITE_API int LITE_share_runtime_memroy(
         LiteNetwork src_network, LiteNetwork dst_network);
 
+/**
+ * \brief share the runtime memory with all the networks using the arena with
+ * the same name, the networks must not be forwarded concurrently
+ * \param[in] network The network pointer
+ * \param[in] arena_name The name of the arena
+ */
+LITE_API int LITE_share_runtime_memory_with_arena(
+        LiteNetwork network, const char* arena_name);
+
 /**
  * \brief enable profile the network, a JSON format file will be generated
  * \param[in] network The loaded model
@@ -165,6 +165,13 @@ int LITE_set_persistent_cache(const char* cache_path, int always_sync) {
     LITE_CAPI_END();
 }
 
+int LITE_set_shared_persistent_cache(const char* cache_path) {
+    LITE_CAPI_BEGIN();
+    LITE_ASSERT(cache_path, "The ptr pass to LITE api is null");
+    lite::set_shared_persistent_cache(cache_path);
+    LITE_CAPI_END();
+}
+
 int LITE_set_tensor_rt_cache(const char* cache_path) {
     LITE_CAPI_BEGIN();
     LITE_ASSERT(cache_path, "The ptr pass to LITE api is null");
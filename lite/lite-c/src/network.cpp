@@ -647,6 +647,16 @@ int LITE_share_runtime_memroy(LiteNetwork dst_network, LiteNetwork src_network)
     LITE_CAPI_END();
 }
 
+int LITE_share_runtime_memory_with_arena(LiteNetwork network, const char* arena_name) {
+    LITE_CAPI_BEGIN();
+    LITE_ASSERT(network, "The network pass to LITE api is null");
+    LITE_ASSERT(arena_name, "The arena name pass to LITE api is null");
+    std::shared_ptr<lite::Network> network_shared{
+            static_cast<lite::Network*>(network), [](void*) {}};
+    lite::Runtime::share_runtime_memory_with_arena(network_shared, arena_name);
+    LITE_CAPI_END();
+}
+
 int LITE_get_static_memory_alloc_info(LiteNetwork network, const char* log_dir) {
     LITE_CAPI_BEGIN();
 #ifndef __IN_TEE_ENV__
@@ -0,0 +1,223 @@
+#include "perf_report.h"
+#if MGB_ENABLE_JSON
+#include "megbrain/opr/blas.h"
+#include "megbrain/opr/dnn/convolution.h"
+#include "megbrain/opr/dnn/pooling.h"
+#include "megbrain/opr/io.h"
+#include "megbrain/plugin/opr_footprint.h"
+#include "megbrain/plugin/perf_counter.h"
+#include "megbrain/utils/timer.h"
+#include "text_table.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace mgb;
+using namespace lar;
+
+namespace {
+
+//! average seconds of an execution of \p func after warming up
+double time_func(cg::AsyncExecutable* func) {
+    for (int i = 0; i < 2; ++i) {
+        func->execute().wait();
+    }
+    size_t nr_run = 0;
+    RealTimer timer;
+    do {
+        func->execute().wait();
+        ++nr_run;
+    } while (nr_run < 3 || timer.get_secs() < 0.2);
+    return timer.get_secs() / nr_run;
+}
+
+//! name of the algo chosen by the opr, or empty if it has no choice of algos
+std::string get_algo_name(cg::OperatorNodeBase* opr) {
+#define cb(_Opr)                                                        \
+    if (auto typed = opr->try_cast_final<opr::_Opr>()) {                \
+        auto&& algo = typed->megdnn_opr()->execution_policy().algo;     \
+        return algo.valid() ? algo.name : std::string{"<heuristic>"};   \
+    }
+    cb(ConvolutionForward);
+    cb(ConvBiasForward);
+    cb(ConvolutionBackwardData);
+    cb(Convolution3DForward);
+    cb(LocalShareForward);
+    cb(DeformableConvForward);
+    cb(BatchConvBiasForward);
+    cb(MatrixMul);
+    cb(BatchedMatrixMul);
+    cb(PoolingForward);
+#undef cb
+    return {};
+}
+
+//! seconds spent in the kernels of \p opr in its last execution, or a
+//! negative value if it is not profiled
+double get_kern_time(json::Object& device_prof, cg::OperatorNodeBase* opr) {
+    auto&& opr_prof = device_prof[opr->id_str()];
+    if (!opr_prof) {
+        return -1;
+    }
+    auto number = [](json::Object& obj, const char* key) {
+        return obj[key]->cast_final_safe<json::Number>().get_impl();
+    };
+    // kernels on several comp nodes run in parallel
+    double time = 0;
+    for (auto&& i : opr_prof->cast_final_safe<json::Object>().get_impl()) {
+        auto&& event = i.second->cast_final_safe<json::Object>();
+        time = std::max(time, number(event, "end") - number(event, "kern"));
+    }
+    return time;
+}
+
+struct OprRecord {
+    cg::OperatorNodeBase* opr;
+    double time;
+    OprFootprint::Result footprint;
+};
+
+}  // namespace
+
+Roofline lar::calibrate_roofline(CompNode comp_node) {
+    auto make_var = [comp_node](cg::ComputingGraph& graph, const TensorShape& shape) {
+        HostTensorND host{comp_node, shape, dtype::Float32()};
+        auto ptr = host.ptr<float>();
+        for (size_t i = 0, it = shape.total_nr_elems(); i < it; ++i) {
+            ptr[i] = 1.f + (i % 7) * 0.125f;
+        }
+        auto dev = std::make_shared<DeviceTensorND>();
+        dev->copy_from(host).sync();
+        return opr::SharedDeviceTensor::make(graph, dev);
+    };
+
+    Roofline ret;
+    {
+        constexpr size_t N = 1024;
+        auto graph = cg::ComputingGraph::make();
+        auto a = make_var(*graph, {N, N}), b = make_var(*graph, {N, N});
+        auto func = graph->compile({{opr::MatrixMul::make(a, b), {}}});
+        ret.gflops = 2.0 * N * N * N / time_func(func.get()) * 1e-9;
+    }
+    {
+        // large enough to go through the last level cache
+        constexpr size_t N = 16 << 20;
+        auto graph = cg::ComputingGraph::make();
+        auto x = make_var(*graph, {N});
+        auto func = graph->compile({{x + 1.f, {}}});
+        ret.gbps = 2.0 * N * sizeof(float) / time_func(func.get()) * 1e-9;
+    }
+    return ret;
+}
+
+
+std::string lar::make_perf_report(
+        cg::AsyncExecutable* func, const GraphProfiler& profiler,
+        const PerfCounterProfiler* counters, const Roofline& roofline,
+        size_t nr_top) {
+    auto prof = profiler.to_json();
+    auto&& device_prof = (*prof)["device"]->cast_final_safe<json::Object>();
+    OprFootprint opr_footprint;
+    std::vector<OprRecord> records;
+    double tot_time = 0;
+    func->iter_opr_seq([&](cg::OperatorNodeBase* opr) {
+        auto time = get_kern_time(device_prof, opr);
+        if (time >= 0) {
+            records.push_back({opr, time, opr_footprint.calc_footprint(opr)});
+            tot_time += time;
+        }
+        return true;
+    });
+    if (records.empty()) {
+        return {};
+    }
+    std::sort(
+            records.begin(), records.end(),
+            [](const OprRecord& a, const OprRecord& b) { return a.time > b.time; });
+
+    // arithmetic intensity at which the roofline turns from memory bound to
+    // compute bound
+    double ridge = roofline.gflops / roofline.gbps;
+    auto table = TextTable("perf report");
+    table.padding(1);
+    table.align(TextTable::Align::Mid)
+            .add("rank")
+            .add("name")
+            .add("type")
+            .add("time(ms)")
+            .add("time(%)")
+            .add("GFLOPS")
+            .add("GB/s")
+            .add("FLOP/byte")
+            .add("bound")
+            .add("attainable")
+            .add("efficiency");
+#if MGB_ENABLE_PERF_COUNTER
+    if (counters) {
+        table.add("IPC").add("LLC miss").add("dTLB miss");
+    }
+#endif
+    table.add("algo").eor();
+    for (size_t i = 0; i < std::min(nr_top, records.size()); ++i) {
+        auto&& rec = records[i];
+        auto&& fp = rec.footprint;
+        double time = std::max(rec.time, 1e-9);
+        double gflops = fp.computation / time * 1e-9;
+        double gbps = fp.memory / time * 1e-9;
+        double intensity = fp.memory ? static_cast<double>(fp.computation) / fp.memory
+                                     : 0.;
+        // oprs without computation are measured by their bandwidth
+        bool compute_bound = fp.computation && intensity >= ridge;
+        double attainable = fp.computation
+                                  ? std::min(roofline.gflops, intensity * roofline.gbps)
+                                  : roofline.gbps;
+        double achieved = fp.computation ? gflops : gbps;
+        auto name = rec.opr->name();
+        if (name.size() > 40) {
+            name = name.substr(0, 37) + "...";
+        }
+        table.align(TextTable::Align::Mid)
+                .add(std::to_string(i + 1))
+                .add(name)
+                .add(rec.opr->dyn_typeinfo()->name)
+                .add(ssprintf("%.3f", rec.time * 1e3))
+                .add(ssprintf("%.2f", tot_time ? rec.time / tot_time * 100 : 0.))
+                .add(ssprintf("%.2f", gflops))
+                .add(ssprintf("%.2f", gbps))
+                .add(ssprintf("%.2f", intensity))
+                .add(compute_bound ? "compute" : "memory")
+                .add(ssprintf(
+                        "%.2f %s", attainable, fp.computation ? "GFLOPS" : "GB/s"))
+                .add(ssprintf("%.1f%%", achieved / attainable * 100));
+#if MGB_ENABLE_PERF_COUNTER
+        if (counters) {
+            // counters are averaged over the executions, and missing ones are
+            // shown as -
+            using C = PerfCounterProfiler;
+            auto&& result = counters->result();
+            auto iter = result.find(rec.opr);
+            auto get = [&](C::Counter c) -> Maybe<double> {
+                if (iter == result.end() || !iter->second.nr_exec ||
+                    !(iter->second.available & (1u << c))) {
+                    return None;
+                }
+                return static_cast<double>(iter->second.values[c]) /
+                       iter->second.nr_exec;
+            };
+            auto cycles = get(C::CYCLES), insts = get(C::INSTRUCTIONS),
+                 llc = get(C::LLC_MISSES), dtlb = get(C::DTLB_MISSES);
+            table.add(
+                    cycles.valid() && insts.valid() && cycles.val() > 0
+                            ? ssprintf("%.2f", insts.val() / cycles.val())
+                            : "-");
+            table.add(llc.valid() ? ssprintf("%.0f", llc.val()) : "-");
+            table.add(dtlb.valid() ? ssprintf("%.0f", dtlb.val()) : "-");
+        }
+#endif
+        table.add(get_algo_name(rec.opr)).eor();
+    }
+    std::stringstream ss;
+    ss << table;
+    return ss.str();
+}
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+#include "megbrain/graph.h"
+#include "megbrain/plugin/profiler.h"
+
+#if MGB_ENABLE_JSON
+namespace mgb {
+class PerfCounterProfiler;
+}  // namespace mgb
+
+namespace lar {
+
+//! peak performance of a comp node
+struct Roofline {
+    //! float32 matrix multiplication
+    double gflops = 0;
+    //! bytes read and written by a float32 elemwise opr
+    double gbps = 0;
+};
+
+//! measure the roofline of \p comp_node with the kernels of float32 MatrixMul
+//! and elemwise oprs
+Roofline calibrate_roofline(mgb::CompNode comp_node);
+
+/*!
+ * \brief rank the operators of \p func by their kernel time in \p profiler,
+ *      and compare the performance they achieved with \p roofline
+ *
+ * \param counters hardware counters of the operators; if given, the IPC and
+ *      the LLC and dTLB misses per execution are also reported
+ * \return text table of the top \p nr_top operators, or an empty string if
+ *      no operator is profiled
+ */
+std::string make_perf_report(
+        mgb::cg::AsyncExecutable* func, const mgb::GraphProfiler& profiler,
+        const mgb::PerfCounterProfiler* counters, const Roofline& roofline,
+        size_t nr_top);
+
+}  // namespace lar
+#endif
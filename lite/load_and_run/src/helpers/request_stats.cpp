@@ -0,0 +1,39 @@
+#include "request_stats.h"
+#include <algorithm>
+
+using namespace lar;
+
+PoissonArrival::PoissonArrival(double qps, Clock::time_point start, uint32_t seed)
+        : m_rng{seed}, m_interval{qps}, m_arrival{start} {}
+
+PoissonArrival::Clock::time_point PoissonArrival::next() {
+    m_arrival += std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(m_interval(m_rng)));
+    return m_arrival;
+}
+
+LatencyStats::LatencyStats(std::vector<double> latencies)
+        : m_sorted{std::move(latencies)} {
+    std::sort(m_sorted.begin(), m_sorted.end());
+    for (auto latency : m_sorted) {
+        m_sum += latency;
+    }
+}
+
+double LatencyStats::avg() const {
+    return m_sorted.empty() ? 0 : m_sum / m_sorted.size();
+}
+
+double LatencyStats::max() const {
+    return m_sorted.empty() ? 0 : m_sorted.back();
+}
+
+double LatencyStats::percentile(double p) const {
+    if (m_sorted.empty()) {
+        return 0;
+    }
+    auto idx = static_cast<size_t>(std::max(p, 0.0) * m_sorted.size());
+    return m_sorted[std::min(idx, m_sorted.size() - 1)];
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace lar {
+
+/*!
+ * \brief arrival times of requests as a Poisson process, i.e. with
+ *      exponentially distributed intervals
+ *
+ * The generator is seeded with a fixed value by default, so that runs of the
+ * benchmark see the same arrivals.
+ */
+class PoissonArrival {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    //! \param qps mean number of arrivals per second, must be positive
+    PoissonArrival(double qps, Clock::time_point start, uint32_t seed = 0);
+
+    //! the arrival time of next request
+    Clock::time_point next();
+
+private:
+    std::mt19937 m_rng;
+    std::exponential_distribution<double> m_interval;
+    Clock::time_point m_arrival;
+};
+
+/*!
+ * \brief summary of the latencies of a set of requests
+ */
+class LatencyStats {
+public:
+    explicit LatencyStats(std::vector<double> latencies);
+
+    size_t count() const { return m_sorted.size(); }
+
+    //! all the accessors below return 0 if there is no latency
+    double avg() const;
+    double max() const;
+
+    /*!
+     * \brief the latency that \p p of the requests do not exceed
+     *
+     * It is the nearest rank percentile, the element at index p * count of the
+     * sorted latencies.
+     *
+     * \param p in [0, 1]
+     */
+    double percentile(double p) const;
+
+private:
+    std::vector<double> m_sorted;
+    double m_sum = 0;
+};
+
+}  // namespace lar
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
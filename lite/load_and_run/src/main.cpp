@@ -12,6 +12,15 @@ load_and_run: load_and_run <model_path> [options Flags...]
     -iter           type: int32     default: 10         iteration number for run model
     -thread         type: int32     default: 1          thread number for run model when <thread> is supported
     -warmup_iter    type: int32     default: 1          iteration number for warm up model before run
+
+  Flags from lite/load_and_run/src/strategys/strategy_poisson.cpp:
+    -poisson_qps    type: double    default: 0          simulate Poisson arrival of requests at the given rate and batch them
+    -max_batch_size type: int32     default: 8          max number of requests batched together
+
+  Flags from lite/load_and_run/src/strategys/strategy_throughput.cpp:
+    -throughput_instances type: int32 default: 0        measure throughput of the given number of concurrent instances
+    -instance_threads type: int32   default: 1          number of cpu threads of each instance
+    -throughput_qps type: double    default: 0          Poisson arrival rate of the requests, 0 for closed loop
     
   Flags from com_github_gflags_gflags/src/gflags.cc:
     -flagfile       type: string      default: ""       load flags from file
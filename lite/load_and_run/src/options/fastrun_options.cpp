@@ -37,6 +37,15 @@ void FastRunOption::config_model_internel<ModelLite>(
 #else
         strategy = static_cast<uint32_t>(Strategy::LITE_ALGO_HEURISTIC) | strategy;
 #endif
+        if (enable_cost_model) {
+            LITE_WARN("enable cost model strategy for algo selection");
+            strategy = static_cast<uint32_t>(Strategy::LITE_ALGO_COST_MODEL) | strategy;
+            //! still use the profiled algos in the given cache file
+            if (!m_fast_run_cache.empty()) {
+                strategy = static_cast<uint32_t>(Strategy::LITE_ALGO_PROFILE) |
+                           strategy;
+            }
+        }
         if (batch_binary_equal || enable_reproducible) {
             LITE_WARN("enable reproducible strategy for algo profile");
             if (batch_binary_equal)
@@ -92,6 +101,10 @@ void FastRunOption::config_model_internel<ModelMdl>(
 #else
         strategy = Strategy::HEURISTIC | strategy;
 #endif
+        if (enable_cost_model) {
+            mgb_log_warn("enable cost model strategy for algo selection");
+            strategy = Strategy::COST_MODEL | strategy;
+        }
         if (batch_binary_equal || enable_reproducible) {
             mgb_log_warn("enable reproducible strategy for algo profile");
             strategy = Strategy::REPRODUCIBLE | strategy;
@@ -125,8 +138,15 @@ void FastRunOption::config_model_internel<ModelMdl>(
                 mgb::PersistentCache::set_impl(
                         std::make_shared<mgb::InFilePersistentCache>());
             }
+            if (enable_cost_model) {
+                //! use the profiled algos in cache and the cost model otherwise
+                mgb::gopt::modify_opr_algo_strategy_inplace(
+                        vars, strategy | ModelMdl::Strategy::PROFILE);
+            }
 #if MGB_ENABLE_FASTRUN
-            if (!enable_full_run && !enable_fast_run)
+            else if (!enable_full_run && !enable_fast_run)
+#else
+            else
 #endif
                 mgb::gopt::enable_opr_use_profiling_cache_inplace(vars);
         }
@@ -153,6 +173,7 @@ FastRunOption::FastRunOption() {
 #endif
     batch_binary_equal = FLAGS_binary_equal_between_batch;
     enable_reproducible = FLAGS_reproducible;
+    enable_cost_model = FLAGS_cost_model;
     m_fast_run_cache = FLAGS_fast_run_algo_policy;
     share_batch_size = FLAGS_fast_run_shared_batch_size;
     m_option = {
@@ -161,7 +182,8 @@ FastRunOption::FastRunOption() {
         {"full_run", lar::Bool::make(false)},
 #endif
         {"binary_equal_between_batch", lar::Bool::make(false)},
-        {"reproducible", lar::Bool::make(false)}
+        {"reproducible", lar::Bool::make(false)},
+        {"cost_model", lar::Bool::make(false)}
     };
 #if MGB_ENABLE_FASTRUN
     std::static_pointer_cast<lar::Bool>(m_option["fast_run"])
@@ -173,6 +195,8 @@ FastRunOption::FastRunOption() {
             ->set_value(FLAGS_binary_equal_between_batch);
     std::static_pointer_cast<lar::Bool>(m_option["reproducible"])
             ->set_value(FLAGS_reproducible);
+    std::static_pointer_cast<lar::Bool>(m_option["cost_model"])
+            ->set_value(FLAGS_cost_model);
 
 #if MGB_ENABLE_FASTRUN
     //! while fastrun cache file path is not empty and can't be accessed
@@ -199,6 +223,7 @@ bool FastRunOption::is_valid() {
     ret = ret || FLAGS_binary_equal_between_batch;
     ret = ret || FLAGS_fast_run_shared_batch_size > 0;
     ret = ret || FLAGS_reproducible;
+    ret = ret || FLAGS_cost_model;
     ret = ret || FLAGS_fast_run_algo_policy.size() > 0;
 
     return ret || m_valid;
@@ -223,6 +248,14 @@ void FastRunOption::config_model(
     mgb_throw_if(
             enable_fast_run && enable_full_run, mgb::AssertionError,
             "invalid options of both fast-run and full-run");
+#endif
+    enable_cost_model =
+            std::static_pointer_cast<lar::Bool>(m_option["cost_model"])->get_value();
+#if MGB_ENABLE_FASTRUN
+    mgb_throw_if(
+            enable_cost_model && (enable_fast_run || enable_full_run),
+            mgb::AssertionError,
+            "invalid options of both cost-model and fast-run/full-run");
 #endif
     batch_binary_equal =
             std::static_pointer_cast<lar::Bool>(m_option["binary_equal_between_batch"])
@@ -250,6 +283,11 @@ DEFINE_bool(
         "https://docs.nvidia.com/deeplearning/sdk/cudnn-developer-guide/"
         "index.html#reproducibility"
         "for more details.");
+DEFINE_bool(
+        cost_model, false,
+        "Choose algo by an analytic cost model calibrated on current host instead "
+        "of profiling. Algos in the cache given by `--fast-run-algo-policy` are "
+        "still preferred.");
 DEFINE_uint32(fast_run_shared_batch_size, 0, "Set the batch size used during fastrun");
 DEFINE_string(fast_run_algo_policy, "", "fast-run cache path.");
 
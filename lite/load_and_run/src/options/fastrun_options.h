@@ -9,6 +9,7 @@ DECLARE_bool(fast_run);
 DECLARE_bool(full_run);
 #endif
 DECLARE_bool(reproducible);
+DECLARE_bool(cost_model);
 DECLARE_bool(binary_equal_between_batch);
 DECLARE_uint32(fast_run_shared_batch_size);
 DECLARE_string(fast_run_algo_policy);
@@ -45,6 +46,7 @@ private:
 #endif
     bool batch_binary_equal;       //! fast run stratgey setting
     bool enable_reproducible;      //! enable reproducible strategy
+    bool enable_cost_model;        //! choose algo by the analytic cost model
     size_t share_batch_size;       //! fast run strategy share batch size setting
     std::string m_fast_run_cache;  //! fast run cache file path
     std::string m_option_name;     //! option name
@@ -1,8 +1,10 @@
 #include "model_options.h"
 #include "device_options.h"
+#include "helpers/text_table.h"
 #include "lite/pack_model.h"
 #include "megbrain/opr/search_policy/algo_chooser.h"
 #include "megbrain/utils/infile_persistent_cache.h"
+#include "megbrain/utils/timer.h"
 #include "misc.h"
 #include "models/model_lite.h"
 #include "models/model_mdl.h"
@@ -78,4 +80,122 @@ DEFINE_string(
         "https://megengine.megvii-inc.com/user-guide/deployment/lite/advance/"
         "pack-lite-model.html for more details.");
 
-REGIST_OPTION_CREATOR(pack_model, lar::PackModelOption::create_option);
\ No newline at end of file
+REGIST_OPTION_CREATOR(pack_model, lar::PackModelOption::create_option);
+
+namespace lar {
+template <>
+void CompressionBenchmarkOption::config_model_internel<ModelLite>(
+        RuntimeParam& runtime_param, std::shared_ptr<ModelLite>) {
+    if (runtime_param.stage == RunStage::AFTER_MODEL_LOAD) {
+        mgb_log_warn(
+                "compression benchmark is only supported without --lite, which needs "
+                "the graph of the model");
+    }
+}
+
+template <>
+void CompressionBenchmarkOption::config_model_internel<ModelMdl>(
+        RuntimeParam& runtime_param, std::shared_ptr<ModelMdl> model) {
+    if (runtime_param.stage != RunStage::AFTER_MODEL_LOAD) {
+        return;
+    }
+    using namespace mgb::serialization;
+    using Codec = TensorCompression::Codec;
+    using Storage = TensorCompression::Storage;
+    struct Variant {
+        const char* name;
+        Codec codec;
+        Storage storage;
+    };
+    Variant variants[] = {
+            {"raw", Codec::NONE, Storage::SAME},
+            {"shuffle_lz4", Codec::SHUFFLE_LZ4, Storage::SAME},
+            {"float16", Codec::NONE, Storage::FLOAT16},
+            {"shuffle_lz4_float16", Codec::SHUFFLE_LZ4, Storage::FLOAT16},
+            {"shuffle_lz4_bfloat16", Codec::SHUFFLE_LZ4, Storage::BFLOAT16}};
+
+    auto&& outputs = model->get_mdl_load_result().output_var_list;
+    auto table = mgb::TextTable("compression benchmark");
+    table.padding(1);
+    table.align(mgb::TextTable::Align::Mid)
+            .add("params")
+            .add("file")
+            .add("size(KB)")
+            .add("ratio")
+            .add("load(ms)")
+            .eor();
+    size_t raw_size = 0;
+    for (auto&& variant : variants) {
+        auto path = m_path_prefix + "." + variant.name + ".mge";
+        GraphDumper::DumpConfig dump_config{1, false, false};
+        dump_config.tensor_compression.codec = variant.codec;
+        dump_config.tensor_compression.storage = variant.storage;
+        auto size = GraphDumper::make(
+                            OutputFile::make_fs(path.c_str()),
+                            GraphDumpFormat::FLATBUFFERS)
+                            ->dump(outputs, dump_config)
+                            .tot_bytes;
+        if (!raw_size) {
+            raw_size = size;
+        }
+        // the file is in the page cache after it is dumped, so the time is
+        // spent on parsing and decoding
+        double load_ms = 0;
+        for (size_t i = 0; i < m_nr_iter; ++i) {
+            mgb::RealTimer timer;
+            auto loader = GraphLoader::make(
+                    InputFile::make_fs(path.c_str()), GraphDumpFormat::FLATBUFFERS);
+            GraphLoadConfig load_config;
+            load_config.comp_node_mapper = model->get_mdl_config().comp_node_mapper;
+            loader->load(load_config, false);
+            load_ms += timer.get_msecs();
+        }
+        table.align(mgb::TextTable::Align::Mid)
+                .add(variant.name)
+                .add(path)
+                .add(mgb::ssprintf("%.2f", size / 1024.0))
+                .add(mgb::ssprintf("%.3f", static_cast<double>(size) / raw_size))
+                .add(mgb::ssprintf("%.3f", load_ms / m_nr_iter))
+                .eor();
+    }
+    std::stringstream ss;
+    ss << table;
+    printf("%s\n\n", ss.str().c_str());
+}
+}  // namespace lar
+
+CompressionBenchmarkOption::CompressionBenchmarkOption() {
+    m_option_name = "compression_benchmark";
+    m_path_prefix = FLAGS_compression_benchmark;
+    m_nr_iter = std::max(FLAGS_compression_benchmark_iter, 1);
+}
+
+bool CompressionBenchmarkOption::is_valid() {
+    return !FLAGS_compression_benchmark.empty();
+}
+
+std::shared_ptr<OptionBase> CompressionBenchmarkOption::create_option() {
+    static std::shared_ptr<CompressionBenchmarkOption> option(
+            new CompressionBenchmarkOption);
+    if (CompressionBenchmarkOption::is_valid()) {
+        return std::static_pointer_cast<OptionBase>(option);
+    } else {
+        return nullptr;
+    }
+}
+
+void CompressionBenchmarkOption::config_model(
+        RuntimeParam& runtime_param, std::shared_ptr<ModelBase> model) {
+    CONFIG_MODEL_FUN;
+}
+
+DEFINE_string(
+        compression_benchmark, "",
+        "Dump the model with each compression of params into files with the given "
+        "path prefix, and compare the file sizes and the time to load them.");
+DEFINE_int32(
+        compression_benchmark_iter, 5,
+        "Number of loads to average the load time of the compression benchmark.");
+
+REGIST_OPTION_CREATOR(
+        compression_benchmark, lar::CompressionBenchmarkOption::create_option);
\ No newline at end of file
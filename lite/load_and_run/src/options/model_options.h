@@ -9,6 +9,8 @@ DECLARE_string(pack_info_json);
 DECLARE_string(pack_cache);
 DECLARE_string(pack_info_cryption);
 DECLARE_string(pack_model_cryption);
+DECLARE_string(compression_benchmark);
+DECLARE_int32(compression_benchmark_iter);
 
 namespace lar {
 class PackModelOption : public OptionBase {
@@ -34,4 +36,28 @@ private:
     std::string pack_model_cryption;
     bool is_fast_run_cache = true;
 };
+
+/*!
+ * \brief dump the model with each compression of the params, and compare the
+ * file sizes and the time to load them
+ */
+class CompressionBenchmarkOption : public OptionBase {
+public:
+    static bool is_valid();
+    static std::shared_ptr<OptionBase> create_option();
+    void config_model(
+            RuntimeParam& runtime_param, std::shared_ptr<ModelBase> model) override;
+    std::string option_name() const override { return m_option_name; }
+
+private:
+    CompressionBenchmarkOption();
+
+    template <typename ModelImpl>
+    void config_model_internel(RuntimeParam&, std::shared_ptr<ModelImpl>);
+
+    std::string m_option_name;
+    //! path prefix of the dumped models
+    std::string m_path_prefix;
+    size_t m_nr_iter;
+};
 }  // namespace lar
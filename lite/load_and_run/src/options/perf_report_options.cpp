@@ -0,0 +1,96 @@
+#include "perf_report_options.h"
+#if MGB_ENABLE_JSON
+#include "helpers/perf_report.h"
+#include "misc.h"
+#include "models/model_lite.h"
+#include "models/model_mdl.h"
+
+using namespace mgb;
+
+namespace lar {
+
+template <>
+void PerfReportOption::config_model_internel<ModelLite>(
+        RuntimeParam& runtime_param, std::shared_ptr<ModelLite>) {
+    if (runtime_param.stage == RunStage::BEFORE_MODEL_LOAD) {
+        mgb_log_warn(
+                "perf report is only supported without --lite, which needs the graph "
+                "of the model");
+    }
+}
+
+template <>
+void PerfReportOption::config_model_internel<ModelMdl>(
+        RuntimeParam& runtime_param, std::shared_ptr<ModelMdl> model) {
+    if (runtime_param.stage == RunStage::BEFORE_MODEL_LOAD) {
+        // share the profiler with --profile if it is also given
+        if (!model->get_profiler()) {
+            model->set_profiler();
+        }
+#if MGB_ENABLE_PERF_COUNTER
+        m_perf_counter = std::make_unique<PerfCounterProfiler>(
+                model->get_mdl_config().comp_graph.get());
+#endif
+        return;
+    }
+    if (runtime_param.stage != RunStage::AFTER_MODEL_RUNNING ||
+        !model->get_profiler() || !model->get_async_func()) {
+        return;
+    }
+
+    auto&& outputs = model->get_mdl_load_result().output_var_list;
+    auto comp_node = outputs[0].node()->comp_node();
+    auto roofline = calibrate_roofline(comp_node);
+    printf("perf report on %s: peak %.2f GFLOPS, bandwidth %.2f GB/s, ridge %.2f "
+           "FLOP/byte\n",
+           comp_node.to_string().c_str(), roofline.gflops, roofline.gbps,
+           roofline.gflops / roofline.gbps);
+    PerfCounterProfiler* counters = nullptr;
+#if MGB_ENABLE_PERF_COUNTER
+    counters = m_perf_counter.get();
+#endif
+    auto report = make_perf_report(
+            model->get_async_func().get(), *model->get_profiler(), counters,
+            roofline, m_nr_top);
+    printf("%s\n\n", report.c_str());
+#if MGB_ENABLE_PERF_COUNTER
+    // the counters must be released before the graph
+    m_perf_counter.reset();
+#endif
+}
+}  // namespace lar
+
+using namespace lar;
+
+PerfReportOption::PerfReportOption() {
+    m_option_name = "perf_report";
+    m_nr_top = std::max(FLAGS_perf_report_top, 1);
+}
+
+bool PerfReportOption::is_valid() {
+    return FLAGS_perf_report;
+}
+
+std::shared_ptr<OptionBase> PerfReportOption::create_option() {
+    static std::shared_ptr<PerfReportOption> option(new PerfReportOption);
+    if (PerfReportOption::is_valid()) {
+        return std::static_pointer_cast<OptionBase>(option);
+    } else {
+        return nullptr;
+    }
+}
+
+void PerfReportOption::config_model(
+        RuntimeParam& runtime_param, std::shared_ptr<ModelBase> model) {
+    CONFIG_MODEL_FUN;
+}
+
+DEFINE_bool(
+        perf_report, false,
+        "Profile the model, measure the peak GFLOPS and memory bandwidth of its comp "
+        "node, and print the operators ranked by time with their achieved and "
+        "attainable performance and chosen algos.");
+DEFINE_int32(perf_report_top, 20, "Number of operators listed in the perf report.");
+
+REGIST_OPTION_CREATOR(perf_report, lar::PerfReportOption::create_option);
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+#include <gflags/gflags.h>
+#include "megbrain/plugin/perf_counter.h"
+#include "models/model.h"
+#include "option_base.h"
+
+#if MGB_ENABLE_JSON
+DECLARE_bool(perf_report);
+DECLARE_int32(perf_report_top);
+
+namespace lar {
+/*!
+ * \brief rank the operators of the model by their time, and compare the
+ *      performance they achieved with the roofline of the comp node
+ *
+ * The peak compute and memory bandwidth of the comp node are measured by
+ * calibration kernels after the model runs. The time of each operator comes
+ * from GraphProfiler, and its computation and memory from OprFootprint. The
+ * IPC and cache and TLB misses of the operators are also reported where
+ * PerfCounterProfiler is supported.
+ */
+class PerfReportOption final : public OptionBase {
+public:
+    static bool is_valid();
+
+    static std::shared_ptr<OptionBase> create_option();
+
+    void config_model(
+            RuntimeParam& runtime_param, std::shared_ptr<ModelBase> model) override;
+
+    std::string option_name() const override { return m_option_name; };
+
+private:
+    PerfReportOption();
+    template <typename ModelImpl>
+    void config_model_internel(RuntimeParam&, std::shared_ptr<ModelImpl>){};
+
+    std::string m_option_name;
+    size_t m_nr_top;
+#if MGB_ENABLE_PERF_COUNTER
+    std::unique_ptr<mgb::PerfCounterProfiler> m_perf_counter;
+#endif
+};
+}  // namespace lar
+#endif
@@ -2,15 +2,42 @@
 #include <iostream>
 #include "strategy_fitting.h"
 #include "strategy_normal.h"
+#include "strategy_poisson.h"
+#include "strategy_throughput.h"
 
 using namespace lar;
 DECLARE_bool(fitting);
 std::shared_ptr<StrategyBase> StrategyBase::create_strategy(std::string model_path) {
     if (FLAGS_fitting) {
         return std::make_shared<FittingStrategy>(model_path);
+    } else if (FLAGS_throughput_instances > 0) {
+        return std::make_shared<ThroughputStrategy>(model_path);
+    } else if (FLAGS_poisson_qps > 0) {
+        return std::make_shared<PoissonStrategy>(model_path);
     } else {
         return std::make_shared<NormalStrategy>(model_path);
     }
 }
 
+void lar::config_model_stages(
+        OptionMap& options, RuntimeParam& runtime_param,
+        std::shared_ptr<ModelBase> model, std::initializer_list<RunStage> stages) {
+    for (auto stage : stages) {
+        runtime_param.stage = stage;
+        for (auto& option : options) {
+            option.second->config_model(runtime_param, model);
+        }
+    }
+}
+
+void lar::config_model_before_running(
+        OptionMap& options, RuntimeParam& runtime_param,
+        std::shared_ptr<ModelBase> model) {
+    config_model_stages(
+            options, runtime_param, model,
+            {RunStage::AFTER_MODEL_LOAD, RunStage::GLOBAL_OPTIMIZATION,
+             RunStage::BEFORE_OUTSPEC_SET, RunStage::AFTER_OUTSPEC_SET,
+             RunStage::MODEL_RUNNING});
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <initializer_list>
 #include <string>
 #include <unordered_map>
 #include "helpers/common.h"
@@ -22,6 +23,17 @@ public:
     std::shared_ptr<OptionMap> m_options;
 };
 
+//! configure the model by all the options at each of the stages in turn
+void config_model_stages(
+        OptionMap& options, RuntimeParam& runtime_param,
+        std::shared_ptr<ModelBase> model, std::initializer_list<RunStage> stages);
+
+//! configure the loaded model by all the options at the stages before it runs,
+//! from AFTER_MODEL_LOAD to MODEL_RUNNING
+void config_model_before_running(
+        OptionMap& options, RuntimeParam& runtime_param,
+        std::shared_ptr<ModelBase> model);
+
 }  // namespace lar
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -6,15 +6,20 @@
 #elif __linux__ || __unix__ || __APPLE__
 #include <unistd.h>
 #endif
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <list>
 #include <regex>
+#include <sstream>
 #include <thread>
 #include "lite/pack_model.h"
 #include "megbrain/common.h"
 #include "megbrain/comp_node_env.h"
 #include "megbrain/exception.h"
+#include "megbrain/system.h"
+#include "megbrain/utils/hash.h"
+#include "megbrain/utils/persistent_cache.h"
 #include "megbrain/utils/timer.h"
 #include "megbrain/version.h"
 #include "megdnn/version.h"
@@ -150,17 +155,107 @@ void OptionsFastManager::reset_option() {
 }
 
 ////////////////// OptionsTimeProfiler //////////////////
+namespace {
+//! identity of the device the fitting runs on, so that the results profiled on
+//! another device are not reused
+std::string device_identity() {
+#if LITE_WITH_CUDA
+    if (!FLAGS_cpu) {
+        return mgb::PersistentCache::make_category_from_comp_node(
+                mgb::CompNode::load("gpu0"));
+    }
+#endif
+    std::string cpu_name = "unknown";
+#if __linux__
+    std::ifstream fin("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(fin, line)) {
+        auto pos = line.find(':');
+        if (line.compare(0, 10, "model name") == 0 && pos != std::string::npos) {
+            std::istringstream value(line.substr(pos + 1));
+            std::getline(value >> std::ws, cpu_name);
+            break;
+        }
+    }
+#endif
+    return mgb::ssprintf(
+            "plat=cpu;dev=%s;cores=%d", cpu_name.c_str(), mgb::sys::get_cpu_count());
+}
+}  // namespace
+
+OptionsTimeProfiler::OptionsTimeProfiler() {
+    m_cache_path = FLAGS_fitting_cache;
+    if (!m_cache_path.empty()) {
+        m_device = device_identity();
+        //! the key is split by spaces
+        std::replace(m_device.begin(), m_device.end(), ' ', '_');
+        load_cache();
+    }
+}
 
-void OptionsTimeProfiler::profile_with_given_options(
+std::string OptionsTimeProfiler::cache_key(
+        const std::string& model_path, const std::string& code) {
+    auto iter = m_model_hash.find(model_path);
+    if (iter == m_model_hash.end()) {
+        std::ifstream fin(model_path, std::ios::binary);
+        mgb::XXHash hash;
+        char buf[1 << 16];
+        while (fin) {
+            fin.read(buf, sizeof(buf));
+            hash.update(buf, fin.gcount());
+        }
+        iter = m_model_hash.emplace(model_path, hash.digest()).first;
+    }
+    //! the order of the options in the code is not stable
+    std::vector<std::string> options;
+    std::istringstream code_stream(code);
+    std::string option;
+    while (code_stream >> option) {
+        options.push_back(option);
+    }
+    std::sort(options.begin(), options.end());
+    std::string key = std::to_string(iter->second) + " " + m_device;
+    for (auto&& item : options) {
+        key += " " + item;
+    }
+    return key;
+}
+
+void OptionsTimeProfiler::load_cache() {
+    //! each line is "<iterations> <average time> <key>", where later lines
+    //! replace the earlier ones with no more iterations
+    std::ifstream fin(m_cache_path);
+    std::string line;
+    while (std::getline(fin, line)) {
+        std::istringstream line_stream(line);
+        CacheEntry entry;
+        std::string key;
+        if (!(line_stream >> entry.first >> entry.second) ||
+            !std::getline(line_stream >> std::ws, key)) {
+            continue;
+        }
+        auto&& cached = m_cache[key];
+        if (entry.first >= cached.first) {
+            cached = entry;
+        }
+    }
+    mgb_log("load %zu fitting results from %s", m_cache.size(), m_cache_path.c_str());
+}
+
+void OptionsTimeProfiler::save_cache(const std::string& key, const CacheEntry& entry) {
+    m_cache[key] = entry;
+    std::ofstream fout(m_cache_path, std::ios::app);
+    fout << entry.first << " " << entry.second << " " << key << std::endl;
+}
+
+double OptionsTimeProfiler::profile_with_given_options(
         const std::string& model_path, std::shared_ptr<OptionMap>& given_options,
-        const std::string& option_code) {
+        const std::string& option_code, size_t run_iter) {
     RuntimeParam runtime_param;
     auto model = ModelBase::create_model(model_path);
     mgb::RealTimer timer;
-    auto stage_config_model = [&]() {
-        for (auto& option : *given_options) {
-            option.second->config_model(runtime_param, model);
-        }
+    auto stage_config_model = [&](RunStage stage) {
+        config_model_stages(*given_options, runtime_param, model, {stage});
     };
 
     auto warm_up = [&]() {
@@ -171,8 +266,19 @@ void OptionsTimeProfiler::profile_with_given_options(
             mgb_log_warn("warm up %ld time %f ms", i, timer.get_msecs() - start);
         }
     };
+    //! a run is hopeless once it is slower than the best one by the ratio; the
+    //! exhaustive search profiles every candidate in full
+    double drop_time = TIME_OUT;
+    if (FLAGS_fitting_search == "halving" && FLAGS_fitting_drop_ratio > 0) {
+        drop_time =
+                std::min(drop_time, m_best_setting.second * FLAGS_fitting_drop_ratio);
+    }
+    //! model with testcase
+    size_t case_num = runtime_param.testcase_num;
     double inference_time = 0.0;
-    auto run_iter = [&]() {
+    //! iterations run over all the testcases so far
+    size_t nr_run = 0;
+    auto run_iter_func = [&]() {
         for (size_t i = 0; i < runtime_param.run_iter; i++) {
             auto start = timer.get_msecs();
             model->run_model();
@@ -180,43 +286,58 @@ void OptionsTimeProfiler::profile_with_given_options(
             auto end = timer.get_msecs();
             mgb_log_warn("run iter %ld time %f ms", i, end - start);
             inference_time += end - start;
+            ++nr_run;
             mgb_throw_if(
                     inference_time > TIME_OUT, mgb::TimeoutError,
                     "time out while using fitting");
+            //! the average sums the time of an iteration of all the testcases
+            auto average = inference_time / nr_run * case_num;
+            mgb_throw_if(
+                    average > drop_time, mgb::TimeoutError,
+                    "terminated early with average time %.2f ms, while the best is "
+                    "%.2f ms",
+                    average, m_best_setting.second);
         }
     };
 
-    //! model with testcase
-    size_t case_num = runtime_param.testcase_num;
-
-    bool exception_state = false;
+    std::string key;
+    if (!m_cache_path.empty()) {
+        key = cache_key(model_path, option_code);
+    }
+    bool exception_state = false, cached = false;
     MGB_TRY {
         timer.reset();
-        runtime_param.stage = RunStage::BEFORE_MODEL_LOAD;
-        stage_config_model();
-
-        model->load_model();
-        //! after load configure
-        auto config_model_before_runing = [&]() {
-            for (auto stage :
-                 {RunStage::AFTER_MODEL_LOAD, RunStage::GLOBAL_OPTIMIZATION,
-                  RunStage::BEFORE_OUTSPEC_SET, RunStage::AFTER_OUTSPEC_SET,
-                  RunStage::MODEL_RUNNING}) {
-                runtime_param.stage = stage;
-                stage_config_model();
+        stage_config_model(RunStage::BEFORE_MODEL_LOAD);
+        if (run_iter) {
+            runtime_param.run_iter = run_iter;
+        }
+        auto iter = m_cache.find(key);
+        if (iter != m_cache.end() && iter->second.first >= runtime_param.run_iter) {
+            inference_time = iter->second.second * runtime_param.run_iter;
+            cached = true;
+            //! the model is not loaded, but the options still dump their caches,
+            //! like the fastrun cache, as after a profiled run
+            for (auto name : {"fastrun", "tensorRT"}) {
+                auto option = given_options->find(name);
+                if (option != given_options->end()) {
+                    runtime_param.stage = RunStage::AFTER_MODEL_RUNNING;
+                    option->second->config_model(runtime_param, model);
+                }
             }
-        };
-        timer.reset();
-        for (size_t idx = 0; idx < case_num; idx++) {
-            auto start = timer.get_msecs();
-            config_model_before_runing();
-            auto end = timer.get_msecs();
-            mgb_log_warn("config model time %f ms", end - start);
-            warm_up();
-            run_iter();
+        } else {
+            model->load_model();
+            timer.reset();
+            for (size_t idx = 0; idx < case_num; idx++) {
+                auto start = timer.get_msecs();
+                //! after load configure
+                config_model_before_running(*given_options, runtime_param, model);
+                auto end = timer.get_msecs();
+                mgb_log_warn("config model time %f ms", end - start);
+                warm_up();
+                run_iter_func();
+            }
+            stage_config_model(RunStage::AFTER_MODEL_RUNNING);
         }
-        runtime_param.stage = RunStage::AFTER_MODEL_RUNNING;
-        stage_config_model();
     }
     MGB_CATCH(std::exception & exc, {
         mgb_log_error("catch exception: %s", exc.what());
@@ -226,11 +347,14 @@ void OptionsTimeProfiler::profile_with_given_options(
     auto average = inference_time / runtime_param.run_iter;
     if (exception_state) {
         average = TIME_OUT;
+    } else if (!key.empty() && !cached) {
+        save_cache(key, {runtime_param.run_iter, average});
     }
 
     //! record profile result
-    printf("profile option:\n%s\naverage time = %.2f\n", option_code.c_str(), average);
-    m_options_profile_result.insert({option_code, average});
+    printf("%s option:\n%s\naverage time = %.2f\n", cached ? "cached" : "profile",
+           option_code.c_str(), average);
+    m_options_profile_result[option_code] = average;
 
     //! record the best result
 
@@ -238,6 +362,7 @@ void OptionsTimeProfiler::profile_with_given_options(
         m_best_setting.first = option_code;
         m_best_setting.second = average;
     }
+    return average;
 }
 /////////////////////////// UserInfoParser /////////////////////////////
 void UserInfoParser::get_user_info() {
@@ -419,13 +544,8 @@ void FittingStrategy::dump_best_options_with_model() {
     std::vector<uint8_t> info_binary_cache_data;
     auto model = ModelBase::create_model(m_model_path);
     RuntimeParam runtime_param;
-    auto stage_config_model = [&]() {
-        for (auto& option : *m_options) {
-            option.second->config_model(runtime_param, model);
-        }
-    };
-    runtime_param.stage = RunStage::BEFORE_MODEL_LOAD;
-    stage_config_model();
+    config_model_stages(
+            *m_options, runtime_param, model, {RunStage::BEFORE_MODEL_LOAD});
 
     model->load_model();
 
@@ -450,19 +570,19 @@ void FittingStrategy::dump_best_options_with_model() {
     m_packed_info.push_back({mgb::json::String("valid"), mgb::json::Bool::make(true)});
     m_packed_info.push_back(
             {mgb::json::String("name"), mgb::json::String::make("packed_model")});
+    m_packed_info.push_back(
+            {mgb::json::String("fitting"),
+             mgb::json::Object::make(
+                     {{"search", mgb::json::String::make(FLAGS_fitting_search)},
+                      {"options", mgb::json::String::make(m_best_options)},
+                      {"average_time", mgb::json::Number::make(m_best_time)}})});
     auto obj = mgb::json::Object::make(m_packed_info);
     json_info_str = obj->to_string();
 #endif
     std::vector<uint8_t> json_info(json_info_str.begin(), json_info_str.end());
 
     //! get model binary data after optimized
-    for (auto stage :
-         {RunStage::AFTER_MODEL_LOAD, RunStage::GLOBAL_OPTIMIZATION,
-          RunStage::BEFORE_OUTSPEC_SET, RunStage::AFTER_OUTSPEC_SET,
-          RunStage::MODEL_RUNNING}) {
-        runtime_param.stage = stage;
-        stage_config_model();
-    }
+    config_model_before_running(*m_options, runtime_param, model);
     model->run_model();
     model->wait();
 
@@ -496,23 +616,12 @@ FittingStrategy::AutoCleanFile::~AutoCleanFile() {
 void FittingStrategy::AutoCleanFile::dump_model() {
     auto model = ModelBase::create_model(m_model_path);
     RuntimeParam runtime_param;
-    auto stage_config_model = [&]() {
-        for (auto& option : *m_options) {
-            option.second->config_model(runtime_param, model);
-        }
-    };
-    runtime_param.stage = RunStage::BEFORE_MODEL_LOAD;
-    stage_config_model();
+    config_model_stages(
+            *m_options, runtime_param, model, {RunStage::BEFORE_MODEL_LOAD});
 
     model->load_model();
     //! get model binary data after optimized
-    for (auto stage :
-         {RunStage::AFTER_MODEL_LOAD, RunStage::GLOBAL_OPTIMIZATION,
-          RunStage::BEFORE_OUTSPEC_SET, RunStage::AFTER_OUTSPEC_SET,
-          RunStage::MODEL_RUNNING}) {
-        runtime_param.stage = stage;
-        stage_config_model();
-    }
+    config_model_before_running(*m_options, runtime_param, model);
     model->run_model();
     model->wait();
 
@@ -538,17 +647,15 @@ void FittingStrategy::run() {
             profiler == nullptr, mgb::AssertionError,
             "get empty profiler for fittting\n");
     //! profile model with fixed options
+    std::vector<Candidate> fixed_candidates;
     while (!m_manager->is_fixed_end()) {
         std::string option_str = m_manager->set_next_fixed_options();
-        profiler->profile_with_given_options(m_model_path, m_options, option_str);
-#if (MEGDNN_AARCH64 || MEGDNN_ARMV7)
-        //! sleep to keep machine with stable cpu frequence
-        usleep(500000);
-#endif
+        fixed_candidates.push_back({option_str, option_str});
     }
+    auto best_fixed = search_best_options(profiler, fixed_candidates);
     std::string m_tmp_model = m_model_path;
     const std::regex layout_regex("layout_transform");
-    auto best_fixed_options = profiler->get_best_setting();
+    auto best_fixed_options = best_fixed.first;
     m_manager->set_options(best_fixed_options);
     //! dump model for global layout transform
     auto m_tmp_file = AutoCleanFile(m_model_path, m_options);
@@ -557,34 +664,104 @@ void FittingStrategy::run() {
         m_model_path = m_tmp_file.filename();
     }
     //! profile model with given profiler
+    std::vector<Candidate> candidates;
     while (!m_manager->is_end_options()) {
         std::string curr_option_str = m_manager->set_next_options();
         //! set option with current option and fixed options
-        if (m_model_path == m_tmp_model) {
-            auto total_option_str = curr_option_str + best_fixed_options;
-            m_manager->set_options(total_option_str);
-        }
-
-        curr_option_str += best_fixed_options;
-        profiler->profile_with_given_options(m_model_path, m_options, curr_option_str);
-#if (MEGDNN_AARCH64 || MEGDNN_ARMV7)
-        usleep(500000);
-#endif
+        auto total_option_str = curr_option_str + best_fixed_options;
+        candidates.push_back(
+                {total_option_str,
+                 m_model_path == m_tmp_model ? total_option_str : curr_option_str});
+    }
+    auto best = search_best_options(profiler, candidates);
+    if (best_fixed.second < best.second) {
+        best = best_fixed;
     }
     //! set with best options and inference
     m_model_path = m_tmp_model;
-    auto best_options = profiler->get_best_setting();
+    m_best_options = best.first;
 
-    m_manager->set_options(best_options);
-    profiler->profile_with_given_options(m_model_path, m_options, best_options);
+    m_manager->set_options(m_best_options);
+    m_best_time = profiler->profile_with_given_options(
+            m_model_path, m_options, m_best_options, 0);
 
     //! save best options into given dir
-    std::cout << "the best options:\n" << best_options << std::endl;
+    std::cout << "the best options:\n" << m_best_options << std::endl;
 
     if (!m_dumped_model.empty()) {
         dump_best_options_with_model();
     }
 }
+
+std::pair<std::string, double> FittingStrategy::search_best_options(
+        std::shared_ptr<OptionsProfiler>& profiler, std::vector<Candidate> candidates) {
+    std::pair<std::string, double> best = {"", TIME_OUT};
+    auto profile = [&](const Candidate& candidate, size_t run_iter) {
+        m_manager->set_options(candidate.applied);
+        auto time = profiler->profile_with_given_options(
+                m_model_path, m_options, candidate.code, run_iter);
+#if (MEGDNN_AARCH64 || MEGDNN_ARMV7)
+        //! sleep to keep machine with stable cpu frequence
+        usleep(500000);
+#endif
+        return time;
+    };
+    if (FLAGS_fitting_search != "halving") {
+        for (auto&& candidate : candidates) {
+            auto time = profile(candidate, 0);
+            if (time < best.second) {
+                best = {candidate.code, time};
+            }
+        }
+        return best;
+    }
+
+    mgb_assert(FLAGS_fitting_eta > 1, "--fitting_eta must be greater than 1");
+    size_t eta = FLAGS_fitting_eta;
+    size_t run_iter = std::max(FLAGS_fitting_min_iter, 1);
+    std::vector<std::pair<double, size_t>> times;
+    while (!candidates.empty()) {
+        times.clear();
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            times.push_back({profile(candidates[i], run_iter), i});
+        }
+        std::sort(times.begin(), times.end());
+        best = {candidates[times[0].second].code, times[0].first};
+        if (candidates.size() == 1) {
+            break;
+        }
+        //! keep the fastest 1/eta of the candidates which did not fail or
+        //! terminate early
+        size_t nr_keep = (candidates.size() + eta - 1) / eta;
+        std::vector<Candidate> kept;
+        for (size_t i = 0; i < nr_keep && times[i].first < TIME_OUT; ++i) {
+            kept.push_back(candidates[times[i].second]);
+        }
+        mgb_log("successive halving: keep %zu of %zu candidates with %zu iterations",
+                kept.size(), candidates.size(), run_iter);
+        candidates = std::move(kept);
+        run_iter *= eta;
+    }
+    return best;
+}
 DEFINE_bool(
         fitting, false, "use the fitting mode profile and get the best option set.");
 DEFINE_string(dump_fitting_model, "", "dump the best option and algo cache into model");
+DEFINE_string(
+        fitting_search, "exhaustive",
+        "search of the fitting mode: exhaustive profiles every candidate options "
+        "with the same iterations, halving profiles them with successive halving");
+DEFINE_int32(
+        fitting_eta, 3,
+        "the fraction of candidates kept and the growth of iterations in each "
+        "round of successive halving");
+DEFINE_int32(
+        fitting_min_iter, 2, "iterations of the first round of successive halving");
+DEFINE_double(
+        fitting_drop_ratio, 2.0,
+        "terminate profiling of options in the halving search once they are slower "
+        "than the best options by the ratio, 0 to disable");
+DEFINE_string(
+        fitting_cache, "",
+        "file to cache the profiling results of the fitting mode across runs, which "
+        "are keyed by the model, the device and the options");
@@ -4,6 +4,11 @@
 #include "strategy.h"
 DECLARE_bool(fitting);
 DECLARE_string(dump_fitting_model);
+DECLARE_string(fitting_search);
+DECLARE_int32(fitting_eta);
+DECLARE_int32(fitting_min_iter);
+DECLARE_double(fitting_drop_ratio);
+DECLARE_string(fitting_cache);
 #define TIME_OUT 10000
 namespace lar {
 
@@ -55,9 +60,11 @@ class OptionsProfiler {
 public:
     OptionsProfiler(){};
 
-    //! run with m_options
-    virtual void profile_with_given_options(
-            const std::string&, std::shared_ptr<OptionMap>&, const std::string&) = 0;
+    //! run with m_options for \p run_iter iterations, or the iterations set by
+    //! the options if it is 0, and return the average time
+    virtual double profile_with_given_options(
+            const std::string&, std::shared_ptr<OptionMap>&, const std::string&,
+            size_t run_iter) = 0;
 
     //! get the best setting and inference time
     virtual std::string get_best_setting() { return ""; }
@@ -67,20 +74,38 @@ public:
 
 /**
  * profiler to get the fast setting
+ *
+ * In the halving search, a run is terminated early once its average time
+ * exceeds the best average time by --fitting_drop_ratio. With --fitting_cache, the average times of the
+ * finished runs are appended to the cache file, keyed by the content of the
+ * model and the options, and reused by later runs needing no more iterations.
  */
 class OptionsTimeProfiler final : public OptionsProfiler {
 public:
-    OptionsTimeProfiler(){};
+    OptionsTimeProfiler();
 
-    void profile_with_given_options(
-            const std::string&, std::shared_ptr<OptionMap>&,
-            const std::string&) override;
+    double profile_with_given_options(
+            const std::string&, std::shared_ptr<OptionMap>&, const std::string&,
+            size_t run_iter) override;
 
     std::string get_best_setting() override { return m_best_setting.first; }
 
 private:
+    //! number of iterations and average time of a cached run
+    using CacheEntry = std::pair<size_t, double>;
+
+    std::string cache_key(const std::string& model_path, const std::string& code);
+    void load_cache();
+    void save_cache(const std::string& key, const CacheEntry& entry);
+
     std::unordered_map<std::string, double> m_options_profile_result;
     std::pair<std::string, double> m_best_setting = {"", TIME_OUT};
+    std::string m_cache_path;
+    std::unordered_map<std::string, CacheEntry> m_cache;
+    //! model path => hash of its content
+    std::unordered_map<std::string, uint64_t> m_model_hash;
+    //! identity of the device, which is a part of the cache key
+    std::string m_device;
 };
 
 /**
@@ -137,7 +162,31 @@ public:
     void dump_model();
 
 private:
+    struct Candidate {
+        //! options recorded for the candidate
+        std::string code;
+        //! options applied to profile the candidate
+        std::string applied;
+    };
+
+    /*!
+     * \brief profile the candidates and return the best one with its average
+     *      time
+     *
+     * With --fitting_search=halving, the candidates are profiled in rounds of
+     * successive halving: every round profiles the remaining candidates with
+     * --fitting_eta times the iterations of the previous round, starting from
+     * --fitting_min_iter, and keeps the fastest 1/fitting_eta of them.
+     * Otherwise each candidate is profiled once with the iterations set by
+     * the options.
+     */
+    std::pair<std::string, double> search_best_options(
+            std::shared_ptr<OptionsProfiler>& profiler,
+            std::vector<Candidate> candidates);
+
     std::string m_model_path;
+    std::string m_best_options;
+    double m_best_time = TIME_OUT;
 
     std::string m_dumped_model;
     std::shared_ptr<OptionsFastManager> m_manager;
@@ -36,14 +36,11 @@ void NormalStrategy::run_subline() {
     auto model = ModelBase::create_model(m_model_path);
     mgb_assert(model != nullptr, "create model failed!!");
 
-    auto stage_config_model = [&]() {
-        for (auto& option : *m_options) {
-            option.second->config_model(m_runtime_param, model);
-        }
+    auto stage_config_model = [&](RunStage stage) {
+        config_model_stages(*m_options, m_runtime_param, model, {stage});
     };
     //! execute before load config
-    m_runtime_param.stage = RunStage::BEFORE_MODEL_LOAD;
-    stage_config_model();
+    stage_config_model(RunStage::BEFORE_MODEL_LOAD);
 
     mgb::RealTimer timer;
     model->load_model();
@@ -51,12 +48,10 @@ void NormalStrategy::run_subline() {
 
     //! after load configure
     auto config_after_load = [&]() {
-        for (auto stage :
-             {RunStage::AFTER_MODEL_LOAD, RunStage::GLOBAL_OPTIMIZATION,
-              RunStage::BEFORE_OUTSPEC_SET, RunStage::AFTER_OUTSPEC_SET}) {
-            m_runtime_param.stage = stage;
-            stage_config_model();
-        }
+        config_model_stages(
+                *m_options, m_runtime_param, model,
+                {RunStage::AFTER_MODEL_LOAD, RunStage::GLOBAL_OPTIMIZATION,
+                 RunStage::BEFORE_OUTSPEC_SET, RunStage::AFTER_OUTSPEC_SET});
     };
 
     auto warm_up = [&]() {
@@ -66,8 +61,7 @@ void NormalStrategy::run_subline() {
             model->run_model();
             model->wait();
             printf("warm up %lu  %.3fms\n", i, timer.get_msecs_reset());
-            m_runtime_param.stage = RunStage::AFTER_RUNNING_WAIT;
-            stage_config_model();
+            stage_config_model(RunStage::AFTER_RUNNING_WAIT);
         }
     };
 
@@ -81,8 +75,7 @@ void NormalStrategy::run_subline() {
             auto exec_time = timer.get_msecs();
             model->wait();
             auto cur = timer.get_msecs();
-            m_runtime_param.stage = RunStage::AFTER_RUNNING_WAIT;
-            stage_config_model();
+            stage_config_model(RunStage::AFTER_RUNNING_WAIT);
             printf("iter %lu/%lu: e2e=%.3f ms (host=%.3f ms)\n", i, run_num, cur,
                    exec_time);
             time_sum += cur;
@@ -110,22 +103,19 @@ void NormalStrategy::run_subline() {
         config_after_load();
         //! config when running model
         mgb_log_warn("run testcase: %zu ", idx);
-        m_runtime_param.stage = RunStage::MODEL_RUNNING;
-        stage_config_model();
+        stage_config_model(RunStage::MODEL_RUNNING);
 
         if (idx == 0) {
             warm_up();
         }
         tot_time += run_iter(idx);
 
-        m_runtime_param.stage = RunStage::AFTER_RUNNING_ITER;
-        stage_config_model();
+        stage_config_model(RunStage::AFTER_RUNNING_ITER);
     }
 
     printf("=== total time: %.3fms\n", tot_time);
     //! execute after run
-    m_runtime_param.stage = RunStage::AFTER_MODEL_RUNNING;
-    stage_config_model();
+    stage_config_model(RunStage::AFTER_MODEL_RUNNING);
 };
 
 void NormalStrategy::run() {
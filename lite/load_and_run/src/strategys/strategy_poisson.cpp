@@ -0,0 +1,136 @@
+#include "strategy_poisson.h"
+#include <algorithm>
+#include <condition_variable>
+#include <thread>
+#include "helpers/request_stats.h"
+#include "lite/batching.h"
+#include "megbrain/common.h"
+#include "misc.h"
+#include "models/model_lite.h"
+
+using namespace lar;
+
+PoissonStrategy::PoissonStrategy(std::string model_path) {
+    mgb::set_log_level(mgb::LogLevel::WARN);
+    lite::set_log_level(LiteLogLevel::WARN);
+    m_options = std::make_shared<OptionMap>();
+    m_model_path = model_path;
+    auto option_creator_map = OptionFactory::get_Instance().get_option_creator_map();
+    for (auto& creator : *option_creator_map) {
+        auto option = creator.second();
+        if (option) {
+            m_options->insert({creator.first, option});
+        }
+    }
+}
+
+void PoissonStrategy::run() {
+    auto model = ModelBase::create_model(m_model_path);
+    mgb_assert(model != nullptr, "create model failed!!");
+    mgb_assert(
+            model->type() == ModelType::LITE_MODEL,
+            "--poisson_qps only supports lite model, use it with --lite");
+    mgb_assert(FLAGS_max_batch_size > 0, "--max_batch_size must be positive");
+    config_model_stages(
+            *m_options, m_runtime_param, model, {RunStage::BEFORE_MODEL_LOAD});
+    model->load_model();
+    config_model_before_running(*m_options, m_runtime_param, model);
+    for (size_t i = 0; i < m_runtime_param.warmup_iter; i++) {
+        model->run_model();
+        model->wait();
+    }
+
+    //! all the requests use the inputs set by the input options
+    auto network = std::static_pointer_cast<ModelLite>(model)->get_lite_network();
+    std::vector<std::shared_ptr<lite::Tensor>> inputs;
+    for (auto&& name : network->get_all_input_name()) {
+        auto input = std::make_shared<lite::Tensor>();
+        input->copy_from(*network->get_io_tensor(name));
+        inputs.push_back(input);
+    }
+    lite::BatchingConfig config;
+    config.max_batch_size = FLAGS_max_batch_size;
+    config.max_wait_us = FLAGS_max_batch_wait_us;
+    config.pad_to_max_batch = FLAGS_pad_batch;
+    lite::BatchedNetwork batched{network, config};
+
+    using Clock = std::chrono::steady_clock;
+    size_t nr_requests = FLAGS_poisson_requests;
+    std::vector<Clock::time_point> arrivals(nr_requests);
+    std::vector<std::future<lite::BatchedNetwork::Outputs>> futures(nr_requests);
+    std::vector<double> latencies(nr_requests);
+    std::mutex mtx;
+    std::condition_variable cv;
+    size_t nr_submitted = 0;
+    Clock::time_point finish;
+    std::thread collector([&]() {
+        for (size_t i = 0; i < nr_requests; ++i) {
+            std::future<lite::BatchedNetwork::Outputs> future;
+            Clock::time_point arrival;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&]() { return nr_submitted > i; });
+                future = std::move(futures[i]);
+                arrival = arrivals[i];
+            }
+            future.get();
+            latencies[i] = std::chrono::duration<double, std::milli>(
+                                   Clock::now() - arrival)
+                                   .count();
+        }
+        finish = Clock::now();
+    });
+
+    //! the arrival time is scheduled ahead, so the latency includes the time
+    //! a request waits for the client to submit it
+    auto start = Clock::now();
+    PoissonArrival arrival_gen{FLAGS_poisson_qps, start};
+    for (size_t i = 0; i < nr_requests; ++i) {
+        auto arrival = arrival_gen.next();
+        std::this_thread::sleep_until(arrival);
+        auto future = batched.submit(inputs);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            arrivals[i] = arrival;
+            futures[i] = std::move(future);
+            ++nr_submitted;
+        }
+        cv.notify_one();
+    }
+    collector.join();
+
+    auto secs = std::chrono::duration<double>(finish - start).count();
+    auto stats = batched.get_stats();
+    LatencyStats latency{std::move(latencies)};
+    printf("\n=== poisson arrival: qps=%.3f requests=%zu max_batch_size=%d "
+           "max_batch_wait_us=%d\n",
+           FLAGS_poisson_qps, nr_requests, FLAGS_max_batch_size,
+           FLAGS_max_batch_wait_us);
+    printf("=== throughput=%.3f req/s batches=%zu avg_batch=%.3f padded=%zu\n",
+           nr_requests / secs, stats.nr_batches,
+           stats.nr_samples / std::max<double>(stats.nr_batches, 1),
+           stats.nr_padded_samples);
+    printf("=== latency: avg=%.3f ms p50=%.3f ms p90=%.3f ms p99=%.3f ms "
+           "max=%.3f ms\n\n",
+           latency.avg(), latency.percentile(0.5), latency.percentile(0.9),
+           latency.percentile(0.99), latency.max());
+
+    config_model_stages(
+            *m_options, m_runtime_param, model, {RunStage::AFTER_MODEL_RUNNING});
+}
+
+DEFINE_double(
+        poisson_qps, 0,
+        "simulate requests arriving as a Poisson process with the given rate per "
+        "second, which are batched by lite::BatchedNetwork (only for --lite)");
+DEFINE_int32(poisson_requests, 1000, "number of requests to simulate");
+DEFINE_int32(max_batch_size, 8, "max number of requests batched together");
+DEFINE_int32(
+        max_batch_wait_us, 1000,
+        "max time in microseconds to wait for more requests to batch");
+DEFINE_bool(
+        pad_batch, false,
+        "pad batches to max_batch_size, so that the model always runs with the "
+        "same input shapes");
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
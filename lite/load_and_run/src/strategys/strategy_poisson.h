@@ -0,0 +1,29 @@
+#pragma once
+#include <gflags/gflags.h>
+#include "strategy.h"
+DECLARE_double(poisson_qps);
+DECLARE_int32(poisson_requests);
+DECLARE_int32(max_batch_size);
+DECLARE_int32(max_batch_wait_us);
+DECLARE_bool(pad_batch);
+
+namespace lar {
+/*!
+ * \brief: strategy to serve requests arriving as a Poisson process
+ *
+ * Requests with the inputs given by the input options are submitted to a
+ * lite::BatchedNetwork at exponentially distributed intervals, and the
+ * throughput and the latencies from arrival to finish are reported.
+ */
+class PoissonStrategy : public StrategyBase {
+public:
+    PoissonStrategy(std::string model_path);
+
+    void run() override;
+
+private:
+    std::string m_model_path;
+};
+}  // namespace lar
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,323 @@
+#include "strategy_throughput.h"
+#include <algorithm>
+#include <condition_variable>
+#include <queue>
+#include <thread>
+#include "helpers/request_stats.h"
+#include "helpers/text_table.h"
+#include "megbrain/common.h"
+#include "megbrain/system.h"
+#include "misc.h"
+#include "models/model_lite.h"
+#if __linux__ || __unix__
+#include <sys/resource.h>
+#endif
+
+DECLARE_bool(share_param_mem);
+
+using namespace lar;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Instance {
+    size_t model_idx;
+    std::shared_ptr<lite::Network> network;
+    //! first core the threads are pinned to, or -1 if not pinned
+    int first_core = -1;
+    //! latencies of the requests in milliseconds
+    std::vector<double> latencies;
+};
+
+//! seconds of cpu time used by all the threads of the process, or a negative
+//! value if it is unknown
+double process_cpu_secs() {
+#if __linux__ || __unix__
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return -1;
+    }
+    auto secs = [](const timeval& t) { return t.tv_sec + t.tv_usec * 1e-6; };
+    return secs(usage.ru_utime) + secs(usage.ru_stime);
+#else
+    return -1;
+#endif
+}
+
+std::vector<std::string> split_paths(const std::string& str) {
+    std::vector<std::string> ret;
+    size_t begin = 0;
+    while (begin <= str.size()) {
+        auto end = std::min(str.find(',', begin), str.size());
+        if (end > begin) {
+            ret.push_back(str.substr(begin, end - begin));
+        }
+        begin = end + 1;
+    }
+    return ret;
+}
+
+std::string base_name(const std::string& path) {
+    auto pos = path.find_last_of("/\\");
+    return pos == std::string::npos ? path : path.substr(pos + 1);
+}
+
+double elapsed_ms(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+}  // namespace
+
+ThroughputStrategy::ThroughputStrategy(std::string model_path) {
+    mgb::set_log_level(mgb::LogLevel::WARN);
+    lite::set_log_level(LiteLogLevel::WARN);
+    m_options = std::make_shared<OptionMap>();
+    m_model_path = model_path;
+    auto option_creator_map = OptionFactory::get_Instance().get_option_creator_map();
+    for (auto& creator : *option_creator_map) {
+        auto option = creator.second();
+        if (option) {
+            m_options->insert({creator.first, option});
+        }
+    }
+}
+
+void ThroughputStrategy::run() {
+    auto model = ModelBase::create_model(m_model_path);
+    mgb_assert(model != nullptr, "create model failed!!");
+    mgb_assert(
+            model->type() == ModelType::LITE_MODEL,
+            "--throughput_instances only supports lite model, use it with --lite");
+    mgb_assert(FLAGS_instance_threads > 0, "--instance_threads must be positive");
+    config_model_stages(
+            *m_options, m_runtime_param, model, {RunStage::BEFORE_MODEL_LOAD});
+    model->load_model();
+    config_model_before_running(*m_options, m_runtime_param, model);
+
+    //! the instances are created with the config of the configured network,
+    //! which is only used to provide the inputs and the params
+    auto model_lite = std::static_pointer_cast<ModelLite>(model);
+    auto primary = model_lite->get_lite_network();
+    auto&& config = model_lite->get_config();
+    std::vector<std::string> model_paths{m_model_path};
+    for (auto&& path : split_paths(FLAGS_throughput_models)) {
+        model_paths.push_back(path);
+    }
+    //! the IO set by the options names the tensors of the model, and the extra
+    //! models use their own IO found in their graphs
+    std::vector<lite::NetworkIO> model_ios(model_paths.size());
+    model_ios[0] = model_lite->get_networkIO();
+    std::vector<std::shared_ptr<lite::Network>> param_owners(model_paths.size());
+    param_owners[0] = primary;
+
+    bool is_cpu = config.device_type == LiteDeviceType::LITE_CPU;
+    size_t nr_threads = FLAGS_instance_threads;
+    int nr_cores = mgb::sys::get_cpu_count();
+    std::vector<Instance> instances(FLAGS_throughput_instances);
+    for (size_t i = 0; i < instances.size(); ++i) {
+        auto&& inst = instances[i];
+        inst.model_idx = i % model_paths.size();
+        auto network =
+                std::make_shared<lite::Network>(config, model_ios[inst.model_idx]);
+        // a comp node of its own, so the instances do not queue on one worker
+        if (is_cpu) {
+            network->set_device_id(i + 1);
+            if (nr_threads > 1) {
+                lite::Runtime::set_cpu_threads_number(network, nr_threads);
+            }
+        } else {
+            network->set_stream_id(i + 1);
+        }
+        auto&& owner = param_owners[inst.model_idx];
+        if (FLAGS_share_param_mem && owner) {
+            lite::Runtime::shared_weight_with_network(network, owner);
+        } else {
+            network->load_model(model_paths[inst.model_idx]);
+            if (!owner) {
+                owner = network;
+            }
+        }
+        if (is_cpu && FLAGS_pin_cores) {
+            inst.first_core = (i * nr_threads) % nr_cores;
+            int first_core = inst.first_core;
+            lite::Runtime::set_runtime_thread_affinity(
+                    network, [first_core, nr_cores](int thread_id) {
+                        int core = (first_core + thread_id) % nr_cores;
+                        mgb::sys::set_cpu_affinity({core});
+                    });
+        }
+        for (auto&& name : network->get_all_input_name()) {
+            if (inst.model_idx == 0) {
+                network->get_io_tensor(name)->copy_from(*primary->get_io_tensor(name));
+            } else {
+                network->get_io_tensor(name)->fill_zero();
+            }
+        }
+        for (size_t j = 0; j < m_runtime_param.warmup_iter; ++j) {
+            network->forward();
+            network->wait();
+        }
+        inst.network = std::move(network);
+    }
+
+    auto run_request = [](Instance& inst, Clock::time_point arrival) {
+        inst.network->forward();
+        inst.network->wait();
+        inst.latencies.push_back(elapsed_ms(arrival));
+    };
+    bool open_loop = FLAGS_throughput_qps > 0;
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+                                    std::chrono::duration<double>(
+                                            FLAGS_throughput_seconds));
+    double cpu_start = process_cpu_secs();
+    std::vector<std::thread> workers;
+    if (!open_loop) {
+        //! closed loop: each instance runs the next request as soon as the
+        //! previous one finishes, until the deadline
+        for (auto&& inst : instances) {
+            auto inst_ptr = &inst;
+            workers.emplace_back([inst_ptr, &run_request, deadline]() {
+                while (Clock::now() < deadline) {
+                    run_request(*inst_ptr, Clock::now());
+                }
+            });
+        }
+        for (auto&& worker : workers) {
+            worker.join();
+        }
+    } else {
+        //! open loop: requests arrive as a Poisson process until the deadline,
+        //! and are run by the first idle instance; the latency counts from the
+        //! scheduled arrival, so it includes the time waiting in the queue
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::queue<Clock::time_point> arrivals;
+        bool finished = false;
+        for (auto&& inst : instances) {
+            auto inst_ptr = &inst;
+            workers.emplace_back([&, inst_ptr]() {
+                for (;;) {
+                    Clock::time_point arrival;
+                    {
+                        std::unique_lock<std::mutex> lock(mtx);
+                        cv.wait(lock, [&]() { return finished || !arrivals.empty(); });
+                        if (arrivals.empty()) {
+                            return;
+                        }
+                        arrival = arrivals.front();
+                        arrivals.pop();
+                    }
+                    run_request(*inst_ptr, arrival);
+                }
+            });
+        }
+        PoissonArrival arrival_gen{FLAGS_throughput_qps, start};
+        for (;;) {
+            auto arrival = arrival_gen.next();
+            if (arrival >= deadline) {
+                break;
+            }
+            std::this_thread::sleep_until(arrival);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                arrivals.push(arrival);
+            }
+            cv.notify_one();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            finished = true;
+        }
+        cv.notify_all();
+        for (auto&& worker : workers) {
+            worker.join();
+        }
+    }
+    double secs = std::chrono::duration<double>(Clock::now() - start).count();
+    double cpu_secs = process_cpu_secs() - cpu_start;
+
+    auto table = mgb::TextTable("throughput of instances");
+    table.padding(1);
+    table.align(mgb::TextTable::Align::Mid)
+            .add("instance")
+            .add("model")
+            .add("threads")
+            .add("cores")
+            .add("requests")
+            .add("qps")
+            .add("avg(ms)")
+            .eor();
+    std::vector<double> latencies;
+    for (size_t i = 0; i < instances.size(); ++i) {
+        auto&& inst = instances[i];
+        double sum = 0;
+        for (auto latency : inst.latencies) {
+            sum += latency;
+        }
+        std::string cores = "-";
+        if (inst.first_core >= 0) {
+            cores = mgb::ssprintf(
+                    "%d-%d", inst.first_core,
+                    static_cast<int>((inst.first_core + nr_threads - 1) % nr_cores));
+        }
+        size_t nr_requests = inst.latencies.size();
+        table.align(mgb::TextTable::Align::Mid)
+                .add(std::to_string(i))
+                .add(base_name(model_paths[inst.model_idx]))
+                .add(std::to_string(nr_threads))
+                .add(cores)
+                .add(std::to_string(nr_requests))
+                .add(mgb::ssprintf("%.3f", nr_requests / secs))
+                .add(mgb::ssprintf("%.3f", sum / std::max<size_t>(nr_requests, 1)))
+                .eor();
+        latencies.insert(latencies.end(), inst.latencies.begin(), inst.latencies.end());
+    }
+    std::stringstream ss;
+    ss << table;
+    printf("%s\n", ss.str().c_str());
+
+    mgb_assert(!latencies.empty(), "no request finished in the benchmark");
+    LatencyStats stats{std::move(latencies)};
+    size_t nr_requests = stats.count();
+    if (open_loop) {
+        printf("\n=== open loop: arrival qps=%.3f", FLAGS_throughput_qps);
+    } else {
+        printf("\n=== closed loop:");
+    }
+    printf(" instances=%zu models=%zu threads_per_instance=%zu duration=%.3f s\n",
+           instances.size(), model_paths.size(), nr_threads, secs);
+    printf("=== throughput=%.3f req/s requests=%zu\n", nr_requests / secs,
+           nr_requests);
+    printf("=== latency: avg=%.3f ms p50=%.3f ms p95=%.3f ms p99=%.3f ms "
+           "p999=%.3f ms max=%.3f ms\n",
+           stats.avg(), stats.percentile(0.5), stats.percentile(0.95),
+           stats.percentile(0.99), stats.percentile(0.999), stats.max());
+    if (cpu_secs >= 0) {
+        printf("=== cpu: %.2f cores busy, %.1f%% of %d cores\n\n", cpu_secs / secs,
+               cpu_secs / secs / nr_cores * 100, nr_cores);
+    }
+
+    config_model_stages(
+            *m_options, m_runtime_param, model, {RunStage::AFTER_MODEL_RUNNING});
+}
+
+DEFINE_int32(
+        throughput_instances, 0,
+        "measure the throughput of the given number of instances of the models "
+        "running concurrently (only for --lite)");
+DEFINE_string(
+        throughput_models, "",
+        "comma separated paths of extra models, the instances are assigned to the "
+        "model and the extra models in turn");
+DEFINE_int32(instance_threads, 1, "number of cpu threads of each instance");
+DEFINE_bool(
+        pin_cores, false,
+        "pin the threads of each instance to their own cores, the instances take "
+        "the cores in turn");
+DEFINE_double(throughput_seconds, 10, "duration of the throughput benchmark");
+DEFINE_double(
+        throughput_qps, 0,
+        "rate per second of requests arriving as a Poisson process, which are run "
+        "by the idle instances; 0 runs each instance in a closed loop");
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
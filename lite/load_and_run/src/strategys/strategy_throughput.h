@@ -0,0 +1,35 @@
+#pragma once
+#include <gflags/gflags.h>
+#include "strategy.h"
+DECLARE_int32(throughput_instances);
+DECLARE_string(throughput_models);
+DECLARE_int32(instance_threads);
+DECLARE_bool(pin_cores);
+DECLARE_double(throughput_seconds);
+DECLARE_double(throughput_qps);
+
+namespace lar {
+/*!
+ * \brief: strategy to measure the throughput of instances of models running
+ *      concurrently
+ *
+ * Each instance is a network of the model, or of one of the extra models, on
+ * its own comp node with its own threads, optionally pinned to its own cores
+ * and sharing the params of the first instance of the same model. The
+ * instances are driven in a closed loop, where each runs the next request as
+ * soon as the previous finishes, or in an open loop, where requests arrive as
+ * a Poisson process and are run by the first idle instance. The aggregate QPS,
+ * latency percentiles and cpu utilization are reported.
+ */
+class ThroughputStrategy : public StrategyBase {
+public:
+    ThroughputStrategy(std::string model_path);
+
+    void run() override;
+
+private:
+    std::string m_model_path;
+};
+}  // namespace lar
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
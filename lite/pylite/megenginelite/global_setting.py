@@ -32,6 +32,7 @@ class _GlobalAPI(_LiteCObjBase):
         ),
         ("LITE_set_loader_lib_path", [c_char_p]),
         ("LITE_set_persistent_cache", [c_char_p, c_int]),
+        ("LITE_set_shared_persistent_cache", [c_char_p]),
         # ('LITE_set_tensor_rt_cache', [c_char_p]),
         ("LITE_dump_persistent_cache", [c_char_p]),
         ("LITE_dump_tensor_rt_cache", [c_char_p]),
@@ -94,6 +95,11 @@ class LiteGlobal(object):
         c_path = c_char_p(path.encode("utf-8"))
         LiteGlobal._api.LITE_set_persistent_cache(c_path, always_sync)
 
+    @staticmethod
+    def set_shared_persistent_cache(path):
+        c_path = c_char_p(path.encode("utf-8"))
+        LiteGlobal._api.LITE_set_shared_persistent_cache(c_path)
+
     @staticmethod
     def set_tensorrt_cache(path):
         c_path = c_char_p(path.encode("utf-8"))
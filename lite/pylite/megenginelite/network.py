@@ -348,6 +348,7 @@ class _NetworkAPI(_LiteCObjBase):
         ("LITE_set_network_algo_fastrun_config", [_Cnetwork, c_int, c_int]),
         ("LITE_set_network_algo_workspace_limit", [_Cnetwork, c_size_t]),
         ("LITE_share_runtime_memroy", [_Cnetwork, _Cnetwork]),
+        ("LITE_share_runtime_memory_with_arena", [_Cnetwork, c_char_p]),
         ("LITE_enable_profile_performance", [_Cnetwork, c_char_p]),
         ("LITE_enable_io_txt_dump", [_Cnetwork, c_char_p]),
         ("LITE_enable_io_bin_dump", [_Cnetwork, c_char_p]),
@@ -555,6 +556,14 @@ class LiteNetwork(object):
         assert isinstance(src_network, LiteNetwork)
         self._api.LITE_share_runtime_memroy(self._network, src_network._network)
 
+    def share_runtime_memory_with_arena(self, arena_name):
+        """
+        share runtime memory with all the networks using the arena with the same
+        name, the networks must not be forwarded concurrently
+        """
+        c_name = arena_name.encode("utf-8")
+        self._api.LITE_share_runtime_memory_with_arena(self._network, c_name)
+
     def async_with_callback(self, async_callback):
         callback = wrap_async_callback(async_callback)
         self._api.LITE_set_async_callback(self._network, callback)
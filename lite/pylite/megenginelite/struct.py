@@ -66,12 +66,16 @@ class LiteAlgoSelectStrategy(IntEnum):
 
     LITE_ALGO_PROFILE | LITE_ALGO_OPTIMIZED | LITE_ALGO_REPRODUCIBLE means:
     profile the best algorithm form the optimzed and reproducible algorithms
+
+    LITE_ALGO_COST_MODEL means: choose the algorithm with the least running
+    time estimated by an analytic cost model, without profiling
     """
 
     LITE_ALGO_HEURISTIC = 1
     LITE_ALGO_PROFILE = 2
     LITE_ALGO_REPRODUCIBLE = 4
     LITE_ALGO_OPTIMIZED = 8
+    LITE_ALGO_COST_MODEL = 16
 
 
 class LiteLogLevel(IntEnum):
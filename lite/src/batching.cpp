@@ -0,0 +1,246 @@
+#include "lite/batching.h"
+#include "misc.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+using namespace lite;
+
+namespace {
+//! whether the inputs of two requests can be concatenated on dim 0
+bool is_batchable(
+        const std::vector<std::shared_ptr<Tensor>>& lhs,
+        const std::vector<std::shared_ptr<Tensor>>& rhs) {
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        auto&& a = lhs[i]->get_layout();
+        auto&& b = rhs[i]->get_layout();
+        if (a.ndim != b.ndim || a.data_type != b.data_type ||
+            lhs[i]->get_device_type() != rhs[i]->get_device_type()) {
+            return false;
+        }
+        for (size_t j = 1; j < a.ndim; ++j) {
+            if (a.shapes[j] != b.shapes[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//! get the slice [begin, end) on dim 0, which shares memory with tensor
+std::shared_ptr<Tensor> slice_batch(Tensor& tensor, size_t begin, size_t end) {
+    return tensor.slice({begin}, {end});
+}
+}  // namespace
+
+struct BatchedNetwork::Impl {
+    struct Request {
+        std::vector<std::shared_ptr<Tensor>> inputs;
+        size_t batch;
+        std::promise<Outputs> promise;
+    };
+
+    std::shared_ptr<Network> network;
+    BatchingConfig config;
+    std::vector<std::string> input_names, output_names;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<Request> queue;
+    bool stopped = false;
+    Stats stats;
+    std::thread worker;
+
+    void run();
+
+    //! take the requests of the next batch from the queue, with mtx locked
+    std::vector<Request> take_batch();
+
+    void forward_batch(std::vector<Request>& batch);
+};
+
+BatchedNetwork::BatchedNetwork(
+        std::shared_ptr<Network> network, const BatchingConfig& config) {
+    LITE_ERROR_HANDLER_BEGIN
+    LITE_CHECK_NON_NULL_POINTER(network);
+    LITE_ASSERT(config.max_batch_size > 0, "max_batch_size must be positive");
+    m_impl = std::make_unique<Impl>();
+    m_impl->network = std::move(network);
+    m_impl->config = config;
+    m_impl->input_names = m_impl->network->get_all_input_name();
+    m_impl->output_names = m_impl->network->get_all_output_name();
+    auto impl = m_impl.get();
+    m_impl->worker = std::thread([impl]() { impl->run(); });
+    LITE_ERROR_HANDLER_END
+}
+
+BatchedNetwork::~BatchedNetwork() {
+    {
+        std::lock_guard<std::mutex> lock(m_impl->mtx);
+        m_impl->stopped = true;
+    }
+    m_impl->cv.notify_all();
+    m_impl->worker.join();
+}
+
+std::future<BatchedNetwork::Outputs> BatchedNetwork::submit(
+        std::vector<std::shared_ptr<Tensor>> inputs) {
+    LITE_ERROR_HANDLER_BEGIN
+    LITE_ASSERT(
+            inputs.size() == m_impl->input_names.size(),
+            "the network has %zu inputs, but %zu inputs are given",
+            m_impl->input_names.size(), inputs.size());
+    size_t batch = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        LITE_CHECK_NON_NULL_POINTER(inputs[i]);
+        auto&& layout = inputs[i]->get_layout();
+        LITE_ASSERT(
+                layout.ndim > 0 && layout.shapes[0] > 0,
+                "input %s has no batch dim", m_impl->input_names[i].c_str());
+        LITE_ASSERT(
+                !i || layout.shapes[0] == batch,
+                "inputs of a request must have the same batch size");
+        batch = layout.shapes[0];
+    }
+    Impl::Request request{std::move(inputs), batch, {}};
+    auto future = request.promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_impl->mtx);
+        m_impl->queue.push_back(std::move(request));
+    }
+    m_impl->cv.notify_all();
+    return future;
+    LITE_ERROR_HANDLER_END
+}
+
+BatchedNetwork::Stats BatchedNetwork::get_stats() const {
+    std::lock_guard<std::mutex> lock(m_impl->mtx);
+    return m_impl->stats;
+}
+
+void BatchedNetwork::Impl::run() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        cv.wait(lock, [this]() { return stopped || !queue.empty(); });
+        if (queue.empty()) {
+            return;
+        }
+        // wait for more requests until the batch is full or the deadline
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::microseconds(config.max_wait_us);
+        auto is_full = [this]() {
+            size_t batch = 0;
+            for (auto&& request : queue) {
+                if (is_batchable(request.inputs, queue.front().inputs)) {
+                    batch += request.batch;
+                }
+            }
+            return batch >= config.max_batch_size;
+        };
+        while (!stopped && !is_full() &&
+               cv.wait_until(lock, deadline) != std::cv_status::timeout) {
+        }
+        auto batch = take_batch();
+        lock.unlock();
+#if LITE_ENABLE_EXCEPTION
+        try {
+            forward_batch(batch);
+        } catch (...) {
+            for (auto&& request : batch) {
+                request.promise.set_exception(std::current_exception());
+            }
+        }
+#else
+        forward_batch(batch);
+#endif
+        lock.lock();
+    }
+}
+
+std::vector<BatchedNetwork::Impl::Request> BatchedNetwork::Impl::take_batch() {
+    std::vector<Request> batch;
+    size_t nr_samples = 0;
+    for (auto iter = queue.begin(); iter != queue.end();) {
+        // a request larger than max_batch_size runs alone
+        bool fit = batch.empty() ||
+                   (nr_samples + iter->batch <= config.max_batch_size &&
+                    is_batchable(iter->inputs, batch[0].inputs));
+        if (fit) {
+            nr_samples += iter->batch;
+            batch.push_back(std::move(*iter));
+            iter = queue.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+    return batch;
+}
+
+void BatchedNetwork::Impl::forward_batch(std::vector<Request>& batch) {
+    size_t nr_samples = 0;
+    for (auto&& request : batch) {
+        nr_samples += request.batch;
+    }
+    size_t nr_padded = nr_samples;
+    if (config.pad_to_max_batch) {
+        nr_padded = std::max(nr_samples, config.max_batch_size);
+    }
+    for (size_t i = 0; i < input_names.size(); ++i) {
+        auto input = network->get_io_tensor(input_names[i]);
+        auto layout = batch[0].inputs[i]->get_layout();
+        layout.shapes[0] = nr_padded;
+        input->set_layout(layout);
+        if (batch.size() == 1 && nr_padded == nr_samples) {
+            input->copy_from(*batch[0].inputs[i]);
+            continue;
+        }
+        size_t offset = 0;
+        for (auto&& request : batch) {
+            slice_batch(*input, offset, offset + request.batch)
+                    ->copy_from(*request.inputs[i]);
+            offset += request.batch;
+        }
+        if (offset < nr_padded) {
+            slice_batch(*input, offset, nr_padded)->fill_zero();
+        }
+    }
+    network->forward();
+    network->wait();
+
+    std::vector<Outputs> outputs(batch.size());
+    for (auto&& name : output_names) {
+        auto output = network->get_io_tensor(name);
+        // the memory of network outputs is reused by the next forward
+        auto copy = std::make_shared<Tensor>(
+                output->get_device_id(), output->get_device_type());
+        copy->copy_from(*output);
+        auto&& layout = copy->get_layout();
+        bool whole = layout.ndim == 0 || layout.shapes[0] != nr_padded ||
+                     (batch.size() == 1 && nr_padded == nr_samples);
+        size_t offset = 0;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (whole) {
+                outputs[i].push_back(copy);
+            } else {
+                outputs[i].push_back(
+                        slice_batch(*copy, offset, offset + batch[i].batch));
+            }
+            offset += batch[i].batch;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stats.nr_requests += batch.size();
+        stats.nr_batches++;
+        stats.nr_samples += nr_samples;
+        stats.nr_padded_samples += nr_padded - nr_samples;
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+        batch[i].promise.set_value(std::move(outputs[i]));
+    }
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
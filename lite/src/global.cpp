@@ -15,6 +15,7 @@
 #include "megbrain/serialization/extern_c_opr.h"
 #include "megbrain/version.h"
 #include "megbrain/utils/infile_persistent_cache.h"
+#include "megbrain/utils/mmap_persistent_cache.h"
 #include "mge/common.h"
 #if MGB_ENABLE_TENSOR_RT
 #include "megbrain/tensorrt/tensorrt_engine_cache.h"
@@ -164,8 +165,25 @@ void lite::set_persistent_cache(const std::string& cache_path, bool always_sync)
             cache_path.c_str(), always_sync));
 }
 
+void lite::set_shared_persistent_cache(const std::string& cache_path) {
+    LITE_LOCK_GUARD(cache_control.cache_mutex);
+    cache_control.cache_type = "shared_file";
+    if (cache_control.config_algo_times >= 1) {
+        LITE_WARN(
+                "The cache has been set，maybe some model is using now, change "
+                "it now may cause unknow error!!");
+    }
+    cache_control.config_algo_times++;
+    mgb::PersistentCache::set_impl(
+            std::make_shared<mgb::MmapPersistentCache>(cache_path.c_str()));
+}
+
 void lite::dump_persistent_cache(const std::string& cache_path) {
     LITE_LOCK_GUARD(cache_control.cache_mutex);
+    if (cache_control.cache_type == "shared_file") {
+        //! records are written to the shared file when they are put
+        return;
+    }
     LITE_ASSERT(
             cache_control.cache_type == "file",
             "now cache type not correct, it can't be dumped.");
@@ -241,6 +259,10 @@ void lite::set_persistent_cache(const std::string&, bool) {
     LITE_THROW("mge is disbale at build time, please build with mge");
 }
 
+void lite::set_shared_persistent_cache(const std::string&) {
+    LITE_THROW("mge is disbale at build time, please build with mge");
+}
+
 void lite::dump_persistent_cache(const std::string&) {
     LITE_THROW("mge is disbale at build time, please build with mge");
 }
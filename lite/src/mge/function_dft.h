@@ -179,6 +179,8 @@ inline void call_func<NetworkImplDft, void>(
         return CALL_FUNC(enable_io_bin_dump, file_name);
     } else if (func_name == "dump_layout_transform_model") {
         return CALL_FUNC(dump_layout_transform_model, file_name);
+    } else if (func_name == "share_runtime_memory_with_arena") {
+        return CALL_FUNC(share_runtime_memory_with_arena, file_name);
     }
     THROW_FUNC_ERROR(func_name);
 }
@@ -142,6 +142,11 @@ void NetworkImplDft::share_runtime_memory_with(Network::NetworkImplBase* network
             network_impl->cast_final_safe<NetworkImplDft>().m_load_config.comp_graph));
 }
 
+void NetworkImplDft::share_runtime_memory_with_arena(const std::string& arena_name) {
+    LITE_ASSERT(m_load_config.comp_graph);
+    m_load_config.comp_graph->share_device_memory_with_arena(arena_name);
+}
+
 void NetworkImplDft::set_cpu_inplace_mode() {
     LITE_ASSERT(
             m_user_config->device_type == LiteDeviceType::LITE_CPU,
@@ -796,6 +801,10 @@ void NetworkImplDft::set_network_algo_policy(
     if (static_cast<uint32_t>(strategy) & LiteAlgoSelectStrategy::LITE_ALGO_OPTIMIZED) {
         dst_strategy = dst_strategy | S::OPTIMIZED;
     }
+    if (static_cast<uint32_t>(strategy) &
+        LiteAlgoSelectStrategy::LITE_ALGO_COST_MODEL) {
+        dst_strategy = dst_strategy | S::COST_MODEL;
+    }
     if (static_cast<uint32_t>(dst_strategy) != 0)
         m_execution_policy = dst_strategy;
 
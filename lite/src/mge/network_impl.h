@@ -131,6 +131,9 @@ public:
 
     //! share the runtime memory with other network, the weights is not shared
     void share_runtime_memory_with(NetworkImplBase* network);
+
+    //! share the runtime memory with all networks using the named arena
+    void share_runtime_memory_with_arena(const std::string& arena_name);
     //! set threads affinity callback;
     void set_runtime_thread_affinity(
             const ThreadAffinityCallback& thread_affinity_callback);
@@ -447,6 +447,23 @@ void Runtime::share_runtime_memory_with(
     LITE_ERROR_HANDLER_END
 }
 
+void Runtime::share_runtime_memory_with_arena(
+        std::shared_ptr<Network> dst_network, std::string arena_name) {
+    LITE_ERROR_HANDLER_BEGIN
+    auto network_impl_dst = NetworkHelper::implement(dst_network);
+    if (network_impl_dst->get_backend_type() == LiteBackend::LITE_DEFAULT) {
+        LITE_ASSERT(
+                !NetworkHelper::loaded(dst_network),
+                "share_runtime_memory_with_arena should be used before model "
+                "loaded.");
+        call_func<NetworkImplDft, void>(
+                "share_runtime_memory_with_arena", network_impl_dst, arena_name);
+        return;
+    }
+    LITE_THROW("share_runtime_memory_with_arena is not aviliable in the backend.");
+    LITE_ERROR_HANDLER_END
+}
+
 void Runtime::enable_io_txt_dump(
         std::shared_ptr<Network> network, std::string io_txt_out_file) {
     LITE_ERROR_HANDLER_BEGIN
@@ -175,6 +175,14 @@ public:
         LITE_ASSERT(network);
         network->m_impl = std::move(impl);
     }
+    static const Config& config(const std::shared_ptr<Network> network) {
+        LITE_ASSERT(network);
+        return network->m_config;
+    }
+    static const NetworkIO& network_io(const std::shared_ptr<Network> network) {
+        LITE_ASSERT(network);
+        return network->m_network_io;
+    }
 };
 
 }  // namespace lite
@@ -0,0 +1,176 @@
+#include "lite/pipeline.h"
+#include "misc.h"
+#include "network_impl_base.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+using namespace lite;
+
+struct NetworkPipeline::Impl {
+    struct Task {
+        std::shared_ptr<Network> network;
+        Callback callback;
+    };
+
+    std::vector<std::shared_ptr<Network>> networks;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<std::shared_ptr<Network>> idle;
+    //! submitted forwards in the order of submission
+    std::deque<Task> tasks;
+    //! submitted forwards whose callbacks have not returned
+    size_t nr_pending = 0;
+    bool stopped = false;
+    std::exception_ptr error;
+    std::thread worker;
+
+    void run();
+
+    void finish(Task& task);
+};
+
+NetworkPipeline::NetworkPipeline(std::shared_ptr<Network> network, size_t depth) {
+    LITE_ERROR_HANDLER_BEGIN
+    LITE_CHECK_NON_NULL_POINTER(network);
+    LITE_ASSERT(depth > 0, "depth of the pipeline must be positive");
+    LITE_ASSERT(
+            NetworkHelper::loaded(network),
+            "the network of a pipeline should be loaded.");
+    m_impl = std::make_unique<Impl>();
+    auto&& config = NetworkHelper::config(network);
+    auto&& network_io = NetworkHelper::network_io(network);
+    m_impl->networks.push_back(network);
+    for (size_t i = 1; i < depth; ++i) {
+        // each replica runs on its own stream, with its own IO tensors and
+        // memory of the intermediate vars, and shares the weights
+        auto replica = std::make_shared<Network>(config, network_io);
+        replica->set_device_id(network->get_device_id());
+        replica->set_stream_id(network->get_stream_id() + i);
+        if (config.device_type == LiteDeviceType::LITE_CPU) {
+            Runtime::set_cpu_threads_number(
+                    replica, Runtime::get_cpu_threads_number(network));
+            if (Runtime::is_cpu_inplace_mode(network)) {
+                Runtime::set_cpu_inplace_mode(replica);
+            }
+        }
+        Runtime::shared_weight_with_network(replica, network);
+        m_impl->networks.push_back(std::move(replica));
+    }
+    m_impl->idle.assign(m_impl->networks.begin(), m_impl->networks.end());
+    auto impl = m_impl.get();
+    m_impl->worker = std::thread([impl]() { impl->run(); });
+    LITE_ERROR_HANDLER_END
+}
+
+NetworkPipeline::~NetworkPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(m_impl->mtx);
+        m_impl->stopped = true;
+    }
+    m_impl->cv.notify_all();
+    m_impl->worker.join();
+}
+
+size_t NetworkPipeline::depth() const {
+    return m_impl->networks.size();
+}
+
+std::shared_ptr<Network> NetworkPipeline::acquire() {
+    std::unique_lock<std::mutex> lock(m_impl->mtx);
+    m_impl->cv.wait(lock, [this]() { return !m_impl->idle.empty(); });
+    auto network = std::move(m_impl->idle.front());
+    m_impl->idle.pop_front();
+    return network;
+}
+
+void NetworkPipeline::submit(std::shared_ptr<Network> network, Callback callback) {
+    LITE_ERROR_HANDLER_BEGIN
+    LITE_ASSERT(
+            std::find(m_impl->networks.begin(), m_impl->networks.end(), network) !=
+                    m_impl->networks.end(),
+            "the network is not acquired from the pipeline");
+    std::lock_guard<std::mutex> lock(m_impl->mtx);
+    auto in_flight = std::any_of(
+            m_impl->tasks.begin(), m_impl->tasks.end(),
+            [&](const Impl::Task& task) { return task.network == network; });
+    LITE_ASSERT(
+            !in_flight && std::find(m_impl->idle.begin(), m_impl->idle.end(),
+                                    network) == m_impl->idle.end(),
+            "the network should be acquired before submitted");
+    // forward is asynchronous except in cpu inplace mode, where the forwards
+    // are serialized in the order of submission
+#if LITE_ENABLE_EXCEPTION
+    try {
+        network->forward();
+    } catch (...) {
+        // the network is given back, or acquire() would wait for it forever
+        m_impl->idle.push_back(std::move(network));
+        m_impl->cv.notify_all();
+        throw;
+    }
+#else
+    network->forward();
+#endif
+    m_impl->tasks.push_back({std::move(network), std::move(callback)});
+    m_impl->nr_pending++;
+    m_impl->cv.notify_all();
+    LITE_ERROR_HANDLER_END
+}
+
+void NetworkPipeline::wait() {
+    LITE_ERROR_HANDLER_BEGIN
+    std::unique_lock<std::mutex> lock(m_impl->mtx);
+    m_impl->cv.wait(lock, [this]() { return !m_impl->nr_pending; });
+    if (m_impl->error) {
+        auto error = m_impl->error;
+        m_impl->error = nullptr;
+        std::rethrow_exception(error);
+    }
+    LITE_ERROR_HANDLER_END
+}
+
+void NetworkPipeline::Impl::run() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        cv.wait(lock, [this]() { return stopped || !tasks.empty(); });
+        if (tasks.empty()) {
+            return;
+        }
+        // the task stays in tasks until it is finished, so a network is never
+        // both idle and in flight
+        auto task = tasks.front();
+        lock.unlock();
+#if LITE_ENABLE_EXCEPTION
+        std::exception_ptr task_error;
+        try {
+            finish(task);
+        } catch (...) {
+            task_error = std::current_exception();
+        }
+        lock.lock();
+        if (task_error && !error) {
+            error = task_error;
+        }
+#else
+        finish(task);
+        lock.lock();
+#endif
+        tasks.pop_front();
+        idle.push_back(std::move(task.network));
+        nr_pending--;
+        cv.notify_all();
+    }
+}
+
+void NetworkPipeline::Impl::finish(Task& task) {
+    task.network->wait();
+    if (task.callback) {
+        task.callback(*task.network);
+    }
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,82 @@
+#include "lite_build_config.h"
+
+#if LITE_BUILD_WITH_MGE
+#include "./test_common.h"
+#include "lite/batching.h"
+
+#include <thread>
+
+using namespace lite;
+
+TEST(TestBatchedNetwork, ConcurrentRequests) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    auto result_lite = mgelite_lar(model_path, config, "data", lite_tensor);
+
+    auto network = std::make_shared<Network>(config);
+    network->load_model(model_path);
+    BatchingConfig batching;
+    batching.max_batch_size = 4;
+    batching.max_wait_us = 10000;
+    BatchedNetwork batched{network, batching};
+
+    // a request with two samples shares the batch with others
+    auto double_input = TensorUtils::concat({*lite_tensor, *lite_tensor}, 0);
+    constexpr size_t NR_THREAD = 6;
+    std::vector<BatchedNetwork::Outputs> results(NR_THREAD);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < NR_THREAD; ++i) {
+        threads.emplace_back([&, i]() {
+            results[i] = batched.forward({i % 3 ? lite_tensor : double_input});
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    for (size_t i = 0; i < NR_THREAD; ++i) {
+        ASSERT_EQ(1u, results[i].size());
+        auto output = results[i][0];
+        size_t batch = i % 3 ? 1 : 2;
+        ASSERT_EQ(batch, output->get_layout().shapes[0]);
+        for (size_t j = 0; j < batch; ++j) {
+            auto sample = std::make_shared<Tensor>(LiteDeviceType::LITE_CPU);
+            sample->copy_from(*output->slice({j}, {j + 1}));
+            compare_lite_tensor<float>(sample, result_lite);
+        }
+    }
+    auto stats = batched.get_stats();
+    ASSERT_EQ(NR_THREAD, stats.nr_requests);
+    ASSERT_EQ(8u, stats.nr_samples);
+    ASSERT_GE(stats.nr_batches, 2u);
+    ASSERT_EQ(0u, stats.nr_padded_samples);
+}
+
+TEST(TestBatchedNetwork, PadToMaxBatch) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    auto result_lite = mgelite_lar(model_path, config, "data", lite_tensor);
+
+    auto network = std::make_shared<Network>(config);
+    network->load_model(model_path);
+    BatchingConfig batching;
+    batching.max_batch_size = 4;
+    batching.max_wait_us = 0;
+    batching.pad_to_max_batch = true;
+    BatchedNetwork batched{network, batching};
+    for (size_t i = 0; i < 3; ++i) {
+        auto outputs = batched.submit({lite_tensor}).get();
+        ASSERT_EQ(1u, outputs[0]->get_layout().shapes[0]);
+        ASSERT_EQ(4u, network->get_input_tensor(0)->get_layout().shapes[0]);
+        auto output = std::make_shared<Tensor>(LiteDeviceType::LITE_CPU);
+        output->copy_from(*outputs[0]);
+        compare_lite_tensor<float>(output, result_lite);
+    }
+    auto stats = batched.get_stats();
+    ASSERT_EQ(3u, stats.nr_batches);
+    ASSERT_EQ(9u, stats.nr_padded_samples);
+}
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -316,6 +316,28 @@ TEST(TestNetWork, SharedRuntimeMem) {
     network_dst->load_model(model_path);
 }
 
+TEST(TestNetWork, SharedRuntimeMemArena) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+
+    auto result_mgb = mgb_lar(model_path, config, "data", lite_tensor);
+
+    std::shared_ptr<Network> networks[3];
+    for (auto&& network : networks) {
+        network = std::make_shared<Network>(config);
+        Runtime::share_runtime_memory_with_arena(network, "test_arena");
+        network->load_model(model_path);
+    }
+    for (auto&& network : networks) {
+        auto input_tensor = network->get_input_tensor(0);
+        input_tensor->reset(lite_tensor->get_memory_ptr(), lite_tensor->get_layout());
+        network->forward();
+        network->wait();
+        compare_lite_tensor<float>(network->get_output_tensor(0), result_mgb);
+    }
+}
+
 TEST(TestNetWork, UserAllocator) {
     auto allocator = std::make_shared<CheckAllocator>();
     {
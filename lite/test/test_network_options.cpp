@@ -7,10 +7,12 @@
 #include "lite/global.h"
 
 #include "megbrain/tensor.h"
+#include "megbrain/utils/mmap_persistent_cache.h"
 #include "test_common.h"
 
 #include <string.h>
 #include <chrono>
+#include <cstdio>
 #include <memory>
 #include <random>
 
@@ -212,6 +214,67 @@ TEST(TestNetWorkOptions, FastRunIgnorBatch) {
     ASSERT_TRUE(fopen("./algo_cache.txt", "r"));
 }
 
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+TEST(TestNetWorkOptions, SharedPersistentCache) {
+    Config config;
+    auto tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    std::string input_name = "data";
+    std::string cache_path = "./algo_cache_shared.bin";
+    auto result_mgb = mgb_lar(model_path, config, input_name, tensor);
+
+    auto run = [&]() {
+        std::shared_ptr<Network> network = std::make_shared<Network>(config);
+        network->load_model(model_path);
+        Runtime::set_network_algo_policy(
+                network, LiteAlgoSelectStrategy::LITE_ALGO_PROFILE |
+                                 LiteAlgoSelectStrategy::LITE_ALGO_REPRODUCIBLE);
+        std::shared_ptr<Tensor> input_tensor = network->get_io_tensor(input_name);
+        input_tensor->reset(tensor->get_memory_ptr(), tensor->get_layout());
+        std::shared_ptr<Tensor> output_tensor = network->get_output_tensor(0);
+        auto result_tensor = std::make_shared<Tensor>(
+                LiteDeviceType::LITE_CPU,
+                Layout{{1, 1000}, 2, LiteDataType::LITE_FLOAT});
+        output_tensor->reset(
+                result_tensor->get_memory_ptr(), result_tensor->get_layout());
+        network->forward();
+        network->wait();
+        compare_lite_tensor<float>(output_tensor, result_mgb);
+    };
+
+    auto stat = []() {
+        auto cache =
+                dynamic_cast<mgb::MmapPersistentCache*>(&mgb::PersistentCache::inst());
+        mgb_assert(cache);
+        return cache->stat();
+    };
+
+    //! restore the global cache replaced below when the test exits
+    struct CacheGuard {
+        std::shared_ptr<mgb::PersistentCache> prev;
+        ~CacheGuard() { mgb::PersistentCache::set_impl(prev); }
+    } guard{mgb::PersistentCache::set_impl(
+            std::make_shared<mgb::InMemoryPersistentCache>())};
+
+    std::remove(cache_path.c_str());
+    set_shared_persistent_cache(cache_path);
+    run();
+    //! the profiled algos are written to the file when they are put, and
+    //! dumping is a no-op
+    dump_persistent_cache(cache_path);
+    auto stat0 = stat();
+    ASSERT_GT(stat0.nr_record, 0u);
+    ASSERT_GT(stat0.file_size, 0u);
+
+    //! a new instance on the same file reuses the records
+    set_shared_persistent_cache(cache_path);
+    run();
+    auto stat1 = stat();
+    ASSERT_EQ(stat0.nr_record, stat1.nr_record);
+    ASSERT_EQ(stat0.file_size, stat1.file_size);
+}
+#endif
+
 #if LITE_WITH_CUDA
 TEST(TestNetWorkOptions, NCHW4) {
     Config config;
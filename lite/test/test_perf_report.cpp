@@ -0,0 +1,76 @@
+#include "lite_build_config.h"
+
+#if LITE_BUILD_WITH_MGE
+#include "helpers/perf_report.h"
+#include "megbrain/opr/basic_arith_wrapper.h"
+#include "megbrain/opr/blas.h"
+#include "megbrain/opr/dnn/convolution.h"
+#include "megbrain/opr/io.h"
+#include "megbrain/plugin/perf_counter.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+
+#if MGB_ENABLE_JSON
+using namespace mgb;
+using namespace lar;
+
+namespace {
+std::shared_ptr<HostTensorND> make_host(CompNode cn, const TensorShape& shape) {
+    auto ret = std::make_shared<HostTensorND>(cn, shape, dtype::Float32());
+    auto ptr = ret->ptr<float>();
+    for (size_t i = 0, it = shape.total_nr_elems(); i < it; ++i) {
+        ptr[i] = (i % 13) * 0.1f - 0.6f;
+    }
+    return ret;
+}
+
+size_t nr_lines(const std::string& str) {
+    return std::count(str.begin(), str.end(), '\n');
+}
+}  // namespace
+
+TEST(TestPerfReport, ToyModel) {
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    auto x = opr::Host2DeviceCopy::make(*graph, make_host(cn, {1, 8, 16, 16})),
+         w = opr::Host2DeviceCopy::make(*graph, make_host(cn, {16, 8, 3, 3})),
+         a = opr::Host2DeviceCopy::make(*graph, make_host(cn, {64, 64}));
+    opr::Convolution::Param param;
+    param.pad_h = param.pad_w = 1;
+    auto conv = opr::Convolution::make(x, w, param);
+    auto matmul = opr::MatrixMul::make(a, a);
+    auto func = graph->compile(
+            {{opr::relu(conv), {}}, {matmul.reshape({4096}) + 1.f, {}}});
+
+    GraphProfiler profiler{graph.get()};
+    std::unique_ptr<PerfCounterProfiler> counters;
+#if MGB_ENABLE_PERF_COUNTER
+    counters = std::make_unique<PerfCounterProfiler>(graph.get());
+#endif
+    for (int i = 0; i < 3; ++i) {
+        func->execute().wait();
+    }
+
+    Roofline roofline;
+    roofline.gflops = 100;
+    roofline.gbps = 10;
+    auto report = make_perf_report(func.get(), profiler, counters.get(), roofline, 20);
+    ASSERT_NE(std::string::npos, report.find("ConvolutionForward")) << report;
+    ASSERT_NE(std::string::npos, report.find("MatrixMul")) << report;
+    ASSERT_NE(std::string::npos, report.find("compute")) << report;
+    ASSERT_NE(std::string::npos, report.find("memory")) << report;
+#if MGB_ENABLE_PERF_COUNTER
+    ASSERT_NE(std::string::npos, report.find("IPC")) << report;
+#endif
+
+    //! only the top operators are listed
+    auto top1 = make_perf_report(func.get(), profiler, counters.get(), roofline, 1);
+    ASSERT_LT(nr_lines(top1) + 2, nr_lines(report));
+
+    auto calibrated = calibrate_roofline(cn);
+    ASSERT_GT(calibrated.gflops, 0);
+    ASSERT_GT(calibrated.gbps, 0);
+}
+#endif
+#endif
@@ -0,0 +1,106 @@
+#include "lite_build_config.h"
+
+#if LITE_BUILD_WITH_MGE
+#include "./test_common.h"
+#include "lite/pipeline.h"
+
+#include <algorithm>
+
+using namespace lite;
+
+TEST(TestNetworkPipeline, InFlightForwards) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    auto result_lite = mgelite_lar(model_path, config, "data", lite_tensor);
+
+    auto network = std::make_shared<Network>(config);
+    network->load_model(model_path);
+    NetworkPipeline pipeline{network, 3};
+    ASSERT_EQ(3u, pipeline.depth());
+
+    constexpr size_t NR_FORWARD = 8;
+    std::vector<size_t> finished;
+    std::vector<Network*> used;
+    for (size_t i = 0; i < NR_FORWARD; ++i) {
+        auto net = pipeline.acquire();
+        if (std::find(used.begin(), used.end(), net.get()) == used.end()) {
+            used.push_back(net.get());
+        }
+        net->get_input_tensor(0)->copy_from(*lite_tensor);
+        pipeline.submit(net, [&, i](Network& net) {
+            finished.push_back(i);
+            auto output = std::make_shared<Tensor>(LiteDeviceType::LITE_CPU);
+            output->copy_from(*net.get_output_tensor(0));
+            compare_lite_tensor<float>(output, result_lite);
+        });
+    }
+    pipeline.wait();
+    ASSERT_EQ(3u, used.size());
+    ASSERT_EQ(NR_FORWARD, finished.size());
+    for (size_t i = 0; i < NR_FORWARD; ++i) {
+        ASSERT_EQ(i, finished[i]);
+    }
+}
+
+TEST(TestNetworkPipeline, CpuInplace) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    auto result_lite = mgelite_lar(model_path, config, "data", lite_tensor);
+
+    auto network = std::make_shared<Network>(config);
+    Runtime::set_cpu_inplace_mode(network);
+    network->load_model(model_path);
+    NetworkPipeline pipeline{network, 2};
+    size_t nr_finished = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        auto net = pipeline.acquire();
+        net->get_input_tensor(0)->copy_from(*lite_tensor);
+        pipeline.submit(net, [&](Network& net) {
+            nr_finished++;
+            compare_lite_tensor<float>(net.get_output_tensor(0), result_lite);
+        });
+    }
+    pipeline.wait();
+    ASSERT_EQ(4u, nr_finished);
+}
+
+#if LITE_ENABLE_EXCEPTION
+TEST(TestNetworkPipeline, ForwardError) {
+    Config config;
+    auto lite_tensor = get_input_data("./input_data.npy");
+    std::string model_path = "./shufflenet.mge";
+    auto result_lite = mgelite_lar(model_path, config, "data", lite_tensor);
+
+    auto network = std::make_shared<Network>(config);
+    network->load_model(model_path);
+    bool fail = true;
+    network->set_start_callback(
+            [&](const std::unordered_map<
+                    std::string, std::pair<IO, std::shared_ptr<Tensor>>>&) {
+                if (fail) {
+                    fail = false;
+                    LITE_THROW("forward failed");
+                }
+            });
+    NetworkPipeline pipeline{network, 1};
+    auto net = pipeline.acquire();
+    net->get_input_tensor(0)->copy_from(*lite_tensor);
+    ASSERT_THROW(pipeline.submit(net), std::exception);
+
+    //! the failed network is idle again and can be reused
+    net = pipeline.acquire();
+    ASSERT_EQ(network, net);
+    size_t nr_finished = 0;
+    pipeline.submit(net, [&](Network& net) {
+        nr_finished++;
+        compare_lite_tensor<float>(net.get_output_tensor(0), result_lite);
+    });
+    pipeline.wait();
+    ASSERT_EQ(1u, nr_finished);
+}
+#endif
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
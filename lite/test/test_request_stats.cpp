@@ -0,0 +1,56 @@
+#include "helpers/request_stats.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+using namespace lar;
+
+TEST(TestRequestStats, PoissonArrival) {
+    using Clock = PoissonArrival::Clock;
+    constexpr size_t NR = 20000;
+    constexpr double QPS = 1000;
+    auto start = Clock::now();
+    auto run = [&](uint32_t seed) {
+        PoissonArrival gen{QPS, start, seed};
+        std::vector<Clock::time_point> ret;
+        for (size_t i = 0; i < NR; ++i) {
+            ret.push_back(gen.next());
+        }
+        return ret;
+    };
+    auto arrivals = run(0);
+    ASSERT_GE(arrivals.front(), start);
+    ASSERT_TRUE(std::is_sorted(arrivals.begin(), arrivals.end()));
+
+    //! the intervals are exponential with mean 1 / qps, whose standard
+    //! deviation is also 1 / qps
+    auto secs = std::chrono::duration<double>(arrivals.back() - start).count();
+    ASSERT_NEAR(secs / NR, 1 / QPS, 5 / QPS / std::sqrt(NR));
+
+    ASSERT_EQ(arrivals, run(0));
+    ASSERT_NE(arrivals, run(1));
+}
+
+TEST(TestRequestStats, LatencyStats) {
+    std::vector<double> latencies(100);
+    std::iota(latencies.begin(), latencies.end(), 1.0);
+    std::shuffle(latencies.begin(), latencies.end(), std::mt19937{0});
+    LatencyStats stats{latencies};
+    ASSERT_EQ(100u, stats.count());
+    ASSERT_DOUBLE_EQ(50.5, stats.avg());
+    ASSERT_DOUBLE_EQ(100, stats.max());
+    ASSERT_DOUBLE_EQ(1, stats.percentile(0));
+    ASSERT_DOUBLE_EQ(51, stats.percentile(0.5));
+    ASSERT_DOUBLE_EQ(100, stats.percentile(0.99));
+    ASSERT_DOUBLE_EQ(100, stats.percentile(1));
+
+    LatencyStats empty{{}};
+    ASSERT_EQ(0u, empty.count());
+    ASSERT_EQ(0, empty.avg());
+    ASSERT_EQ(0, empty.max());
+    ASSERT_EQ(0, empty.percentile(0.5));
+}
@@ -808,6 +808,14 @@ void ComputingGraphImpl::share_device_memory_with(ComputingGraph& other) {
             oimpl.var_node_mem_manager().static_device_memory_manager());
 }
 
+void ComputingGraphImpl::share_device_memory_with_arena(const std::string& name) {
+    mgb_assert(
+            !m_current_comp_seq,
+            "share_device_memory_with_arena must be called before compiling graph");
+    var_node_mem_manager().static_device_memory_manager(
+            StaticDeviceMemoryManager::get_arena(name));
+}
+
 void ComputingGraphImpl::set_device_memory_allocator(
         std::shared_ptr<DeviceMemoryAllocator> allocator) {
     var_node_mem_manager().static_device_memory_manager()->set_allocator(
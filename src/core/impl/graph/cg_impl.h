@@ -215,6 +215,7 @@ public:
     SeqModifierForDTR& seq_modifier_for_dtr();
 #endif
     void share_device_memory_with(ComputingGraph& other) override;
+    void share_device_memory_with_arena(const std::string& name) override;
 
     void set_device_memory_allocator(
             std::shared_ptr<DeviceMemoryAllocator> allocator) override;
@@ -36,7 +36,11 @@ StaticDeviceMemoryManager::StaticDeviceMemoryManager()
 
 void StaticDeviceMemoryManager::exec_enter() {
     auto flag = m_in_exec.test_and_set();
-    mgb_assert(!flag, "double-lock on StaticDeviceMemoryManager");
+    mgb_assert(
+            !flag,
+            "double-lock on StaticDeviceMemoryManager%s%s: graphs sharing static "
+            "device memory must not be executed concurrently",
+            m_arena_name.empty() ? "" : " of arena ", m_arena_name.c_str());
 }
 
 void StaticDeviceMemoryManager::exec_exit() {
@@ -49,6 +53,7 @@ const DeviceTensorStorage& StaticDeviceMemoryManager::alloc(
     if (cur_version != m_version) {
         m_storage.clear();
         m_version = cur_version;
+        ++m_storage_gen;
     }
     auto&& storage = m_storage[cn];
     if (size > storage.size()) {
@@ -56,6 +61,7 @@ const DeviceTensorStorage& StaticDeviceMemoryManager::alloc(
             storage.comp_node(cn);
         }
         m_allocator->alloc_static(graph, storage, size);
+        ++m_storage_gen;
         auto ptr = storage.ptr();
         MGB_MARK_USED_VAR(ptr);
         mgb_assert(storage.size() >= size);
@@ -85,6 +91,7 @@ size_t StaticDeviceMemoryManager::clear_all() {
         update_max(ret, i.second.use_count());
     }
     m_storage.clear();
+    ++m_storage_gen;
     return ret;
 }
 
@@ -92,6 +99,22 @@ std::shared_ptr<StaticDeviceMemoryManager> StaticDeviceMemoryManager::
         make_default_impl() {
     return std::make_shared<StaticDeviceMemoryManager>();
 }
+
+std::shared_ptr<StaticDeviceMemoryManager> StaticDeviceMemoryManager::get_arena(
+        const std::string& name) {
+    static std::mutex mtx;
+    static std::unordered_map<std::string, std::weak_ptr<StaticDeviceMemoryManager>>
+            arenas;
+    MGB_LOCK_GUARD(mtx);
+    auto&& ref = arenas[name];
+    auto ret = ref.lock();
+    if (!ret) {
+        ret = std::make_shared<StaticDeviceMemoryManager>();
+        ret->m_arena_name = name;
+        ref = ret;
+    }
+    return ret;
+}
 #else
 size_t StaticDeviceMemoryManager::clear_all() {
     // do not actually clear so memory can be shared and reused by other graphs
@@ -110,6 +133,12 @@ std::shared_ptr<StaticDeviceMemoryManager> StaticDeviceMemoryManager::
 
     return {std::shared_ptr<StaticDeviceMemoryManager>{}, &inst};
 }
+
+std::shared_ptr<StaticDeviceMemoryManager> StaticDeviceMemoryManager::get_arena(
+        const std::string&) {
+    // all graphs already share the global instance
+    return make_default_impl();
+}
 #endif  // MGB_THREAD_SAFE
 
 /* ==================== AsyncVarReleaser ==================== */
@@ -424,7 +453,8 @@ bool VarNodeMemManager::make_static_var_tensor_from_alloc_plan() {
     auto&& cn2usage = m_seq_mem_opt.static_mem_usage();
     auto cur_version = m_static_dev_mem_mgr->version(m_owner_graph);
     mgb_assert(cur_version != DeviceMemoryAllocator::VERSION_INVALID);
-    if (cur_version == m_static_mem_refholder_dev_mem_mgr_version) {
+    if (cur_version == m_static_mem_refholder_dev_mem_mgr_version &&
+        m_static_dev_mem_mgr->storage_gen() == m_static_mem_refholder_storage_gen) {
         return false;
     }
 
@@ -472,6 +502,7 @@ bool VarNodeMemManager::make_static_var_tensor_from_alloc_plan() {
     }
 
     m_static_mem_refholder_dev_mem_mgr_version = cur_version;
+    m_static_mem_refholder_storage_gen = m_static_dev_mem_mgr->storage_gen();
     return true;
 }
 
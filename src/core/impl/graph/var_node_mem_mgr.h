@@ -29,10 +29,19 @@ class ComputingGraphImpl;
  * An instance of StaticDeviceMemoryManager can be shared by multiple
  * AsyncExecutable objects, so they can share device memory.
  *
+ * Process-wide named instances (arenas) can be obtained by get_arena(), so
+ * unrelated graphs that are executed in turn can share one buffer sized to the
+ * max of their static memory usage. Graphs using the same storage always run
+ * the tasks touching it on the same comp node, so they are ordered on device;
+ * concurrent execution on host is detected by exec_enter().
  */
 class StaticDeviceMemoryManager {
     std::atomic_flag m_in_exec = ATOMIC_FLAG_INIT;
     size_t m_version = 0;
+    //! incremented whenever storage on some comp node is replaced
+    size_t m_storage_gen = 0;
+    //! name of the arena, or empty if this is not obtained from get_arena()
+    std::string m_arena_name;
     CompNode::UnorderedMap<DeviceTensorStorage> m_storage;
     std::shared_ptr<DeviceMemoryAllocator> m_allocator;
 
@@ -82,8 +91,28 @@ public:
         return m_allocator->static_alloc_version(graph);
     }
 
+    /*!
+     * \brief generation of the storage, which changes when the storage is
+     *      reallocated for any of the graphs sharing this manager
+     *
+     * Graphs must re-bind their static vars if it changes, so the old storage
+     * can be released.
+     */
+    size_t storage_gen() const { return m_storage_gen; }
+
+    const std::string& arena_name() const { return m_arena_name; }
+
     //! make a default implementation using system allocator
     static std::shared_ptr<StaticDeviceMemoryManager> make_default_impl();
+
+    /*!
+     * \brief get the process-wide arena with given name, creating it if it
+     *      does not exist
+     *
+     * An arena is destructed when no graph uses it.
+     */
+    static std::shared_ptr<StaticDeviceMemoryManager> get_arena(
+            const std::string& name);
 };
 
 /*!
@@ -428,6 +457,7 @@ private:
             StaticDeviceMemoryManager::make_default_impl();
     SmallVector<DeviceTensorStorage> m_static_mem_refholder;
     size_t m_static_mem_refholder_dev_mem_mgr_version = 0;
+    size_t m_static_mem_refholder_storage_gen = 0;
 
     void assert_in_mem_opt_phase(size_t status);
 
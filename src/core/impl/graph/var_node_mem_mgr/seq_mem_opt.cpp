@@ -1,6 +1,5 @@
 #include "./seq_mem_opt.h"
 #include "../cg_impl.h"
-#include "./static_mem_alloc.h"
 
 #include "megbrain/graph/event.h"
 #include "megbrain/graph/exc_extra_info.h"
@@ -13,6 +12,43 @@ using namespace cg;
 
 constexpr double BYTE2MB = 1.0 / 1024.0 / 1024;
 
+//! an incremental plan is accepted if it needs no more memory than the previous
+//! plan, or is within this ratio of the lower bound
+constexpr double INCREMENTAL_MEM_PLAN_TOLERANCE = 0.05;
+
+namespace {
+/*!
+ * \brief get the static memory allocator algorithm, which could be changed by
+ *      the MGB_STATIC_MEM_ALLOC_ALGO env var
+ */
+StaticMemAlloc::AllocatorAlgo get_static_mem_alloc_algo() {
+    using Algo = StaticMemAlloc::AllocatorAlgo;
+    static Algo algo = []() {
+        auto env = MGB_GETENV("MGB_STATIC_MEM_ALLOC_ALGO");
+        if (!env) {
+            return Algo::PUSHDOWN;
+        }
+        std::string name{env};
+        if (name == "INTERVAL_MOVE")
+            return Algo::INTERVAL_MOVE;
+        if (name == "BEST_FIT")
+            return Algo::BEST_FIT;
+        if (name == "PUSHDOWN")
+            return Algo::PUSHDOWN;
+        if (name == "GREEDY_BY_SIZE")
+            return Algo::GREEDY_BY_SIZE;
+        if (name == "BEST_OF")
+            return Algo::BEST_OF;
+        mgb_throw(
+                MegBrainError,
+                "invalid MGB_STATIC_MEM_ALLOC_ALGO: %s; valid values are "
+                "INTERVAL_MOVE, BEST_FIT, PUSHDOWN, GREEDY_BY_SIZE and BEST_OF",
+                env);
+    }();
+    return algo;
+}
+}  // anonymous namespace
+
 class SeqMemOptimizer::StaticMemAllocLogger {
 public:
     virtual ~StaticMemAllocLogger() = default;
@@ -283,12 +319,10 @@ bool SeqMemOptimizer::run_static_mem_alloc() {
     return ret;
 }
 
-bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
-        CompNode comp_node, const std::vector<MemChunkLifeInterval>& chunks,
-        StaticMemAllocLogger& static_mem_alloc_logger) {
-    size_t size_ub = 0;
-
-    auto allocator = StaticMemAlloc::make(StaticMemAlloc::AllocatorAlgo::PUSHDOWN);
+std::unique_ptr<StaticMemAlloc> SeqMemOptimizer::make_static_mem_alloc(
+        CompNode comp_node, StaticMemAlloc::AllocatorAlgo algo,
+        const std::vector<const MemChunkLifeInterval*>& chunks) const {
+    auto allocator = StaticMemAlloc::make(algo);
     allocator->alignment(comp_node.get_mem_addr_alignment());
     allocator->padding(comp_node.get_mem_padding());
 #if MGB_ENABLE_DEBUG_UTIL
@@ -297,11 +331,10 @@ bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
     };
 #endif
     ThinHashMap<MemAllocPlan::Chunk*, size_t> chunk2allocatorid;
-    for (auto&& chk : chunks) {
-        auto id = allocator->add(chk.begin, chk.end, chk.chunk->size(), &chk);
-        auto ins_rst = chunk2allocatorid.emplace(chk.chunk, id);
+    for (auto chk : chunks) {
+        auto id = allocator->add(chk->begin, chk->end, chk->chunk->size(), chk);
+        auto ins_rst = chunk2allocatorid.emplace(chk->chunk, id);
         mgb_assert(ins_rst.second);
-        size_ub += chk.chunk->size();
     }
 
     for (auto&& i : m_writable_fwd_mem_plans) {
@@ -316,13 +349,189 @@ bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
                     i.first->offset_in_chunk_byte());
         }
     }
-    {
-        decltype(chunk2allocatorid) v;
-        chunk2allocatorid.swap(v);
+    return allocator;
+}
+
+std::vector<SeqMemOptimizer::PrevMemPlan::OverwriteSpec> SeqMemOptimizer::
+        get_overwrite_specs(const std::vector<MemChunkLifeInterval>& chunks) const {
+    ThinHashSet<MemAllocPlan::Chunk*> chunk_set;
+    for (auto&& chk : chunks) {
+        chunk_set.insert(chk.chunk);
+    }
+    std::vector<PrevMemPlan::OverwriteSpec> ret;
+    for (auto&& i : m_writable_fwd_mem_plans) {
+        auto from = &i.first->chunk(), to = &i.second->chunk();
+        if (chunk_set.count(from) && chunk_set.count(to)) {
+            ret.emplace_back(
+                    to->owner_var, from->owner_var, i.first->offset_in_chunk_byte());
+        }
     }
+    return ret;
+}
 
+bool SeqMemOptimizer::run_incremental_mem_plan(
+        CompNode comp_node, const std::vector<MemChunkLifeInterval>& chunks,
+        const PrevMemPlan& prev, std::vector<size_t>& offsets, size_t& size,
+        size_t& size_lb) {
+    // chunks overwriting each other are placed as a whole, so a chunk is
+    // considered changed if anyone in its overwrite group is changed
+    std::vector<size_t> group(chunks.size());
+    auto find_group = [&](size_t i) {
+        while (group[i] != i) {
+            i = group[i] = group[group[i]];
+        }
+        return i;
+    };
+    ThinHashMap<VarNode*, size_t> var2idx;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        group[i] = i;
+        var2idx[chunks[i].chunk->owner_var] = i;
+    }
+    for (auto&& i : prev.overwrite) {
+        group[find_group(var2idx.at(std::get<0>(i)))] =
+                find_group(var2idx.at(std::get<1>(i)));
+    }
+
+    std::vector<bool> changed(chunks.size());
+    std::vector<bool> group_changed(chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        auto&& chk = chunks[i];
+        auto iter = prev.chunks.find(chk.chunk->owner_var);
+        if (iter == prev.chunks.end() || iter->second.begin != chk.begin ||
+            iter->second.end != chk.end || iter->second.size != chk.chunk->size()) {
+            group_changed[find_group(i)] = true;
+        } else {
+            offsets[i] = iter->second.offset;
+        }
+    }
+
+    // merged time ranges of the changed chunks; chunks are sorted by begin
+    std::vector<std::pair<size_t, size_t>> changed_ranges;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (!group_changed[find_group(i)])
+            continue;
+        changed[i] = true;
+        auto&& chk = chunks[i];
+        if (!changed_ranges.empty() && chk.begin <= changed_ranges.back().second) {
+            update_max(changed_ranges.back().second, chk.end);
+        } else {
+            changed_ranges.emplace_back(chk.begin, chk.end);
+        }
+    }
+    if (changed_ranges.empty()) {
+        size = prev.size;
+        size_lb = prev.size_lb;
+        mgb_log_debug(
+                "incremental static mem plan on %s: all %zu chunks unchanged",
+                comp_node.to_string().c_str(), chunks.size());
+        return true;
+    }
+    auto alive_with_changed = [&](const MemChunkLifeInterval& chk) {
+        auto iter = std::upper_bound(
+                changed_ranges.begin(), changed_ranges.end(),
+                std::make_pair(chk.begin, std::numeric_limits<size_t>::max()));
+        if (iter != changed_ranges.end() && iter->first < chk.end)
+            return true;
+        return iter != changed_ranges.begin() && std::prev(iter)->second > chk.begin;
+    };
+
+    // changed chunks and the unchanged ones alive at the same time are
+    // placed by the allocator; others keep their offsets without being
+    // solved
+    std::vector<const MemChunkLifeInterval*> sub_chunks;
+    std::vector<size_t> sub2idx;
+    size_t kept_size = 0, nr_pinned = 0;
+    auto alignment = comp_node.get_mem_addr_alignment();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        auto&& chk = chunks[i];
+        if (changed[i] || alive_with_changed(chk)) {
+            sub_chunks.push_back(&chk);
+            sub2idx.push_back(i);
+        } else {
+            update_max(
+                    kept_size,
+                    get_aligned_power2(
+                            offsets[i] + chk.chunk->size() +
+                                    comp_node.get_mem_padding(),
+                            alignment));
+        }
+    }
+    auto allocator = make_static_mem_alloc(
+            comp_node, StaticMemAlloc::AllocatorAlgo::GREEDY_BY_SIZE, sub_chunks);
+    for (size_t i = 0; i < sub_chunks.size(); ++i) {
+        if (!changed[sub2idx[i]]) {
+            // ids are assigned in the order of add()
+            allocator->addr_hint(i, offsets[sub2idx[i]]);
+            ++nr_pinned;
+        }
+    }
     allocator->solve();
-    size_t size = allocator->tot_alloc(), size_lb = allocator->tot_alloc_lower_bound();
+
+    bool hint_rejected = false;
+    for (size_t i = 0; i < sub_chunks.size(); ++i) {
+        auto addr = allocator->get_start_addr(sub_chunks[i]);
+        if (!changed[sub2idx[i]] && addr != offsets[sub2idx[i]]) {
+            hint_rejected = true;
+        }
+        offsets[sub2idx[i]] = addr;
+    }
+    size = std::max(allocator->tot_alloc(), kept_size);
+    // all the chunks alive at the time of a changed chunk are in the
+    // sub-problem, so its lower bound is also a lower bound of the whole one
+    size_lb = allocator->tot_alloc_lower_bound();
+    bool accept = !hint_rejected &&
+                  (size <= prev.size ||
+                   size <= size_lb * (1 + INCREMENTAL_MEM_PLAN_TOLERANCE));
+    mgb_log_debug(
+            "incremental static mem plan on %s: solved %zu/%zu chunks (%zu "
+            "pinned), size=%zu prev_size=%zu; %s",
+            comp_node.to_string().c_str(), sub_chunks.size(), chunks.size(),
+            nr_pinned, size, prev.size,
+            accept ? "accepted"
+                   : (hint_rejected ? "hint rejected, fallback to full planning"
+                                    : "fallback to full planning"));
+    return accept;
+}
+
+bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
+        CompNode comp_node, const std::vector<MemChunkLifeInterval>& chunks,
+        StaticMemAllocLogger& static_mem_alloc_logger) {
+    size_t size_ub = 0;
+    for (auto&& chk : chunks) {
+        size_ub += chk.chunk->size();
+    }
+
+    bool incremental = m_graph->options().seq_opt.enable_incremental_mem_plan;
+    std::vector<PrevMemPlan::OverwriteSpec> overwrite;
+    std::vector<size_t> offsets(chunks.size());
+    size_t size = 0, size_lb = 0;
+    bool solved = false;
+    if (incremental) {
+        overwrite = get_overwrite_specs(chunks);
+        auto prev_iter = m_prev_mem_plan.find(comp_node);
+        // a changed forwarding invalidates the relative placement of the
+        // unchanged chunks
+        if (prev_iter != m_prev_mem_plan.end() &&
+            prev_iter->second.overwrite == overwrite) {
+            solved = run_incremental_mem_plan(
+                    comp_node, chunks, prev_iter->second, offsets, size, size_lb);
+        }
+    }
+    if (!solved) {
+        std::vector<const MemChunkLifeInterval*> all_chunks;
+        all_chunks.reserve(chunks.size());
+        for (auto&& chk : chunks) {
+            all_chunks.push_back(&chk);
+        }
+        auto allocator = make_static_mem_alloc(
+                comp_node, get_static_mem_alloc_algo(), all_chunks);
+        allocator->solve();
+        size = allocator->tot_alloc();
+        size_lb = allocator->tot_alloc_lower_bound();
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            offsets[i] = allocator->get_start_addr(&chunks[i]);
+        }
+    }
 
     static_mem_alloc_logger.push(comp_node, size, size_lb, size_ub);
 
@@ -332,9 +541,20 @@ bool SeqMemOptimizer::run_static_mem_alloc_on_comp_node(
 
     if (!should_realloc) {
         m_static_mem_usage.val()[comp_node] = size;
-        for (auto&& chk : chunks) {
-            chk.chunk->mem_alloc_status.set_static_offset(
-                    allocator->get_start_addr(&chk));
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            chunks[i].chunk->mem_alloc_status.set_static_offset(offsets[i]);
+        }
+        if (incremental) {
+            auto&& prev = m_prev_mem_plan[comp_node];
+            prev.chunks.clear();
+            prev.overwrite = std::move(overwrite);
+            prev.size = size;
+            prev.size_lb = size_lb;
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                auto&& chk = chunks[i];
+                prev.chunks[chk.chunk->owner_var] = {
+                        chk.begin, chk.end, chk.chunk->size(), offsets[i]};
+            }
         }
 #ifndef __IN_TEE_ENV__
         auto& recorder = StaticMemRecorder::Instance();
@@ -360,6 +580,8 @@ void SeqMemOptimizer::reset_opr_seq(
     m_cur_static_alloc_var = static_alloc_var;
     m_all_comp_nodes = std::move(all_comp_nodes);
     m_static_mem_usage.invalidate();
+    // time indices of chunks are only meaningful within the same sequence
+    m_prev_mem_plan.clear();
 }
 
 void SeqMemOptimizer::add_writable_fwd_mem_plan_pair(
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "../impl_common.h"
+#include "./static_mem_alloc.h"
+
+#include <tuple>
 
 namespace mgb {
 namespace cg {
@@ -24,6 +27,25 @@ class SeqMemOptimizer {
 
     using CompNode2Chunkset = CompNode::UnorderedMap<ThinHashSet<MemAllocPlan::Chunk*>>;
 
+    /*!
+     * \brief static allocation plan of the previous run on a comp node, used
+     *      for incremental re-planning
+     *
+     * chunks are identified by their owner vars
+     */
+    struct PrevMemPlan {
+        struct ChunkPlan {
+            size_t begin, end, size, offset;
+        };
+        //! (overwriter, overwritten, offset) of the writable forwarding
+        //! between chunks
+        using OverwriteSpec = std::tuple<VarNode*, VarNode*, size_t>;
+
+        ThinHashMap<VarNode*, ChunkPlan> chunks;
+        std::vector<OverwriteSpec> overwrite;
+        size_t size = 0, size_lb = 0;
+    };
+
     ComputingGraphImpl* m_graph;
     const OprNodeArray* m_cur_seq_full;
     const OprNodeArray* m_cur_seq_sys_alloc;
@@ -32,6 +54,8 @@ class SeqMemOptimizer {
     Maybe<CompNode::UnorderedMap<size_t>> m_static_mem_usage;
     SmallVector<CompNode> m_all_comp_nodes;
 
+    CompNode::UnorderedMap<PrevMemPlan> m_prev_mem_plan;
+
     size_t m_status = 0;
     std::vector<std::pair<MemAllocPlan*, MemAllocPlan*>> m_writable_fwd_mem_plans;
 
@@ -49,6 +73,32 @@ class SeqMemOptimizer {
             CompNode cn, const std::vector<MemChunkLifeInterval>& chunks,
             StaticMemAllocLogger& static_mem_alloc_logger);
 
+    //! make an allocator for the given chunks, with the writable forwarding
+    //! between them
+    std::unique_ptr<StaticMemAlloc> make_static_mem_alloc(
+            CompNode cn, StaticMemAlloc::AllocatorAlgo algo,
+            const std::vector<const MemChunkLifeInterval*>& chunks) const;
+
+    //! writable forwarding specs between the given chunks
+    std::vector<PrevMemPlan::OverwriteSpec> get_overwrite_specs(
+            const std::vector<MemChunkLifeInterval>& chunks) const;
+
+    /*!
+     * \brief re-plan only the chunks changed since the previous plan
+     *
+     * Unchanged chunks keep their offsets; only the changed chunks and the
+     * unchanged ones alive at the same time are passed to the allocator,
+     * with the latter pinned at their previous offsets.
+     *
+     * \param[out] offsets offset of each chunk
+     * \return whether the plan is accepted; a full plan should be computed
+     *      otherwise
+     */
+    bool run_incremental_mem_plan(
+            CompNode cn, const std::vector<MemChunkLifeInterval>& chunks,
+            const PrevMemPlan& prev, std::vector<size_t>& offsets, size_t& size,
+            size_t& size_lb);
+
 public:
     SeqMemOptimizer(ComputingGraphImpl* graph) : m_graph(graph) {}
 
@@ -29,12 +29,25 @@ public:
 
         //! O(n log n) allocator with better performance
         PUSHDOWN,
+
+        //! greedy-by-size on conflict graph with local search; a placement
+        //! pass is O(n * k log k) where k is the number of intervals alive at
+        //! the same time, or O(n^2) if k is so large that the conflict graph
+        //! is not kept; large problems only get a few passes
+        GREEDY_BY_SIZE,
+
+        //! run other allocators in parallel and keep the plan with least
+        //! peak memory usage
+        BEST_OF,
     };
 
     static std::unique_ptr<StaticMemAlloc> make(AllocatorAlgo algo);
 
     virtual ~StaticMemAlloc() = default;
 
+    //! algorithm of this allocator
+    virtual AllocatorAlgo algo() const = 0;
+
     /*!
      * \brief add a memory alloc request, which is used during time interval
      *      [begin, end)
@@ -48,6 +61,16 @@ public:
     virtual StaticMemAlloc& add_overwrite_spec(
             size_t iid_src, size_t iid_dest, size_t offset) = 0;
 
+    /*!
+     * \brief hint that interval *iid* should be placed at given address,
+     *      usually taken from a previous plan of a slightly different problem
+     *
+     * The allocator keeps the address if the interval, together with the
+     * intervals overwriting it, could still be placed there without conflict;
+     * only GREEDY_BY_SIZE honors the hints, and other algorithms ignore them
+     */
+    virtual StaticMemAlloc& addr_hint(size_t iid, size_t addr) = 0;
+
     /*!
      * \brief solve allocation scheme after add() and add_overwrite_spec()
      *      has been called
@@ -88,6 +111,19 @@ public:
      */
     virtual StaticMemAlloc& padding(size_t padding) = 0;
 
+    /*!
+     * \brief set whether to reuse the plan of an identical problem solved
+     *      before in this process
+     *
+     * Plans are memoized by a hash of the intervals, overwrite specs,
+     * alignment and algorithm; enabled by default. Must be called before
+     * calling solve()
+     */
+    virtual StaticMemAlloc& enable_plan_cache(bool flag) = 0;
+
+    //! whether the plan of last solve() is taken from the plan cache
+    virtual bool plan_cache_hit() const = 0;
+
 #if MGB_ENABLE_DEBUG_UTIL
     //! set by the caller to convert key to VarNode* for debug logging
     VarNode* (*dbg_key2varnode)(UserKeyType) = nullptr;
@@ -73,7 +73,9 @@ class StaticMemAllocBestFit final : public StaticMemAllocImplHelper {
 public:
     void do_solve() override;
 
-    size_t tot_alloc() const override { return m_top; }
+    size_t solved_tot_alloc() const override { return m_top; }
+
+    AllocatorAlgo algo() const override { return AllocatorAlgo::BEST_FIT; }
 };
 
 }  // namespace cg
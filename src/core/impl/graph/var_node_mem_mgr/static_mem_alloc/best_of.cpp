@@ -0,0 +1,117 @@
+#include "./best_of.h"
+
+#include "megbrain/system.h"
+#include "megbrain/utils/async_worker.h"
+
+using namespace mgb;
+using namespace cg;
+
+namespace {
+//! INTERVAL_MOVE is O(n^2) and only tried for small problems
+constexpr size_t INTERVAL_MOVE_MAX_SIZE = 1000;
+
+//! at most this many algorithms are run concurrently
+constexpr size_t MAX_NR_SOLVER = 4;
+
+using WorkerPool = FutureThreadPool<void>;
+
+//! the workers are shared by all the solves, so they are only started once
+//! in a process rather than for each graph compiling
+WorkerPool& worker_pool() {
+    struct Pool {
+        WorkerPool workers{std::string{"memalloc"}};
+        Pool() {
+            workers.start(std::min<size_t>(
+                    MAX_NR_SOLVER, std::max<int>(sys::get_cpu_count(), 1)));
+        }
+    };
+    static Pool inst;
+    return inst.workers;
+}
+
+const char* algo_name(StaticMemAlloc::AllocatorAlgo algo) {
+    using A = StaticMemAlloc::AllocatorAlgo;
+    switch (algo) {
+        case A::INTERVAL_MOVE:
+            return "INTERVAL_MOVE";
+        case A::BEST_FIT:
+            return "BEST_FIT";
+        case A::PUSHDOWN:
+            return "PUSHDOWN";
+        case A::GREEDY_BY_SIZE:
+            return "GREEDY_BY_SIZE";
+        default:
+            return "BEST_OF";
+    }
+}
+}  // anonymous namespace
+
+void StaticMemAllocBestOf::do_solve() {
+    std::vector<AllocatorAlgo> algos{
+            AllocatorAlgo::PUSHDOWN, AllocatorAlgo::GREEDY_BY_SIZE};
+#if !MGB_BUILD_SLIM_SERVING
+    algos.push_back(AllocatorAlgo::BEST_FIT);
+    if (m_interval.size() <= INTERVAL_MOVE_MAX_SIZE) {
+        algos.push_back(AllocatorAlgo::INTERVAL_MOVE);
+    }
+#endif
+
+    // replay the intervals with resolved overwrite specs into each solver; the
+    // sizes already include padding
+    std::vector<std::unique_ptr<StaticMemAllocImplHelper>> solvers;
+    std::vector<size_t> sub_id(m_interval.size());
+    for (auto algo : algos) {
+        solvers.emplace_back(
+                static_cast<StaticMemAllocImplHelper*>(make(algo).release()));
+        auto&& s = solvers.back();
+        s->m_nested = true;
+        s->alignment(get_alignment());
+        for (auto i : m_interval) {
+            sub_id.at(i->id) = s->add(i->time_begin, i->time_end, i->size, i->key);
+        }
+        for (auto i : m_interval) {
+            if (!i->is_overwrite_root()) {
+                s->add_overwrite_spec(
+                        sub_id[i->id], sub_id[i->overwrite_dest()->id],
+                        i->offset_in_overwrite_dest());
+            }
+        }
+    }
+
+    auto&& workers = worker_pool();
+    std::vector<WorkerPool::Future> futures;
+    for (auto&& s : solvers) {
+        futures.emplace_back(workers.launch([ptr = s.get()]() { ptr->solve(); }));
+    }
+    // all the solvers must finish before an exception destroys them
+    std::exception_ptr exc;
+    for (auto&& i : futures) {
+        MGB_TRY { i.get(); }
+        MGB_CATCH(..., {
+            if (!exc) {
+                exc = std::current_exception();
+            }
+        })
+    }
+    if (exc) {
+        std::rethrow_exception(exc);
+    }
+
+    StaticMemAllocImplHelper* best = nullptr;
+    for (auto&& s : solvers) {
+        if (!best || s->tot_alloc() < best->tot_alloc()) {
+            best = s.get();
+        }
+    }
+    for (auto i : m_interval) {
+        i->addr_begin = best->get_start_addr(i->key);
+    }
+    m_peak = best->tot_alloc();
+    mgb_log_debug(
+            "static mem alloc: best of %zu algorithms is %s, peak=%zu "
+            "lower_bound=%zu",
+            solvers.size(), algo_name(best->algo()), m_peak,
+            best->tot_alloc_lower_bound());
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
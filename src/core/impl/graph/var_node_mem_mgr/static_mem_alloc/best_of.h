@@ -0,0 +1,26 @@
+#pragma once
+
+#include "./impl.h"
+
+namespace mgb {
+namespace cg {
+
+/*!
+ * \brief run several allocators concurrently on the same intervals and keep
+ *      the plan with least peak memory usage
+ */
+class StaticMemAllocBestOf final : public StaticMemAllocImplHelper {
+    size_t m_peak = 0;
+
+    void do_solve() override;
+
+    size_t solved_tot_alloc() const override { return m_peak; }
+
+public:
+    AllocatorAlgo algo() const override { return AllocatorAlgo::BEST_OF; }
+};
+
+}  // namespace cg
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,367 @@
+#include "./greedy_by_size.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace mgb;
+using namespace cg;
+
+namespace {
+//! max number of reorderings tried by local search
+constexpr size_t MAX_LOCAL_SEARCH_ITER = 64;
+
+//! local search stops when it has visited this many times of rectangle pairs
+//! as all the initial orders together
+constexpr size_t LOCAL_SEARCH_EFFORT = 16;
+
+//! more initial orders and local search are only tried before this many
+//! rectangle pairs have been visited, which bounds the number of placement
+//! passes on problems with many long living intervals
+constexpr size_t MAX_NR_VISITED = 1 << 24;
+
+//! max number of edges in the conflict graph; for larger problems conflicts
+//! are computed on the fly to bound memory usage
+constexpr size_t MAX_NR_CONFLICT_EDGE = 1 << 22;
+}  // anonymous namespace
+
+void StaticMemAllocGreedyBySize::init_blocks() {
+    m_blocks.clear();
+    std::vector<size_t> root2block(m_interval.size(), INVALID);
+    for (auto i : m_interval) {
+        if (i->is_overwrite_root()) {
+            root2block.at(i->id) = m_blocks.size();
+            m_blocks.push_back({i, i->time_begin, i->time_end, 0, {}, {}, INVALID});
+        }
+    }
+    auto&& hints = addr_hints();
+    auto get_hint = [&](Interval* i) {
+        return i->id < hints.size() ? hints[i->id] : INVALID;
+    };
+    for (auto&& blk : m_blocks) {
+        auto hint = get_hint(blk.root);
+        if (hint != INVALID && hint == align(hint)) {
+            blk.hint = hint;
+        }
+    }
+    for (auto i : m_interval) {
+        Interval* root = i;
+        size_t offset = 0;
+        if (!i->is_overwrite_root()) {
+            root = i->overwrite_dest_root();
+            offset = i->offset_in_overwrite_dest_root();
+        }
+        auto&& blk = m_blocks[root2block.at(root->id)];
+        blk.rects.push_back({i->time_begin, i->time_end, offset, offset + i->size});
+        if (blk.hint != INVALID && get_hint(i) != blk.hint + offset) {
+            // the block can only be kept if all its members are kept
+            blk.hint = INVALID;
+        }
+        update_min(blk.time_begin, i->time_begin);
+        update_max(blk.time_end, i->time_end);
+        update_max(blk.extent, offset + i->size);
+    }
+
+    // build conflict graph by sweeping over block begin time; the number of
+    // edges is counted first, since a block is connected to all the earlier
+    // ones except those ended before it begins
+    std::vector<size_t> by_begin(m_blocks.size()), ends, active;
+    for (size_t i = 0; i < by_begin.size(); ++i) {
+        by_begin[i] = i;
+        ends.push_back(m_blocks[i].time_end);
+    }
+    std::sort(by_begin.begin(), by_begin.end(), [this](size_t a, size_t b) {
+        return m_blocks[a].time_begin < m_blocks[b].time_begin;
+    });
+    std::sort(ends.begin(), ends.end());
+    size_t nr_edge = 0;
+    for (size_t i = 0; i < by_begin.size(); ++i) {
+        auto begin = m_blocks[by_begin[i]].time_begin;
+        nr_edge += i - (std::upper_bound(ends.begin(), ends.end(), begin) -
+                        ends.begin());
+    }
+    m_has_conflict_graph = nr_edge <= MAX_NR_CONFLICT_EDGE;
+    if (!m_has_conflict_graph) {
+        return;
+    }
+    for (auto cur : by_begin) {
+        auto&& blk = m_blocks[cur];
+        auto end = std::remove_if(active.begin(), active.end(), [&](size_t i) {
+            return m_blocks[i].time_end <= blk.time_begin;
+        });
+        active.erase(end, active.end());
+        for (auto i : active) {
+            blk.conflict.push_back(i);
+            m_blocks[i].conflict.push_back(cur);
+        }
+        active.push_back(cur);
+    }
+}
+
+void StaticMemAllocGreedyBySize::add_forbid(
+        std::vector<Range>& dst, size_t base, const Rect& q, const Rect& r) {
+    using sidx_t = ptrdiff_t;
+    if (q.time_begin < r.time_end && r.time_begin < q.time_end) {
+        // r placed at x conflicts with q iff
+        // x + r.offset_begin < q_end && q_begin < x + r.offset_end
+        auto b = static_cast<sidx_t>(base);
+        dst.emplace_back(
+                b + static_cast<sidx_t>(q.offset_begin) -
+                        static_cast<sidx_t>(r.offset_end) + 1,
+                b + static_cast<sidx_t>(q.offset_end) -
+                        static_cast<sidx_t>(r.offset_begin));
+    }
+}
+
+void StaticMemAllocGreedyBySize::insert_placed(
+        size_t cur, const std::vector<size_t>& addr) {
+    auto&& blk = m_blocks[cur];
+    if (blk.rects.size() != 1) {
+        m_placed_multi.push_back(cur);
+        return;
+    }
+    auto begin = static_cast<ptrdiff_t>(addr[cur]);
+    Placed item{
+            begin, begin + static_cast<ptrdiff_t>(blk.extent), blk.time_begin,
+            blk.time_end};
+    auto pos = std::upper_bound(
+            m_placed.begin(), m_placed.end(), item,
+            [](const Placed& a, const Placed& b) {
+                return a.addr_begin < b.addr_begin;
+            });
+    m_placed.insert(pos, item);
+}
+
+void StaticMemAllocGreedyBySize::collect_forbid(
+        size_t cur, const std::vector<size_t>& addr) {
+    using sidx_t = ptrdiff_t;
+    // only the begin of the ranges matters for finding the gaps
+    auto less_begin = [](const Range& a, const Range& b) { return a.first < b.first; };
+    auto&& blk = m_blocks[cur];
+    m_forbid.clear();
+    if (m_has_conflict_graph) {
+        for (auto other : blk.conflict) {
+            if (addr[other] != INVALID) {
+                for (auto&& q : m_blocks[other].rects) {
+                    for (auto&& r : blk.rects) {
+                        add_forbid(m_forbid, addr[other], q, r);
+                    }
+                }
+            }
+        }
+        m_nr_visited += m_forbid.size();
+        std::sort(m_forbid.begin(), m_forbid.end(), less_begin);
+        return;
+    }
+
+    // without the conflict graph all the placed blocks are scanned; for each
+    // rectangle of current block the ranges due to single rectangle blocks
+    // come out sorted since they are scanned in address order, and only the
+    // others have to be sorted before all the runs are merged
+    m_forbid_unsorted.clear();
+    m_forbid_run.assign(1, 0);
+    for (auto&& r : blk.rects) {
+        // every block is written but only kept if it conflicts, which avoids
+        // unpredictable branches
+        size_t size = m_forbid.size();
+        m_forbid.resize(size + m_placed.size());
+        auto out = m_forbid.data() + size;
+        auto rb = static_cast<sidx_t>(r.offset_begin),
+             re = static_cast<sidx_t>(r.offset_end);
+        for (auto&& q : m_placed) {
+            *out = {q.addr_begin - re + 1, q.addr_end - rb};
+            out += q.time_begin < r.time_end && r.time_begin < q.time_end;
+        }
+        m_forbid.resize(out - m_forbid.data());
+        m_forbid_run.push_back(m_forbid.size());
+        for (auto other : m_placed_multi) {
+            for (auto&& q : m_blocks[other].rects) {
+                add_forbid(m_forbid_unsorted, addr[other], q, r);
+            }
+        }
+    }
+    std::sort(m_forbid_unsorted.begin(), m_forbid_unsorted.end(), less_begin);
+    m_forbid.insert(m_forbid.end(), m_forbid_unsorted.begin(), m_forbid_unsorted.end());
+    m_forbid_run.push_back(m_forbid.size());
+    for (size_t i = 2; i < m_forbid_run.size(); ++i) {
+        std::inplace_merge(
+                m_forbid.begin(), m_forbid.begin() + m_forbid_run[i - 1],
+                m_forbid.begin() + m_forbid_run[i], less_begin);
+    }
+    m_nr_visited += m_forbid.size();
+}
+
+std::vector<size_t> StaticMemAllocGreedyBySize::place_hinted() {
+    m_fixed_addr.assign(m_blocks.size(), INVALID);
+    m_placed.clear();
+    m_placed_multi.clear();
+    std::vector<size_t> hinted, free;
+    for (size_t i = 0; i < m_blocks.size(); ++i) {
+        (m_blocks[i].hint != INVALID ? hinted : free).push_back(i);
+    }
+    // keep larger blocks first if hints conflict
+    std::stable_sort(hinted.begin(), hinted.end(), [this](size_t a, size_t b) {
+        return m_blocks[a].extent > m_blocks[b].extent;
+    });
+    for (auto cur : hinted) {
+        auto x = static_cast<ptrdiff_t>(m_blocks[cur].hint);
+        collect_forbid(cur, m_fixed_addr);
+        bool ok = true;
+        for (auto&& f : m_forbid) {
+            if (f.first > x) {
+                break;
+            }
+            if (x < f.second) {
+                ok = false;
+                break;
+            }
+        }
+        if (ok) {
+            m_fixed_addr[cur] = m_blocks[cur].hint;
+            if (!m_has_conflict_graph) {
+                insert_placed(cur, m_fixed_addr);
+            }
+        } else {
+            free.push_back(cur);
+        }
+    }
+    return free;
+}
+
+size_t StaticMemAllocGreedyBySize::place_all(
+        const std::vector<size_t>& order, std::vector<size_t>& addr) {
+    using sidx_t = ptrdiff_t;
+    addr = m_fixed_addr;
+    size_t peak = 0;
+    m_placed.clear();
+    m_placed_multi.clear();
+    for (size_t i = 0; i < addr.size(); ++i) {
+        if (addr[i] != INVALID) {
+            update_max(peak, addr[i] + m_blocks[i].extent);
+            if (!m_has_conflict_graph) {
+                insert_placed(i, addr);
+            }
+        }
+    }
+    for (auto cur : order) {
+        collect_forbid(cur, addr);
+
+        // find the tightest free gap; the gap after all forbidden ranges is
+        // unbounded and only used if no other gap fits
+        size_t best_addr = INVALID, best_slack = std::numeric_limits<size_t>::max();
+        sidx_t gap_begin = 0;
+        for (auto&& f : m_forbid) {
+            if (f.first > gap_begin) {
+                auto cand = static_cast<sidx_t>(align(gap_begin));
+                if (cand < f.first) {
+                    auto slack = static_cast<size_t>(f.first - cand);
+                    if (slack < best_slack) {
+                        best_slack = slack;
+                        best_addr = static_cast<size_t>(cand);
+                    }
+                }
+            }
+            update_max(gap_begin, f.second);
+        }
+        if (best_addr == INVALID) {
+            best_addr = align(gap_begin);
+        }
+        addr[cur] = best_addr;
+        update_max(peak, best_addr + m_blocks[cur].extent);
+        if (!m_has_conflict_graph) {
+            insert_placed(cur, addr);
+        }
+    }
+    return peak;
+}
+
+void StaticMemAllocGreedyBySize::do_solve() {
+    init_blocks();
+    m_peak = 0;
+    m_nr_visited = 0;
+    size_t nr_blk = m_blocks.size();
+    if (!nr_blk) {
+        return;
+    }
+
+    // only the blocks not fixed by hints are reordered
+    auto free = place_hinted();
+    size_t nr_free = free.size();
+    std::vector<size_t> order, addr, best_order, best_addr;
+    size_t best_peak = std::numeric_limits<size_t>::max();
+    auto try_order = [&]() {
+        auto peak = place_all(order, addr);
+        if (peak < best_peak) {
+            best_peak = peak;
+            best_order = order;
+            best_addr.swap(addr);
+            return true;
+        }
+        return false;
+    };
+
+    // initial orders: largest extent, largest area and longest lifetime first
+    using KeyFunc = size_t (*)(const Block&);
+    KeyFunc keys[] = {
+            [](const Block& b) { return b.extent; },
+            [](const Block& b) { return b.extent * (b.time_end - b.time_begin); },
+            [](const Block& b) { return b.time_end - b.time_begin; },
+    };
+    for (auto key : keys) {
+        if (m_nr_visited > MAX_NR_VISITED) {
+            break;
+        }
+        order = free;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            auto ka = key(m_blocks[a]), kb = key(m_blocks[b]);
+            return ka > kb ||
+                   (ka == kb && m_blocks[a].time_begin < m_blocks[b].time_begin);
+        });
+        try_order();
+    }
+
+    // local search: place the block that reaches the peak earlier
+    size_t effort_limit = std::min(
+            std::max<size_t>(m_nr_visited, nr_blk) * LOCAL_SEARCH_EFFORT,
+            MAX_NR_VISITED);
+    std::vector<size_t> pos(nr_blk, INVALID);
+    std::vector<bool> tried(nr_blk, false);
+    for (size_t iter = 0; iter < MAX_LOCAL_SEARCH_ITER && m_nr_visited < effort_limit;
+         ++iter) {
+        for (size_t i = 0; i < nr_free; ++i) {
+            pos[best_order[i]] = i;
+        }
+        size_t crit = INVALID;
+        for (auto i : free) {
+            if (!tried[i] && best_addr[i] + m_blocks[i].extent == best_peak &&
+                (crit == INVALID || pos[i] > pos[crit])) {
+                crit = i;
+            }
+        }
+        if (crit == INVALID) {
+            break;
+        }
+        tried[crit] = true;
+        auto p = pos[crit];
+        if (!p) {
+            continue;
+        }
+        order = best_order;
+        std::rotate(order.begin() + p / 2, order.begin() + p, order.begin() + p + 1);
+        if (try_order()) {
+            tried.assign(nr_blk, false);
+        }
+    }
+
+    for (size_t i = 0; i < nr_blk; ++i) {
+        m_blocks[i].root->addr_begin = best_addr[i];
+    }
+    for (auto i : m_interval) {
+        if (!i->is_overwrite_root()) {
+            i->addr_begin = i->overwrite_dest_root()->addr_begin +
+                            i->offset_in_overwrite_dest_root();
+        }
+    }
+    m_peak = best_peak;
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
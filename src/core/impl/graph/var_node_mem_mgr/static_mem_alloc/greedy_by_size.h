@@ -0,0 +1,115 @@
+#pragma once
+
+#include "./impl.h"
+
+namespace mgb {
+namespace cg {
+
+/*!
+ * \brief greedy-by-size allocator on a conflict graph, refined by local search
+ *
+ * Each overwrite root together with all the intervals that (transitively)
+ * overwrite it forms a block; a block is described by the (time, address)
+ * rectangles of its members relative to the address of the root. Blocks whose
+ * lifetimes overlap are connected in the conflict graph.
+ *
+ * Blocks are placed one by one in a given order, each at the aligned address
+ * whose free gap among the already placed conflicting blocks fits it best.
+ * Several orders are tried, and the best one is refined by moving the blocks
+ * that determine the peak earlier in the order.
+ *
+ * Blocks whose members all have consistent address hints are placed at the
+ * hinted address first if it does not conflict with other hinted blocks; only
+ * the remaining blocks are ordered and placed greedily.
+ */
+class StaticMemAllocGreedyBySize final : public StaticMemAllocImplHelper {
+    struct Rect {
+        size_t time_begin, time_end, offset_begin, offset_end;
+    };
+
+    struct Block {
+        Interval* root;
+        size_t time_begin, time_end, extent;
+        //! members of this block, in the address space of the root
+        std::vector<Rect> rects;
+        //! blocks whose lifetime overlaps with this one
+        std::vector<size_t> conflict;
+        //! hinted address of the root, or INVALID
+        size_t hint;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_peak = 0;
+
+    //! address of blocks placed at their hints, INVALID for other blocks
+    std::vector<size_t> m_fixed_addr;
+
+    //! [begin, end) of root addresses forbidden for a block
+    using Range = std::pair<ptrdiff_t, ptrdiff_t>;
+
+    //! forbidden ranges for the block being placed, sorted by begin
+    std::vector<Range> m_forbid;
+
+    //! buffers used by collect_forbid() without the conflict graph
+    std::vector<Range> m_forbid_unsorted;
+    std::vector<size_t> m_forbid_run;
+
+    //! a placed block of a single rectangle, i.e. [addr_begin, addr_end)
+    //! during [time_begin, time_end)
+    struct Placed {
+        ptrdiff_t addr_begin, addr_end;
+        size_t time_begin, time_end;
+    };
+
+    //! placed single rectangle blocks ordered by address and other placed
+    //! blocks; only maintained without the conflict graph
+    std::vector<Placed> m_placed;
+    std::vector<size_t> m_placed_multi;
+
+    //! whether Block::conflict is computed; it is omitted if the graph is
+    //! too large, and conflicts are found by scanning the placed blocks
+    bool m_has_conflict_graph = false;
+
+    //! number of conflicting rectangle pairs visited by place_all(), used to
+    //! bound the effort of local search
+    size_t m_nr_visited = 0;
+
+    void init_blocks();
+
+    //! place hinted blocks into m_fixed_addr, and return the other blocks
+    std::vector<size_t> place_hinted();
+
+    //! append the range forbidden for \p r by \p q placed at \p base
+    static void add_forbid(
+            std::vector<Range>& dst, size_t base, const Rect& q, const Rect& r);
+
+    //! add block \p cur to the placed blocks
+    void insert_placed(size_t cur, const std::vector<size_t>& addr);
+
+    /*!
+     * \brief compute sorted m_forbid for block \p cur given placed blocks
+     *
+     * This is O(k log k) where k is the number of conflicting rectangles, or
+     * O(n + k) for blocks of a single rectangle without the conflict graph.
+     */
+    void collect_forbid(size_t cur, const std::vector<size_t>& addr);
+
+    /*!
+     * \brief place the blocks in given order after the fixed ones
+     * \param[out] addr address of each block, indexed by block id
+     * \return peak memory usage
+     */
+    size_t place_all(const std::vector<size_t>& order, std::vector<size_t>& addr);
+
+    void do_solve() override;
+
+    size_t solved_tot_alloc() const override { return m_peak; }
+
+public:
+    AllocatorAlgo algo() const override { return AllocatorAlgo::GREEDY_BY_SIZE; }
+};
+
+}  // namespace cg
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -1,8 +1,14 @@
 #include "./impl.h"
 #include "./best_fit.h"
+#include "./best_of.h"
+#include "./greedy_by_size.h"
 #include "./interval_move.h"
 #include "./pushdown.h"
 
+#include "megbrain/utils/hash.h"
+#include "megbrain/utils/thread.h"
+
+#include <deque>
 #include <map>
 
 #if MGB_ENABLE_DEBUG_UTIL
@@ -17,6 +23,79 @@ using namespace cg;
 
 constexpr size_t StaticMemAllocImplHelper::INVALID;
 
+/* ======================== PlanCache ======================== */
+
+/*!
+ * \brief process-wide cache of solved plans
+ *
+ * Graphs are often recompiled with unchanged shapes (e.g. when only some
+ * outputs change), and identical sub-graphs are compiled in several graphs;
+ * solving the same problem again is wasted work for the slower algorithms.
+ */
+class StaticMemAllocImplHelper::PlanCache {
+    static constexpr size_t MAX_NR_ENTRY = 32;
+
+    struct Entry {
+        std::vector<size_t> key, addr;
+        size_t tot_alloc;
+    };
+
+    MGB_MUTEX m_mtx;
+    std::unordered_map<uint64_t, Entry> m_entries;
+    //! hash of entries from old to new, for eviction
+    std::deque<uint64_t> m_order;
+
+    static uint64_t hash(const std::vector<size_t>& key) {
+        return XXHash{}.update(key.data(), key.size() * sizeof(size_t)).digest();
+    }
+
+public:
+    static PlanCache& inst() {
+        static PlanCache cache;
+        return cache;
+    }
+
+    //! fill addr_begin of intervals and return whether the plan is found
+    bool get(
+            const std::vector<size_t>& key, std::vector<Interval>& intervals,
+            size_t& tot_alloc) {
+        MGB_LOCK_GUARD(m_mtx);
+        auto iter = m_entries.find(hash(key));
+        if (iter == m_entries.end() || iter->second.key != key) {
+            return false;
+        }
+        auto&& addr = iter->second.addr;
+        mgb_assert(addr.size() == intervals.size());
+        for (size_t i = 0; i < addr.size(); ++i) {
+            intervals[i].addr_begin = addr[i];
+        }
+        tot_alloc = iter->second.tot_alloc;
+        return true;
+    }
+
+    void put(
+            std::vector<size_t> key, const std::vector<Interval>& intervals,
+            size_t tot_alloc) {
+        std::vector<size_t> addr(intervals.size());
+        for (size_t i = 0; i < addr.size(); ++i) {
+            addr[i] = intervals[i].addr_begin;
+        }
+        auto h = hash(key);
+        MGB_LOCK_GUARD(m_mtx);
+        auto ins = m_entries.emplace(h, Entry{});
+        if (ins.second) {
+            m_order.push_back(h);
+            if (m_order.size() > MAX_NR_ENTRY) {
+                m_entries.erase(m_order.front());
+                m_order.pop_front();
+            }
+        }
+        ins.first->second = {std::move(key), std::move(addr), tot_alloc};
+    }
+};
+
+/* ======================== StaticMemAllocImplHelper ======================== */
+
 StaticMemAllocImplHelper::Interval* StaticMemAllocImplHelper::Interval::
         overwrite_dest_root_path_compression() {
     auto&& ptr = m_overwrite_dest_root;
@@ -86,13 +165,53 @@ StaticMemAlloc& StaticMemAllocImplHelper::add_overwrite_spec(
     return *this;
 }
 
+StaticMemAlloc& StaticMemAllocImplHelper::addr_hint(size_t iid, size_t addr) {
+    mgb_assert(iid < m_interval_storage.size());
+    if (m_addr_hint.size() < m_interval_storage.size()) {
+        m_addr_hint.resize(m_interval_storage.size(), INVALID);
+    }
+    m_addr_hint[iid] = addr;
+    return *this;
+}
+
 size_t StaticMemAllocImplHelper::get_start_addr(UserKeyType key) const {
     return m_userkey2itrv.at(key)->addr_begin;
 }
 
+std::vector<size_t> StaticMemAllocImplHelper::make_plan_cache_key() const {
+    std::vector<size_t> key;
+    key.reserve(m_interval_storage.size() * 3 + 4);
+    key.push_back(static_cast<size_t>(algo()));
+    key.push_back(m_alignment);
+    key.push_back(m_interval_storage.size());
+    for (auto&& i : m_interval_storage) {
+        key.push_back(i.time_begin_orig);
+        key.push_back(i.time_end_orig);
+        key.push_back(i.size_orig);
+    }
+    // overwrite specs resolved by init_overwrite_dest()
+    for (auto&& i : m_interval_storage) {
+        if (auto dest = i.overwrite_dest()) {
+            key.push_back(i.id);
+            key.push_back(dest->id);
+            key.push_back(i.offset_in_overwrite_dest());
+        }
+    }
+    key.push_back(INVALID);
+    for (size_t i = 0; i < m_addr_hint.size(); ++i) {
+        if (m_addr_hint[i] != INVALID) {
+            key.push_back(i);
+            key.push_back(m_addr_hint[i]);
+        }
+    }
+    return key;
+}
+
 StaticMemAlloc& StaticMemAllocImplHelper::solve() {
-    dbg_dump_interval_list();
-    dbg_load_interval_list();
+    if (!m_nested) {
+        dbg_dump_interval_list();
+        dbg_load_interval_list();
+    }
     m_interval.clear();
     m_interval.reserve(m_interval_storage.size());
     m_userkey2itrv.clear();
@@ -104,11 +223,24 @@ StaticMemAlloc& StaticMemAllocImplHelper::solve() {
 
     init_overwrite_dest();
 
-    do_solve();
+    std::vector<size_t> cache_key;
+    m_plan_cache_hit = false;
+    if (m_enable_plan_cache && !m_nested) {
+        cache_key = make_plan_cache_key();
+        m_plan_cache_hit =
+                PlanCache::inst().get(cache_key, m_interval_storage, m_tot_alloc);
+    }
+    if (!m_plan_cache_hit) {
+        do_solve();
+        m_tot_alloc = solved_tot_alloc();
+    }
 
     check_result_and_calc_lower_bound();
+    if (!cache_key.empty() && !m_plan_cache_hit) {
+        PlanCache::inst().put(std::move(cache_key), m_interval_storage, m_tot_alloc);
+    }
 #ifndef __IN_TEE_ENV__
-    if (StaticMemRecorder::Instance().valid()) {
+    if (!m_nested && StaticMemRecorder::Instance().valid()) {
         StaticMemRecorder::Instance().clear_memory_chunk();
         for (auto&& i : m_interval) {
             size_t overwrite_dest_id = 0;
@@ -163,6 +295,7 @@ void StaticMemAllocImplHelper::dbg_load_interval_list() {
 
     m_interval_storage.clear();
     m_overwrite_spec.clear();
+    m_addr_hint.clear();
     size_t nr_interval;
     fin >> nr_interval;
     for (size_t i = 0; i < nr_interval; ++i) {
@@ -310,7 +443,7 @@ void StaticMemAllocImplHelper::check_result_and_calc_lower_bound() {
 template <typename T>
 void StaticMemAllocImplHelper::print_bottleneck_oprs(const T& time2event) {
 #if MGB_ENABLE_DEBUG_UTIL
-    if (!MGB_GETENV("MGB_PRINT_STATIC_ALLOC_BOTTLENECK"))
+    if (m_nested || !MGB_GETENV("MGB_PRINT_STATIC_ALLOC_BOTTLENECK"))
         return;
     mgb_assert(dbg_key2varnode);
 
@@ -377,6 +510,10 @@ std::unique_ptr<StaticMemAlloc> StaticMemAlloc::make(AllocatorAlgo algo) {
 #endif
         case AllocatorAlgo::PUSHDOWN:
             return std::make_unique<StaticMemAllocPushdown>();
+        case AllocatorAlgo::GREEDY_BY_SIZE:
+            return std::make_unique<StaticMemAllocGreedyBySize>();
+        case AllocatorAlgo::BEST_OF:
+            return std::make_unique<StaticMemAllocBestOf>();
         default:
             mgb_assert(0, "unknown mem allocator algorithm");
     }
@@ -12,6 +12,9 @@ namespace mgb {
 namespace cg {
 
 class StaticMemAllocImplHelper : public StaticMemAlloc {
+    friend class StaticMemAllocBestOf;
+    class PlanCache;
+
 public:
     class Interval;
     using IntervalPtrArray = std::vector<Interval*>;
@@ -25,6 +28,8 @@ public:
 
     size_t get_start_addr(UserKeyType key) const override final;
 
+    StaticMemAlloc& addr_hint(size_t iid, size_t addr) override final;
+
     StaticMemAlloc& solve() override final;
 
     StaticMemAlloc& alignment(size_t alignment) override final {
@@ -38,6 +43,15 @@ public:
         return *this;
     }
 
+    StaticMemAlloc& enable_plan_cache(bool flag) override final {
+        m_enable_plan_cache = flag;
+        return *this;
+    }
+
+    bool plan_cache_hit() const override final { return m_plan_cache_hit; }
+
+    size_t tot_alloc() const override final { return m_tot_alloc; }
+
     size_t tot_alloc_lower_bound() const override final { return m_peak_lower_bound; }
 
 protected:
@@ -52,13 +66,28 @@ protected:
      */
     virtual void do_solve() = 0;
 
+    //! peak memory usage of the plan computed by do_solve()
+    virtual size_t solved_tot_alloc() const = 0;
+
     /*!
      * \brief get aligned address
      */
     size_t align(size_t addr) { return get_aligned_power2(addr, m_alignment); }
 
+    size_t get_alignment() const { return m_alignment; }
+
+    //! address hints given by addr_hint(), indexed by interval id; empty if no
+    //! hint is given
+    const std::vector<size_t>& addr_hints() const { return m_addr_hint; }
+
 private:
-    size_t m_alignment = 1, m_padding = 0, m_peak_lower_bound = 0;
+    size_t m_alignment = 1, m_padding = 0, m_peak_lower_bound = 0, m_tot_alloc = 0;
+    bool m_enable_plan_cache = true, m_plan_cache_hit = false;
+
+    //! whether this allocator is used by another one (e.g. BEST_OF) to solve
+    //! a sub problem; debug utilities and recorders are skipped for nested
+    //! allocators
+    bool m_nested = false;
 
     //! original interval storage
     std::vector<Interval> m_interval_storage;
@@ -66,6 +95,8 @@ private:
     //! tuple of (src, dest, offset)
     std::vector<std::tuple<size_t, size_t, size_t>> m_overwrite_spec;
 
+    std::vector<size_t> m_addr_hint;
+
     ThinHashMap<UserKeyType, Interval*> m_userkey2itrv;
 
     /*!
@@ -75,6 +106,9 @@ private:
 
     void check_result_and_calc_lower_bound();
 
+    //! key to lookup the plan of current problem in PlanCache
+    std::vector<size_t> make_plan_cache_key() const;
+
     //! called by check_result_and_calc_lower_bound() to print bottleneck
     //! oprs for debug; use template because I do not want to repeat the
     //! long type name of time2event
@@ -61,11 +61,13 @@ class StaticMemAllocIntervalMove final : public StaticMemAllocImplHelper {
 
     void do_solve() override;
 
-public:
-    size_t tot_alloc() const override {
+    size_t solved_tot_alloc() const override {
         mgb_assert(m_peak);
         return m_peak;
     }
+
+public:
+    AllocatorAlgo algo() const override { return AllocatorAlgo::INTERVAL_MOVE; }
 };
 
 }  // namespace cg
@@ -27,7 +27,9 @@ class StaticMemAllocPushdown final : public StaticMemAllocImplHelper {
 public:
     void do_solve() override;
 
-    size_t tot_alloc() const override { return m_peak_usage; }
+    size_t solved_tot_alloc() const override { return m_peak_usage; }
+
+    AllocatorAlgo algo() const override { return AllocatorAlgo::PUSHDOWN; }
 };
 
 }  // namespace cg
@@ -0,0 +1,494 @@
+#include "megbrain/utils/mmap_persistent_cache.h"
+#include "megbrain/version.h"
+#include "megdnn/version.h"
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#define MGB_HAVE_MMAP_CACHE 1
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define MGB_HAVE_MMAP_CACHE 0
+#endif
+
+#include <cerrno>
+#include <cstring>
+
+using namespace mgb;
+
+#if MGB_HAVE_MMAP_CACHE
+
+namespace {
+
+constexpr char MAGIC[8] = {'M', 'G', 'B', 'P', 'C', 'M', 'M', '\0'};
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr size_t HEADER_SIZE = 128;
+constexpr size_t MIN_GROW_SIZE = 1024 * 1024;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t nr_bucket;
+    //! end of the last record, which is where next record is appended
+    uint64_t data_end;
+    //! size of the file
+    uint64_t capacity;
+    uint64_t nr_record;
+    uint64_t nr_stale;
+    //! set when the file is replaced by compact()
+    uint32_t obsolete;
+};
+static_assert(sizeof(FileHeader) <= HEADER_SIZE, "header too large");
+
+enum RecordFlag : uint32_t { LIVE = 0, STALE = 1 };
+
+struct RecordHeader {
+    uint64_t next;
+    uint64_t hash;
+    uint32_t version;
+    uint32_t flag;
+    uint32_t category_size;
+    uint32_t key_size;
+    uint32_t value_size;
+    uint32_t pad;
+
+    const uint8_t* category() const {
+        return reinterpret_cast<const uint8_t*>(this + 1);
+    }
+    const uint8_t* key() const { return category() + category_size; }
+    const uint8_t* value() const { return key() + key_size; }
+
+    static size_t record_size(
+            size_t category_size, size_t key_size, size_t value_size) {
+        return (sizeof(RecordHeader) + category_size + key_size + value_size + 7) &
+               ~size_t(7);
+    }
+    size_t record_size() const {
+        return record_size(category_size, key_size, value_size);
+    }
+};
+static_assert(sizeof(RecordHeader) % 8 == 0, "bad record alignment");
+
+uint64_t record_hash(const std::string& category, const PersistentCache::Blob& key) {
+    //! the separator keeps (ab, c) and (a, bc) apart
+    return XXHash{}
+            .update(category.data(), category.size())
+            .update("\0", 1)
+            .update(key.ptr, key.size)
+            .digest();
+}
+
+//! stamp of the MegEngine and MegDNN versions of current binary
+uint32_t version_stamp() {
+    int versions[] = {MGE_MAJOR, MGE_MINOR,    MGE_PATCH,
+                      MGB_IS_DEV, MEGDNN_MAJOR, MEGDNN_MINOR, MEGDNN_PATCH};
+    return static_cast<uint32_t>(XXHash{}.update(versions, sizeof(versions)).digest());
+}
+
+size_t data_begin(uint32_t nr_bucket) {
+    return HEADER_SIZE + sizeof(uint64_t) * nr_bucket;
+}
+
+//! RAII guard of flock(2)
+class FileLock : public NonCopyableObj {
+    int m_fd;
+
+public:
+    FileLock(int fd, int operation) : m_fd{fd} {
+        int ret;
+        do {
+            ret = flock(fd, operation);
+        } while (ret && errno == EINTR);
+        mgb_assert(!ret, "failed to lock cache file: %s", strerror(errno));
+    }
+    ~FileLock() { flock(m_fd, LOCK_UN); }
+};
+
+}  // anonymous namespace
+
+class MmapPersistentCache::Impl {
+    std::string m_path;
+    uint32_t m_init_nr_bucket;
+    uint32_t m_version = version_stamp();
+    int m_fd = -1;
+    uint8_t* m_base = nullptr;
+    size_t m_mapped_size = 0;
+    //! mappings replaced by remap(); kept alive so that blobs returned by get()
+    //! remain valid
+    std::vector<std::pair<uint8_t*, size_t>> m_retired_maps;
+
+    FileHeader* header() const { return reinterpret_cast<FileHeader*>(m_base); }
+
+    uint64_t* buckets() const {
+        return reinterpret_cast<uint64_t*>(m_base + HEADER_SIZE);
+    }
+
+    RecordHeader* record_at(uint64_t offset) const {
+        mgb_assert(
+                offset + sizeof(RecordHeader) <= m_mapped_size,
+                "corrupted cache file %s: record offset %zu out of range %zu",
+                m_path.c_str(), static_cast<size_t>(offset), m_mapped_size);
+        return reinterpret_cast<RecordHeader*>(m_base + offset);
+    }
+
+    void open_file() {
+        m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        mgb_assert(
+                m_fd >= 0, "failed to open %s: %s", m_path.c_str(), strerror(errno));
+        FileLock lock(m_fd, LOCK_EX);
+        struct stat st;
+        mgb_assert(!fstat(m_fd, &st), "failed to stat %s", m_path.c_str());
+        if (!st.st_size) {
+            init_file();
+        } else {
+            FileHeader hdr;
+            mgb_assert(
+                    static_cast<size_t>(st.st_size) >= HEADER_SIZE &&
+                            pread(m_fd, &hdr, sizeof(hdr), 0) ==
+                                    static_cast<ssize_t>(sizeof(hdr)),
+                    "cache file %s too small", m_path.c_str());
+            mgb_assert(
+                    !memcmp(hdr.magic, MAGIC, sizeof(MAGIC)) &&
+                            hdr.format_version == FORMAT_VERSION,
+                    "%s is not a mmap persistent cache of format version %u",
+                    m_path.c_str(), FORMAT_VERSION);
+        }
+        remap();
+    }
+
+    void init_file() {
+        size_t capacity = data_begin(m_init_nr_bucket) + MIN_GROW_SIZE;
+        mgb_assert(
+                !ftruncate(m_fd, capacity), "failed to resize %s: %s",
+                m_path.c_str(), strerror(errno));
+        FileHeader hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, MAGIC, sizeof(MAGIC));
+        hdr.format_version = FORMAT_VERSION;
+        hdr.nr_bucket = m_init_nr_bucket;
+        hdr.data_end = data_begin(m_init_nr_bucket);
+        hdr.capacity = capacity;
+        //! buckets are zero filled by ftruncate
+        mgb_assert(
+                pwrite(m_fd, &hdr, sizeof(hdr), 0) ==
+                        static_cast<ssize_t>(sizeof(hdr)),
+                "failed to write %s: %s", m_path.c_str(), strerror(errno));
+    }
+
+    void close_file() {
+        if (m_base) {
+            m_retired_maps.emplace_back(m_base, m_mapped_size);
+            m_base = nullptr;
+            m_mapped_size = 0;
+        }
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    //! map the whole file, must be called with file locked
+    void remap() {
+        struct stat st;
+        mgb_assert(!fstat(m_fd, &st), "failed to stat %s", m_path.c_str());
+        size_t size = st.st_size;
+        if (m_base && size == m_mapped_size) {
+            return;
+        }
+        auto ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        mgb_assert(
+                ptr != MAP_FAILED, "failed to mmap %s: %s", m_path.c_str(),
+                strerror(errno));
+        if (m_base) {
+            m_retired_maps.emplace_back(m_base, m_mapped_size);
+        }
+        m_base = static_cast<uint8_t*>(ptr);
+        m_mapped_size = size;
+    }
+
+    /*!
+     * \brief make sure current mapping is up to date: reopen the file if it
+     *      has been replaced by compact() in some process, and remap if it
+     *      has been grown
+     *
+     * \return the lock acquired on the up to date file
+     */
+    std::unique_ptr<FileLock> sync(int operation) {
+        for (;;) {
+            auto lock = std::make_unique<FileLock>(m_fd, operation);
+            if (header()->obsolete) {
+                lock.reset();
+                close_file();
+                open_file();
+                continue;
+            }
+            if (header()->capacity != m_mapped_size) {
+                remap();
+            }
+            return lock;
+        }
+    }
+
+    bool match(
+            const RecordHeader* rec, uint64_t hash, const std::string& category,
+            const Blob& key) const {
+        return rec->hash == hash && rec->flag == LIVE && rec->version == m_version &&
+               rec->category_size == category.size() && rec->key_size == key.size &&
+               !memcmp(rec->category(), category.data(), category.size()) &&
+               !memcmp(rec->key(), key.ptr, key.size);
+    }
+
+    RecordHeader* find(uint64_t hash, const std::string& category, const Blob& key) {
+        auto offset = buckets()[hash & (header()->nr_bucket - 1)];
+        while (offset) {
+            auto rec = record_at(offset);
+            if (match(rec, hash, category, key)) {
+                return rec;
+            }
+            offset = rec->next;
+        }
+        return nullptr;
+    }
+
+    //! grow the file to hold at least \p size bytes
+    void reserve(size_t size) {
+        auto hdr = header();
+        if (size <= hdr->capacity) {
+            return;
+        }
+        size_t capacity = std::max<size_t>(
+                std::max<size_t>(hdr->capacity * 2, size),
+                hdr->capacity + MIN_GROW_SIZE);
+        mgb_assert(
+                !ftruncate(m_fd, capacity), "failed to resize %s: %s",
+                m_path.c_str(), strerror(errno));
+        hdr->capacity = capacity;
+        remap();
+    }
+
+    template <typename Func>
+    void foreach_record(Func&& func) {
+        auto end = header()->data_end;
+        for (uint64_t offset = data_begin(header()->nr_bucket); offset < end;) {
+            auto rec = record_at(offset);
+            func(rec);
+            offset += rec->record_size();
+        }
+    }
+
+public:
+    MGB_MUTEX mtx;
+
+    Impl(const char* path, size_t nr_bucket)
+            : m_path{path}, m_init_nr_bucket(nr_bucket) {
+        mgb_assert(
+                nr_bucket && !(nr_bucket & (nr_bucket - 1)),
+                "nr_bucket must be power of 2, got %zu", nr_bucket);
+        open_file();
+    }
+
+    ~Impl() {
+        close_file();
+        for (auto&& i : m_retired_maps) {
+            munmap(i.first, i.second);
+        }
+    }
+
+    Maybe<Blob> get(const std::string& category, const Blob& key) {
+        auto lock = sync(LOCK_SH);
+        auto rec = find(record_hash(category, key), category, key);
+        if (!rec) {
+            return None;
+        }
+        return Blob{rec->value(), rec->value_size};
+    }
+
+    void put(const std::string& category, const Blob& key, const Blob& value) {
+        auto lock = sync(LOCK_EX);
+        auto hash = record_hash(category, key);
+        if (auto rec = find(hash, category, key)) {
+            //! another process may have put the same value already
+            if (rec->value_size == value.size &&
+                !memcmp(rec->value(), value.ptr, value.size)) {
+                return;
+            }
+        }
+
+        size_t rec_size =
+                RecordHeader::record_size(category.size(), key.size, value.size);
+        uint64_t offset = header()->data_end;
+        reserve(offset + rec_size);
+
+        //! remap may happen in reserve, so find old record after it
+        auto old = find(hash, category, key);
+        auto&& bucket = buckets()[hash & (header()->nr_bucket - 1)];
+        auto rec = record_at(offset);
+        rec->next = bucket;
+        rec->hash = hash;
+        rec->version = m_version;
+        rec->flag = LIVE;
+        rec->category_size = category.size();
+        rec->key_size = key.size;
+        rec->value_size = value.size;
+        rec->pad = 0;
+        memcpy(const_cast<uint8_t*>(rec->category()), category.data(), category.size());
+        memcpy(const_cast<uint8_t*>(rec->key()), key.ptr, key.size);
+        memcpy(const_cast<uint8_t*>(rec->value()), value.ptr, value.size);
+
+        //! publish the record after it is fully written
+        bucket = offset;
+        auto hdr = header();
+        hdr->data_end = offset + rec_size;
+        ++hdr->nr_record;
+        if (old) {
+            old->flag = STALE;
+            ++hdr->nr_stale;
+        }
+    }
+
+    size_t invalidate(const std::string& category) {
+        auto lock = sync(LOCK_EX);
+        size_t cnt = 0;
+        foreach_record([&](RecordHeader* rec) {
+            if (rec->flag == LIVE && rec->category_size == category.size() &&
+                !memcmp(rec->category(), category.data(), category.size())) {
+                rec->flag = STALE;
+                ++cnt;
+            }
+        });
+        header()->nr_stale += cnt;
+        return cnt;
+    }
+
+    void compact() {
+        auto lock = sync(LOCK_EX);
+        auto nr_bucket = header()->nr_bucket;
+
+        std::vector<uint8_t> buf(data_begin(nr_bucket), 0);
+        uint64_t nr_record = 0;
+        foreach_record([&](RecordHeader* rec) {
+            if (rec->flag != LIVE || rec->version != m_version) {
+                return;
+            }
+            auto size = rec->record_size();
+            auto offset = buf.size();
+            buf.resize(offset + size);
+            memcpy(buf.data() + offset, rec, size);
+            auto bucket = reinterpret_cast<uint64_t*>(buf.data() + HEADER_SIZE) +
+                          (rec->hash & (nr_bucket - 1));
+            //! records are visited from old to new, so the newest one ends up
+            //! at the head of the chain
+            reinterpret_cast<RecordHeader*>(buf.data() + offset)->next = *bucket;
+            *bucket = offset;
+            ++nr_record;
+        });
+        size_t data_end = buf.size();
+        size_t capacity = data_end + MIN_GROW_SIZE;
+        buf.resize(capacity, 0);
+        auto hdr = reinterpret_cast<FileHeader*>(buf.data());
+        memcpy(hdr->magic, MAGIC, sizeof(MAGIC));
+        hdr->format_version = FORMAT_VERSION;
+        hdr->nr_bucket = nr_bucket;
+        hdr->data_end = data_end;
+        hdr->capacity = capacity;
+        hdr->nr_record = nr_record;
+        hdr->nr_stale = 0;
+        hdr->obsolete = 0;
+
+        auto tmp_path = ssprintf("%s.compact.%d", m_path.c_str(), getpid());
+        int fd = ::open(
+                tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        mgb_assert(
+                fd >= 0, "failed to open %s: %s", tmp_path.c_str(), strerror(errno));
+        size_t written = 0;
+        while (written < buf.size()) {
+            auto ret = ::write(fd, buf.data() + written, buf.size() - written);
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+            mgb_assert(
+                    ret > 0, "failed to write %s: %s", tmp_path.c_str(),
+                    strerror(errno));
+            written += ret;
+        }
+        fsync(fd);
+        ::close(fd);
+        mgb_assert(
+                !rename(tmp_path.c_str(), m_path.c_str()), "failed to replace %s: %s",
+                m_path.c_str(), strerror(errno));
+
+        //! processes still using the old file switch to the new one on their
+        //! next access
+        header()->obsolete = 1;
+        lock.reset();
+        close_file();
+        open_file();
+        mgb_log_debug(
+                "compact cache file %s: %zu records kept", m_path.c_str(),
+                static_cast<size_t>(nr_record));
+    }
+
+    Stat stat() {
+        auto lock = sync(LOCK_SH);
+        auto hdr = header();
+        return {static_cast<size_t>(hdr->nr_record), static_cast<size_t>(hdr->nr_stale),
+                static_cast<size_t>(hdr->data_end)};
+    }
+};
+
+#else
+
+class MmapPersistentCache::Impl {
+public:
+    MGB_MUTEX mtx;
+
+    Impl(const char*, size_t) {
+        mgb_throw(
+                MegBrainError,
+                "MmapPersistentCache is not supported on this platform");
+    }
+
+    Maybe<Blob> get(const std::string&, const Blob&) { return None; }
+    void put(const std::string&, const Blob&, const Blob&) {}
+    size_t invalidate(const std::string&) { return 0; }
+    void compact() {}
+    Stat stat() { return {0, 0, 0}; }
+};
+
+#endif
+
+MmapPersistentCache::MmapPersistentCache(const char* path, size_t nr_bucket)
+        : m_impl{std::make_unique<Impl>(path, nr_bucket)} {}
+
+MmapPersistentCache::~MmapPersistentCache() noexcept = default;
+
+Maybe<PersistentCache::Blob> MmapPersistentCache::get(
+        const std::string& category, const Blob& key) {
+    MGB_LOCK_GUARD(m_impl->mtx);
+    return m_impl->get(category, key);
+}
+
+void MmapPersistentCache::put(
+        const std::string& category, const Blob& key, const Blob& value) {
+    MGB_LOCK_GUARD(m_impl->mtx);
+    m_impl->put(category, key, value);
+}
+
+void MmapPersistentCache::compact() {
+    MGB_LOCK_GUARD(m_impl->mtx);
+    m_impl->compact();
+}
+
+size_t MmapPersistentCache::invalidate(const std::string& category) {
+    MGB_LOCK_GUARD(m_impl->mtx);
+    return m_impl->invalidate(category);
+}
+
+MmapPersistentCache::Stat MmapPersistentCache::stat() {
+    MGB_LOCK_GUARD(m_impl->mtx);
+    return m_impl->stat();
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
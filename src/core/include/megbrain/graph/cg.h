@@ -91,6 +91,22 @@ struct GraphCommonOptimizeOptions {
     bool weight_preprocess = false;
     //! fuse preprocess patten, like astype + pad_channel + dimshuffle
     bool fuse_preprocess = false;
+    //! whether to quantize the constant float32 weights of matrix muls on cpu
+    //! to weight_quant_bits, keeping the activations in float32
+    bool weight_quant = false;
+    //! bits of the quantized weights, 8 or 4
+    uint32_t weight_quant_bits = 8;
+    //! number of weights along k sharing a scale, 0 for per output channel
+    uint32_t weight_quant_group_size = 0;
+    //! whether to compute the float32 matrix muls and convolutions on cpu with
+    //! bfloat16 inputs, accumulating in float32
+    bool bf16_f32_comp = false;
+    //! whether to fuse the channel-wise conv bias and the 1x1 conv bias after
+    //! it on cpu, so the output of the channel-wise conv stays in cache
+    bool fuse_depthwise_pointwise_conv = false;
+    //! whether to fuse the conv bias and the 2x2 or 3x3 pooling after it on
+    //! cpu, so the output of the conv is pooled while it is in cache
+    bool fuse_conv_bias_pooling = false;
     enum LayoutTransform : uint32_t {
         DEFAULT,
         NCHW4,       ///< compute using NCHW4 tensor format
@@ -124,6 +140,10 @@ struct GraphCommonOptimizeOptions {
     SET(fuse_conv_bias_with_z);
     SET(fuse_preprocess);
     SET(weight_preprocess);
+    SET(weight_quant);
+    SET(bf16_f32_comp);
+    SET(fuse_depthwise_pointwise_conv);
+    SET(fuse_conv_bias_pooling);
 #undef SET
 #define SET(_trans, _trans_capital)                                 \
     GraphCommonOptimizeOptions& enable_##_trans() {                 \
@@ -316,6 +336,12 @@ public:
             //! whether to enable comp node optimization (e.g. using copy
             //! stream for I/O operators)
             bool enable_seq_comp_node_opt = true;
+
+            //! whether to keep the static memory offsets of chunks whose size
+            //! and lifetime are unchanged when re-planning after shape
+            //! changes; only the affected chunks are placed, and a full plan
+            //! is computed if the result uses too much memory
+            bool enable_incremental_mem_plan = false;
         } seq_opt;
 
         //! graph optimization options
@@ -570,6 +596,19 @@ public:
      */
     virtual void share_device_memory_with(ComputingGraph& other) = 0;
 
+    /*!
+     * \brief share static device memory with all the graphs in this process
+     *      that use the arena with the same name
+     *
+     * The arena keeps one buffer on each comp node, sized to the max static
+     * memory usage of the graphs using it. This is intended for hosting many
+     * models that are executed in turn, e.g. on the same worker thread.
+     *
+     * This method must be called before compiling. Executing graphs that
+     * share an arena concurrently is an error.
+     */
+    virtual void share_device_memory_with_arena(const std::string& name) = 0;
+
     /*!
      * \brief set a custom DeviceMemoryAllocator to be used
      *
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "megbrain/utils/persistent_cache.h"
+
+namespace mgb {
+
+/**
+ * \brief persistent cache backed by an append-only, hash indexed file mapped
+ *      into memory, so that concurrent processes on one host can read and
+ *      extend a common cache without loading it all
+ *
+ * file format (all integers in local endian):
+ *
+ * <header|128 bytes><bucket|uint64_t * nr_bucket><record>*
+ *
+ * record:
+ * <next|uint64_t><hash|uint64_t><version|uint32_t><flag|uint32_t>
+ *  <category_size|uint32_t><key_size|uint32_t><value_size|uint32_t><pad|uint32_t>
+ *  <category|uint8_t*><key|uint8_t*><value|uint8_t*> padded to 8 bytes
+ *
+ * Each bucket holds the offset of the newest record whose hash falls into it,
+ * and records in the same bucket are chained by \c next, so a lookup walks a
+ * single chain and returns a pointer into the mapped file without any
+ * deserialization. Records are only appended; putting an existing key appends
+ * a new record and marks the old one stale.
+ *
+ * Writers hold an exclusive flock(2) on the file and readers a shared one.
+ * Every record is stamped with the MegEngine and MegDNN versions; records of
+ * other versions are ignored on lookup and dropped by compact().
+ *
+ * Blobs returned by get() stay valid until this object is destroyed, even if
+ * the file is grown or compacted meanwhile.
+ *
+ * \warning only available on POSIX systems
+ */
+class MmapPersistentCache final : public PersistentCache {
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+
+public:
+    struct Stat {
+        size_t nr_record;  //!< number of records in file, including stale ones
+        size_t nr_stale;   //!< number of stale records
+        //! bytes used by the header, buckets and records; the file itself is
+        //! larger, since space is preallocated for appending
+        size_t file_size;
+    };
+
+    /*!
+     * \param path path of the cache file, created if it does not exist
+     * \param nr_bucket number of hash buckets used when creating a new file,
+     *      must be power of 2; ignored for existing files
+     */
+    MGE_WIN_DECLSPEC_FUC explicit MmapPersistentCache(
+            const char* path, size_t nr_bucket = 4096);
+    MGE_WIN_DECLSPEC_FUC ~MmapPersistentCache() noexcept;
+
+    MGE_WIN_DECLSPEC_FUC Maybe<Blob> get(
+            const std::string& category, const Blob& key) override;
+    MGE_WIN_DECLSPEC_FUC void put(
+            const std::string& category, const Blob& key, const Blob& value) override;
+
+    //! rewrite the file with only live records of current version; other
+    //! processes switch to the new file on their next access
+    MGE_WIN_DECLSPEC_FUC void compact();
+
+    //! mark all records in given category stale, return number of records
+    //! invalidated
+    MGE_WIN_DECLSPEC_FUC size_t invalidate(const std::string& category);
+
+    MGE_WIN_DECLSPEC_FUC Stat stat();
+};
+
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
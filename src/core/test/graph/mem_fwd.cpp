@@ -123,6 +123,53 @@ TEST(TestGraph, ShareDevMem) {
     run(true);
 }
 
+TEST(TestGraph, ShareDevMemArena) {
+    HostTensorGenerator<> gen;
+    auto host_x0 = gen({1234}), host_x1 = gen({4321});
+
+    auto make_graph = [&](std::shared_ptr<HostTensorND> host_x) {
+        auto graph = ComputingGraph::make();
+        graph->share_device_memory_with_arena("test_share_dev_mem_arena");
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x), y = x + 1;
+        return std::make_pair(graph, y);
+    };
+
+    HostTensorND host_y0, host_y1;
+    auto g0 = make_graph(host_x0), g1 = make_graph(host_x1);
+    auto f0 = g0.first->compile({make_callback_copy(g0.second, host_y0)});
+    auto f1 = g1.first->compile({make_callback_copy(g1.second, host_y1)});
+    f0->execute().wait();
+    f1->execute().wait();
+
+    // the arena has grown for g1, and g0 should switch to the new storage
+    f0->execute().wait();
+    ASSERT_EQ(dev_ptr(g0.second), dev_ptr(g1.second));
+    auto cn = g0.second.node()->comp_node();
+    ASSERT_EQ(
+            g1.first->get_device_memory_size(cn),
+            g0.first->get_device_memory_size(cn));
+    ASSERT_GE(
+            g0.first->get_device_memory_size(cn),
+            host_x1->layout().span().dist_byte());
+
+    auto px0 = host_x0->ptr<float>(), py0 = host_y0.ptr<float>();
+    for (size_t i = 0; i < 1234; ++i) {
+        MGB_ASSERT_FLOAT_EQ(px0[i] + 1, py0[i]);
+    }
+    auto px1 = host_x1->ptr<float>(), py1 = host_y1.ptr<float>();
+    for (size_t i = 0; i < 4321; ++i) {
+        MGB_ASSERT_FLOAT_EQ(px1[i] + 1, py1[i]);
+    }
+
+    // graphs in other arenas do not share memory
+    auto g2 = make_graph(host_x0);
+    g2.first->share_device_memory_with_arena("test_share_dev_mem_arena_other");
+    HostTensorND host_y2;
+    g2.first->compile({make_callback_copy(g2.second, host_y2)})->execute().wait();
+    ASSERT_NE(dev_ptr(g0.second), dev_ptr(g2.second));
+    MGB_ASSERT_TENSOR_EQ(host_y0, host_y2);
+}
+
 TEST(TestGraph, MemFwd0) {
     HostTensorGenerator<> gen;
     auto host_x = gen({3000, 300});
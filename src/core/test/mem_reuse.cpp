@@ -315,4 +315,54 @@ TEST(TestMemReuse, FwdNoSysMemAlloc) {
     }
 }
 
+TEST(TestMemReuse, IncrementalMemPlan) {
+    HostTensorGenerator<> gen;
+    auto host_a = gen({8, 16}), host_b = gen({8, 16}), host_w = gen({16, 16});
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    graph->options().seq_opt.enable_incremental_mem_plan = true;
+    auto a = opr::Host2DeviceCopy::make(*graph, host_a),
+         b = opr::Host2DeviceCopy::make(*graph, host_b),
+         w = opr::SharedDeviceTensor::make(*graph, *host_w);
+    SymbolVar a_chain[3], b_chain[3];
+    for (int i = 0; i < 3; ++i) {
+        a_chain[i] = opr::MatrixMul::make(i ? a_chain[i - 1] : a, w);
+        b_chain[i] = opr::MatrixMul::make(i ? b_chain[i - 1] : b, w);
+    }
+    HostTensorND host_ya, host_yb;
+    auto func = graph->compile(
+            {make_callback_copy(a_chain[2], host_ya),
+             make_callback_copy(b_chain[2], host_yb)});
+
+    // offsets of the b chain relative to its first var
+    auto get_b_offsets = [&]() {
+        std::vector<ptrdiff_t> ret;
+        auto base = static_cast<const dt_byte*>(prev_dev_ptr(b_chain[0]));
+        for (int i = 1; i < 3; ++i) {
+            ret.push_back(
+                    static_cast<const dt_byte*>(prev_dev_ptr(b_chain[i])) - base);
+        }
+        return ret;
+    };
+
+    func->execute();
+    auto offsets = get_b_offsets();
+    HostTensorND expect_yb;
+    expect_yb.copy_from(host_yb);
+
+    // only the a chain is affected by the shape change
+    host_a->copy_from(*gen({32, 16}));
+    func->execute();
+    ASSERT_EQ(offsets, get_b_offsets());
+    ASSERT_EQ(TensorShape({32, 16}), host_ya.shape());
+    MGB_ASSERT_TENSOR_EQ(expect_yb, host_yb);
+
+    // shrinking back re-plans the a chain again
+    host_a->copy_from(*gen({4, 16}));
+    func->execute();
+    ASSERT_EQ(offsets, get_b_offsets());
+    ASSERT_EQ(TensorShape({4, 16}), host_ya.shape());
+    MGB_ASSERT_TENSOR_EQ(expect_yb, host_yb);
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -1,4 +1,8 @@
 #include "../impl/graph/var_node_mem_mgr/static_mem_alloc.h"
+#include "megbrain/opr/basic_arith_wrapper.h"
+#include "megbrain/opr/dnn/convolution.h"
+#include "megbrain/opr/io.h"
+#include "megbrain/opr/tensor_manip.h"
 #include "megbrain/test/helper.h"
 #include "megbrain/utils/arith_helper.h"
 #include "megbrain/utils/timer.h"
@@ -13,7 +17,8 @@ using namespace cg;
         "static_mem_alloc disabled because it causes the program to crash at startup"
 #else
 
-#define ITER_ALGO(cb) cb(INTERVAL_MOVE) cb(BEST_FIT) cb(PUSHDOWN)
+#define ITER_ALGO(cb) \
+    cb(INTERVAL_MOVE) cb(BEST_FIT) cb(PUSHDOWN) cb(GREEDY_BY_SIZE) cb(BEST_OF)
 
 namespace {
 
@@ -222,6 +227,165 @@ TEST(TestStaticMemAllocAlgo, PushdownChain) {
     ASSERT_EQ(NR + NR - 1, allocator->tot_alloc());
 }
 
+TEST(TestStaticMemAllocAlgo, GreedyBySizeGap) {
+    // id 2 should reuse the memory of id 0 after it is freed
+    auto allocator =
+            StaticMemAlloc::make(StaticMemAlloc::AllocatorAlgo::GREEDY_BY_SIZE);
+    allocator->add(0, 2, 4, makeuk(0));
+    allocator->add(0, 4, 8, makeuk(1));
+    allocator->add(2, 4, 3, makeuk(2));
+    allocator->add(1, 4, 1, makeuk(3));
+    allocator->solve();
+    ASSERT_EQ(13u, allocator->tot_alloc_lower_bound());
+    ASSERT_EQ(13u, allocator->tot_alloc());
+}
+
+TEST(TestStaticMemAllocAlgo, GreedyBySizeAddrHint) {
+    auto run = [](size_t hint3) {
+        auto allocator =
+                StaticMemAlloc::make(StaticMemAlloc::AllocatorAlgo::GREEDY_BY_SIZE);
+        auto id0 = allocator->add(0, 2, 4, makeuk(0));
+        auto id1 = allocator->add(0, 4, 8, makeuk(1));
+        allocator->add(2, 4, 3, makeuk(2));
+        auto id3 = allocator->add(1, 4, 1, makeuk(3));
+        allocator->addr_hint(id0, 8).addr_hint(id1, 0).addr_hint(id3, hint3);
+        allocator->solve();
+        std::vector<size_t> addr;
+        for (int i = 0; i < 4; ++i) {
+            addr.push_back(allocator->get_start_addr(makeuk(i)));
+        }
+        return std::make_pair(allocator->tot_alloc(), addr);
+    };
+
+    // hinted intervals are kept, and the new one reuses the memory of id 0
+    auto r0 = run(12);
+    ASSERT_EQ(13u, r0.first);
+    ASSERT_EQ((std::vector<size_t>{8, 0, 8, 12}), r0.second);
+
+    // conflicting hint of id 3 is ignored
+    auto r1 = run(4);
+    ASSERT_EQ(8u, r1.second[0]);
+    ASSERT_EQ(0u, r1.second[1]);
+    ASSERT_NE(4u, r1.second[3]);
+}
+
+TEST(TestStaticMemAllocAlgo, PlanCache) {
+    auto run = [](StaticMemAlloc::AllocatorAlgo algo, bool enable_cache) {
+        auto allocator = StaticMemAlloc::make(algo);
+        allocator->alignment(4).enable_plan_cache(enable_cache);
+        auto id0 = allocator->add(0, 2, 5, makeuk(0));
+        auto id1 = allocator->add(1, 3, 3, makeuk(1));
+        allocator->add(0, 3, 7, makeuk(2));
+        allocator->add(2, 5, 9, makeuk(3));
+        allocator->add_overwrite_spec(id1, id0, 2);
+        allocator->solve();
+        std::vector<size_t> addr;
+        for (int i = 0; i < 4; ++i) {
+            addr.push_back(allocator->get_start_addr(makeuk(i)));
+        }
+        return std::make_tuple(
+                allocator->plan_cache_hit(), allocator->tot_alloc(), addr);
+    };
+    using Algo = StaticMemAlloc::AllocatorAlgo;
+    auto r0 = run(Algo::BEST_OF, true), r1 = run(Algo::BEST_OF, true),
+         r2 = run(Algo::BEST_OF, false), r3 = run(Algo::PUSHDOWN, true);
+    ASSERT_TRUE(std::get<0>(r1));
+    ASSERT_FALSE(std::get<0>(r2));
+    // the plan of other algorithms should not be reused
+    ASSERT_FALSE(std::get<0>(r3));
+    ASSERT_EQ(std::get<1>(r0), std::get<1>(r1));
+    ASSERT_EQ(std::get<2>(r0), std::get<2>(r1));
+    ASSERT_EQ(std::get<1>(r0), std::get<1>(r2));
+}
+
+/*!
+ * record the static memory plan of a real graph by StaticMemRecorder, and
+ * replay it on all the algorithms to compare their peak memory and solve time
+ */
+TEST(TestStaticMemAllocAlgo, BenchmarkRecordedPlan) {
+    using Algo = StaticMemAlloc::AllocatorAlgo;
+    using ChunkRecord = StaticMemRecorder::memory_chunk_record;
+
+    // a resnet-like graph with branches
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    auto mkcvar = [&](const TensorShape& shp, const char* name) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+    constexpr size_t NR_BLOCK = 16, C = 8;
+    auto x = opr::Host2DeviceCopy::make(*graph, gen({2, C, 32, 32}, cn));
+    opr::Convolution::Param pad1;
+    pad1.pad_h = pad1.pad_w = 1;
+    SymbolVarArray branches;
+    for (size_t i = 0; i < NR_BLOCK; ++i) {
+        auto y = opr::relu(opr::Convolution::make(
+                x, mkcvar({C, C, 3, 3}, "k0"), pad1));
+        y = opr::Convolution::make(y, mkcvar({C, C, 3, 3}, "k1"), pad1);
+        x = opr::relu(x + y);
+        if (i % 4 == 3) {
+            branches.push_back(opr::Convolution::make(x, mkcvar({C, C, 1, 1}, "k2")));
+        }
+    }
+    auto out = opr::Concat::make(branches, 1);
+
+    auto&& recorder = StaticMemRecorder::Instance();
+    recorder.active();
+    graph->options().allocate_static_mem_after_graph_compile = true;
+    graph->options().graph_opt_level = 0;
+    graph->compile({{out, [](DeviceTensorND&) {}}});
+    recorder.deactive();
+    std::vector<ChunkRecord> chunks = recorder.memory_chunk();
+    recorder.clear_memory_chunk();
+    ASSERT_GT(chunks.size(), NR_BLOCK);
+
+    // the recorder only keeps the overwrite root, so find the interval that
+    // is directly overwritten
+    auto find_overwrite_dest = [&](const ChunkRecord& src) -> const ChunkRecord* {
+        auto root = src.overwrite_dest_id;
+        for (auto&& i : chunks) {
+            if ((i.id == root || (i.is_overwrite && i.overwrite_dest_id == root)) &&
+                i.time_end == src.time_begin + 1 && i.addr_begin <= src.addr_begin &&
+                src.addr_end <= i.addr_end) {
+                return &i;
+            }
+        }
+        return nullptr;
+    };
+
+    size_t best_peak = std::numeric_limits<size_t>::max(), best_of_peak = 0;
+    auto run = [&](Algo algo, const char* name) {
+        auto allocator = StaticMemAlloc::make(algo);
+        allocator->alignment(cn.get_mem_addr_alignment()).enable_plan_cache(false);
+        for (auto&& i : chunks) {
+            allocator->add(i.time_begin, i.time_end, i.size_orig, makeuk(i.id));
+        }
+        for (auto&& i : chunks) {
+            if (i.is_overwrite) {
+                auto dest = find_overwrite_dest(i);
+                mgb_assert(dest);
+                allocator->add_overwrite_spec(
+                        i.id, dest->id, i.addr_begin - dest->addr_begin);
+            }
+        }
+        RealTimer timer;
+        allocator->solve();
+        auto time = timer.get_secs();
+        auto peak = allocator->tot_alloc(), lb = allocator->tot_alloc_lower_bound();
+        mgb_log("%s: nr_interval=%zu time=%.3fms peak/lower_bound=%zu/%zu=%.3f", name,
+                chunks.size(), time * 1e3, peak, lb, double(peak) / lb);
+        if (algo == Algo::BEST_OF) {
+            best_of_peak = peak;
+        } else {
+            best_peak = std::min(best_peak, peak);
+        }
+    };
+#define cb(_algo) run(Algo::_algo, #_algo);
+    ITER_ALGO(cb)
+#undef cb
+    ASSERT_EQ(best_peak, best_of_peak);
+}
+
 #endif  // WIN32
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
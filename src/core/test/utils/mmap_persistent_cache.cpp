@@ -0,0 +1,138 @@
+#include "megbrain/utils/mmap_persistent_cache.h"
+#include "megbrain/test/helper.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+
+using namespace mgb;
+
+namespace {
+using Blob = PersistentCache::Blob;
+
+Blob make_blob(const std::string& str) {
+    return {str.data(), str.size()};
+}
+
+std::string to_str(const Maybe<Blob>& blob) {
+    mgb_assert(blob.valid());
+    return {static_cast<const char*>(blob->ptr), blob->size};
+}
+
+std::string cache_file(const char* name) {
+    auto path = output_file(name);
+    std::remove(path.c_str());
+    return path;
+}
+}  // anonymous namespace
+
+TEST(TestMmapPersistentCache, PutGet) {
+    auto path = cache_file("mmap_cache_put_get");
+    MmapPersistentCache cache{path.c_str(), 4};
+    ASSERT_FALSE(cache.get("cat", make_blob("k0")).valid());
+
+    //! more records than buckets to exercise chaining
+    for (int i = 0; i < 64; ++i) {
+        cache.put("cat", make_blob(ssprintf("k%d", i)), make_blob(ssprintf("v%d", i)));
+    }
+    for (int i = 0; i < 64; ++i) {
+        auto val = cache.get("cat", make_blob(ssprintf("k%d", i)));
+        ASSERT_EQ(ssprintf("v%d", i), to_str(val));
+    }
+    ASSERT_FALSE(cache.get("other", make_blob("k0")).valid());
+    //! category and key must not be concatenated ambiguously
+    ASSERT_FALSE(cache.get("catk", make_blob("0")).valid());
+
+    cache.put("cat", make_blob("k0"), make_blob("new"));
+    ASSERT_EQ("new", to_str(cache.get("cat", make_blob("k0"))));
+    auto stat = cache.stat();
+    ASSERT_EQ(65u, stat.nr_record);
+    ASSERT_EQ(1u, stat.nr_stale);
+
+    //! putting an identical value should not append
+    cache.put("cat", make_blob("k0"), make_blob("new"));
+    ASSERT_EQ(65u, cache.stat().nr_record);
+    ASSERT_EQ(stat.file_size, cache.stat().file_size);
+}
+
+TEST(TestMmapPersistentCache, Grow) {
+    auto path = cache_file("mmap_cache_grow");
+    MmapPersistentCache cache{path.c_str()};
+    std::string big(3 * 1024 * 1024, 'x');
+    cache.put("cat", make_blob("small"), make_blob("v"));
+    auto small = cache.get("cat", make_blob("small"));
+    cache.put("cat", make_blob("big"), make_blob(big));
+    ASSERT_EQ(big, to_str(cache.get("cat", make_blob("big"))));
+    auto size = cache.stat().file_size;
+    ASSERT_GE(size, big.size());
+    //! only the space taken by records is reported, not the preallocated one
+    ASSERT_LT(size, big.size() + 64 * 1024);
+    //! blob returned before growing should still be valid
+    ASSERT_EQ("v", to_str(small));
+}
+
+TEST(TestMmapPersistentCache, Reopen) {
+    auto path = cache_file("mmap_cache_reopen");
+    {
+        MmapPersistentCache cache{path.c_str()};
+        cache.put("cat", make_blob("key"), make_blob("value"));
+    }
+    MmapPersistentCache cache{path.c_str()};
+    ASSERT_EQ("value", to_str(cache.get("cat", make_blob("key"))));
+}
+
+TEST(TestMmapPersistentCache, SharedFile) {
+    auto path = cache_file("mmap_cache_shared");
+    MmapPersistentCache c0{path.c_str()}, c1{path.c_str()};
+    c0.put("cat", make_blob("a"), make_blob("0"));
+    ASSERT_EQ("0", to_str(c1.get("cat", make_blob("a"))));
+    c1.put("cat", make_blob("a"), make_blob("1"));
+    ASSERT_EQ("1", to_str(c0.get("cat", make_blob("a"))));
+
+    //! the file is replaced by compact(), and the other instance should
+    //! follow it
+    c0.compact();
+    ASSERT_EQ("1", to_str(c1.get("cat", make_blob("a"))));
+    c1.put("cat", make_blob("b"), make_blob("2"));
+    ASSERT_EQ("2", to_str(c0.get("cat", make_blob("b"))));
+}
+
+TEST(TestMmapPersistentCache, InvalidateCompact) {
+    auto path = cache_file("mmap_cache_compact");
+    MmapPersistentCache cache{path.c_str()};
+    for (int i = 0; i < 8; ++i) {
+        cache.put("c0", make_blob(ssprintf("k%d", i)), make_blob("v"));
+        cache.put("c1", make_blob(ssprintf("k%d", i)), make_blob("v"));
+    }
+    auto before = cache.get("c1", make_blob("k0"));
+    ASSERT_EQ(8u, cache.invalidate("c0"));
+    ASSERT_FALSE(cache.get("c0", make_blob("k0")).valid());
+    auto stat = cache.stat();
+    ASSERT_EQ(8u, stat.nr_stale);
+
+    cache.compact();
+    auto size = stat.file_size;
+    stat = cache.stat();
+    ASSERT_EQ(8u, stat.nr_record);
+    ASSERT_EQ(0u, stat.nr_stale);
+    ASSERT_LT(stat.file_size, size);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_FALSE(cache.get("c0", make_blob(ssprintf("k%d", i))).valid());
+        ASSERT_EQ("v", to_str(cache.get("c1", make_blob(ssprintf("k%d", i)))));
+    }
+    ASSERT_EQ("v", to_str(before));
+}
+
+TEST(TestMmapPersistentCache, AsGlobalCache) {
+    auto path = cache_file("mmap_cache_global");
+    auto old = PersistentCache::set_impl(
+            std::make_shared<MmapPersistentCache>(path.c_str()));
+    PersistentCache::inst().put("cat", make_blob("k"), make_blob("v"));
+    ASSERT_EQ("v", to_str(PersistentCache::inst().get("cat", make_blob("k"))));
+    PersistentCache::set_impl(old);
+}
+
+#endif
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
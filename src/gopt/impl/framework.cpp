@@ -729,6 +729,10 @@ const GraphOptimizer& GraphOptimizer::add_passes_for_optimize_options(
     });
     cb(f16_io_comp, { add_pass(ConvertF32ToF16Pass::make(false)); });
     cb(f16_io_f32_comp, { add_pass(ConvertF32ToF16Pass::make(true)); });
+    cb(weight_quant, {
+        add_pass<ConvertWeightQuantMatrixMulPass>(
+                options.weight_quant_bits, options.weight_quant_group_size);
+    });
 
     cb(nchw4, {
         add_pass<FuseConvBiasNonlinPass>();
@@ -796,6 +800,16 @@ const GraphOptimizer& GraphOptimizer::add_passes_for_optimize_options(
         add_pass<FuseConvBiasNonlinPass>();
         add_pass<FuseConvBiasZPass>();
     });
+    cb(fuse_depthwise_pointwise_conv, {
+        add_pass<FuseConvBiasNonlinPass>();
+        add_pass<FuseDepthwisePointwiseConvBiasPass>();
+    });
+    cb(fuse_conv_bias_pooling, {
+        add_pass<FuseConvBiasNonlinPass>();
+        add_pass<FuseConvBiasPoolingPass>();
+    });
+    //! after the fusions, so that the fused conv bias is converted as a whole
+    cb(bf16_f32_comp, { add_pass<ConvertF32ToBF16Pass>(); });
 
 #undef cb
 
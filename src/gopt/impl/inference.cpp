@@ -1795,6 +1795,263 @@ void ConvertBatchNormToElemwisePass::apply(OptState& state) const {
     MIDOUT_E
 }
 
+/* ================ ConvertWeightQuantMatrixMulPass ================ */
+ConvertWeightQuantMatrixMulPass::ConvertWeightQuantMatrixMulPass(
+        uint32_t bits, uint32_t group_size)
+        : m_bits{bits}, m_group_size{group_size} {
+    mgb_assert(
+            bits == 8 || bits == 4, "weight quant only supports 8 or 4 bits, got %u",
+            bits);
+    mgb_assert(
+            bits == 8 || group_size % 2 == 0,
+            "group size of 4-bit weights must be even, got %u", group_size);
+}
+
+const char* ConvertWeightQuantMatrixMulPass::name() const {
+    return mgb_cstr_log("convert_weight_quant_matrix_mul");
+}
+
+void ConvertWeightQuantMatrixMulPass::apply(OptState& state) const {
+    MIDOUT_B("ConvertWeightQuantMatrixMulPass::apply")
+    //! value of a constant float32 weight on cpu, or an empty tensor
+    auto get_weight = [](VarNode* var) {
+        HostTensorND ret;
+        if (var->dtype() != dtype::Float32() ||
+            var->comp_node().device_type() != CompNode::DeviceType::CPU) {
+            return ret;
+        }
+        auto opr = var->owner_opr();
+        if (auto imm = opr->try_cast_final<opr::ImmutableTensor>()) {
+            ret.copy_from(imm->host_value());
+        } else if (auto sdt = opr->try_cast_final<opr::SharedDeviceTensor>()) {
+            ret.copy_from(sdt->get_dev_tensor()).sync();
+        }
+        return ret;
+    };
+
+    int qmax = m_bits == 8 ? 127 : 7;
+    //! quantize (batch, k, n) or (batch, n, k) weights into (batch, n, k)
+    //! int8, packed along k if they have 4 bits, and their scales
+    auto quantize = [&](const HostTensorND& weight, bool transpose, size_t batch,
+                        size_t K, size_t N, size_t group, HostTensorND& qweight,
+                        HostTensorND& scale) {
+        size_t nr_groups = K / group, row_bytes = K * m_bits / 8;
+        auto cn = weight.comp_node();
+        qweight.comp_node(cn).dtype(dtype::Int8()).resize({batch, N, row_bytes});
+        scale.comp_node(cn).dtype(dtype::Float32()).resize({batch, N, nr_groups});
+        auto src = weight.ptr<float>();
+        auto dst = qweight.ptr<int8_t>();
+        auto sptr = scale.ptr<float>();
+        memset(dst, 0, batch * N * row_bytes);
+        for (size_t b = 0; b < batch; ++b) {
+            const float* w = src + b * K * N;
+            auto at = [&](size_t n, size_t k) {
+                return transpose ? w[n * K + k] : w[k * N + n];
+            };
+            for (size_t n = 0; n < N; ++n) {
+                int8_t* q = dst + (b * N + n) * row_bytes;
+                for (size_t g = 0; g < nr_groups; ++g) {
+                    float amax = 0;
+                    for (size_t k = g * group; k < (g + 1) * group; ++k) {
+                        amax = std::max(amax, std::abs(at(n, k)));
+                    }
+                    float s = amax > 0 ? amax / qmax : 1.f;
+                    sptr[(b * N + n) * nr_groups + g] = s;
+                    for (size_t k = g * group; k < (g + 1) * group; ++k) {
+                        int v = std::round(at(n, k) / s);
+                        v = std::min(std::max(v, -qmax - 1), qmax);
+                        if (m_bits == 8) {
+                            q[k] = v;
+                        } else {
+                            q[k / 2] |= (v & 0xf) << (k % 2 * 4);
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    auto rewriter = state.graph().make_rewriter();
+    auto try_convert = [&](OperatorNodeBase* opr) -> VarNode* {
+        megdnn::param::MatrixMul param;
+        if (auto matmul = try_cast_as_op<opr::MatrixMul>(opr)) {
+            param = matmul->param();
+        } else if (auto bmatmul = try_cast_as_op<opr::BatchedMatrixMul>(opr)) {
+            param = bmatmul->param();
+        } else {
+            return nullptr;
+        }
+        using Param = megdnn::param::MatrixMul;
+        if (param.transposeA || param.format != Param::Format::DEFAULT ||
+            param.compute_mode != Param::ComputeMode::DEFAULT ||
+            opr->input(0)->dtype() != dtype::Float32() ||
+            opr->output(0)->dtype() != dtype::Float32()) {
+            return nullptr;
+        }
+        auto weight = get_weight(rewriter.get_var(opr->input(1)));
+        if (weight.empty()) {
+            return nullptr;
+        }
+        auto&& shp = weight.shape();
+        size_t batch_dim = shp.ndim - 2, batch = batch_dim ? shp[0] : 1;
+        size_t K = shp[batch_dim + param.transposeB],
+               N = shp[batch_dim + !param.transposeB];
+        size_t group = m_group_size ? m_group_size : K;
+        if (K % group || group % (8 / m_bits)) {
+            return nullptr;
+        }
+        HostTensorND qweight, scale;
+        quantize(weight, param.transposeB, batch, K, N, group, qweight, scale);
+        if (!batch_dim) {
+            qweight.resize({N, K * m_bits / 8});
+            scale.resize({N, K / group});
+        }
+        auto graph = opr->owner_graph();
+        auto name = opr->input(1)->name();
+        auto make_const = [&](const HostTensorND& val, const char* suffix) {
+            auto dev = std::make_shared<DeviceTensorND>();
+            dev->copy_from(val).sync();
+            return opr::SharedDeviceTensor::make_const(*graph, dev, {name + suffix});
+        };
+        opr::WeightQuantMatrixMul::Param new_param;
+        new_param.bits = m_bits;
+        new_param.group_size = m_group_size;
+        return opr::WeightQuantMatrixMul::make(
+                       rewriter.get_var(opr->input(0)),
+                       make_const(qweight, ":quantized"), make_const(scale, ":scale"),
+                       new_param, opr->config())
+                .node();
+    };
+    auto on_opr = [&](OperatorNodeBase* opr) {
+        if (auto new_var = try_convert(opr)) {
+            rewriter.replace_var(
+                    opr->output(0), new_var,
+                    mgb_cstr_log("replace matrix_mul(a, w) -> "
+                                 "weight_quant_matrix_mul(a, quant(w), scale)"));
+            return;
+        }
+        rewriter.auto_replace_outputs(opr);
+    };
+    state.graph().iter(on_opr);
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ ConvertF32ToBF16Pass ================ */
+const char* ConvertF32ToBF16Pass::name() const {
+    return mgb_cstr_log("convert_f32_to_bf16");
+}
+
+void ConvertF32ToBF16Pass::apply(OptState& state) const {
+    MIDOUT_B("ConvertF32ToBF16Pass::apply")
+    auto rewriter = state.graph().make_rewriter();
+    //! the bfloat16 input of the conversion of a converted opr is reused
+    auto to_bf16 = [](VarNode* var) -> VarNode* {
+        if (auto cvt = try_cast_as_op<opr::TypeCvt>(var->owner_opr())) {
+            if (cvt->input(0)->dtype() == dtype::BFloat16()) {
+                return cvt->input(0);
+            }
+        }
+        return opr::TypeCvt::make(var, dtype::BFloat16()).node();
+    };
+    auto can_convert = [](OperatorNodeBase* opr) {
+        for (auto inp : opr->input()) {
+            if (inp->dtype() != dtype::Float32()) {
+                return false;
+            }
+        }
+        return opr->output(0)->dtype() == dtype::Float32() &&
+               opr->output(0)->comp_node().device_type() ==
+                       CompNode::DeviceType::CPU &&
+               !opr->config().output_dtype().valid();
+    };
+
+    auto try_convert = [&](OperatorNodeBase* opr) -> VarNode* {
+        using MatmulParam = megdnn::param::MatrixMul;
+        using ConvParam = megdnn::param::Convolution;
+        if (!can_convert(opr)) {
+            return nullptr;
+        }
+        auto new_inp = [&](size_t idx) {
+            return to_bf16(rewriter.get_var(opr->input(idx)));
+        };
+        if (auto matmul = try_cast_as_op<opr::MatrixMul>(opr)) {
+            auto param = matmul->param();
+            if (param.compute_mode != MatmulParam::ComputeMode::DEFAULT ||
+                param.format != MatmulParam::Format::DEFAULT) {
+                return nullptr;
+            }
+            param.compute_mode = MatmulParam::ComputeMode::FLOAT32;
+            return opr::MatrixMul::make(
+                           new_inp(0), new_inp(1), param, matmul->execution_policy(),
+                           opr->config())
+                    .node();
+        }
+        if (auto bmatmul = try_cast_as_op<opr::BatchedMatrixMul>(opr)) {
+            auto param = bmatmul->param();
+            if (param.compute_mode != MatmulParam::ComputeMode::DEFAULT ||
+                param.format != MatmulParam::Format::DEFAULT) {
+                return nullptr;
+            }
+            param.compute_mode = MatmulParam::ComputeMode::FLOAT32;
+            return opr::BatchedMatrixMul::make(
+                           new_inp(0), new_inp(1), param, bmatmul->execution_policy(),
+                           opr->config())
+                    .node();
+        }
+        if (auto conv = try_cast_as_op<opr::ConvolutionForward>(opr)) {
+            auto param = conv->param();
+            if (param.compute_mode != ConvParam::ComputeMode::DEFAULT ||
+                param.format != ConvParam::Format::NCHW) {
+                return nullptr;
+            }
+            param.compute_mode = ConvParam::ComputeMode::FLOAT32;
+            return opr::Convolution::make(
+                           new_inp(0), new_inp(1), param, conv->execution_policy(),
+                           opr->config())
+                    .node();
+        }
+        if (auto conv_bias = try_cast_as_op<opr::ConvBiasForward>(opr)) {
+            using ConvBiasParam = megdnn::param::ConvBias;
+            auto param = conv_bias->param();
+            //! the z of the conv bias is not converted
+            if (param.compute_mode != ConvBiasParam::ComputeMode::DEFAULT ||
+                param.format != ConvBiasParam::Format::NCHW ||
+                opr->input().size() > 3) {
+                return nullptr;
+            }
+            param.compute_mode = ConvBiasParam::ComputeMode::FLOAT32;
+            if (opr->input().size() == 2) {
+                return opr::ConvBias::make(
+                               new_inp(0), new_inp(1), param,
+                               conv_bias->execution_policy(), opr->config())
+                        .node();
+            }
+            return opr::ConvBias::make(
+                           new_inp(0), new_inp(1), new_inp(2), param,
+                           conv_bias->execution_policy(), opr->config())
+                    .node();
+        }
+        return nullptr;
+    };
+    auto on_opr = [&](OperatorNodeBase* opr) {
+        if (auto new_var = try_convert(opr)) {
+            rewriter.replace_var(
+                    opr->output(0),
+                    opr::TypeCvt::make(new_var, dtype::Float32()).node(),
+                    mgb_cstr_log("replace opr(a, b) -> "
+                                 "typecvt(opr(typecvt(a), typecvt(b)), f32)"));
+            return;
+        }
+        rewriter.auto_replace_outputs(opr);
+    };
+    state.graph().iter(on_opr);
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
 /* ================ FuseConvBiasNonlinPass ================ */
 const char* FuseConvBiasNonlinPass::name() const {
     return "combine_conv_bias_and_relu";
@@ -2203,6 +2460,266 @@ void FuseConvBiasZPass::apply(OptState& state) const {
     MIDOUT_E
 }
 
+/* ================ FuseDepthwisePointwiseConvBiasPass ================ */
+const char* FuseDepthwisePointwiseConvBiasPass::name() const {
+    return mgb_cstr_log("fuse_depthwise_pointwise_conv_bias");
+}
+
+void FuseDepthwisePointwiseConvBiasPass::apply(OptState& state) const {
+    MIDOUT_B("FuseDepthwisePointwiseConvBiasPass::apply")
+    UniqReaderCheck uniq_reader_check{state.graph()};
+    auto rewriter = state.graph().make_rewriter();
+    using Param = opr::ConvBias::Param;
+
+    //! NCHW ConvBias on cpu without z or dilation, whose dtypes are all
+    //! float32 or int8 with int32 biases
+    auto check_conv_bias = [](opr::ConvBias* conv_bias) -> bool {
+        auto&& param = conv_bias->param();
+        if (param.format != Param::Format::NCHW ||
+            param.mode != Param::Mode::CROSS_CORRELATION ||
+            param.compute_mode != Param::ComputeMode::DEFAULT ||
+            param.dilate_h != 1 || param.dilate_w != 1 ||
+            conv_bias->input().size() > 3 ||
+            conv_bias->output(0)->comp_node().device_type() !=
+                    CompNode::DeviceType::CPU) {
+            return false;
+        }
+        auto dtype = conv_bias->input(0)->dtype();
+        bool is_float = dtype.enumv() == DTypeEnum::Float32;
+        if (!is_float && dtype.enumv() != DTypeEnum::QuantizedS8) {
+            return false;
+        }
+        for (auto var : {conv_bias->input(1), conv_bias->output(0)}) {
+            if (var->dtype().enumv() != dtype.enumv()) {
+                return false;
+            }
+        }
+        return conv_bias->input().size() < 3 ||
+               conv_bias->input(2)->dtype().enumv() ==
+                       (is_float ? DTypeEnum::Float32 : DTypeEnum::QuantizedS32);
+    };
+    //! whether the bias is absent or broadcast along the channels
+    auto check_bias = [](opr::ConvBias* conv_bias, size_t channels) -> bool {
+        return conv_bias->input().size() < 3 ||
+               conv_bias->input(2)->shape().eq_shape({1, channels, 1, 1});
+    };
+    //! the bias of \p conv_bias, which is made of zeros if it is absent
+    auto get_bias = [&](opr::ConvBias* conv_bias, size_t channels) -> VarNode* {
+        if (conv_bias->input().size() == 3) {
+            return rewriter.get_var(conv_bias->input(2));
+        }
+        DType dtype = dtype::Float32();
+        if (conv_bias->input(0)->dtype().enumv() == DTypeEnum::QuantizedS8) {
+            dtype = dtype::QuantizedS32(
+                    conv_bias->input(0)->dtype().param<dtype::QuantizedS8>().scale *
+                    conv_bias->input(1)->dtype().param<dtype::QuantizedS8>().scale);
+        }
+        HostTensorND zeros{
+                conv_bias->output(0)->comp_node(), {1, channels, 1, 1}, dtype};
+        memset(zeros.raw_ptr(), 0, zeros.layout().span().dist_byte());
+        return opr::ImmutableTensor::make(*conv_bias->owner_graph(), zeros).node();
+    };
+
+    auto try_fuse = [&](OperatorNodeBase* opr) -> VarNode* {
+        auto pw = try_cast_as_op<opr::ConvBias>(opr);
+        if (!pw || !check_conv_bias(pw) ||
+            pw->param().sparse != Param::Sparse::DENSE || pw->param().pad_h ||
+            pw->param().pad_w || pw->param().stride_h != 1 ||
+            pw->param().stride_w != 1 || !uniq_reader_check(pw->input(0))) {
+            return nullptr;
+        }
+        auto dw = try_cast_as_op<opr::ConvBias>(pw->input(0)->owner_opr());
+        if (!dw || !check_conv_bias(dw) ||
+            dw->param().sparse != Param::Sparse::GROUP) {
+            return nullptr;
+        }
+        auto&& src_shape = dw->input(0)->shape();
+        auto&& dw_shape = dw->input(1)->shape();
+        auto&& pw_shape = pw->input(1)->shape();
+        if (src_shape.ndim != 4 || dw_shape.ndim != 5 || pw_shape.ndim != 4) {
+            return nullptr;
+        }
+        size_t channels = src_shape[1], out_channels = pw_shape[0];
+        if (dw_shape[0] != channels || dw_shape[1] != 1 || dw_shape[2] != 1 ||
+            pw_shape[1] != channels || pw_shape[2] != 1 || pw_shape[3] != 1 ||
+            !check_bias(dw, channels) || !check_bias(pw, out_channels)) {
+            return nullptr;
+        }
+        opr::DepthwisePointwiseConvBias::Param param;
+        param.dw_nonline_mode = dw->param().nonlineMode;
+        param.pw_nonline_mode = pw->param().nonlineMode;
+        param.pad_h = dw->param().pad_h;
+        param.pad_w = dw->param().pad_w;
+        param.stride_h = dw->param().stride_h;
+        param.stride_w = dw->param().stride_w;
+        auto config = pw->config();
+        config.output_dtype(pw->output(0)->dtype());
+        return opr::DepthwisePointwiseConvBias::make(
+                       rewriter.get_var(dw->input(0)), rewriter.get_var(dw->input(1)),
+                       get_bias(dw, channels), rewriter.get_var(pw->input(1)),
+                       get_bias(pw, out_channels), param, config)
+                .node();
+    };
+
+    auto on_opr = [&](OperatorNodeBase* opr) {
+        if (auto new_var = try_fuse(opr)) {
+            rewriter.replace_var(
+                    opr->output(0), new_var,
+                    mgb_cstr_log("replace conv_bias(conv_bias(x, dw, b0), pw, b1) "
+                                 "-> depthwise_pointwise_conv_bias(x, dw, b0, pw, "
+                                 "b1)"));
+            uniq_reader_check.update_on_opr_auto_replace(opr, new_var->owner_opr());
+            return;
+        }
+        auto new_opr = rewriter.auto_replace_outputs(opr);
+        uniq_reader_check.update_on_opr_auto_replace(opr, new_opr);
+    };
+    state.graph().iter(on_opr);
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ FuseConvBiasPoolingPass ================ */
+const char* FuseConvBiasPoolingPass::name() const {
+    return mgb_cstr_log("fuse_conv_bias_pooling");
+}
+
+void FuseConvBiasPoolingPass::apply(OptState& state) const {
+    MIDOUT_B("FuseConvBiasPoolingPass::apply")
+    UniqReaderCheck uniq_reader_check{state.graph()};
+    auto rewriter = state.graph().make_rewriter();
+    using ConvParam = opr::ConvBias::Param;
+    using PoolingParam = opr::Pooling::Param;
+    using Param = opr::ConvPooling::Param;
+
+    //! ConvPooling computes the conv directly, 4 output channels at a time,
+    //! which only beats the im2col and winograd algos of ConvBias when the
+    //! reduction of each output and the output channels are small, e.g. the
+    //! first convs of a network
+    constexpr size_t MAX_OC = 32, MAX_IC_FH_FW = 16 * 3 * 3;
+    //! float32 dense NCHW ConvBias on cpu without z or dilation, whose bias is
+    //! absent or broadcast along the channels
+    auto check_conv_bias = [](opr::ConvBias* conv_bias) -> bool {
+        auto&& param = conv_bias->param();
+        if (param.format != ConvParam::Format::NCHW ||
+            param.sparse != ConvParam::Sparse::DENSE ||
+            param.compute_mode != ConvParam::ComputeMode::DEFAULT ||
+            param.dilate_h != 1 || param.dilate_w != 1 ||
+            conv_bias->input().size() > 3 ||
+            conv_bias->output(0)->comp_node().device_type() !=
+                    CompNode::DeviceType::CPU ||
+            conv_bias->input(1)->shape().ndim != 4) {
+            return false;
+        }
+        auto&& filter = conv_bias->input(1)->shape();
+        if (filter[0] > MAX_OC || filter[1] * filter[2] * filter[3] > MAX_IC_FH_FW) {
+            return false;
+        }
+        for (auto var : conv_bias->input()) {
+            if (var->dtype().enumv() != DTypeEnum::Float32) {
+                return false;
+            }
+        }
+        size_t channels = conv_bias->input(1)->shape()[0];
+        return conv_bias->output(0)->dtype().enumv() == DTypeEnum::Float32 &&
+               (conv_bias->input().size() < 3 ||
+                conv_bias->input(2)->shape().eq_shape({1, channels, 1, 1}));
+    };
+    auto check_pooling = [](opr::Pooling* pooling) -> bool {
+        auto&& param = pooling->param();
+        return param.format == PoolingParam::Format::NCHW &&
+               (param.mode == PoolingParam::Mode::MAX ||
+                param.mode == PoolingParam::Mode::AVERAGE) &&
+               param.window_h == param.window_w &&
+               (param.window_h == 2 || param.window_h == 3);
+    };
+    //! the nonlinearity of ConvPooling for \p mode, which is false if not
+    //! supported
+    auto get_nonline_mode = [](ConvParam::NonlineMode mode,
+                               Param::NonlineMode& ret) -> bool {
+        switch (mode) {
+            case ConvParam::NonlineMode::IDENTITY:
+                ret = Param::NonlineMode::IDENTITY;
+                return true;
+            case ConvParam::NonlineMode::RELU:
+                ret = Param::NonlineMode::RELU;
+                return true;
+            case ConvParam::NonlineMode::SIGMOID:
+                ret = Param::NonlineMode::SIGMOID;
+                return true;
+            default:
+                return false;
+        }
+    };
+    //! the bias of \p conv_bias, which is made of zeros if it is absent
+    auto get_bias = [&](opr::ConvBias* conv_bias) -> VarNode* {
+        if (conv_bias->input().size() == 3) {
+            return rewriter.get_var(conv_bias->input(2));
+        }
+        size_t channels = conv_bias->input(1)->shape()[0];
+        HostTensorND zeros{
+                conv_bias->output(0)->comp_node(), {1, channels, 1, 1},
+                dtype::Float32()};
+        memset(zeros.raw_ptr(), 0, zeros.layout().span().dist_byte());
+        return opr::ImmutableTensor::make(*conv_bias->owner_graph(), zeros).node();
+    };
+
+    auto try_fuse = [&](OperatorNodeBase* opr) -> VarNode* {
+        auto pooling = try_cast_as_op<opr::Pooling>(opr);
+        if (!pooling || !check_pooling(pooling) ||
+            !uniq_reader_check(pooling->input(0))) {
+            return nullptr;
+        }
+        auto conv_bias = try_cast_as_op<opr::ConvBias>(pooling->input(0)->owner_opr());
+        Param param;
+        if (!conv_bias || !check_conv_bias(conv_bias) ||
+            !get_nonline_mode(conv_bias->param().nonlineMode, param.nonlineMode)) {
+            return nullptr;
+        }
+        auto&& conv_param = conv_bias->param();
+        auto&& pooling_param = pooling->param();
+        param.convMode = conv_param.mode == ConvParam::Mode::CONVOLUTION
+                               ? Param::ConvMode::CONVOLUTION
+                               : Param::ConvMode::CROSS_CORRELATION;
+        param.poolMode = pooling_param.mode == PoolingParam::Mode::MAX
+                               ? Param::PoolMode::MAX
+                               : Param::PoolMode::AVERAGE;
+        param.pool_shape_h = pooling_param.window_h;
+        param.pool_shape_w = pooling_param.window_w;
+        param.pool_stride_h = pooling_param.stride_h;
+        param.pool_stride_w = pooling_param.stride_w;
+        param.pool_pad_h = pooling_param.pad_h;
+        param.pool_pad_w = pooling_param.pad_w;
+        param.conv_stride_h = conv_param.stride_h;
+        param.conv_stride_w = conv_param.stride_w;
+        param.conv_pad_h = conv_param.pad_h;
+        param.conv_pad_w = conv_param.pad_w;
+        return opr::ConvPooling::make(
+                       rewriter.get_var(conv_bias->input(0)),
+                       rewriter.get_var(conv_bias->input(1)), get_bias(conv_bias),
+                       param, pooling->config())
+                .node();
+    };
+
+    auto on_opr = [&](OperatorNodeBase* opr) {
+        if (auto new_var = try_fuse(opr)) {
+            rewriter.replace_var(
+                    opr->output(0), new_var,
+                    mgb_cstr_log("replace pooling(conv_bias(x, w, b)) -> "
+                                 "conv_pooling(x, w, b)"));
+            uniq_reader_check.update_on_opr_auto_replace(opr, new_var->owner_opr());
+            return;
+        }
+        auto new_opr = rewriter.auto_replace_outputs(opr);
+        uniq_reader_check.update_on_opr_auto_replace(opr, new_opr);
+    };
+    state.graph().iter(on_opr);
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
 /* ================ FuseDeconvCvtPass ================ */
 const char* FuseDeconvCvtPass::name() const {
     return "combine_deconv_and_typecvt";
@@ -123,6 +123,40 @@ public:
     void apply(OptState& opt) const override;
 };
 
+/*!
+ * \brief quantize the constant float32 weights of MatrixMul and
+ *      BatchedMatrixMul on cpu to int8 or int4, and replace the oprs by
+ *      WeightQuantMatrixMul whose activations stay in float32
+ *
+ * The weights are quantized symmetrically, with a scale for each output
+ * channel or for each group of group_size weights along k. It reduces the
+ * memory traffic of the matrix muls with few rows of activations, such as the
+ * fully connected layers of language models when decoding.
+ */
+class ConvertWeightQuantMatrixMulPass final : public Pass {
+    uint32_t m_bits, m_group_size;
+
+public:
+    ConvertWeightQuantMatrixMulPass(uint32_t bits, uint32_t group_size);
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief compute the float32 matrix muls, convolutions and conv biases on cpu
+ *      in bfloat16
+ *
+ * Their inputs are converted to bfloat16 and the products are accumulated in
+ * float32, so the gemm reads half the bytes of weights and activations. The
+ * outputs are converted back to float32, leaving the other oprs unchanged; a
+ * conversion back and forth between two converted oprs is skipped.
+ */
+class ConvertF32ToBF16Pass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
 /*!
  * \brief fuse convolution, bias add, relu oprs to a ConvBiasForward opr
  */
@@ -141,6 +175,35 @@ public:
     void apply(OptState& opt) const override;
 };
 
+/*!
+ * \brief fuse a channel-wise ConvBias and the 1x1 ConvBias reading its output
+ *      to a DepthwisePointwiseConvBias opr on cpu
+ *
+ * Both oprs must be in NCHW without z, and the channel-wise output must have
+ * no other reader, so it is never written to memory as a whole.
+ */
+class FuseDepthwisePointwiseConvBiasPass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief fuse a float32 dense ConvBias and the 2x2 or 3x3 Pooling reading its
+ *      output to a ConvPooling opr on cpu
+ *
+ * Both oprs must be in NCHW, the ConvBias must have no z and its output must
+ * have no other reader, so it is never written to memory as a whole. Only
+ * convs with at most 32 output channels and 144 inputs per output, e.g.
+ * 16 channels of 3x3, are fused, since the direct kernel of ConvPooling is
+ * slower than the optimized ConvBias algos on larger ones.
+ */
+class FuseConvBiasPoolingPass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
 /*!
  * \brief fuse preprocess, like pad channel, quint8 to qint8
  */
@@ -311,10 +374,17 @@ public:
     static std::unique_ptr<EnableNchw44DotPass> make_nchw44_dot_converter();
 };
 
+/*!
+ * The serialized options are laid out as:
+ *  - bits 0-7: the flags up to weight_quant_bits
+ *  - bits 8-31: weight_quant_group_size
+ *  - bits 32-47: layout_transform
+ *  - bits 48-63: the flags added later, one bit each
+ */
 struct OptimizeForInferenceOptions : cg::GraphCommonOptimizeOptions {
     uint64_t serialize() {
         uint64_t ret = 0;
-        ret |= (uint64_t)layout_transform << 32;
+        ret |= (uint64_t)(layout_transform & 0xffffu) << 32;
         if (f16_io_f32_comp)
             ret |= 1u;
         if (f16_io_comp)
@@ -327,6 +397,17 @@ struct OptimizeForInferenceOptions : cg::GraphCommonOptimizeOptions {
             ret |= 1u << 4;
         if (fuse_preprocess)
             ret |= 1u << 5;
+        if (weight_quant)
+            ret |= 1u << 6;
+        if (weight_quant_bits == 4)
+            ret |= 1u << 7;
+        ret |= (uint64_t)(weight_quant_group_size & 0xffffffu) << 8;
+        if (bf16_f32_comp)
+            ret |= (uint64_t)1 << 48;
+        if (fuse_depthwise_pointwise_conv)
+            ret |= (uint64_t)1 << 49;
+        if (fuse_conv_bias_pooling)
+            ret |= (uint64_t)1 << 50;
         return ret;
     }
 
@@ -338,7 +419,13 @@ struct OptimizeForInferenceOptions : cg::GraphCommonOptimizeOptions {
         ret.fuse_conv_bias_with_z = buf & 1u << 3;
         ret.weight_preprocess = buf & 1u << 4;
         ret.fuse_preprocess = buf & 1u << 5;
-        ret.layout_transform = (LayoutTransform)(buf >> 32);
+        ret.weight_quant = buf & 1u << 6;
+        ret.weight_quant_bits = buf & 1u << 7 ? 4 : 8;
+        ret.weight_quant_group_size = buf >> 8 & 0xffffffu;
+        ret.layout_transform = (LayoutTransform)(buf >> 32 & 0xffffu);
+        ret.bf16_f32_comp = buf & (uint64_t)1 << 48;
+        ret.fuse_depthwise_pointwise_conv = buf & (uint64_t)1 << 49;
+        ret.fuse_conv_bias_pooling = buf & (uint64_t)1 << 50;
         return ret;
     }
 };
@@ -1786,6 +1786,160 @@ TEST(TestGoptInference, concatbypass) {
     ASSERT_EQ(1, relayout_format_nr);
 }
 
+TEST(TestGoptInference, ConvertWeightQuantMatrixMul) {
+    auto cn = CompNode::load("cpu0");
+    constexpr size_t M = 3, K = 64, N = 40, BATCH = 2;
+    for (uint32_t bits : {8u, 4u}) {
+        for (uint32_t group_size : {0u, 16u}) {
+            HostTensorGenerator<> gen;
+            auto graph = ComputingGraph::make();
+            graph->options().graph_opt_level = 0;
+            // weights on the quantization grid of each group, so they are
+            // quantized exactly
+            int qmax = bits == 8 ? 127 : 7;
+            size_t group = group_size ? group_size : K;
+            std::mt19937 rng(bits + group_size);
+            auto mkweight = [&](const char* name, const TensorShape& shp,
+                                bool transpose) {
+                auto host = std::make_shared<HostTensorND>(cn, shp, dtype::Float32());
+                size_t batch = shp.ndim == 3 ? shp[0] : 1;
+                auto ptr = host->ptr<float>();
+                for (size_t b = 0; b < batch; ++b) {
+                    for (size_t n = 0; n < N; ++n) {
+                        float step = 0.01f * (n % 5 + 1);
+                        for (size_t k = 0; k < K; ++k) {
+                            int q = static_cast<int>(rng() % (2 * qmax + 1)) - qmax;
+                            if (k % group == 0) {
+                                q = qmax;
+                            }
+                            size_t idx = transpose ? n * K + k : k * N + n;
+                            ptr[b * K * N + idx] = q * step;
+                        }
+                    }
+                }
+                return opr::SharedDeviceTensor::make(*graph, *host).rename(name);
+            };
+            auto x = opr::Host2DeviceCopy::make(*graph, gen({M, K}, cn)).rename("x"),
+                 bx = opr::Host2DeviceCopy::make(*graph, gen({BATCH, M, K}, cn))
+                              .rename("bx");
+            auto w = mkweight("w", {K, N}, false),
+                 bw = mkweight("bw", {BATCH, N, K}, true);
+            opr::MatrixMul::Param param;
+            param.transposeB = true;
+            auto y = opr::MatrixMul::make(x, w),
+                 by = opr::BatchedMatrixMul::make(bx, bw, param);
+
+            auto options = gopt::OptimizeForInferenceOptions{};
+            options.enable_weight_quant();
+            options.weight_quant_bits = bits;
+            options.weight_quant_group_size = group_size;
+            SymbolVar y_opt, by_opt;
+            unpack_vector(
+                    gopt::optimize_for_inference({y, by}, options), y_opt, by_opt);
+            ASSERT_EQ(0u, find_opr_num<opr::MatrixMul>(y_opt));
+            ASSERT_EQ(0u, find_opr_num<opr::BatchedMatrixMul>(by_opt));
+            ASSERT_EQ(bits, find_opr<opr::WeightQuantMatrixMul>(y_opt).param().bits);
+            ASSERT_EQ(
+                    group_size,
+                    find_opr<opr::WeightQuantMatrixMul>(by_opt).param().group_size);
+
+            HostTensorND host_y, host_y_opt, host_by, host_by_opt;
+            auto func = graph->compile(
+                    {make_callback_copy(y, host_y),
+                     make_callback_copy(y_opt, host_y_opt),
+                     make_callback_copy(by, host_by),
+                     make_callback_copy(by_opt, host_by_opt)});
+            func->execute();
+            MGB_ASSERT_TENSOR_NEAR(host_y, host_y_opt, 1e-4);
+            MGB_ASSERT_TENSOR_NEAR(host_by, host_by_opt, 1e-4);
+        }
+    }
+}
+
+TEST(TestGoptInference, ConvertF32ToBF16) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen(0, 1, 0);
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+    auto x = mkvar("x", {5, 64}), w0 = mkcvar("w0", {64, 48}),
+         w1 = mkcvar("w1", {48, 40});
+    auto z = opr::MatrixMul::make(opr::MatrixMul::make(x, w0), w1);
+    auto img = mkvar("img", {2, 8, 12, 12}), filter = mkcvar("filter", {16, 8, 3, 3});
+    opr::Convolution::Param conv_param;
+    conv_param.pad_h = conv_param.pad_w = 1;
+    auto conv = opr::Convolution::make(img, filter, conv_param);
+    opr::ConvBias::Param conv_bias_param;
+    conv_bias_param.pad_h = conv_bias_param.pad_w = 1;
+    conv_bias_param.nonlineMode = opr::ConvBias::Param::NonlineMode::RELU;
+    auto conv_bias = opr::ConvBias::make(
+            img, filter, mkcvar("bias", {1, 16, 1, 1}), conv_bias_param);
+
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_bf16_f32_comp();
+    SymbolVar z_opt, conv_opt, conv_bias_opt;
+    unpack_vector(
+            gopt::optimize_for_inference({z, conv, conv_bias}, options), z_opt,
+            conv_opt, conv_bias_opt);
+    // the weights are converted when the params are fused, and the output of
+    // the first matmul is passed to the second one in bfloat16
+    ASSERT_EQ(2u, find_opr_num<opr::TypeCvt>(z_opt));
+    ASSERT_EQ(dtype::BFloat16(), find_opr<opr::MatrixMul>(z_opt).input(0)->dtype());
+    ASSERT_EQ(
+            opr::MatrixMul::Param::ComputeMode::FLOAT32,
+            find_opr<opr::MatrixMul>(z_opt).param().compute_mode);
+    ASSERT_EQ(2u, find_opr_num<opr::TypeCvt>(conv_opt));
+    ASSERT_EQ(
+            dtype::BFloat16(), find_opr<opr::Convolution>(conv_opt).input(1)->dtype());
+    auto&& conv_bias_bf16 = find_opr<opr::ConvBias>(conv_bias_opt);
+    ASSERT_EQ(dtype::BFloat16(), conv_bias_bf16.input(2)->dtype());
+    ASSERT_EQ(
+            opr::ConvBias::Param::ComputeMode::FLOAT32,
+            conv_bias_bf16.param().compute_mode);
+    ASSERT_EQ(dtype::Float32(), z_opt.dtype());
+    ASSERT_EQ(dtype::Float32(), conv_opt.dtype());
+    ASSERT_EQ(dtype::Float32(), conv_bias_opt.dtype());
+
+    HostTensorND host_z, host_z_opt, host_conv, host_conv_opt, host_conv_bias,
+            host_conv_bias_opt;
+    auto func = graph->compile(
+            {make_callback_copy(z, host_z), make_callback_copy(z_opt, host_z_opt),
+             make_callback_copy(conv, host_conv),
+             make_callback_copy(conv_opt, host_conv_opt),
+             make_callback_copy(conv_bias, host_conv_bias),
+             make_callback_copy(conv_bias_opt, host_conv_bias_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_z, host_z_opt, 5e-2);
+    MGB_ASSERT_TENSOR_NEAR(host_conv, host_conv_opt, 5e-2);
+    MGB_ASSERT_TENSOR_NEAR(host_conv_bias, host_conv_bias_opt, 5e-2);
+}
+
+TEST(TestGoptInference, SerializeOptions) {
+    using Options = gopt::OptimizeForInferenceOptions;
+    Options options;
+    options.enable_weight_quant();
+    options.weight_quant_bits = 4;
+    options.weight_quant_group_size = 0xffffff;
+    options.enable_bf16_f32_comp();
+    options.enable_fuse_depthwise_pointwise_conv();
+    options.enable_fuse_conv_bias_pooling();
+    options.enable_nchw44();
+    auto ret = Options::deserialize(options.serialize());
+    ASSERT_TRUE(ret.weight_quant);
+    ASSERT_EQ(4u, ret.weight_quant_bits);
+    ASSERT_EQ(0xffffffu, ret.weight_quant_group_size);
+    ASSERT_TRUE(ret.bf16_f32_comp);
+    ASSERT_TRUE(ret.fuse_depthwise_pointwise_conv);
+    ASSERT_TRUE(ret.fuse_conv_bias_pooling);
+    ASSERT_EQ(Options::LayoutTransform::NCHW44, ret.layout_transform);
+    ASSERT_FALSE(ret.f16_io_comp);
+}
+
 TEST(TestGoptInference, ConvertBatchNormPass) {
     auto cn = CompNode::load("cpu0");
 
@@ -2020,6 +2174,180 @@ TEST(TestGoptInference, ConvBiasNonlinearityFusePass_FullBias) {
     }
 }
 
+TEST(TestGoptInference, FuseDepthwisePointwiseConvBias) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+
+    using Param = opr::ConvBias::Param;
+    Param dw_param, pw_param;
+    dw_param.sparse = Param::Sparse::GROUP;
+    dw_param.pad_h = dw_param.pad_w = 1;
+    dw_param.stride_h = dw_param.stride_w = 2;
+    dw_param.nonlineMode = Param::NonlineMode::RELU;
+    pw_param.nonlineMode = Param::NonlineMode::H_SWISH;
+    auto host_x = gen({2, 8, 15, 17}, cn);
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x);
+    auto dw_w = mkcvar("dw_w", {8, 1, 1, 3, 3}), dw_b = mkcvar("dw_b", {1, 8, 1, 1}),
+         pw_w = mkcvar("pw_w", {16, 8, 1, 1}), pw_b = mkcvar("pw_b", {1, 16, 1, 1});
+    // with biases, without biases, and with two readers of the channel-wise
+    // output which prevent the fusion
+    auto y0 = opr::ConvBias::make(
+            opr::ConvBias::make(x, dw_w, dw_b, dw_param), pw_w, pw_b, pw_param);
+    auto y1 = opr::ConvBias::make(opr::ConvBias::make(x, dw_w, dw_param), pw_w);
+    auto dw2 = opr::ConvBias::make(x, dw_w, dw_b, dw_param),
+         y2 = opr::ConvBias::make(dw2, pw_w, pw_b) + opr::ConvBias::make(dw2, pw_w);
+
+    SymbolVar y0_opt, y1_opt, y2_opt;
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_fuse_depthwise_pointwise_conv();
+    unpack_vector(
+            gopt::optimize_for_inference({y0, y1, y2}, options), y0_opt, y1_opt,
+            y2_opt);
+    ASSERT_EQ(0u, find_opr_num<opr::ConvBias>(y0_opt));
+    ASSERT_EQ(0u, find_opr_num<opr::ConvBias>(y1_opt));
+    ASSERT_EQ(3u, find_opr_num<opr::ConvBias>(y2_opt));
+    auto&& fused = find_opr<opr::DepthwisePointwiseConvBias>(y0_opt).param();
+    ASSERT_EQ(2u, fused.stride_h);
+    ASSERT_EQ(Param::NonlineMode::H_SWISH, fused.pw_nonline_mode);
+
+    HostTensorND host_y0, host_y0_opt, host_y1, host_y1_opt, host_y2, host_y2_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y0, host_y0), make_callback_copy(y0_opt, host_y0_opt),
+             make_callback_copy(y1, host_y1), make_callback_copy(y1_opt, host_y1_opt),
+             make_callback_copy(y2, host_y2),
+             make_callback_copy(y2_opt, host_y2_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y0, host_y0_opt, 1e-4);
+    MGB_ASSERT_TENSOR_NEAR(host_y1, host_y1_opt, 1e-4);
+    MGB_ASSERT_TENSOR_NEAR(host_y2, host_y2_opt, 1e-4);
+}
+
+TEST(TestGoptInference, FuseDepthwisePointwiseConvBiasQint8) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkcvar = [&](const char* name, const TensorShape& shp, const DType& dtype) {
+        return opr::TypeCvt::make(
+                opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name),
+                dtype);
+    };
+
+    using Param = opr::ConvBias::Param;
+    Param dw_param, pw_param;
+    dw_param.sparse = Param::Sparse::GROUP;
+    dw_param.pad_h = dw_param.pad_w = 2;
+    dw_param.nonlineMode = Param::NonlineMode::RELU;
+    auto x = opr::TypeCvt::make(
+            opr::Host2DeviceCopy::make(*graph, gen({1, 8, 12, 12}, cn)),
+            dtype::QuantizedS8(0.2f));
+    auto dw_w = mkcvar("dw_w", {8, 1, 1, 5, 5}, dtype::QuantizedS8(0.1f)),
+         dw_b = mkcvar("dw_b", {1, 8, 1, 1}, dtype::QuantizedS32(0.02f)),
+         pw_w = mkcvar("pw_w", {16, 8, 1, 1}, dtype::QuantizedS8(0.1f)),
+         pw_b = mkcvar("pw_b", {1, 16, 1, 1}, dtype::QuantizedS32(0.03f));
+    auto mid = opr::ConvBias::make(
+            x, dw_w, dw_b, dw_param, {}, OperatorNodeConfig{dtype::QuantizedS8(0.3f)});
+    auto y = opr::ConvBias::make(
+            mid, pw_w, pw_b, pw_param, {},
+            OperatorNodeConfig{dtype::QuantizedS8(0.4f)});
+
+    SymbolVar y_opt;
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_fuse_depthwise_pointwise_conv();
+    unpack_vector(gopt::optimize_for_inference({y}, options), y_opt);
+    ASSERT_EQ(0u, find_opr_num<opr::ConvBias>(y_opt));
+    ASSERT_EQ(
+            dtype::QuantizedS8(0.4f),
+            find_opr<opr::DepthwisePointwiseConvBias>(y_opt).output(0)->dtype());
+
+    auto float_y = opr::TypeCvt::make(y, dtype::Float32()),
+         float_y_opt = opr::TypeCvt::make(y_opt, dtype::Float32());
+    HostTensorND host_y, host_y_opt;
+    auto func = graph->compile(
+            {make_callback_copy(float_y, host_y),
+             make_callback_copy(float_y_opt, host_y_opt)});
+    func->execute();
+    // allow a step of the output scale for the ties of rounding
+    MGB_ASSERT_TENSOR_NEAR(host_y, host_y_opt, 0.41f);
+}
+
+TEST(TestGoptInference, FuseConvBiasPooling) {
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+
+    using Param = opr::ConvBias::Param;
+    using PoolingParam = opr::Pooling::Param;
+    Param param0, param1;
+    param0.pad_h = param0.pad_w = 1;
+    param0.nonlineMode = Param::NonlineMode::RELU;
+    param1.mode = Param::Mode::CONVOLUTION;
+    param1.stride_h = param1.stride_w = 2;
+    PoolingParam max_param, avg_param;
+    max_param.mode = PoolingParam::Mode::MAX;
+    max_param.window_h = max_param.window_w = 2;
+    max_param.stride_h = max_param.stride_w = 2;
+    avg_param.mode = PoolingParam::Mode::AVERAGE;
+    avg_param.window_h = avg_param.window_w = 3;
+    avg_param.stride_h = avg_param.stride_w = 2;
+    avg_param.pad_h = avg_param.pad_w = 1;
+    auto host_x = gen({2, 4, 21, 19}, cn);
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x);
+    auto w = mkcvar("w", {8, 4, 3, 3}), b = mkcvar("b", {1, 8, 1, 1});
+    // with a bias, without a bias, and with two readers of the conv output
+    // which prevent the fusion
+    auto y0 = opr::Pooling::make(opr::ConvBias::make(x, w, b, param0), max_param);
+    auto y1 = opr::Pooling::make(opr::ConvBias::make(x, w, param1), avg_param);
+    auto conv2 = opr::ConvBias::make(x, w, b, param1),
+         y2 = opr::Pooling::make(conv2, max_param) +
+              opr::Pooling::make(conv2, avg_param);
+    // too many channels for the direct kernel of ConvPooling to pay off
+    auto x3 = opr::Host2DeviceCopy::make(*graph, gen({1, 32, 16, 16}, cn));
+    auto y3 = opr::Pooling::make(
+            opr::ConvBias::make(
+                    x3, mkcvar("w3", {64, 32, 3, 3}), mkcvar("b3", {1, 64, 1, 1}),
+                    param0),
+            max_param);
+
+    SymbolVar y0_opt, y1_opt, y2_opt, y3_opt;
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_fuse_conv_bias_pooling();
+    unpack_vector(
+            gopt::optimize_for_inference({y0, y1, y2, y3}, options), y0_opt, y1_opt,
+            y2_opt, y3_opt);
+    ASSERT_EQ(1u, find_opr_num<opr::ConvBias>(y3_opt));
+    ASSERT_EQ(0u, find_opr_num<opr::ConvPooling>(y3_opt));
+    ASSERT_EQ(0u, find_opr_num<opr::ConvBias>(y0_opt));
+    ASSERT_EQ(0u, find_opr_num<opr::Pooling>(y0_opt));
+    ASSERT_EQ(0u, find_opr_num<opr::ConvBias>(y1_opt));
+    ASSERT_EQ(1u, find_opr_num<opr::ConvBias>(y2_opt));
+    ASSERT_EQ(2u, find_opr_num<opr::Pooling>(y2_opt));
+    auto&& fused = find_opr<opr::ConvPooling>(y1_opt).param();
+    ASSERT_EQ(opr::ConvPooling::Param::ConvMode::CONVOLUTION, fused.convMode);
+    ASSERT_EQ(opr::ConvPooling::Param::PoolMode::AVERAGE, fused.poolMode);
+    ASSERT_EQ(3u, fused.pool_shape_h);
+
+    HostTensorND host_y0, host_y0_opt, host_y1, host_y1_opt, host_y2, host_y2_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y0, host_y0), make_callback_copy(y0_opt, host_y0_opt),
+             make_callback_copy(y1, host_y1), make_callback_copy(y1_opt, host_y1_opt),
+             make_callback_copy(y2, host_y2),
+             make_callback_copy(y2_opt, host_y2_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y0, host_y0_opt, 1e-4);
+    MGB_ASSERT_TENSOR_NEAR(host_y1, host_y1_opt, 1e-4);
+    MGB_ASSERT_TENSOR_NEAR(host_y2, host_y2_opt, 1e-4);
+}
+
 #if (MEGDNN_AARCH64 || MEGDNN_ARMV7) && !MGB_OPENCL && !MGB_CUDA
 TEST(TestGoptInference, FuseTypeCvtAndElemwiseCase0) {
     HostTensorGenerator<dtype::Int16, RandomDistribution::UNIFORM> gen(0, 255);
@@ -713,4 +713,14 @@ SymbolVarArray SVD::make(
     return ret;
 }
 
+/* ================= WeightQuantMatrixMul =================  */
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(WeightQuantMatrixMul);
+MEGDNN_OPR_INIT3(WeightQuantMatrixMul, "weight_quant_matrix_mul")
+
+void WeightQuantMatrixMul::init_output_dtype() {
+    //! the weights are int8 while the output has the dtype of the activations
+    output(0)->dtype(input(0)->dtype());
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
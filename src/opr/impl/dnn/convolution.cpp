@@ -1535,6 +1535,37 @@ void BatchConvBiasForward::init_output_format() {
     output(0)->format(input(0)->format());
 }
 
+/* ==================== DepthwisePointwiseConvBiasForward  ==================== */
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(DepthwisePointwiseConvBiasForward);
+
+DepthwisePointwiseConvBiasForward::DepthwisePointwiseConvBiasForward(
+        VarNode* src, VarNode* dw_filter, VarNode* dw_bias, VarNode* pw_filter,
+        VarNode* pw_bias, const Param& param, const OperatorNodeConfig& config)
+        : Super(src->owner_graph(), config, "depthwise_pointwise_conv_bias", {src}) {
+    init_megdnn_opr(*this, param);
+    add_input({src, dw_filter, dw_bias, pw_filter, pw_bias});
+}
+
+SymbolVar DepthwisePointwiseConvBiasForward::make(
+        SymbolVar src, SymbolVar dw_filter, SymbolVar dw_bias, SymbolVar pw_filter,
+        SymbolVar pw_bias, const Param& param, const OperatorNodeConfig& config) {
+    return src.insert_single_output_opr<DepthwisePointwiseConvBiasForward>(
+            src.node(), dw_filter.node(), dw_bias.node(), pw_filter.node(),
+            pw_bias.node(), param, config);
+}
+
+void DepthwisePointwiseConvBiasForward::init_output_dtype() {
+    DType output_dtype = config().output_dtype();
+    megdnn_opr()->deduce_dtype(
+            input(0)->dtype(), input(1)->dtype(), input(2)->dtype(), input(3)->dtype(),
+            input(4)->dtype(), output_dtype);
+    output(0)->dtype(output_dtype);
+}
+
+/* ==================== ConvPoolingForward  ==================== */
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(ConvPoolingForward);
+MEGDNN_OPR_INIT3(ConvPoolingForward, "conv_pooling")
+
 #undef IMPL_CONV
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
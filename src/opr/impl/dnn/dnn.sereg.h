@@ -674,6 +674,8 @@ MGB_SEREG_OPR_AND_REG_SHALLOW_COPY(
 
 using ConvBiasForwardV4 = ConvBiasForward;
 MGB_SEREG_OPR_AND_REG_SHALLOW_COPY(ConvBiasForwardV4, 0, opr_shallow_copy_conv);
+MGB_SEREG_OPR(DepthwisePointwiseConvBias, 5);
+MGB_SEREG_OPR(ConvPooling, 3);
 
 using BatchNormV1 = BatchNorm;
 using BatchNormBackwardV1 = BatchNormBackward;
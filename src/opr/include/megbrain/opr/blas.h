@@ -112,6 +112,27 @@ public:
             const OperatorNodeConfig& config = {});
 };
 
+/*!
+ * \brief matrix mul of float activations and int8/int4 weights with their
+ *      scales, see megdnn::WeightQuantMatrixMul
+ *
+ * It is usually made by gopt::ConvertWeightQuantMatrixMulPass from a matrix
+ * mul with constant float weights.
+ */
+MGB_DEFINE_OPR_CLASS(
+        WeightQuantMatrixMul,
+        intl::MegDNNOprWrapperFwd<megdnn::WeightQuantMatrixMul>) // {
+    void init_output_dtype() override;
+
+public:
+    MGE_WIN_DECLSPEC_FUC WeightQuantMatrixMul(
+            VarNode* a, VarNode* weight, VarNode* scale, const Param& param,
+            const OperatorNodeConfig& config);
+    MGE_WIN_DECLSPEC_FUC static SymbolVar make(
+            SymbolVar a, SymbolVar weight, SymbolVar scale, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+};
+
 }  // namespace opr
 }  // namespace mgb
 
@@ -172,6 +172,50 @@ public:
 };
 using ConvBias = ConvBiasForward;
 
+/*!
+ * \brief a channel-wise conv followed by a 1x1 conv, each with a bias and a
+ *      nonlinearity, see megdnn::DepthwisePointwiseConvBias
+ *
+ * It is usually made by gopt::FuseDepthwisePointwiseConvBiasPass from two
+ * ConvBias oprs. The output dtype must be given in the config for int8.
+ */
+MGB_DEFINE_OPR_CLASS_WITH_EXPORT(
+        DepthwisePointwiseConvBiasForward,
+        intl::MegDNNOprWrapperFwd<megdnn::DepthwisePointwiseConvBiasForward>) // {
+    void init_output_dtype() override;
+
+public:
+    MGE_WIN_DECLSPEC_FUC DepthwisePointwiseConvBiasForward(
+            VarNode* src, VarNode* dw_filter, VarNode* dw_bias, VarNode* pw_filter,
+            VarNode* pw_bias, const Param& param, const OperatorNodeConfig& config);
+
+    MGE_WIN_DECLSPEC_FUC static SymbolVar make(
+            SymbolVar src, SymbolVar dw_filter, SymbolVar dw_bias,
+            SymbolVar pw_filter, SymbolVar pw_bias, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+};
+using DepthwisePointwiseConvBias = DepthwisePointwiseConvBiasForward;
+
+/*!
+ * \brief a dense conv with a bias and a nonlinearity followed by a pooling,
+ *      see megdnn::ConvPooling
+ *
+ * It is usually made by gopt::FuseConvBiasPoolingPass from a ConvBias and a
+ * Pooling.
+ */
+MGB_DEFINE_OPR_CLASS_WITH_EXPORT(
+        ConvPoolingForward, intl::MegDNNOprWrapperFwd<megdnn::ConvPoolingForward>) // {
+public:
+    MGE_WIN_DECLSPEC_FUC ConvPoolingForward(
+            VarNode* src, VarNode* filter, VarNode* bias, const Param& param,
+            const OperatorNodeConfig& config);
+
+    MGE_WIN_DECLSPEC_FUC static SymbolVar make(
+            SymbolVar src, SymbolVar filter, SymbolVar bias, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+};
+using ConvPooling = ConvPoolingForward;
+
 /*!
  * \brief Can be used in two ways: compute gradient of conv, or deconv
  */
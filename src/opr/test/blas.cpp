@@ -416,9 +416,10 @@ TEST(TestOprDNN, MatrixMulExePolicy) {
 #if MGB_ENABLE_FASTRUN
     for (auto strategy : SmallVector<S>{
                  S::PROFILE, S::HEURISTIC, S::PROFILE | S::REPRODUCIBLE,
-                 S::PROFILE | S::HEURISTIC}) {
+                 S::PROFILE | S::HEURISTIC, S::COST_MODEL,
+                 S::COST_MODEL | S::PROFILE}) {
 #else
-    for (auto strategy : {S : HEURISTIC, S::PROFILE | S::HEURISTIC}) {
+    for (auto strategy : {S : HEURISTIC, S::PROFILE | S::HEURISTIC, S::COST_MODEL}) {
 #endif
 
         auto graph = ComputingGraph::make();
@@ -5,6 +5,7 @@
 #include "megbrain/opr/basic_arith.h"
 #include "megbrain/opr/dnn/convolution.h"
 #include "megbrain/opr/tensor_manip.h"
+#include "megbrain/rdnn/cost_model.h"
 #include "megbrain/serialization/serializer.h"
 #include "megbrain/test/autocheck.h"
 #include "megbrain/test/helper.h"
@@ -372,6 +373,117 @@ TEST(TestOprDNN, ConvBiasExePolicy) {
     PersistentCache::set_impl(orig_impl);
 }
 
+TEST(TestOprDNN, ConvBiasCostModel) {
+    using Param = opr::ConvBias::Param;
+    using Policy = opr::ConvBias::ExecutionPolicy;
+    using S = Policy::Strategy;
+
+    auto cn = CompNode::load("cpux");
+    HostTensorGenerator<> gen;
+    auto host_x = gen({2, 16, 23, 23}, cn), host_w = gen({32, 16, 3, 3}, cn),
+         host_b = gen({1, 32, 1, 1}, cn);
+
+    auto run = [&](S strategy, HostTensorND& host_y) {
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+             w = opr::Host2DeviceCopy::make(*graph, host_w),
+             b = opr::Host2DeviceCopy::make(*graph, host_b);
+        Param param;
+        param.pad_h = param.pad_w = 1;
+        param.nonlineMode = Param::NonlineMode::RELU;
+        Policy policy;
+        policy.strategy = strategy;
+        auto y = opr::ConvBias::make(x, w, b, param, policy);
+        auto func = graph->compile({make_callback_copy(y, host_y)});
+        func->execute();
+        megdnn::AlgorithmCache::instance().clear();
+    };
+
+    HostTensorND host_y_heuristic, host_y_cost_model;
+    run(S::HEURISTIC, host_y_heuristic);
+    run(S::COST_MODEL, host_y_cost_model);
+    MGB_ASSERT_TENSOR_NEAR(host_y_heuristic, host_y_cost_model, 1e-3);
+}
+
+TEST(TestOprDNN, ConvBiasCostModelRank) {
+    using CostModel = rdnn::CostModel;
+    using Attribute = megdnn::AlgoAttribute;
+    //! only the name and the attribute of an algo are seen by the cost model
+    struct Algo final : megdnn::Algorithm {
+        std::string m_name;
+        Attribute m_attr;
+        Algo(std::string name, Attribute attr = Attribute::DEFAULT)
+                : m_name{std::move(name)}, m_attr{attr} {}
+        Attribute attribute() const override { return m_attr; }
+        const char* name() const override { return m_name.c_str(); }
+        uint32_t type() const override { return 0; }
+    };
+
+    //! no efficiency fitted by fastrun, so the priors of the table are used
+    auto orig_impl =
+            PersistentCache::set_impl(std::make_shared<InMemoryPersistentCache>());
+    CostModel::HostParam host{8.f, 8.f, 24.f, 5.f};
+    constexpr size_t NR_THREADS = 4;
+
+    //! names of \p algos sorted by the estimated time of a float32 NCHW conv
+    auto rank = [&](const TensorShape& xshp, const TensorShape& wshp, uint32_t pad,
+                    std::vector<Algo>& algos) {
+        megdnn::param::ConvBias param;
+        param.pad_h = param.pad_w = pad;
+        TensorShape yshp{
+                xshp[0], wshp[0], xshp[2] + 2 * pad - wshp[2] + 1,
+                xshp[3] + 2 * pad - wshp[3] + 1};
+        TensorLayoutArray layouts{
+                {xshp, dtype::Float32()},
+                {wshp, dtype::Float32()},
+                {{1, wshp[0], 1, 1}, dtype::Float32()},
+                {dtype::Float32()},
+                {yshp, dtype::Float32()}};
+        std::string param_str;
+        megdnn::Algorithm::serialize_write_pod(param, param_str);
+        auto workload = CostModel::workload(
+                megdnn::Algorithm::OprType::CONVBIAS_FORWARD, param_str, layouts);
+        mgb_assert(workload.valid());
+        std::vector<std::pair<double, std::string>> times;
+        for (auto&& algo : algos) {
+            times.emplace_back(
+                    CostModel::estimate_time(host, *workload, &algo, 0, NR_THREADS),
+                    algo.m_name);
+        }
+        std::sort(times.begin(), times.end());
+        std::vector<std::string> ret;
+        for (auto&& i : times) {
+            ret.push_back(i.second);
+        }
+        return ret;
+    };
+
+    //! compute bound: winograd saves more multiplications than its
+    //! transforms cost, and the naive algo runs on a single thread
+    std::vector<Algo> algos_3x3{
+            {"X86_CONV_BIAS_DIRECT_STRIDE1_LARGE_GROUP"},
+            {"IM2COLMATMUL:X86_F32_MKL_PACKA:192"},
+            {"NAIVE_CONV_BIAS", Attribute::NAIVE},
+            {"WINOGRAD:FB_GI_F32_MK4_4x8:4:2:32"}};
+    std::vector<std::string> expect_3x3{
+            "WINOGRAD:FB_GI_F32_MK4_4x8:4:2:32", "IM2COLMATMUL:X86_F32_MKL_PACKA:192",
+            "X86_CONV_BIAS_DIRECT_STRIDE1_LARGE_GROUP", "NAIVE_CONV_BIAS"};
+    ASSERT_EQ(expect_3x3, rank({1, 64, 56, 56}, {64, 64, 3, 3}, 1, algos_3x3));
+
+    //! memory bound: the unfold of im2col costs more than the matmul, while
+    //! conv1x1 reads the input in place
+    std::vector<Algo> algos_1x1{
+            {"IM2COLMATMUL:X86_F32_MKL_PACKA:192"},
+            {"CONV1x1:X86_F32_MKL_PACKA:24"},
+            {"NAIVE_CONV_BIAS", Attribute::NAIVE}};
+    std::vector<std::string> expect_1x1{
+            "CONV1x1:X86_F32_MKL_PACKA:24", "IM2COLMATMUL:X86_F32_MKL_PACKA:192",
+            "NAIVE_CONV_BIAS"};
+    ASSERT_EQ(expect_1x1, rank({1, 8, 112, 112}, {8, 8, 1, 1}, 0, algos_1x1));
+
+    PersistentCache::set_impl(orig_impl);
+}
+
 TEST(TestOprDNN, ConvBiasExePolicy_Quantized8Asym) {
     using Param = opr::ConvBias::Param;
     Param param;
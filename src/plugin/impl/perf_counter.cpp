@@ -0,0 +1,262 @@
+#include "megbrain/plugin/perf_counter.h"
+
+#if MGB_ENABLE_PERF_COUNTER
+#include "megbrain/comp_node_env.h"
+#include "megbrain/graph/event.h"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace mgb;
+
+MGB_TYPEINFO_OBJ_IMPL(PerfCounterHolder);
+
+namespace {
+
+using Counter = PerfCounterProfiler::Counter;
+using CounterValues = PerfCounterProfiler::CounterValues;
+
+/*!
+ * \brief counters of the calling thread, opened as a group so they are
+ *      scheduled onto the pmu together
+ */
+class CounterGroup : public NonCopyableObj {
+    int m_fds[Counter::NR_COUNTER];
+    int m_leader = -1;
+    //! positions of the counters in the values read from the group
+    int m_pos[Counter::NR_COUNTER];
+    int m_nr_opened = 0;
+
+    static perf_event_attr make_attr(Counter counter) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        auto cache_miss = [](uint64_t cache) {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        switch (counter) {
+            case Counter::CYCLES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case Counter::INSTRUCTIONS:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case Counter::LLC_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cache_miss(PERF_COUNT_HW_CACHE_LL);
+                break;
+            case Counter::DTLB_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cache_miss(PERF_COUNT_HW_CACHE_DTLB);
+                break;
+            default:
+                mgb_throw(MegBrainError, "bad perf counter %zu", size_t(counter));
+        }
+        return attr;
+    }
+
+public:
+    CounterGroup() {
+        for (size_t i = 0; i < Counter::NR_COUNTER; ++i) {
+            auto attr = make_attr(static_cast<Counter>(i));
+            // the first counter opened leads the group
+            int fd = syscall(__NR_perf_event_open, &attr, 0, -1, m_leader, 0);
+            m_fds[i] = fd;
+            m_pos[i] = -1;
+            if (fd < 0) {
+                continue;
+            }
+            if (m_leader < 0) {
+                m_leader = fd;
+            }
+            m_pos[i] = m_nr_opened++;
+        }
+        if (m_leader >= 0) {
+            ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    ~CounterGroup() {
+        for (int fd : m_fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    //! the group of the calling thread
+    static CounterGroup& get() {
+        thread_local CounterGroup group;
+        return group;
+    }
+
+    bool has(Counter counter) const { return m_pos[counter] >= 0; }
+
+    //! read the counters, scaled up if the group is multiplexed; return a mask
+    //! of the available counters
+    unsigned read(CounterValues& values) const {
+        if (m_leader < 0) {
+            return 0;
+        }
+        // nr, time_enabled, time_running and the values
+        uint64_t buf[3 + Counter::NR_COUNTER];
+        auto size = sizeof(uint64_t) * (3 + m_nr_opened);
+        if (::read(m_leader, buf, size) != static_cast<ssize_t>(size) ||
+            buf[0] != static_cast<uint64_t>(m_nr_opened)) {
+            return 0;
+        }
+        double scale = buf[2] ? static_cast<double>(buf[1]) / buf[2] : 1.;
+        unsigned mask = 0;
+        for (size_t i = 0; i < Counter::NR_COUNTER; ++i) {
+            if (m_pos[i] >= 0) {
+                values[i] = static_cast<uint64_t>(buf[3 + m_pos[i]] * scale);
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+    }
+};
+
+}  // namespace
+
+PerfCounterProfiler::PerfCounterProfiler(cg::ComputingGraph* graph)
+        : PluginBase(graph) {
+    graph->options().user_data.get_user_data_or_create<PerfCounterHolder>()->profiler =
+            this;
+
+    // counters are read by tasks dispatched to the cpu comp node, which run
+    // right before and after the kernels of the operator on the same thread
+    auto dispatch = [](CompNode cn, thin_function<void()> task) {
+        CompNodeEnv::from_comp_node(cn).cpu_env().dispatch(std::move(task));
+    };
+    auto on_exec_start = [this, dispatch](const cg::event::OprExecKernelStart& event) {
+        auto opr = event.opr;
+        for (auto cn : cg::get_opr_comp_node_set(opr)) {
+            if (cn.device_type() != CompNode::DeviceType::CPU) {
+                continue;
+            }
+            {
+                MGB_LOCK_GUARD(m_mtx);
+                auto&& rst = m_result[opr];
+                if (!rst.nr_exec) {
+                    rst.footprint = m_opr_footprint.calc_footprint(opr);
+                }
+            }
+            auto callback = [this, dispatch, opr, cn]() {
+                dispatch(cn, [this, opr, cn]() { on_kern_start(opr, cn); });
+            };
+            event.env->dispatch_on_comp_node(cn, callback);
+        }
+    };
+    auto on_exec_finish = [this, dispatch](const cg::event::OprExecKernelEnd& event) {
+        auto opr = event.opr;
+        for (auto cn : cg::get_opr_comp_node_set(opr)) {
+            if (cn.device_type() != CompNode::DeviceType::CPU) {
+                continue;
+            }
+            auto callback = [this, dispatch, opr, cn]() {
+                dispatch(cn, [this, opr, cn]() { on_kern_end(opr, cn); });
+            };
+            event.env->dispatch_on_comp_node(cn, callback);
+        }
+    };
+    auto on_graph_compile = [this](const cg::event::CompSeqOrderDetermined&) {
+        MGB_LOCK_GUARD(m_mtx);
+        m_start.clear();
+        m_result.clear();
+    };
+    auto&& ev = graph->event();
+    add_event_handler(
+            ev.register_receiver<cg::event::OprExecKernelStart>(on_exec_start));
+    add_event_handler(
+            ev.register_receiver<cg::event::OprExecKernelEnd>(on_exec_finish));
+    add_event_handler(
+            ev.register_receiver<cg::event::CompSeqOrderDetermined>(on_graph_compile));
+}
+
+PerfCounterProfiler::~PerfCounterProfiler() noexcept {
+    m_owner_graph->options().user_data.pop_user_data<PerfCounterHolder>();
+}
+
+const char* PerfCounterProfiler::counter_name(Counter counter) {
+    static const char* names[] = {
+            "cycles", "instructions", "llc_misses", "dtlb_misses"};
+    static_assert(sizeof(names) / sizeof(names[0]) == NR_COUNTER, "bad counter names");
+    return names[counter];
+}
+
+bool PerfCounterProfiler::is_available(Counter counter) {
+    return CounterGroup::get().has(counter);
+}
+
+void PerfCounterProfiler::on_kern_start(cg::OperatorNodeBase* opr, CompNode comp_node) {
+    Snapshot snapshot;
+    snapshot.available = CounterGroup::get().read(snapshot.values);
+    MGB_LOCK_GUARD(m_mtx);
+    m_start[{opr, comp_node}] = snapshot;
+}
+
+void PerfCounterProfiler::on_kern_end(cg::OperatorNodeBase* opr, CompNode comp_node) {
+    CounterValues values;
+    unsigned available = CounterGroup::get().read(values);
+    MGB_LOCK_GUARD(m_mtx);
+    auto&& start = m_start[{opr, comp_node}];
+    auto&& rst = m_result[opr];
+    available &= start.available;
+    for (size_t i = 0; i < NR_COUNTER; ++i) {
+        if (available & (1u << i)) {
+            rst.values[i] += values[i] - start.values[i];
+        }
+    }
+    rst.available |= available;
+    ++rst.nr_exec;
+    start.available = 0;
+}
+
+std::shared_ptr<json::Object> PerfCounterProfiler::to_json() const {
+    using namespace json;
+    auto ret = Object::make();
+    for (auto&& i : m_result) {
+        auto&& rst = i.second;
+        if (!rst.nr_exec) {
+            continue;
+        }
+        auto obj = Object::make(
+                {{"name", String::make(i.first->name())},
+                 {"type", String::make(i.first->dyn_typeinfo()->name)},
+                 {"nr_exec", NumberInt::make(rst.nr_exec)},
+                 {"computation", NumberInt::make(rst.footprint.computation)},
+                 {"memory", NumberInt::make(rst.footprint.memory)}});
+        for (size_t j = 0; j < NR_COUNTER; ++j) {
+            if (rst.available & (1u << j)) {
+                (*obj)[counter_name(static_cast<Counter>(j))] =
+                        NumberInt::make(rst.values[j]);
+            }
+        }
+        unsigned ipc_mask = (1u << CYCLES) | (1u << INSTRUCTIONS);
+        if ((rst.available & ipc_mask) == ipc_mask && rst.values[CYCLES]) {
+            (*obj)["ipc"] = Number::make(
+                    static_cast<double>(rst.values[INSTRUCTIONS]) / rst.values[CYCLES]);
+        }
+        if (rst.footprint.memory) {
+            (*obj)["arithmetic_intensity"] =
+                    Number::make(static_cast<double>(rst.footprint.computation) /
+                                 rst.footprint.memory);
+        }
+        (*ret)[i.first->id_str()] = obj;
+    }
+    return ret;
+}
+
+#endif  // MGB_ENABLE_PERF_COUNTER
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -1,5 +1,6 @@
 #include "megbrain/plugin/profiler.h"
 #include "megbrain/plugin/opr_footprint.h"
+#include "megbrain/plugin/perf_counter.h"
 
 #if MGB_ENABLE_JSON
 #include "megbrain/graph/event.h"
@@ -191,11 +192,19 @@ std::shared_ptr<json::Object> GraphProfiler::to_json() const {
             opr_itnl_pf_item[pf_pair.first->id_str()] = pf_pair.second;
         }
     }
-    return Object::make(
+    auto ret = Object::make(
             {{"device", dev_prof},
              {"host", host_prof},
              {"opr_footprint", opr_fp},
              {"opr_internal_pf", opr_internal_pf}});
+#if MGB_ENABLE_PERF_COUNTER
+    auto perf_counter_holder =
+            m_owner_graph->options().user_data.get_user_data<PerfCounterHolder>();
+    if (perf_counter_holder.second) {
+        (*ret)["perf_counter"] = perf_counter_holder.first[0]->profiler->to_json();
+    }
+#endif
+    return ret;
 }
 
 #endif  // MGB_ENABLE_JSON
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "megbrain/plugin/base.h"
+#include "megbrain/plugin/opr_footprint.h"
+
+#if MGB_ENABLE_JSON && defined(__linux__)
+#define MGB_ENABLE_PERF_COUNTER 1
+#else
+#define MGB_ENABLE_PERF_COUNTER 0
+#endif
+
+#if MGB_ENABLE_PERF_COUNTER
+
+#include <array>
+
+namespace mgb {
+
+/*!
+ * \brief count hardware events of the kernels of operators on cpu comp nodes
+ *      with linux perf_event
+ *
+ * The counters are opened on each thread running the kernels, and read right
+ * before and after the kernels of an operator on the thread, so the deltas are
+ * attributed to the operator. On a multithread comp node only the events on
+ * its dispatching thread are counted. Counters unavailable on the platform or
+ * forbidden by perf_event_paranoid are reported as missing.
+ */
+class PerfCounterProfiler final : public PluginBase {
+public:
+    enum Counter : size_t {
+        CYCLES = 0,
+        INSTRUCTIONS,
+        LLC_MISSES,
+        DTLB_MISSES,
+        NR_COUNTER
+    };
+    using CounterValues = std::array<uint64_t, NR_COUNTER>;
+
+    struct OprResult {
+        size_t nr_exec = 0;
+        //! bit i is set if counter i is available
+        unsigned available = 0;
+        CounterValues values{};
+        OprFootprint::Result footprint;
+    };
+
+    MGE_WIN_DECLSPEC_FUC PerfCounterProfiler(cg::ComputingGraph* graph);
+    MGE_WIN_DECLSPEC_FUC ~PerfCounterProfiler() noexcept;
+
+    static const char* counter_name(Counter counter);
+
+    //! whether \p counter could be opened on the calling thread
+    MGE_WIN_DECLSPEC_FUC static bool is_available(Counter counter);
+
+    //! sum of the counters over the executions of each operator
+    const ThinHashMap<cg::OperatorNodeBase*, OprResult>& result() const {
+        return m_result;
+    }
+
+    /*!
+     * \brief counters of each operator, with its footprint and derived
+     *      metrics
+     *
+     * keys of each operator: name, type, nr_exec, the name of each available
+     * counter, computation, memory, ipc, and arithmetic_intensity which is
+     * computation per byte of memory
+     */
+    MGE_WIN_DECLSPEC_FUC std::shared_ptr<json::Object> to_json() const;
+
+private:
+    struct Snapshot {
+        unsigned available = 0;
+        CounterValues values{};
+    };
+
+    MGB_MUTEX m_mtx;
+    //! counters read before the kernels of (opr, comp node)
+    std::unordered_map<std::pair<cg::OperatorNodeBase*, CompNode>, Snapshot, pairhash>
+            m_start;
+    ThinHashMap<cg::OperatorNodeBase*, OprResult> m_result;
+    OprFootprint m_opr_footprint;
+
+    void on_kern_start(cg::OperatorNodeBase* opr, CompNode comp_node);
+    void on_kern_end(cg::OperatorNodeBase* opr, CompNode comp_node);
+};
+
+/*!
+ * \brief user data of a graph to find its PerfCounterProfiler, whose results
+ *      are added to GraphProfiler::to_json()
+ */
+class PerfCounterHolder final : public UserDataContainer::UserData {
+    MGB_TYPEINFO_OBJ_DECL;
+
+public:
+    PerfCounterProfiler* profiler = nullptr;
+};
+
+}  // namespace mgb
+
+#endif  // MGB_ENABLE_PERF_COUNTER
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
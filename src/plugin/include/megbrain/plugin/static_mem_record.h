@@ -25,6 +25,8 @@ public:
 
     void active() { m_is_record = true; }
 
+    void deactive() { m_is_record = false; }
+
     bool valid() { return m_is_record; }
 
     void clear_opr_seq() { m_opr_seq_recorder.clear(); }
@@ -37,6 +39,10 @@ public:
         m_memory_chunk_recorder.push_back(mcr);
     }
 
+    const std::vector<memory_chunk_record>& memory_chunk() const {
+        return m_memory_chunk_recorder;
+    }
+
     void regist_memory_chunk_owner_var_name(size_t id, std::string name) {
         m_memory_chunk_recorder.at(id).owner_var_name = name;
     }
@@ -0,0 +1,53 @@
+#include "megbrain/plugin/perf_counter.h"
+#include "megbrain/opr/basic_arith_wrapper.h"
+#include "megbrain/opr/blas.h"
+#include "megbrain/opr/io.h"
+#include "megbrain/plugin/profiler.h"
+#include "megbrain/test/helper.h"
+
+#if MGB_ENABLE_PERF_COUNTER
+
+using namespace mgb;
+
+TEST(TestPerfCounterProfiler, MatMul) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto host_x = gen({64, 64}, cn), host_y = gen({64, 64}, cn);
+    auto graph = ComputingGraph::make();
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+         y = opr::Host2DeviceCopy::make(*graph, host_y),
+         z = opr::MatrixMul::make(x, y) + x;
+
+    HostTensorND host_z;
+    auto func = graph->compile({make_callback_copy(z, host_z)});
+    auto graph_profiler = std::make_shared<GraphProfiler>(graph.get());
+    auto profiler = std::make_shared<PerfCounterProfiler>(graph.get());
+    for (int i = 0; i < 3; ++i) {
+        func->execute().wait();
+    }
+
+    auto&& result = profiler->result();
+    auto matmul = z.node()->owner_opr()->input(0)->owner_opr();
+    ASSERT_TRUE(result.count(matmul));
+    auto&& rst = result.at(matmul);
+    ASSERT_EQ(3u, rst.nr_exec);
+    ASSERT_EQ(64u * 64 * 64 * 2, rst.footprint.computation);
+    for (size_t i = 0; i < PerfCounterProfiler::NR_COUNTER; ++i) {
+        auto counter = static_cast<PerfCounterProfiler::Counter>(i);
+        if (PerfCounterProfiler::is_available(counter)) {
+            ASSERT_TRUE(rst.available & (1u << i)) << profiler->counter_name(counter);
+        }
+    }
+    if (rst.available & (1u << PerfCounterProfiler::INSTRUCTIONS)) {
+        // a 64x64x64 matmul takes far more than 64^2 instructions
+        ASSERT_GT(rst.values[PerfCounterProfiler::INSTRUCTIONS], 64u * 64 * 3);
+    }
+
+    auto json = graph_profiler->to_json();
+    ASSERT_TRUE((*json)["perf_counter"]);
+    json->writeto_fpath(output_file("test_perf_counter.json"));
+}
+
+#endif  // MGB_ENABLE_PERF_COUNTER
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
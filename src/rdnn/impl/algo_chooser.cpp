@@ -1,8 +1,10 @@
 #include <limits>
 #include <unordered_set>
 
+#include "megbrain/comp_node_env.h"
 #include "megbrain/exception.h"
 #include "megbrain/rdnn/algo_chooser.h"
+#include "megbrain/rdnn/cost_model.h"
 #include "megbrain/utils/invoke.h"
 
 //! TODO: here has to be know some megdnn::opr when there is produced midout.h
@@ -558,6 +560,78 @@ typename AlgoChooser<Opr>::ImplExecutionPolicy AlgoChooser<Opr>::AlgoChooserHelp
     MIDOUT_E
 }
 
+template <typename Opr>
+typename AlgoChooser<Opr>::ImplExecutionPolicy AlgoChooser<Opr>::AlgoChooserHelper::
+        choose_by_cost_model(const ExecutionStrategy& selected_strategy) const {
+    MIDOUT_B(Opr, midout_iv(MGB_HASH_STR("choose_by_cost_model")))
+    auto workload = CostModel::workload(
+            OprTypeFromOprTrait<Opr>::opr_type, m_param,
+            to_layout_array<Opr>(m_fastrun_layouts));
+    if (m_cn.device_type() != CompNode::DeviceType::CPU || !workload.valid()) {
+        return choose_by_heuristic(selected_strategy);
+    }
+    size_t nr_threads =
+            CompNodeEnv::from_comp_node(m_cn).cpu_env().dispatcher->nr_threads();
+    auto workspace_limit =
+            m_desc.get_workspace_limit(m_cn, m_execution_policy.workspace_limit);
+    auto target_attr = extract_algo_attribute(selected_strategy);
+    std::string layouts_str = AlgoChooser::format_fixlayouts(m_fastrun_layouts);
+
+    ImplExecutionPolicy best_policy;
+    double best_time = std::numeric_limits<double>::max();
+    for (auto&& algo_info :
+         APPLY(m_dnn_opr->get_all_algorithms_info(args...), m_fastrun_layouts)) {
+        Algorithm* palgo = m_dnn_opr->get_algorithm_from_desc(algo_info.desc);
+        mgb_assert(palgo, "Unknown algo description");
+        if (!palgo->contain_attribute_all(target_attr.first) ||
+            palgo->contain_attribute_any(target_attr.second)) {
+            continue;
+        }
+
+        //! sub oprs are also chosen by the cost model
+        ImplExecutionPolicy policy;
+        policy.algo = algo_info.desc;
+        std::vector<Algorithm::SearchItem>&& sub_items = palgo->get_subopr_list(
+                to_layout_array<Opr>(m_fastrun_layouts), m_dnn_opr);
+        FOREACH_OPR_TYPE_DISPATCH(sub_items, {
+            auto&& megdnn_opr = opr::intl::create_megdnn_opr<_Opr>(m_cn);
+            megdnn_opr->param() =
+                    Algorithm::deserialize_read_pod<typename _Opr::Param>(_item.param);
+            typename AlgoChooser<_Opr>::AlgoChooserHelper sub_helper(
+                    to_fixed_layouts<_Opr>(_item.layouts), megdnn_opr.get(),
+                    _item.param, m_cn, m_execution_policy, m_allow_weight_preprocess,
+                    m_desc);
+            policy.sub_policy.push_back(
+                    sub_helper.choose_by_cost_model(selected_strategy));
+        });
+
+        size_t workspace = get_workspace_size_bytes(policy);
+        if (workspace > workspace_limit) {
+            continue;
+        }
+        double time =
+                CostModel::estimate_time(workload.val(), palgo, workspace, nr_threads);
+        mgb_log_debug(
+                "cost model %s algorithm %s %s: workspace: %zu; time: %.3gsec",
+                ::MegDNNOpr2Typename<Opr>::name, algo_info.desc.name.c_str(),
+                layouts_str.c_str(), workspace, time);
+        if (time < best_time) {
+            best_time = time;
+            best_policy = std::move(policy);
+        }
+    }
+
+    if (!best_policy.algo.valid()) {
+        mgb_log_warn(
+                "no %s algorithm %s meets the requirement of cost model, fallback "
+                "to heuristic",
+                ::MegDNNOpr2Typename<Opr>::name, layouts_str.c_str());
+        return choose_by_heuristic(selected_strategy);
+    }
+    return best_policy;
+    MIDOUT_E
+}
+
 template <typename Opr>
 typename AlgoChooser<Opr>::ImplExecutionPolicy AlgoChooser<Opr>::AlgoChooserHelper::
         choose_by_profile(
@@ -903,6 +977,16 @@ void AlgoChooser<Opr>::AlgoChooserHelper::profile(
 
     auto workspace_limit =
             m_desc.get_workspace_limit(m_cn, m_execution_policy.workspace_limit);
+    //! the measured times are also used to fit the cost model
+    Maybe<CostModel::Workload> workload;
+    size_t nr_threads = 1;
+    if (m_cn.device_type() == CompNode::DeviceType::CPU) {
+        workload = CostModel::workload(
+                OprTypeFromOprTrait<Opr>::opr_type, m_param,
+                to_layout_array<Opr>(m_fastrun_layouts));
+        nr_threads =
+                CompNodeEnv::from_comp_node(m_cn).cpu_env().dispatcher->nr_threads();
+    }
     RealTimer timer;
     std::unordered_set<std::string> rst_algos;
     if (rst.second.valid()) {
@@ -973,6 +1057,10 @@ void AlgoChooser<Opr>::AlgoChooserHelper::profile(
         mgb_log_debug(
                 "%s: workspace: %zu; time: %.3gsec", msg.c_str(), rst.workspace,
                 rst.time);
+        if (workload.valid()) {
+            CostModel::update_efficiency(
+                    workload.val(), palgo, rst.workspace, nr_threads, rst.time);
+        }
         prof_rst.push_back(rst);
     }
     std::string msg = ssprintf(
@@ -1078,6 +1166,9 @@ std::pair<AlgoAttribute, AlgoAttribute> AlgoChooser<Opr>::AlgoChooserHelper::
     AlgoChooser<megdnn::Opr>::AlgoChooserHelper::choose_by_heuristic(             \
             const ExecutionStrategy& select_strategy) const;                      \
     template typename AlgoChooser<megdnn::Opr>::ImplExecutionPolicy               \
+    AlgoChooser<megdnn::Opr>::AlgoChooserHelper::choose_by_cost_model(            \
+            const ExecutionStrategy& select_strategy) const;                      \
+    template typename AlgoChooser<megdnn::Opr>::ImplExecutionPolicy               \
     AlgoChooser<megdnn::Opr>::AlgoChooserHelper::choose_by_profile(               \
             const ExecutionStrategy& select_strategy, bool enable_update) const;  \
     template typename std::pair<                                                  \
@@ -1128,9 +1219,23 @@ typename AlgoChooser<Opr>::ImplExecutionPolicy AlgoChooser<Opr>::get_policy(
         if (strategy & ExecutionStrategy::OPTIMIZED) {
             ret += "OPTIMIZED ";
         }
+        if (strategy & ExecutionStrategy::COST_MODEL) {
+            ret += "COST_MODEL ";
+        }
         return ret;
     };
     mgb_log_debug("Use Stragegy :%s", strategy2str(opr_strategy).c_str());
+    if (opr_strategy & ExecutionStrategy::COST_MODEL) {
+        //! the cost model sits between heuristic and profile: use the profiled
+        //! result in cache if PROFILE is also set, but never run profiling
+        if (opr_strategy & ExecutionStrategy::PROFILE) {
+            ImplExecutionPolicy policy = helper.choose_by_profile(opr_strategy, false);
+            if (policy.algo.valid()) {
+                return policy;
+            }
+        }
+        return helper.choose_by_cost_model(opr_strategy);
+    }
     if (opr_strategy & ExecutionStrategy::HEURISTIC) {
         if (opr_strategy & ExecutionStrategy::PROFILE) {
             //! this strategy will choose from cache first, then choost by
@@ -0,0 +1,525 @@
+#include "megbrain/rdnn/cost_model.h"
+#include "megbrain/utils/persistent_cache.h"
+#include "megbrain/utils/timer.h"
+
+#include "megdnn/oprs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace mgb;
+using namespace rdnn;
+
+namespace {
+
+/*!
+ * \brief prior compute efficiency of an algorithm family relative to the
+ * calibrated single thread f32 throughput
+ *
+ * Entries are matched in order against the algorithm name, so more specific
+ * patterns must come first. They are only used until fastrun has measured the
+ * algorithm on this host, see CostModel::update_efficiency().
+ */
+struct AlgoEfficiency {
+    const char* pattern;
+    float efficiency;
+    bool multi_thread;
+};
+
+//! naive algorithms are matched by attribute instead of name
+constexpr AlgoEfficiency NAIVE_EFFICIENCY = {"NAIVE", 1.f / 32, false};
+
+// clang-format off
+constexpr AlgoEfficiency ALGO_EFFICIENCY[] = {
+        {"VNNI",        3.2f,     true},
+        {"MKLDNN",      1.6f,     true},
+        {"MKL",         1.f,      true},
+        {"BLAS",        0.9f,     true},
+        {"AVX2",        1.2f,     true},
+        {"AVX",         0.8f,     true},
+        {"SSE",         0.5f,     true},
+        {"F32_6x16",    0.9f,     true},
+        {"F32MK8_8X8",  0.85f,    true},
+        {"GEMV",        0.25f,    true},
+        {"FB_GI_",      0.5f,     true},
+        {"GI_",         0.45f,    true},
+        {"CHANWISE",    0.4f,     true},
+        {"DIRECT",      0.4f,     true},
+        {"FB_",         0.15f,    true},
+        {"FALLBACK",    0.15f,    true},
+};
+// clang-format on
+
+//! efficiency of algorithms neither in the table nor measured by fastrun
+constexpr float DEFAULT_EFFICIENCY = 0.3f;
+
+const AlgoEfficiency* find_efficiency(const std::string& name) {
+    for (auto&& i : ALGO_EFFICIENCY) {
+        if (name.find(i.pattern) != std::string::npos) {
+            return &i;
+        }
+    }
+    return nullptr;
+}
+
+/* ======================= fitted efficiency ======================= */
+
+constexpr const char* EFFICIENCY_CATEGORY = "rdnn.cost_model.efficiency.v1";
+
+//! efficiency fitted from fastrun results, stored in the persistent cache
+//! with the algo name as key
+struct FittedEfficiency {
+    //! geometric mean of the fitted samples
+    float efficiency;
+    uint32_t nr_sample;
+};
+
+//! later samples weigh at least 1 / MAX_SAMPLE, so that the fitted value
+//! follows changes of the host
+constexpr uint32_t MAX_SAMPLE = 16;
+
+Maybe<FittedEfficiency> get_fitted_efficiency(const std::string& name) {
+    PersistentCache::Blob key{name.data(), name.size()};
+    auto cached = PersistentCache::inst().get(EFFICIENCY_CATEGORY, key);
+    if (!cached.valid() || cached->size != sizeof(FittedEfficiency)) {
+        return None;
+    }
+    FittedEfficiency ret;
+    memcpy(&ret, cached->ptr, sizeof(FittedEfficiency));
+    return ret;
+}
+
+void put_fitted_efficiency(const std::string& name, const FittedEfficiency& val) {
+    PersistentCache::Blob key{name.data(), name.size()};
+    PersistentCache::inst().put(
+            EFFICIENCY_CATEGORY, key, {&val, sizeof(FittedEfficiency)});
+}
+
+//! warn once for each algorithm whose efficiency is a pure guess
+void warn_unknown_algo(const std::string& name) {
+    static std::mutex mtx;
+    static std::unordered_set<std::string> warned;
+    MGB_LOCK_GUARD(mtx);
+    if (warned.insert(name).second) {
+        mgb_log_warn(
+                "cost model: no efficiency known for algo %s, assume %.2f; run "
+                "fastrun once on this host to fit it",
+                name.c_str(), DEFAULT_EFFICIENCY);
+    }
+}
+
+//! name of the matmul algo wrapped by im2col, conv1x1 and winograd, which is
+//! the second field of the algo name
+std::string inner_algo_name(const std::string& name) {
+    auto begin = name.find(':');
+    if (begin == std::string::npos) {
+        return name;
+    }
+    auto end = name.find(':', begin + 1);
+    return name.substr(begin + 1, end == std::string::npos ? end : end - begin - 1);
+}
+
+bool start_with(const std::string& name, const char* prefix) {
+    return name.compare(0, strlen(prefix), prefix) == 0;
+}
+
+double span_bytes(const TensorLayout& layout) {
+    if (!layout.ndim) {
+        return 0;
+    }
+    return static_cast<double>(layout.span().dist_byte());
+}
+
+//! number of output channels of a conv like dst layout
+size_t conv_output_channel(
+        const TensorLayout& dst, megdnn::param::ConvBias::Format format) {
+    using Format = megdnn::param::ConvBias::Format;
+    switch (format) {
+        case Format::NCHW:
+            return dst.ndim == 4 ? dst[1] : 0;
+        case Format::NHWC:
+            return dst.ndim == 4 ? dst[3] : 0;
+        case Format::NCHW4:
+        case Format::NCHW8:
+        case Format::NCHW32:
+        case Format::NCHW88:
+        case Format::NCHW44:
+        case Format::NCHW44_DOT:
+        case Format::NCHW64:
+            return dst.ndim == 5 ? dst[1] * dst[4] : 0;
+        default:
+            return 0;
+    }
+}
+
+Maybe<CostModel::Workload> conv_bias_workload(
+        const megdnn::param::ConvBias& param, const TensorLayoutArray& layouts) {
+    using Sparse = megdnn::param::ConvBias::Sparse;
+    using Format = megdnn::param::ConvBias::Format;
+    //! src, filter, bias, z, dst
+    mgb_assert(layouts.size() == 5);
+    auto&& src = layouts[0];
+    auto&& filter = layouts[1];
+    auto&& dst = layouts[4];
+    size_t oc = conv_output_channel(dst, param.format);
+    if (!oc || !filter.ndim) {
+        return None;
+    }
+    CostModel::Workload ret;
+    ret.flops = 2.0 * dst.total_nr_elems() *
+                (static_cast<double>(filter.total_nr_elems()) / oc);
+    for (auto&& layout : layouts) {
+        ret.io_bytes += span_bytes(layout);
+    }
+    size_t fh_idx = param.sparse == Sparse::DENSE ? 2 : 3;
+    if (param.format == Format::NHWC) {
+        fh_idx -= 1;
+    }
+    if (fh_idx < filter.ndim) {
+        ret.filter_size = filter[fh_idx];
+    }
+    //! im2col unfolds each input element into fh * fw / (sh * sw) elements
+    double stride = std::max<double>(param.stride_h * param.stride_w, 1);
+    ret.unfold_bytes = span_bytes(src) * ret.filter_size * ret.filter_size / stride;
+    return ret;
+}
+
+Maybe<CostModel::Workload> matmul_workload(
+        const megdnn::param::MatrixMul& param, const TensorLayoutArray& layouts) {
+    using Format = megdnn::param::MatrixMul::Format;
+    //! A, B, C
+    mgb_assert(layouts.size() == 3);
+    auto&& a = layouts[0];
+    auto&& c = layouts[2];
+    if (!a.ndim || !c.ndim) {
+        return None;
+    }
+    //! A holds M * K elements per batch and C holds M * N, whatever the format
+    size_t n = param.format == Format::DEFAULT ? c[c.ndim - 1] : c[1];
+    CostModel::Workload ret;
+    ret.flops = 2.0 * a.total_nr_elems() * n;
+    for (auto&& layout : layouts) {
+        ret.io_bytes += span_bytes(layout);
+    }
+    return ret;
+}
+
+Maybe<CostModel::Workload> pooling_workload(
+        const megdnn::param::Pooling& param, const TensorLayoutArray& layouts) {
+    //! src, dst
+    mgb_assert(layouts.size() == 2);
+    CostModel::Workload ret;
+    ret.flops = static_cast<double>(layouts[1].total_nr_elems()) * param.window_h *
+                param.window_w;
+    ret.io_bytes = span_bytes(layouts[0]) + span_bytes(layouts[1]);
+    return ret;
+}
+
+/* ======================= calibration ======================= */
+
+CostModel::HostParam default_host_param() {
+    return {8.f, 8.f, 24.f, 5.f};
+}
+
+double measure_gflops() {
+    constexpr size_t LANES = 64, ITERS = 1 << 16;
+    alignas(64) float acc[LANES];
+    for (size_t i = 0; i < LANES; ++i) {
+        acc[i] = 1.f + i * 1e-3f;
+    }
+    volatile float va = 0.999999f, vb = 1e-7f;
+    float a = va, b = vb;
+    double best = 0;
+    for (int rep = 0; rep < 3; ++rep) {
+        RealTimer timer;
+        for (size_t it = 0; it < ITERS; ++it) {
+            for (size_t i = 0; i < LANES; ++i) {
+                acc[i] = acc[i] * a + b;
+            }
+        }
+        double secs = timer.get_secs();
+        if (secs > 0) {
+            best = std::max(best, 2.0 * LANES * ITERS / secs * 1e-9);
+        }
+    }
+    float sum = 0;
+    for (size_t i = 0; i < LANES; ++i) {
+        sum += acc[i];
+    }
+    volatile float sink = sum;
+    MGB_MARK_USED_VAR(sink);
+    return best;
+}
+
+//! copy bandwidth of \p nr_threads threads, each copies \p bytes
+double measure_bandwidth(size_t nr_threads, size_t bytes) {
+    std::vector<std::vector<uint8_t>> src(nr_threads), dst(nr_threads);
+    for (size_t i = 0; i < nr_threads; ++i) {
+        src[i].assign(bytes, static_cast<uint8_t>(i));
+        dst[i].assign(bytes, 0);
+    }
+    auto copy = [&](size_t i) { memcpy(dst[i].data(), src[i].data(), bytes); };
+    double best = 0;
+    for (int rep = 0; rep < 3; ++rep) {
+        RealTimer timer;
+        if (nr_threads == 1) {
+            copy(0);
+        } else {
+            std::vector<std::thread> workers;
+            for (size_t i = 0; i < nr_threads; ++i) {
+                workers.emplace_back(copy, i);
+            }
+            for (auto&& w : workers) {
+                w.join();
+            }
+        }
+        double secs = timer.get_secs();
+        if (secs > 0) {
+            //! read and write
+            best = std::max(best, 2.0 * bytes * nr_threads / secs * 1e-9);
+        }
+    }
+    return best;
+}
+
+/*!
+ * \brief cost of handing a task to \p nr_threads persistent workers and
+ * waiting for all of them, in microseconds
+ *
+ * Like the workers of the CPU dispatcher, the workers are started once and
+ * spin on a generation counter, so thread creation is not measured.
+ */
+double measure_dispatch_us(size_t nr_threads) {
+    constexpr int WARMUP = 4, REPEAT = 64;
+    std::atomic_int generation{0}, done{0};
+    std::atomic_bool stop{false};
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < nr_threads; ++i) {
+        workers.emplace_back([&] {
+            int seen = 0;
+            while (true) {
+                int cur;
+                while ((cur = generation.load(std::memory_order_acquire)) == seen) {
+                    if (stop.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+                    std::this_thread::yield();
+                }
+                seen = cur;
+                done.fetch_add(1, std::memory_order_acq_rel);
+            }
+        });
+    }
+    auto dispatch = [&]() {
+        done.store(0, std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_acq_rel);
+        while (done.load(std::memory_order_acquire) !=
+               static_cast<int>(nr_threads - 1)) {
+            std::this_thread::yield();
+        }
+    };
+    for (int rep = 0; rep < WARMUP; ++rep) {
+        dispatch();
+    }
+    RealTimer timer;
+    for (int rep = 0; rep < REPEAT; ++rep) {
+        dispatch();
+    }
+    double ret = timer.get_secs() * 1e6 / REPEAT;
+    stop.store(true);
+    for (auto&& w : workers) {
+        w.join();
+    }
+    return ret;
+}
+
+constexpr const char* CALIBRATION_CATEGORY = "rdnn.cost_model";
+constexpr const char* CALIBRATION_KEY = "host_param.v2";
+
+/*!
+ * \brief terms of the roofline model of an algorithm, the estimated time is
+ *      max(flops / (peak * efficiency), memory_time) + dispatch_time
+ */
+struct Roofline {
+    double flops;
+    //! peak flops per second of the threads used by the algorithm
+    double peak;
+    double memory_time;
+    double dispatch_time;
+    float efficiency;
+};
+
+Roofline roofline(
+        const CostModel::HostParam& host, const CostModel::Workload& workload,
+        const megdnn::Algorithm* algo, size_t workspace, size_t nr_threads) {
+    std::string name = algo->name();
+
+    double flops = workload.flops;
+    double pack_bytes = workspace;
+    std::string kernel_name = name;
+    if (start_with(name, "WINOGRAD")) {
+        auto wparam = megdnn::ConvBias::parse_winograd_name(name);
+        double m = wparam.output_block_size, r = workload.filter_size;
+        if (m > 0 && r > 0) {
+            double alpha = m + r - 1;
+            //! multiplications are reduced to alpha^2 / (m^2 * r^2), while
+            //! the transformed input and output are alpha^2 / m^2 larger
+            flops *= alpha * alpha / (m * m * r * r);
+            pack_bytes = workload.io_bytes * alpha * alpha / (m * m);
+        }
+        kernel_name = inner_algo_name(name);
+    } else if (start_with(name, "IM2COLMATMUL")) {
+        //! unfolded input is written once and read once by the matmul
+        pack_bytes = 2 * workload.unfold_bytes;
+        kernel_name = inner_algo_name(name);
+    } else if (start_with(name, "CONV1x1")) {
+        pack_bytes = 0;
+        kernel_name = inner_algo_name(name);
+    }
+
+    //! the fitted efficiency is preferred to the prior of the table
+    const AlgoEfficiency* entry = &NAIVE_EFFICIENCY;
+    if (!algo->contain_attribute_all(megdnn::AlgoAttribute::NAIVE)) {
+        entry = find_efficiency(kernel_name);
+    }
+    auto fitted = get_fitted_efficiency(name);
+    float efficiency = DEFAULT_EFFICIENCY;
+    if (fitted.valid()) {
+        efficiency = fitted->efficiency;
+    } else if (entry) {
+        efficiency = entry->efficiency;
+    } else {
+        warn_unknown_algo(name);
+    }
+    bool multi_thread = entry ? entry->multi_thread : true;
+
+    size_t threads = multi_thread ? std::max<size_t>(nr_threads, 1) : 1;
+    double bandwidth =
+            std::min<double>(host.bandwidth_single * threads, host.bandwidth_all);
+    Roofline ret;
+    ret.flops = flops;
+    ret.peak = host.gflops_per_thread * 1e9 * threads;
+    ret.memory_time = (workload.io_bytes + pack_bytes) / (bandwidth * 1e9);
+    ret.dispatch_time = threads > 1 ? host.dispatch_us * 1e-6 : 0;
+    ret.efficiency = efficiency;
+    return ret;
+}
+
+}  // anonymous namespace
+
+Maybe<CostModel::Workload> CostModel::workload(
+        megdnn::Algorithm::OprType opr_type, const std::string& param,
+        const TensorLayoutArray& layouts) {
+    using OprType = megdnn::Algorithm::OprType;
+    switch (opr_type) {
+        case OprType::CONVBIAS_FORWARD:
+            return conv_bias_workload(
+                    megdnn::Algorithm::deserialize_read_pod<megdnn::param::ConvBias>(
+                            param),
+                    layouts);
+        case OprType::MATRIX_MUL_FORWARD:
+        case OprType::BATCHED_MATRIX_MUL_FORWARD:
+            return matmul_workload(
+                    megdnn::Algorithm::deserialize_read_pod<megdnn::param::MatrixMul>(
+                            param),
+                    layouts);
+        case OprType::POOLING_FORWARD:
+            return pooling_workload(
+                    megdnn::Algorithm::deserialize_read_pod<megdnn::param::Pooling>(
+                            param),
+                    layouts);
+        default:
+            return None;
+    }
+}
+
+double CostModel::estimate_time(
+        const Workload& workload, const megdnn::Algorithm* algo, size_t workspace,
+        size_t nr_threads) {
+    return estimate_time(host_param(), workload, algo, workspace, nr_threads);
+}
+
+double CostModel::estimate_time(
+        const HostParam& host, const Workload& workload, const megdnn::Algorithm* algo,
+        size_t workspace, size_t nr_threads) {
+    auto terms = roofline(host, workload, algo, workspace, nr_threads);
+    double compute_time = terms.flops / (terms.peak * terms.efficiency);
+    return std::max(compute_time, terms.memory_time) + terms.dispatch_time;
+}
+
+void CostModel::update_efficiency(
+        const Workload& workload, const megdnn::Algorithm* algo, size_t workspace,
+        size_t nr_threads, double time) {
+    auto terms = roofline(host_param(), workload, algo, workspace, nr_threads);
+    double compute_time = time - terms.dispatch_time;
+    //! a memory bound run only gives a lower bound of the efficiency
+    if (!(terms.flops > 0) || compute_time <= terms.memory_time) {
+        return;
+    }
+    double sample = terms.flops / (terms.peak * compute_time);
+    std::string name = algo->name();
+    FittedEfficiency fitted{static_cast<float>(sample), 1};
+    auto prev = get_fitted_efficiency(name);
+    if (prev.valid()) {
+        uint32_t n = std::min(prev->nr_sample, MAX_SAMPLE - 1);
+        double log_eff = (std::log(prev->efficiency) * n + std::log(sample)) / (n + 1);
+        fitted = {static_cast<float>(std::exp(log_eff)), n + 1};
+    }
+    put_fitted_efficiency(name, fitted);
+}
+
+const CostModel::HostParam& CostModel::host_param() {
+    static HostParam param = []() {
+        PersistentCache::Blob key{CALIBRATION_KEY, strlen(CALIBRATION_KEY)};
+        auto cached = PersistentCache::inst().get(CALIBRATION_CATEGORY, key);
+        if (cached.valid() && cached->size == sizeof(HostParam)) {
+            HostParam ret;
+            memcpy(&ret, cached->ptr, sizeof(HostParam));
+            return ret;
+        }
+        if (MGB_GETENV("MGB_COST_MODEL_NO_CALIBRATE")) {
+            return default_host_param();
+        }
+        auto ret = calibrate();
+        PersistentCache::inst().put(
+                CALIBRATION_CATEGORY, key, {&ret, sizeof(HostParam)});
+        return ret;
+    }();
+    return param;
+}
+
+CostModel::HostParam CostModel::calibrate() {
+    auto ret = default_host_param();
+    size_t nr_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    nr_threads = std::min<size_t>(nr_threads, 16);
+
+    double gflops = measure_gflops();
+    if (gflops > 0) {
+        ret.gflops_per_thread = gflops;
+    }
+    constexpr size_t BUF_BYTES = 32 * 1024 * 1024;
+    double bw_single = measure_bandwidth(1, BUF_BYTES);
+    if (bw_single > 0) {
+        ret.bandwidth_single = bw_single;
+        ret.bandwidth_all = bw_single;
+    }
+    if (nr_threads > 1) {
+        double bw_all = measure_bandwidth(nr_threads, BUF_BYTES / nr_threads);
+        ret.bandwidth_all = std::max<double>(bw_all, ret.bandwidth_single);
+        ret.dispatch_us = measure_dispatch_us(nr_threads);
+    }
+    mgb_log_debug(
+            "cost model calibrated: %.2f GFLOPS/thread, bandwidth %.2f GB/s "
+            "(single) %.2f GB/s (all), dispatch %.2fus",
+            ret.gflops_per_thread, ret.bandwidth_single, ret.bandwidth_all,
+            ret.dispatch_us);
+    return ret;
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
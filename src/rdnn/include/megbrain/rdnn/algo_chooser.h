@@ -97,6 +97,11 @@ public:
         ImplExecutionPolicy choose_by_heuristic(
                 const ExecutionStrategy& selected_strategy) const;
 
+        //! construct algo chain by the analytic cost model, fallback to
+        //! heuristic if the opr is not supported by the cost model
+        ImplExecutionPolicy choose_by_cost_model(
+                const ExecutionStrategy& selected_strategy) const;
+
         //! construct algo chain by profiling
         ImplExecutionPolicy choose_by_profile(
                 const ExecutionStrategy& selected_strategy, bool enable_update) const;
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "megbrain/comp_node.h"
+#include "megbrain/tensor.h"
+#include "megbrain/utils/metahelper.h"
+
+#include "megdnn/oprs/base.h"
+
+namespace mgb {
+namespace rdnn {
+
+/* =================== CostModel =================== */
+/*!
+ * \brief analytic cost model used by ExecutionStrategy::COST_MODEL to choose
+ * CPU algorithms without profiling
+ *
+ * The running time of an algorithm is estimated with a roofline model:
+ *
+ *      t = max(flops / (peak * efficiency * threads),
+ *              (io_bytes + pack_bytes) / bandwidth(threads)) + dispatch
+ *
+ * The host peak and memory bandwidth are measured once per host by a small
+ * calibration benchmark and stored in the PersistentCache, so only the first
+ * process on a host pays for it. Pack overhead is derived from the algorithm
+ * family encoded in its name (winograd, im2col, conv1x1 ...). The efficiency
+ * of an algorithm is fitted from the times measured by fastrun on this host
+ * and also kept in the PersistentCache; a per family table is used as prior
+ * for algorithms which have never been profiled.
+ */
+class CostModel {
+public:
+    //! calibrated host parameters
+    struct HostParam {
+        //! achieved f32 multiply-add throughput of a single thread, in GFLOPS
+        float gflops_per_thread;
+        //! memory bandwidth of a single thread, in GB/s
+        float bandwidth_single;
+        //! memory bandwidth of all threads together, in GB/s
+        float bandwidth_all;
+        //! overhead of dispatching a multi-thread task, in microseconds
+        float dispatch_us;
+    };
+
+    //! algorithm independent workload of an operator
+    struct Workload {
+        //! arithmetic operations of the operator
+        double flops = 0;
+        //! bytes of all the input and output tensors
+        double io_bytes = 0;
+        //! bytes written by an im2col style unfold of the input
+        double unfold_bytes = 0;
+        //! spatial filter size of a convolution, 0 for other operators
+        uint32_t filter_size = 0;
+    };
+
+    /*!
+     * \brief compute the workload of an operator
+     *
+     * \param opr_type type of the megdnn operator
+     * \param param serialized param of the operator
+     * \param layouts input and output layouts of the operator
+     * \return the workload, or None if the operator or format is not
+     *      supported by the cost model
+     */
+    MGE_WIN_DECLSPEC_FUC static Maybe<Workload> workload(
+            megdnn::Algorithm::OprType opr_type, const std::string& param,
+            const TensorLayoutArray& layouts);
+
+    /*!
+     * \brief estimate the running time of an algorithm in seconds
+     *
+     * \param workspace workspace in bytes required by the algorithm
+     * \param nr_threads number of threads of the comp node
+     */
+    MGE_WIN_DECLSPEC_FUC static double estimate_time(
+            const Workload& workload, const megdnn::Algorithm* algo,
+            size_t workspace, size_t nr_threads);
+
+    //! estimate the running time on a host described by \p host instead of
+    //! the calibrated one
+    MGE_WIN_DECLSPEC_FUC static double estimate_time(
+            const HostParam& host, const Workload& workload,
+            const megdnn::Algorithm* algo, size_t workspace, size_t nr_threads);
+
+    /*!
+     * \brief fit the efficiency of an algorithm to a measured running time
+     *
+     * Called with the results of fastrun profiling. Runs bound by memory
+     * bandwidth are ignored since they do not tell the compute efficiency.
+     *
+     * \param time measured running time in seconds
+     */
+    MGE_WIN_DECLSPEC_FUC static void update_efficiency(
+            const Workload& workload, const megdnn::Algorithm* algo,
+            size_t workspace, size_t nr_threads, double time);
+
+    //! get the calibrated host param, calibrate on first call if it is not
+    //! found in the persistent cache
+    MGE_WIN_DECLSPEC_FUC static const HostParam& host_param();
+
+    //! run the calibration benchmark on current host
+    MGE_WIN_DECLSPEC_FUC static HostParam calibrate();
+};
+
+}  // namespace rdnn
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -12,6 +12,7 @@
 #if MGB_ENABLE_FBS_SERIALIZATION
 
 #include "batched_device_value_loader.h"
+#include "tensor_codec.h"
 
 #include "megbrain/graph/exc_extra_info.h"
 #include "megbrain/opr/io.h"
@@ -21,6 +22,7 @@
 #include "megbrain/serialization/metadata.h"
 #include "megbrain/serialization/opr_load_dump.h"
 #include "megbrain/serialization/serializer.h"
+#include "megbrain/system.h"
 #include "megbrain/version.h"
 
 #include <flatbuffers/flatbuffers.h>
@@ -124,6 +126,10 @@ class GraphDumperOSS final : public GraphDumper, OprDumpContextFlatBuffers {
 
     flatbuffers::Offset<fbs::DType> build_dtype(DType dtype);
 
+    //! write the compressed tensor value, or return 0 if it is not compressed
+    flatbuffers::Offset<fbs::TensorCompression> dump_compressed_tensor_value(
+            TensorWriteMethod method, const HostTensorND& tensor);
+
 public:
     GraphDumperOSS(std::unique_ptr<OutputFile> file) : m_file{std::move(file)} {}
     DumpResult dump(
@@ -432,13 +438,17 @@ void GraphDumperOSS::dump_tensor(
     }
 
     size_t value_size = 0;
+    flatbuffers::Offset<fbs::TensorCompression> compression;
     if (has_value) {
         check_tensor_value_valid(name, tensor);
         auto begin = m_file->tell();
         auto&& dumper = m_config.tensor_value_dumper;
+        if (!dumper) {
+            compression = dump_compressed_tensor_value(method, tensor);
+        }
         if (dumper) {
             dumper(*m_file, *m_cur_opr, tensor);
-        } else {
+        } else if (compression.IsNull()) {
             m_file->write(tensor.raw_ptr(), tensor.layout().span().high_byte);
         }
         value_size = m_file->tell() - begin;
@@ -452,11 +462,38 @@ void GraphDumperOSS::dump_tensor(
             m_builder,
             m_builder.CreateSharedString(tensor.comp_node().to_string_logical()));
     auto dtype = build_dtype(tensor.dtype());
-    auto serialized_tensor =
-            fbs::CreateTensor(m_builder, fbname, shape, comp_node, dtype, value_size);
+    auto serialized_tensor = fbs::CreateTensor(
+            m_builder, fbname, shape, comp_node, dtype, value_size, 0, compression);
     m_cur_opr_tensor.emplace_back(serialized_tensor);
 }
 
+flatbuffers::Offset<fbs::TensorCompression> GraphDumperOSS::
+        dump_compressed_tensor_value(
+                TensorWriteMethod method, const HostTensorND& tensor) {
+    using Storage = TensorCompression::Storage;
+    auto&& config = m_config.tensor_compression;
+    auto size = tensor.layout().span().high_byte;
+    // values of the inputs are usually replaced and not worth compressing
+    if (!config.enabled() || method == TensorWriteMethod::VALUE_INPUT ||
+        size < config.min_size) {
+        return {};
+    }
+    // only the params are stored in a lower precision
+    auto storage = method == TensorWriteMethod::VALUE_SHARED ? config.storage
+                                                             : Storage::SAME;
+    auto encoded =
+            tensor_codec::encode(tensor, config.codec, storage, config.chunk_size);
+    if (encoded.codec == TensorCompression::Codec::NONE &&
+        encoded.storage == Storage::SAME) {
+        return {};
+    }
+    m_file->write(encoded.data.data(), encoded.data.size());
+    return fbs::CreateTensorCompression(
+            m_builder, static_cast<fbs::TensorCodec>(encoded.codec),
+            static_cast<fbs::TensorStorage>(encoded.storage), encoded.chunk_size,
+            m_builder.CreateVector(encoded.chunk_sizes));
+}
+
 void GraphDumperOSS::dump_buf_with_len(const void* data, uint32_t size) {
     auto blob = fbs::CreateBlob(
             m_builder, m_builder.CreateVector(static_cast<const uint8_t*>(data), size));
@@ -506,6 +543,7 @@ class GraphLoaderOSS::OprLoadContextImpl final : public OprLoadContextFlatBuffer
     LoadResult::TensorMap m_tensor_map;
     VarNodeArray m_id2varnode;
     BatchedDeviceValueLoader m_device_value_loader;
+    std::unique_ptr<tensor_codec::ChunkDecoder> m_chunk_decoder;
     const fbs::Operator* m_current_opr;
     size_t m_cur_opr_tensor_cnt;
     size_t m_cur_opr_blob_cnt;
@@ -520,6 +558,9 @@ class GraphLoaderOSS::OprLoadContextImpl final : public OprLoadContextFlatBuffer
     void load_tensor_value(
             HostTensorND* dest, const TensorLayout& layout, const fbs::Tensor* tensor);
 
+    void load_compressed_tensor_value(
+            HostTensorND& dest, const TensorLayout& layout, const fbs::Tensor* tensor);
+
     std::shared_ptr<HostTensorND> load_tensor() override;
 
     std::shared_ptr<DeviceTensorND> load_tensor_shared() override;
@@ -624,7 +665,17 @@ void GraphLoaderOSS::OprLoadContextImpl::load_tensor_value(
     auto&& file = m_loader->m_file;
     auto begin_pos = file->tell();
     file->skip(tensor->offset());
-    if (loader) {
+    if (tensor->compression()) {
+        mgb_throw_if(
+                loader, SerializationError,
+                "compressed tensor values can not be loaded by custom tensor value "
+                "loader");
+        if (dest) {
+            load_compressed_tensor_value(*dest, layout, tensor);
+        } else {
+            file->skip(tensor->data_size());
+        }
+    } else if (loader) {
         // call custom loader
         void* dest_ptr = nullptr;
         if (dest) {
@@ -659,6 +710,36 @@ void GraphLoaderOSS::OprLoadContextImpl::load_tensor_value(
     }
 }
 
+void GraphLoaderOSS::OprLoadContextImpl::load_compressed_tensor_value(
+        HostTensorND& dest, const TensorLayout& layout, const fbs::Tensor* tensor) {
+    auto compression = tensor->compression();
+    std::vector<uint32_t> chunk_sizes;
+    if (compression->chunk_sizes()) {
+        chunk_sizes.assign(
+                compression->chunk_sizes()->begin(), compression->chunk_sizes()->end());
+    }
+    if (!m_chunk_decoder) {
+        size_t nr_threads = 0;
+#if MGB_HAVE_THREAD
+        nr_threads = m_loader->m_cur_load_config->nr_decode_threads;
+        if (!nr_threads) {
+            nr_threads = std::min<size_t>(sys::get_cpu_count(), 4);
+        }
+        // decoding on the loading thread is enough for a single cpu
+        if (nr_threads == 1) {
+            nr_threads = 0;
+        }
+#endif
+        m_chunk_decoder = std::make_unique<tensor_codec::ChunkDecoder>(nr_threads);
+    }
+    dest.dtype(layout.dtype).resize(layout);
+    m_chunk_decoder->decode(
+            *m_loader->m_file,
+            static_cast<TensorCompression::Codec>(compression->codec()),
+            static_cast<TensorCompression::Storage>(compression->storage()),
+            compression->chunk_size(), chunk_sizes, dest);
+}
+
 std::shared_ptr<HostTensorND> GraphLoaderOSS::OprLoadContextImpl::load_tensor() {
     mgb_assert(
             m_current_opr->tensors() &&
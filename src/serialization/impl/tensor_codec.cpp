@@ -0,0 +1,399 @@
+#include "tensor_codec.h"
+
+#include "megbrain/exception.h"
+#include "megbrain/system.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace mgb;
+using namespace serialization;
+using namespace tensor_codec;
+
+namespace {
+
+using Codec = TensorCompression::Codec;
+using Storage = TensorCompression::Storage;
+
+// lz4 block format: sequences of literals followed by a back reference, where
+// the last MIN_MATCH + 1 bytes must be literals and no match starts in the last
+// MF_LIMIT bytes
+constexpr size_t MIN_MATCH = 4, LAST_LITERALS = 5, MF_LIMIT = 12, MAX_OFFSET = 65535,
+                 HASH_LOG = 14;
+
+uint32_t read32(const uint8_t* ptr) {
+    uint32_t ret;
+    memcpy(&ret, ptr, 4);
+    return ret;
+}
+
+uint32_t lz4_hash(uint32_t seq) {
+    return (seq * 2654435761u) >> (32 - HASH_LOG);
+}
+
+uint8_t* write_length(uint8_t* dst, size_t length) {
+    for (; length >= 255; length -= 255) {
+        *dst++ = 255;
+    }
+    *dst++ = length;
+    return dst;
+}
+
+uint8_t* write_sequence(
+        uint8_t* dst, const uint8_t* literals, size_t nr_literals, size_t offset,
+        size_t match_length) {
+    auto token = dst++;
+    *token = std::min<size_t>(nr_literals, 15) << 4;
+    if (nr_literals >= 15) {
+        dst = write_length(dst, nr_literals - 15);
+    }
+    memcpy(dst, literals, nr_literals);
+    dst += nr_literals;
+    if (!match_length) {
+        return dst;
+    }
+    *dst++ = offset & 0xff;
+    *dst++ = offset >> 8;
+    match_length -= MIN_MATCH;
+    *token |= std::min<size_t>(match_length, 15);
+    if (match_length >= 15) {
+        dst = write_length(dst, match_length - 15);
+    }
+    return dst;
+}
+
+size_t element_size(DType dtype) {
+    return dtype.is_low_bit() ? 1 : dtype.size();
+}
+
+size_t storage_size(Storage storage, DType dtype) {
+    return storage == Storage::SAME ? element_size(dtype) : 2;
+}
+
+#if !MEGDNN_DISABLE_FLOAT16
+template <typename T>
+void from_float32(const float* src, void* dst, size_t nr_elems) {
+    auto ptr = static_cast<T*>(dst);
+    for (size_t i = 0; i < nr_elems; ++i) {
+        ptr[i] = static_cast<T>(src[i]);
+    }
+}
+
+template <typename T>
+void to_float32(const void* src, float* dst, size_t nr_elems) {
+    auto ptr = static_cast<const T*>(src);
+    for (size_t i = 0; i < nr_elems; ++i) {
+        dst[i] = static_cast<float>(ptr[i]);
+    }
+}
+#endif
+
+//! convert the float32 values to \p storage
+std::vector<uint8_t> to_storage(const HostTensorND& value, Storage storage) {
+    size_t nr_elems = value.layout().total_nr_elems();
+    std::vector<uint8_t> ret(nr_elems * 2);
+#if !MEGDNN_DISABLE_FLOAT16
+    if (storage == Storage::FLOAT16) {
+        from_float32<dt_float16>(value.ptr<float>(), ret.data(), nr_elems);
+    } else {
+        from_float32<dt_bfloat16>(value.ptr<float>(), ret.data(), nr_elems);
+    }
+#else
+    mgb_throw(SerializationError, "float16 is disabled, can not store float16 values");
+#endif
+    return ret;
+}
+
+//! decode a chunk of \p raw_size bytes as stored, and write \p nr_elems
+//! elements of dtype \p dtype at \p dst
+void decode_chunk(
+        Codec codec, Storage storage, DType dtype, const uint8_t* src,
+        size_t src_size, size_t raw_size, void* dst) {
+    size_t elem_size = storage_size(storage, dtype);
+    size_t nr_elems = raw_size / elem_size;
+    thread_local std::vector<uint8_t> decompressed, unshuffled;
+    bool converted = storage != Storage::SAME;
+    const uint8_t* raw = src;
+    if (src_size != raw_size) {
+        mgb_assert(codec == Codec::SHUFFLE_LZ4);
+        decompressed.resize(raw_size);
+        lz4_decompress(src, src_size, decompressed.data(), raw_size);
+        void* unshuffled_ptr = dst;
+        if (converted) {
+            unshuffled.resize(raw_size);
+            unshuffled_ptr = unshuffled.data();
+        }
+        byte_unshuffle(decompressed.data(), unshuffled_ptr, nr_elems, elem_size);
+        if (!converted) {
+            return;
+        }
+        raw = unshuffled.data();
+    } else if (!converted) {
+        memcpy(dst, src, raw_size);
+        return;
+    }
+#if !MEGDNN_DISABLE_FLOAT16
+    if (storage == Storage::FLOAT16) {
+        to_float32<dt_float16>(raw, static_cast<float*>(dst), nr_elems);
+    } else {
+        to_float32<dt_bfloat16>(raw, static_cast<float*>(dst), nr_elems);
+    }
+#else
+    MGB_MARK_USED_VAR(raw);
+    mgb_throw(SerializationError, "float16 is disabled, can not load float16 values");
+#endif
+}
+
+}  // namespace
+
+size_t tensor_codec::lz4_bound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t tensor_codec::lz4_compress(const void* src, size_t size, void* dst) {
+    auto begin = static_cast<const uint8_t*>(src);
+    auto out = static_cast<uint8_t*>(dst);
+    size_t anchor = 0;
+    if (size > MF_LIMIT) {
+        // positions plus one of the last 4-byte sequences with each hash
+        std::vector<uint32_t> table(1 << HASH_LOG, 0);
+        size_t limit = size - MF_LIMIT, match_limit = size - LAST_LITERALS;
+        for (size_t pos = 0; pos < limit;) {
+            auto seq = read32(begin + pos);
+            auto&& entry = table[lz4_hash(seq)];
+            size_t ref = entry;
+            entry = pos + 1;
+            if (!ref || pos + 1 - ref > MAX_OFFSET || read32(begin + ref - 1) != seq) {
+                ++pos;
+                continue;
+            }
+            --ref;
+            size_t length = MIN_MATCH;
+            while (pos + length < match_limit &&
+                   begin[ref + length] == begin[pos + length]) {
+                ++length;
+            }
+            out = write_sequence(out, begin + anchor, pos - anchor, pos - ref, length);
+            pos += length;
+            anchor = pos;
+        }
+    }
+    out = write_sequence(out, begin + anchor, size - anchor, 0, 0);
+    return out - static_cast<uint8_t*>(dst);
+}
+
+void tensor_codec::lz4_decompress(
+        const void* src, size_t src_size, void* dst, size_t dst_size) {
+    auto in = static_cast<const uint8_t*>(src), in_end = in + src_size;
+    auto begin = static_cast<uint8_t*>(dst), out = begin, out_end = out + dst_size;
+    auto check = [](bool cond) {
+        mgb_throw_if(!cond, SerializationError, "corrupted lz4 block of tensor value");
+    };
+    auto read_length = [&](size_t length) {
+        if (length == 15) {
+            uint8_t byte;
+            do {
+                check(in < in_end);
+                byte = *in++;
+                length += byte;
+            } while (byte == 255);
+        }
+        return length;
+    };
+    while (true) {
+        check(in < in_end);
+        uint8_t token = *in++;
+        size_t nr_literals = read_length(token >> 4);
+        check(nr_literals <= size_t(in_end - in) &&
+              nr_literals <= size_t(out_end - out));
+        memcpy(out, in, nr_literals);
+        in += nr_literals;
+        out += nr_literals;
+        if (in == in_end) {
+            break;
+        }
+        check(in_end - in >= 2);
+        size_t offset = in[0] | (in[1] << 8);
+        in += 2;
+        check(offset && offset <= size_t(out - begin));
+        size_t length = read_length(token & 15) + MIN_MATCH;
+        check(length <= size_t(out_end - out));
+        const uint8_t* ref = out - offset;
+        if (offset >= length) {
+            memcpy(out, ref, length);
+            out += length;
+        } else {
+            // overlapped match repeats the last offset bytes
+            for (size_t i = 0; i < length; ++i) {
+                *out++ = ref[i];
+            }
+        }
+    }
+    check(out == out_end);
+}
+
+void tensor_codec::byte_shuffle(
+        const void* src, void* dst, size_t nr_elems, size_t elem_size) {
+    auto in = static_cast<const uint8_t*>(src);
+    auto out = static_cast<uint8_t*>(dst);
+    for (size_t i = 0; i < nr_elems; ++i) {
+        for (size_t j = 0; j < elem_size; ++j) {
+            out[j * nr_elems + i] = in[i * elem_size + j];
+        }
+    }
+}
+
+void tensor_codec::byte_unshuffle(
+        const void* src, void* dst, size_t nr_elems, size_t elem_size) {
+    auto in = static_cast<const uint8_t*>(src);
+    auto out = static_cast<uint8_t*>(dst);
+    for (size_t j = 0; j < elem_size; ++j) {
+        for (size_t i = 0; i < nr_elems; ++i) {
+            out[i * elem_size + j] = in[j * nr_elems + i];
+        }
+    }
+}
+
+Encoded tensor_codec::encode(
+        const HostTensorND& value, Codec codec, Storage storage, size_t chunk_size) {
+    auto dtype = value.dtype();
+    if (dtype != dtype::Float32()) {
+        storage = Storage::SAME;
+    }
+    std::vector<uint8_t> converted;
+    auto raw = reinterpret_cast<const uint8_t*>(value.raw_ptr());
+    size_t raw_size = value.layout().span().high_byte;
+    if (storage != Storage::SAME) {
+        converted = to_storage(value, storage);
+        raw = converted.data();
+        raw_size = converted.size();
+    }
+    size_t elem_size = storage_size(storage, dtype);
+    chunk_size = std::max(chunk_size / elem_size, size_t(1)) * elem_size;
+
+    Encoded ret{codec, storage, chunk_size, {}, {}};
+    if (codec == Codec::NONE) {
+        // a single chunk stored as is
+        ret.data.assign(raw, raw + raw_size);
+        ret.chunk_size = raw_size;
+        ret.chunk_sizes.push_back(raw_size);
+        return ret;
+    }
+    std::vector<uint8_t> shuffled(chunk_size);
+    for (size_t begin = 0; begin < raw_size; begin += chunk_size) {
+        size_t size = std::min(chunk_size, raw_size - begin);
+        byte_shuffle(raw + begin, shuffled.data(), size / elem_size, elem_size);
+        size_t offset = ret.data.size();
+        ret.data.resize(offset + lz4_bound(size));
+        size_t compressed = lz4_compress(shuffled.data(), size, &ret.data[offset]);
+        if (compressed >= size) {
+            memcpy(&ret.data[offset], raw + begin, size);
+            compressed = size;
+        }
+        ret.data.resize(offset + compressed);
+        ret.chunk_sizes.push_back(compressed);
+    }
+    return ret;
+}
+
+/* ======================= ChunkDecoder ======================= */
+
+ChunkDecoder::ChunkDecoder(size_t nr_threads) {
+    for (size_t i = 0; i < nr_threads; ++i) {
+        m_workers.emplace_back([this]() {
+            sys::set_thread_name("chunk_decoder");
+            run();
+        });
+    }
+}
+
+ChunkDecoder::~ChunkDecoder() {
+    {
+        MGB_LOCK_GUARD(m_mtx);
+        m_stopped = true;
+    }
+    m_cv.notify_all();
+    for (auto&& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ChunkDecoder::run() {
+    std::unique_lock<std::mutex> lock(m_mtx);
+    while (true) {
+        m_cv.wait(lock, [this]() { return m_stopped || !m_tasks.empty(); });
+        if (m_tasks.empty()) {
+            return;
+        }
+        auto task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        ++m_nr_running;
+        lock.unlock();
+        MGB_TRY { task(); }
+        MGB_CATCH(..., {
+            MGB_LOCK_GUARD(m_mtx);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        });
+        lock.lock();
+        --m_nr_running;
+        m_cv.notify_all();
+    }
+}
+
+void ChunkDecoder::add_task(thin_function<void()> task) {
+    if (m_workers.empty()) {
+        task();
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_mtx);
+    // bound the chunks read but not decoded
+    m_cv.wait(lock, [this]() { return m_tasks.size() < m_workers.size() * 2; });
+    m_tasks.emplace_back(std::move(task));
+    m_cv.notify_all();
+}
+
+void ChunkDecoder::wait() {
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_cv.wait(lock, [this]() { return m_tasks.empty() && !m_nr_running; });
+    if (m_error) {
+        auto error = m_error;
+        m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ChunkDecoder::decode(
+        InputFile& file, Codec codec, Storage storage, size_t chunk_size,
+        const std::vector<uint32_t>& chunk_sizes, HostTensorND& dest) {
+    auto dtype = dest.dtype();
+    mgb_throw_if(
+            storage != Storage::SAME && dtype != dtype::Float32(), SerializationError,
+            "only float32 tensor values can be stored in other types");
+    size_t elem_size = storage_size(storage, dtype);
+    size_t dest_elem_size = element_size(dtype);
+    size_t raw_size = dest.layout().span().high_byte / dest_elem_size * elem_size;
+    mgb_throw_if(
+            !chunk_size || chunk_size % elem_size ||
+                    (raw_size + chunk_size - 1) / chunk_size != chunk_sizes.size(),
+            SerializationError, "bad chunks of compressed tensor value");
+    auto dest_ptr = dest.raw_ptr();
+    for (size_t i = 0; i < chunk_sizes.size(); ++i) {
+        size_t begin = i * chunk_size;
+        size_t size = std::min(chunk_size, raw_size - begin);
+        mgb_throw_if(
+                chunk_sizes[i] > size, SerializationError,
+                "bad chunks of compressed tensor value");
+        auto chunk = std::make_shared<SharedBuffer>(file.read_shared(chunk_sizes[i]));
+        auto dst = dest_ptr + begin / elem_size * dest_elem_size;
+        add_task([=]() {
+            decode_chunk(
+                    codec, storage, dtype, static_cast<const uint8_t*>(chunk->data()),
+                    chunk->size(), size, dst);
+        });
+    }
+    wait();
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "megbrain/serialization/file.h"
+#include "megbrain/serialization/load_dump_config.h"
+#include "megbrain/tensor.h"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <vector>
+
+namespace mgb {
+namespace serialization {
+namespace tensor_codec {
+
+//! max size of the lz4 block compressed from \p size bytes
+size_t lz4_bound(size_t size);
+
+//! compress into a raw lz4 block and return its size; \p dst should have
+//! lz4_bound(size) bytes
+size_t lz4_compress(const void* src, size_t size, void* dst);
+
+//! decompress a raw lz4 block of exactly \p dst_size bytes
+void lz4_decompress(const void* src, size_t src_size, void* dst, size_t dst_size);
+
+//! group the \p elem_size bytes of the elements by significance
+void byte_shuffle(const void* src, void* dst, size_t nr_elems, size_t elem_size);
+
+//! inverse of byte_shuffle
+void byte_unshuffle(const void* src, void* dst, size_t nr_elems, size_t elem_size);
+
+//! a tensor value encoded by TensorCompression
+struct Encoded {
+    TensorCompression::Codec codec;
+    TensorCompression::Storage storage;
+    size_t chunk_size;
+    std::vector<uint32_t> chunk_sizes;
+    std::vector<uint8_t> data;
+};
+
+//! \p storage is applied only to float32 values
+Encoded encode(
+        const HostTensorND& value, TensorCompression::Codec codec,
+        TensorCompression::Storage storage, size_t chunk_size);
+
+/*!
+ * \brief decode the chunks of tensor values with a pool of threads
+ *
+ * Chunks are read from the file one by one, and each is decoded on a thread of
+ * the pool directly into its place in the dest tensor while the next one is
+ * read.
+ */
+class ChunkDecoder : public NonCopyableObj {
+public:
+    explicit ChunkDecoder(size_t nr_threads);
+    ~ChunkDecoder();
+
+    /*!
+     * \brief read the chunks from \p file and decode them into \p dest
+     * \param dest contiguous tensor with the decoded dtype and layout
+     */
+    void decode(
+            InputFile& file, TensorCompression::Codec codec,
+            TensorCompression::Storage storage, size_t chunk_size,
+            const std::vector<uint32_t>& chunk_sizes, HostTensorND& dest);
+
+private:
+    std::vector<std::thread> m_workers;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    std::deque<thin_function<void()>> m_tasks;
+    size_t m_nr_running = 0;
+    bool m_stopped = false;
+    std::exception_ptr m_error;
+
+    void run();
+    void add_task(thin_function<void()> task);
+    //! wait for all the tasks and throw the first error of them
+    void wait();
+};
+
+}  // namespace tensor_codec
+}  // namespace serialization
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -15,6 +15,35 @@
 
 namespace mgb {
 namespace serialization {
+/*!
+ * \brief compression of the tensor values in a dumped graph
+ *
+ * A tensor value is split into chunks of \p chunk_size bytes, which are
+ * compressed independently, so they can be decoded in parallel while the rest
+ * of the value is being read.
+ */
+struct TensorCompression {
+    enum class Codec : uint8_t {
+        NONE = 0,
+        //! group the bytes of the elements by significance, then lz4
+        SHUFFLE_LZ4 = 1,
+    };
+    //! type to store the float32 params in, which loses precision
+    enum class Storage : uint8_t {
+        SAME = 0,
+        FLOAT16 = 1,
+        BFLOAT16 = 2,
+    };
+
+    Codec codec = Codec::NONE;
+    Storage storage = Storage::SAME;
+    size_t chunk_size = 1 << 20;
+    //! tensor values smaller than this are stored as is
+    size_t min_size = 4096;
+
+    bool enabled() const { return codec != Codec::NONE || storage != Storage::SAME; }
+};
+
 //! config for dumping a whole graph; setup in GraphDumper
 struct GraphDumpConfig {
     /*!
@@ -58,6 +87,10 @@ struct GraphDumpConfig {
     //! names. this list record the mapping between output node and it's name
     std::vector<std::pair<std::string, SymbolVar>> alias_name_map;
 
+    //! compression of the tensor values, which is ignored if
+    //! tensor_value_dumper is set; only supported by the flatbuffers format
+    TensorCompression tensor_compression;
+
     GraphDumpConfig(
             int keep_var_name_ = 1, bool keep_param_name_ = false,
             bool keep_opr_priority_ = false, bool keep_op_name_ = true,
@@ -132,6 +165,10 @@ struct GraphLoadConfig {
     //! GraphDumpConfig
     TensorValueLoader tensor_value_loader;
 
+    //! number of threads to decode compressed tensor values, or 0 for the
+    //! number of cpus up to 4
+    size_t nr_decode_threads = 0;
+
     GraphLoadConfig(
             const CompNodeMapper& comp_node_mapper_ = {},
             const OprLoaderMaker& opr_loader_maker_ = {},
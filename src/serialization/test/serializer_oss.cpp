@@ -706,6 +706,71 @@ TEST(TestSerializer2, MultipleParams) {
     load();
 }
 
+TEST(TestSerializer2, CompressedParams) {
+    auto fname = GET_OUTPUT_FILE();
+    HostTensorGenerator<> gen;
+    // values with few distinct bytes compress well, and random ones do not
+    auto smooth = std::make_shared<HostTensorND>(
+            CompNode::load("xpu0"), TensorShape{64, 1000}, dtype::Float32());
+    for (size_t i = 0; i < 64000; ++i) {
+        smooth->ptr<float>()[i] = (i % 100) * 0.25f;
+    }
+    std::vector<std::shared_ptr<HostTensorND>> tensors{
+            smooth, gen({3, 5000}), gen({2, 3})};
+
+    auto dump = [&](TensorCompression::Storage storage) {
+        auto graph = ComputingGraph::make();
+        SymbolVarArray outputs;
+        for (auto&& i : tensors) {
+            outputs.push_back(opr::SharedDeviceTensor::make(*graph, *i));
+        }
+        GraphDumper::DumpConfig config;
+        config.tensor_compression.codec = TensorCompression::Codec::SHUFFLE_LZ4;
+        config.tensor_compression.storage = storage;
+        config.tensor_compression.chunk_size = 10000;
+        return GraphDumper::make(
+                       OutputFile::make_fs(fname.c_str()), GraphDumpFormat::FLATBUFFERS)
+                ->dump(outputs, config);
+    };
+
+    auto load = [&](size_t nr_decode_threads, float max_err) {
+        auto loader = GraphLoader::make(
+                InputFile::make_fs(fname.c_str()), GraphDumpFormat::FLATBUFFERS);
+        GraphLoader::LoadConfig config;
+        config.nr_decode_threads = nr_decode_threads;
+        auto rst = loader->load(config);
+        ASSERT_EQ(tensors.size(), rst.output_var_list.size());
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            HostTensorND got;
+            got.copy_from(rst.output_var_list[i]
+                                  .node()
+                                  ->owner_opr()
+                                  ->cast_final_safe<opr::SharedDeviceTensor>()
+                                  .get_dev_tensor())
+                    .sync();
+            if (max_err) {
+                MGB_ASSERT_TENSOR_NEAR(*tensors[i], got, max_err);
+            } else {
+                MGB_ASSERT_TENSOR_EQ(*tensors[i], got);
+            }
+        }
+    };
+
+    size_t raw_bytes = (64000 + 15000 + 6) * sizeof(float);
+    auto rst = dump(TensorCompression::Storage::SAME);
+    ASSERT_LT(rst.tensor_value_bytes, raw_bytes * 3 / 4);
+    load(0, 0);
+    load(1, 0);
+    load(3, 0);
+
+    rst = dump(TensorCompression::Storage::FLOAT16);
+    ASSERT_LT(rst.tensor_value_bytes, raw_bytes / 2);
+    load(3, 1e-3);
+
+    rst = dump(TensorCompression::Storage::BFLOAT16);
+    load(3, 1e-2);
+}
+
 TEST(TestSerializer2, ParamerizedDType) {
     auto fname = GET_OUTPUT_FILE();
     TensorShape shape{2, 3, 3};
@@ -43,6 +43,10 @@ pdef('PersistentOutputStorage').add_fields(
               'must be reproducible'),
           Doc('OPTIMIZED = 1 << 3',
               'profile require algos are optmized to achieve fast-profile'),
+          Doc('COST_MODEL = 1 << 4',
+              'estimate the running time of each candidate algorithm with an '
+              'analytic cost model calibrated on the host, and choose the '
+              'cheapest one without profiling'),
           default=('HEURISTIC',),
           member_alias=[(('HEURISTIC', 'REPRODUCIBLE'), 'HEURISTIC_REPRODUCIBLE'),
                         (('PROFILE', 'REPRODUCIBLE'), 'PROFILE_REPRODUCIBLE'),